@@ -24,20 +24,28 @@
 
 /** \file
   * Flow in a lid-driven 3D cavity. Benchmark case
+  *
+  * An optional second argument selects the storage of the populations:
+  * "double" (default), "float", or "mixed" (populations stored as float,
+  * collision computed in double with MixedPrecisionDynamics). For the
+  * reduced-precision modes, the same case is also run in double precision,
+  * and the relative L2-deviation of the velocity field is reported, to
+  * compare the gain in bandwidth with the loss of accuracy.
 **/
 
 #include "palabos3D.h"
 #include "palabos3D.hh"   // include full template code
 #include <iostream>
+#include <string>
 
 using namespace plb;
 using namespace std;
 
-typedef double T;
 #define DESCRIPTOR descriptors::D3Q19Descriptor
 
+template<typename T>
 void cavitySetup( MultiBlockLattice3D<T,DESCRIPTOR>& lattice,
-                  IncomprFlowParam<T> const& parameters,
+                  IncomprFlowParam<double> const& parameters,
                   OnLatticeBoundaryCondition3D<T,DESCRIPTOR>& boundaryCondition )
 {
     const plint nx = parameters.getNx();
@@ -49,86 +57,129 @@ void cavitySetup( MultiBlockLattice3D<T,DESCRIPTOR>& lattice,
     // All walls implement a Dirichlet velocity condition.
     boundaryCondition.setVelocityConditionOnBlockBoundaries(lattice);
 
-    T u = std::sqrt((T)2)/(T)2 * parameters.getLatticeU();
+    T u = std::sqrt((T)2)/(T)2 * (T)parameters.getLatticeU();
     initializeAtEquilibrium(lattice, everythingButTopLid, (T) 1., Array<T,3>((T)0.,(T)0.,(T)0.) );
     initializeAtEquilibrium(lattice, topLid, (T) 1., Array<T,3>(u,(T)0.,u) );
-    setBoundaryVelocity(lattice, topLid, Array<T,3>(u,0.,u) );
+    setBoundaryVelocity(lattice, topLid, Array<T,3>(u,(T)0.,u) );
 
     lattice.initialize();
 }
 
+/// Run the benchmark on a lattice of storage type T, and return the final velocity.
+template<typename T>
+std::auto_ptr<MultiTensorField3D<double,3> > runBenchmark (
+        MultiBlockLattice3D<T,DESCRIPTOR>& lattice,
+        IncomprFlowParam<double> const& parameters, plint numIter, std::string mode )
+{
+    OnLatticeBoundaryCondition3D<T,DESCRIPTOR>* boundaryCondition
+        = createLocalBoundaryCondition3D<T,DESCRIPTOR>();
+
+    cavitySetup(lattice, parameters, *boundaryCondition);
+    plint numCells = lattice.getBoundingBox().nCells();
+
+    // Run the benchmark once "to warm up the machine".
+    for (plint iT=0; iT<numIter; ++iT) {
+        lattice.collideAndStream();
+    }
+
+    // Run the benchmark for good.
+    global::timer("benchmark").restart();
+    for (plint iT=0; iT<numIter; ++iT) {
+        lattice.collideAndStream();
+    }
+    double time = global::timer("benchmark").stop();
+
+    pcout << "Storage \"" << mode << "\" (" << DESCRIPTOR<T>::q*sizeof(T)
+          << " bytes of populations per cell). After " << numIter << " iterations: "
+          << (double) (numCells*numIter) / time / 1.e6
+          << " Mega site updates per second." << std::endl;
+
+    delete boundaryCondition;
+    return copyConvert<T,double,3>(*computeVelocity(lattice));
+}
+
 int main(int argc, char* argv[]) {
 
     plbInit(&argc, &argv);
     //defaultMultiBlockPolicy3D().toggleBlockingCommunication(true);
 
     plint N;
+    std::string mode("double");
     try {
         global::argv(1).read(N);
     }
     catch(...)
     {
         pcout << "Wrong parameters. The syntax is " << std::endl;
-        pcout << argv[0] << " N" << std::endl;
+        pcout << argv[0] << " N [double|float|mixed]" << std::endl;
         pcout << "where N is the resolution. The benchmark cases published " << std::endl;
         pcout << "on the Palabos Wiki use N=100, N=400, N=1000, or N=4000." << std::endl;
         exit(1);
     }
+    if (global::argc()>2) {
+        global::argv(2).read(mode);
+    }
+    if (mode!="double" && mode!="float" && mode!="mixed") {
+        pcout << "Unknown storage \"" << mode << "\": use double, float, or mixed." << std::endl;
+        exit(1);
+    }
 
     pcout << "Starting benchmark with " << N+1 << "x" << N+1 << "x" << N+1 << " grid points "
           << "(approx. 2 minutes on modern processors)." << std::endl;
 
 
-    IncomprFlowParam<T> parameters(
-            (T) 1e-2,  // uMax
-            (T) 1.,    // Re
-            N,         // N
-            1.,        // lx
-            1.,        // ly
-            1.         // lz
+    IncomprFlowParam<double> parameters(
+            1e-2,  // uMax
+            1.,    // Re
+            N,     // N
+            1.,    // lx
+            1.,    // ly
+            1.     // lz
     );
-
-
-    MultiBlockLattice3D<T, DESCRIPTOR> lattice (
-            parameters.getNx(), parameters.getNy(), parameters.getNz(),
-            new BGKdynamics<T,DESCRIPTOR>(parameters.getOmega()) );
+    plint nx = parameters.getNx();
+    plint ny = parameters.getNy();
+    plint nz = parameters.getNz();
+    double omega = parameters.getOmega();
 
     plint numCores = global::mpi().getSize();
     pcout << "Number of MPI threads: " << numCores << std::endl;
     // Current cores run approximately at 5 Mega Sus.
-    T estimateSus= 5.e6*numCores;
+    double estimateSus= 5.e6*numCores;
     // The benchmark should run for approximately two minutes
     // (2*60 seconds).
-    T wishNumSeconds = 60.;
-    plint numCells = lattice.getBoundingBox().nCells();
+    double wishNumSeconds = 60.;
+    plint numCells = nx*ny*nz;
 
     // Run at least three iterations.
     plint numIter = std::max( (plint)3,
                               (plint)(estimateSus*wishNumSeconds/numCells+0.5));
 
-    OnLatticeBoundaryCondition3D<T,DESCRIPTOR>* boundaryCondition
-        = createLocalBoundaryCondition3D<T,DESCRIPTOR>();
-
-    cavitySetup(lattice, parameters, *boundaryCondition);
-
-    // Run the benchmark once "to warm up the machine".
-    for (plint iT=0; iT<numIter; ++iT) {
-        lattice.collideAndStream();
-    }
-
-    // Run the benchmark for good.
-    global::timer("benchmark").start();
     global::profiler().turnOn();
-    for (plint iT=0; iT<numIter; ++iT) {
-        lattice.collideAndStream();
+    std::auto_ptr<MultiTensorField3D<double,3> > velocity;
+    if (mode=="float") {
+        MultiBlockLattice3D<float, DESCRIPTOR> lattice (
+                nx, ny, nz, new BGKdynamics<float,DESCRIPTOR>((float)omega) );
+        velocity = runBenchmark(lattice, parameters, numIter, mode);
+    }
+    else if (mode=="mixed") {
+        MultiBlockLattice3D<float, DESCRIPTOR> lattice (
+                nx, ny, nz, new MixedPrecisionDynamics<float,double,DESCRIPTOR> (
+                                new BGKdynamics<double,DESCRIPTOR>(omega) ) );
+        velocity = runBenchmark(lattice, parameters, numIter, mode);
     }
 
-    pcout << "After " << numIter << " iterations: "
-          << (T) (numCells*numIter) /
-             global::timer("benchmark").getTime() / 1.e6
-          << " Mega site updates per second." << std::endl << std::endl;
+    MultiBlockLattice3D<double, DESCRIPTOR> lattice (
+            nx, ny, nz, new BGKdynamics<double,DESCRIPTOR>(omega) );
+    std::auto_ptr<MultiTensorField3D<double,3> > reference =
+        runBenchmark(lattice, parameters, numIter, "double");
 
-    global::profiler().writeReport();
+    if (velocity.get()) {
+        double errorSqr = computeAverage(*computeNormSqr(*subtract(*velocity, *reference)));
+        double referenceSqr = computeAverage(*computeNormSqr(*reference));
+        pcout << "Relative L2-deviation of the velocity with respect to double precision: "
+              << std::sqrt(errorSqr/referenceSqr) << std::endl;
+    }
+    pcout << std::endl;
 
-    delete boundaryCondition;
+    global::profiler().writeReport();
 }
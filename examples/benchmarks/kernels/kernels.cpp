@@ -0,0 +1,502 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+  * Kernel-level benchmark of the collide-and-stream loop. A fully periodic
+  * lattice is swept over the descriptors, dynamics, lattice sizes, numbers of
+  * blocks per process and cache-block sizes listed in the XML input file
+  * (see kernels.xml). For every configuration, the number of Mega lattice
+  * site updates per second (MLUPS) is measured, together with the minimal
+  * memory traffic per cell update (all populations read and written once)
+  * and the resulting memory bandwidth. The results are written in JSON
+  * format, to be compared across machines and releases.
+  *
+  * The number of MPI processes is the one of the current run: to sweep it,
+  * call the program repeatedly with different values of "mpirun -np", and
+  * provide a different output file name as second argument.
+**/
+
+#include "palabos2D.h"
+#include "palabos2D.hh"   // include full template code
+#include "palabos3D.h"
+#include "palabos3D.hh"   // include full template code
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <iostream>
+
+using namespace plb;
+using namespace std;
+
+typedef double T;
+
+struct KernelParameters {
+    std::vector<std::string> descriptors;
+    std::vector<std::string> dynamics;
+    std::vector<plint> sizes2D;
+    std::vector<plint> sizes3D;
+    std::vector<plint> blocksPerProcess;
+    std::vector<plint> cacheBlockSizes2D;
+    std::vector<plint> cacheBlockSizes3D;
+    T omega;
+    double minTime;
+    std::string outputFile;
+};
+
+struct KernelResult {
+    std::string descriptor;
+    std::string dynamics;
+    plint dimension;
+    plint size;
+    plint numCells;
+    plint numBlocks;
+    plint cacheBlockSize;
+    bool cacheBlocking;
+    plint numIter;
+    double time;
+    double bytesPerCell;
+    double mlups;
+};
+
+void readParameters(XMLreader const& document, KernelParameters& param)
+{
+    document["kernels"]["descriptors"].read(param.descriptors);
+    document["kernels"]["dynamics"].read(param.dynamics);
+    document["kernels"]["omega"].read(param.omega);
+    document["lattice"]["sizes2D"].read(param.sizes2D);
+    document["lattice"]["sizes3D"].read(param.sizes3D);
+    document["lattice"]["blocksPerProcess"].read(param.blocksPerProcess);
+    document["lattice"]["cacheBlockSizes2D"].read(param.cacheBlockSizes2D);
+    document["lattice"]["cacheBlockSizes3D"].read(param.cacheBlockSizes3D);
+    document["measurement"]["minTime"].read(param.minTime);
+    document["measurement"]["outputFile"].read(param.outputFile);
+}
+
+/// Some of the dynamics are only implemented for part of the descriptors:
+///   RegularizedBGKdynamics needs the specialized regularization templates,
+///   TRTdynamics is restricted to 3D, and CompleteTRTdynamics needs the complete
+///   (O(Ma^2)) equilibrium templates.
+template<template<typename U> class Descriptor>
+struct OptionalKernels {
+    static Dynamics<T,Descriptor>* regularized(T omega) { return 0; }
+    static Dynamics<T,Descriptor>* trt(T omega) { return 0; }
+    static Dynamics<T,Descriptor>* completeTrt(T omega) { return 0; }
+};
+
+template<>
+struct OptionalKernels<descriptors::D2Q9Descriptor> {
+    static Dynamics<T,descriptors::D2Q9Descriptor>* regularized(T omega) {
+        return new RegularizedBGKdynamics<T,descriptors::D2Q9Descriptor>(omega);
+    }
+    static Dynamics<T,descriptors::D2Q9Descriptor>* trt(T omega) { return 0; }
+    static Dynamics<T,descriptors::D2Q9Descriptor>* completeTrt(T omega) {
+        return new CompleteTRTdynamics<T,descriptors::D2Q9Descriptor>(omega);
+    }
+};
+
+template<>
+struct OptionalKernels<descriptors::D3Q15Descriptor> {
+    static Dynamics<T,descriptors::D3Q15Descriptor>* regularized(T omega) { return 0; }
+    static Dynamics<T,descriptors::D3Q15Descriptor>* trt(T omega) {
+        return new TRTdynamics<T,descriptors::D3Q15Descriptor>(omega);
+    }
+    static Dynamics<T,descriptors::D3Q15Descriptor>* completeTrt(T omega) { return 0; }
+};
+
+template<>
+struct OptionalKernels<descriptors::D3Q19Descriptor> {
+    static Dynamics<T,descriptors::D3Q19Descriptor>* regularized(T omega) {
+        return new RegularizedBGKdynamics<T,descriptors::D3Q19Descriptor>(omega);
+    }
+    static Dynamics<T,descriptors::D3Q19Descriptor>* trt(T omega) {
+        return new TRTdynamics<T,descriptors::D3Q19Descriptor>(omega);
+    }
+    static Dynamics<T,descriptors::D3Q19Descriptor>* completeTrt(T omega) { return 0; }
+};
+
+template<>
+struct OptionalKernels<descriptors::D3Q27Descriptor> {
+    static Dynamics<T,descriptors::D3Q27Descriptor>* regularized(T omega) {
+        return new RegularizedBGKdynamics<T,descriptors::D3Q27Descriptor>(omega);
+    }
+    static Dynamics<T,descriptors::D3Q27Descriptor>* trt(T omega) {
+        return new TRTdynamics<T,descriptors::D3Q27Descriptor>(omega);
+    }
+    static Dynamics<T,descriptors::D3Q27Descriptor>* completeTrt(T omega) {
+        return new CompleteTRTdynamics<T,descriptors::D3Q27Descriptor>(omega);
+    }
+};
+
+bool isKnownDynamics(std::string const& name) {
+    return name=="BGK" || name=="RegularizedBGK" || name=="TRT" || name=="CompleteTRT" ||
+           name=="MRT" || name=="Smagorinsky" || name=="Entropic";
+}
+
+/// Create the dynamics called "name", or return 0 if it is not available
+///   on the given descriptor. MRT is not handled here, because it requires
+///   its own descriptor.
+template<template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* createDynamics(std::string const& name, T omega)
+{
+    if (name=="BGK") {
+        return new BGKdynamics<T,Descriptor>(omega);
+    }
+    else if (name=="RegularizedBGK") {
+        return OptionalKernels<Descriptor>::regularized(omega);
+    }
+    else if (name=="TRT") {
+        return OptionalKernels<Descriptor>::trt(omega);
+    }
+    else if (name=="CompleteTRT") {
+        // TRT with adjustable second relaxation parameter, here set to
+        //   its default value.
+        return OptionalKernels<Descriptor>::completeTrt(omega);
+    }
+    else if (name=="Smagorinsky") {
+        return new SmagorinskyBGKdynamics<T,Descriptor>(omega, (T)0.14);
+    }
+    else if (name=="Entropic") {
+        return new EntropicDynamics<T,Descriptor>(omega);
+    }
+    return 0;
+}
+
+/// Distribute the blocks of a regular partition round-robin over the processes.
+ThreadAttribution* roundRobinAttribution(std::map<plint,Box3D> const& bulks)
+{
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it!=bulks.end(); ++it) {
+        attribution->addBlock(it->first, it->first % global::mpi().getSize());
+    }
+    return attribution;
+}
+
+ThreadAttribution* roundRobinAttribution(std::map<plint,Box2D> const& bulks)
+{
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    std::map<plint,Box2D>::const_iterator it = bulks.begin();
+    for (; it!=bulks.end(); ++it) {
+        attribution->addBlock(it->first, it->first % global::mpi().getSize());
+    }
+    return attribution;
+}
+
+/// Time the collide-and-stream loop on an initialized lattice. The number of
+///   iterations is chosen from a short warm-up run so that the measurement
+///   lasts at least minTime seconds; the timing of the main processor is
+///   the reference for all processes.
+template<class Lattice>
+void measure(Lattice& lattice, double minTime, plint& numIter, double& time)
+{
+    const plint numWarmup = 3;
+    global::timer("kernels").restart();
+    for (plint iT=0; iT<numWarmup; ++iT) {
+        lattice.collideAndStream();
+    }
+    time = global::timer("kernels").stop();
+    global::mpi().bCast(&time, 1);
+
+    numIter = std::max( numWarmup, (plint)(minTime/time*(double)numWarmup+0.5) );
+    global::mpi().bCast(&numIter, 1);
+
+    global::timer("kernels").restart();
+    for (plint iT=0; iT<numIter; ++iT) {
+        lattice.collideAndStream();
+    }
+    time = global::timer("kernels").stop();
+    global::mpi().bCast(&time, 1);
+}
+
+template<template<typename U> class Descriptor>
+void fillResult( KernelResult& result, std::string const& descriptorName,
+                 std::string const& dynamicsName, plint size, plint numCells,
+                 plint numBlocks, plint cacheBlockSize, bool cacheBlocking,
+                 plint numIter, double time )
+{
+    result.descriptor = descriptorName;
+    result.dynamics = dynamicsName;
+    result.dimension = Descriptor<T>::d;
+    result.size = size;
+    result.numCells = numCells;
+    result.numBlocks = numBlocks;
+    result.cacheBlockSize = cacheBlocking ? cacheBlockSize : 0;
+    result.cacheBlocking = cacheBlocking;
+    result.numIter = numIter;
+    result.time = time;
+    // Each update reads and writes all populations of the cell once.
+    result.bytesPerCell = (double)(2*Descriptor<T>::q*sizeof(T));
+    result.mlups = (double)numCells*(double)numIter / time / 1.e6;
+
+    pcout << setw(8) << descriptorName << setw(16) << dynamicsName
+          << " N=" << setw(5) << size << " blocks=" << setw(4) << numBlocks
+          << " cache=" << setw(4) << result.cacheBlockSize
+          << ": " << result.mlups << " MLUPS, "
+          << result.mlups*result.bytesPerCell*1.e-3 << " GB/s" << std::endl;
+}
+
+template<template<typename U> class Descriptor>
+void benchmark2D( std::string const& descriptorName, std::string const& dynamicsName,
+                  Dynamics<T,Descriptor>* dynamics, KernelParameters const& param,
+                  std::vector<KernelResult>& results )
+{
+    // The cache-block size is only used by the block-wise bulk loop.
+    bool cacheBlocking = Descriptor<T>::vicinity==1;
+    plint defaultCacheBlockSize = BlockLattice2D<T,Descriptor>::cachePolicy().getBlockSize();
+    for (pluint iSize=0; iSize<param.sizes2D.size(); ++iSize) {
+        plint N = param.sizes2D[iSize];
+        for (pluint iBlocks=0; iBlocks<param.blocksPerProcess.size(); ++iBlocks) {
+            SparseBlockStructure2D blockStructure( createRegularDistribution2D (
+                    N, N, param.blocksPerProcess[iBlocks]*global::mpi().getSize() ) );
+            plint numBlocks = blockStructure.getNumBlocks();
+            MultiBlockLattice2D<T,Descriptor> lattice (
+                    MultiBlockManagement2D( blockStructure,
+                                            roundRobinAttribution(blockStructure.getBulks()),
+                                            Descriptor<T>::vicinity ),
+                    defaultMultiBlockPolicy2D().getBlockCommunicator(),
+                    defaultMultiBlockPolicy2D().getCombinedStatistics(),
+                    defaultMultiBlockPolicy2D().getMultiCellAccess<T,Descriptor>(),
+                    dynamics->clone() );
+            lattice.periodicity().toggleAll(true);
+            initializeAtEquilibrium(lattice, lattice.getBoundingBox(), (T)1., Array<T,2>((T)0.02,(T)0.01));
+            lattice.initialize();
+
+            plint numCacheSizes = cacheBlocking ?
+                    std::max((plint)1, (plint)param.cacheBlockSizes2D.size()) : 1;
+            for (plint iCache=0; iCache<numCacheSizes; ++iCache) {
+                plint cacheBlockSize = param.cacheBlockSizes2D.empty() ?
+                                           defaultCacheBlockSize : param.cacheBlockSizes2D[iCache];
+                BlockLattice2D<T,Descriptor>::cachePolicy().setBlockSize(cacheBlockSize);
+                plint numIter;
+                double time;
+                measure(lattice, param.minTime, numIter, time);
+                results.push_back(KernelResult());
+                fillResult<Descriptor> (
+                        results.back(), descriptorName, dynamicsName, N, N*N,
+                        numBlocks, cacheBlockSize, cacheBlocking, numIter, time );
+            }
+        }
+    }
+    BlockLattice2D<T,Descriptor>::cachePolicy().setBlockSize(defaultCacheBlockSize);
+    delete dynamics;
+}
+
+template<template<typename U> class Descriptor>
+void benchmark3D( std::string const& descriptorName, std::string const& dynamicsName,
+                  Dynamics<T,Descriptor>* dynamics, KernelParameters const& param,
+                  std::vector<KernelResult>& results )
+{
+    // The cache-block size is only used by the block-wise bulk loop
+    //   (see BlockLattice3D::bulkCollideAndStream).
+    bool cacheBlocking = Descriptor<T>::q==19;
+    plint defaultCacheBlockSize = BlockLattice3D<T,Descriptor>::cachePolicy().getBlockSize();
+    for (pluint iSize=0; iSize<param.sizes3D.size(); ++iSize) {
+        plint N = param.sizes3D[iSize];
+        for (pluint iBlocks=0; iBlocks<param.blocksPerProcess.size(); ++iBlocks) {
+            SparseBlockStructure3D blockStructure( createRegularDistribution3D (
+                    N, N, N, param.blocksPerProcess[iBlocks]*global::mpi().getSize() ) );
+            plint numBlocks = blockStructure.getNumBlocks();
+            MultiBlockLattice3D<T,Descriptor> lattice (
+                    MultiBlockManagement3D( blockStructure,
+                                            roundRobinAttribution(blockStructure.getBulks()),
+                                            Descriptor<T>::vicinity ),
+                    defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                    defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                    defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>(),
+                    dynamics->clone() );
+            lattice.periodicity().toggleAll(true);
+            initializeAtEquilibrium(lattice, lattice.getBoundingBox(), (T)1.,
+                                    Array<T,3>((T)0.02,(T)0.01,(T)0.005));
+            lattice.initialize();
+
+            plint numCacheSizes = cacheBlocking ?
+                    std::max((plint)1, (plint)param.cacheBlockSizes3D.size()) : 1;
+            for (plint iCache=0; iCache<numCacheSizes; ++iCache) {
+                plint cacheBlockSize = param.cacheBlockSizes3D.empty() ?
+                                           defaultCacheBlockSize : param.cacheBlockSizes3D[iCache];
+                BlockLattice3D<T,Descriptor>::cachePolicy().setBlockSize(cacheBlockSize);
+                plint numIter;
+                double time;
+                measure(lattice, param.minTime, numIter, time);
+                results.push_back(KernelResult());
+                fillResult<Descriptor> (
+                        results.back(), descriptorName, dynamicsName, N, N*N*N,
+                        numBlocks, cacheBlockSize, cacheBlocking, numIter, time );
+            }
+        }
+    }
+    BlockLattice3D<T,Descriptor>::cachePolicy().setBlockSize(defaultCacheBlockSize);
+    delete dynamics;
+}
+
+template<template<typename U> class Descriptor>
+void benchmarkDescriptor2D( std::string const& descriptorName, KernelParameters const& param,
+                            std::vector<KernelResult>& results )
+{
+    for (pluint iDyn=0; iDyn<param.dynamics.size(); ++iDyn) {
+        std::string const& name = param.dynamics[iDyn];
+        if (name=="MRT") continue;
+        if (!isKnownDynamics(name)) {
+            pcout << "Unknown dynamics \"" << name << "\": skipped." << std::endl;
+            continue;
+        }
+        Dynamics<T,Descriptor>* dynamics = createDynamics<Descriptor>(name, param.omega);
+        if (dynamics) {
+            benchmark2D<Descriptor>(descriptorName, name, dynamics, param, results);
+        }
+        else {
+            pcout << name << " is not available on " << descriptorName << ": skipped." << std::endl;
+        }
+    }
+}
+
+template<template<typename U> class Descriptor>
+void benchmarkDescriptor3D( std::string const& descriptorName, KernelParameters const& param,
+                            std::vector<KernelResult>& results )
+{
+    for (pluint iDyn=0; iDyn<param.dynamics.size(); ++iDyn) {
+        std::string const& name = param.dynamics[iDyn];
+        if (name=="MRT") continue;
+        if (!isKnownDynamics(name)) {
+            pcout << "Unknown dynamics \"" << name << "\": skipped." << std::endl;
+            continue;
+        }
+        Dynamics<T,Descriptor>* dynamics = createDynamics<Descriptor>(name, param.omega);
+        if (dynamics) {
+            benchmark3D<Descriptor>(descriptorName, name, dynamics, param, results);
+        }
+        else {
+            pcout << name << " is not available on " << descriptorName << ": skipped." << std::endl;
+        }
+    }
+}
+
+void writeJson( std::string const& fName, KernelParameters const& param,
+                std::vector<KernelResult> const& results )
+{
+    std::ostringstream json;
+    json << std::setprecision(8);
+    json << "{\n"
+         << "  \"benchmark\": \"kernels\",\n"
+         << "  \"numProcesses\": " << global::mpi().getSize() << ",\n"
+         << "  \"sizeofT\": " << sizeof(T) << ",\n"
+         << "  \"omega\": " << param.omega << ",\n"
+         << "  \"minTime\": " << param.minTime << ",\n"
+         << "  \"results\": [\n";
+    for (pluint i=0; i<results.size(); ++i) {
+        KernelResult const& r = results[i];
+        json << "    { \"descriptor\": \"" << r.descriptor << "\""
+             << ", \"dynamics\": \"" << r.dynamics << "\""
+             << ", \"dimension\": " << r.dimension
+             << ", \"size\": " << r.size
+             << ", \"numCells\": " << r.numCells
+             << ", \"numBlocks\": " << r.numBlocks
+             << ", \"cacheBlocking\": " << (r.cacheBlocking ? "true" : "false")
+             << ", \"cacheBlockSize\": " << r.cacheBlockSize
+             << ", \"numIter\": " << r.numIter
+             << ", \"time\": " << r.time
+             << ", \"mlups\": " << r.mlups
+             << ", \"mlupsPerProcess\": " << r.mlups/(double)global::mpi().getSize()
+             << ", \"bytesPerCell\": " << r.bytesPerCell
+             << ", \"bandwidthGBs\": " << r.mlups*r.bytesPerCell*1.e-3
+             << " }" << (i+1<results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n"
+         << "}\n";
+
+    plb_ofstream ofile(fName.c_str());
+    ofile << json.str();
+}
+
+int main(int argc, char* argv[]) {
+
+    plbInit(&argc, &argv);
+
+    std::string paramXmlFileName;
+    try {
+        global::argv(1).read(paramXmlFileName);
+    }
+    catch (PlbIOException& exception) {
+        pcout << "Wrong parameters; the syntax is: " << std::endl;
+        pcout << (std::string)global::argv(0) << " kernels.xml [output.json]" << std::endl;
+        return -1;
+    }
+
+    KernelParameters param;
+    try {
+        XMLreader document(paramXmlFileName);
+        readParameters(document, param);
+    }
+    catch (PlbIOException& exception) {
+        pcout << "Error in input file " << paramXmlFileName
+              << ": " << exception.what() << std::endl;
+        return -1;
+    }
+    if (global::argc()>2) {
+        global::argv(2).read(param.outputFile);
+    }
+
+    pcout << "Number of MPI processes: " << global::mpi().getSize() << std::endl;
+
+    std::vector<KernelResult> results;
+    bool withMRT = std::find(param.dynamics.begin(), param.dynamics.end(), "MRT")
+                       != param.dynamics.end();
+    for (pluint iDesc=0; iDesc<param.descriptors.size(); ++iDesc) {
+        std::string const& name = param.descriptors[iDesc];
+        if (name=="D2Q9") {
+            benchmarkDescriptor2D<descriptors::D2Q9Descriptor>(name, param, results);
+            if (withMRT) {
+                benchmark2D<descriptors::MRTD2Q9Descriptor> (
+                        name, "MRT", new MRTdynamics<T,descriptors::MRTD2Q9Descriptor>(param.omega),
+                        param, results );
+            }
+        }
+        else if (name=="D3Q15") {
+            benchmarkDescriptor3D<descriptors::D3Q15Descriptor>(name, param, results);
+        }
+        else if (name=="D3Q19") {
+            benchmarkDescriptor3D<descriptors::D3Q19Descriptor>(name, param, results);
+            if (withMRT) {
+                benchmark3D<descriptors::MRTD3Q19Descriptor> (
+                        name, "MRT", new MRTdynamics<T,descriptors::MRTD3Q19Descriptor>(param.omega),
+                        param, results );
+            }
+        }
+        else if (name=="D3Q27") {
+            benchmarkDescriptor3D<descriptors::D3Q27Descriptor>(name, param, results);
+        }
+        else {
+            pcout << "Unknown descriptor \"" << name << "\": skipped." << std::endl;
+        }
+        if (withMRT && (name=="D3Q15" || name=="D3Q27")) {
+            pcout << "MRT is not available on " << name << ": skipped." << std::endl;
+        }
+    }
+
+    writeJson(param.outputFile, param, results);
+    pcout << "Results written to " << param.outputFile << std::endl;
+}
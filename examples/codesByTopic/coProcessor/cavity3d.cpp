@@ -205,12 +205,21 @@ int main(int argc, char* argv[]) {
     // Here the co-processor is informed about the domains for which it will need to do computations.
     bool printInfo=true;
     initiateCoProcessors(lattice, BGKdynamics<T,DESCRIPTOR>(parameters.getOmega()).getId(), printInfo);
+    // The full data is transferred to the co-processors once; afterwards, only the
+    // envelopes are exchanged at each iteration.
+    transferToCoProcessors(lattice);
 
     T previousIterationTime = T();
     // Loop over main time iteration.
     for (plint iT=0; iT<parameters.nStep(maxT); ++iT) {
         global::timer("mainLoop").restart();
 
+        // The CPU copy of the co-processor blocks is only up to date in the envelopes.
+        // Get the full data back before producing output.
+        if (iT%parameters.nStep(imSave)==0 || (iT%parameters.nStep(vtkSave)==0 && iT>0)) {
+            transferFromCoProcessors(lattice);
+        }
+
         if (iT%parameters.nStep(imSave)==0) {
             pcout << "Writing Gif ..." << endl;
             writeGifs(lattice, parameters, iT);
@@ -227,24 +236,22 @@ int main(int argc, char* argv[]) {
         }
 
         // @Tomasz: STEP 3
-        // For now, all the data assigned to co-processors is transferred from CPU memory
-        // to co-processor memory before the collision-streaming step, and back to CPU
-        // memory after the collision-streaming step. This is not efficient at all: we
-        // will replace this by communicating outer boundary layers only. It is however
-        // simpler for now, for our first proof of concept.
+        // Only the outer boundary layers of the co-processor blocks are communicated:
+        // the outer layers of the bulk are copied back to CPU memory after the
+        // collision-streaming step, the envelopes of the CPU blocks are synchronized,
+        // and the envelopes are finally sent to the co-processors.
 
         // Execute a time iteration.
-        transferToCoProcessors(lattice);
         lattice.collideAndStream();
-        transferFromCoProcessors(lattice);
-        // After transferring back from co-processor to CPU memory, data in the envelopes
-        // of the CPU blocks must be synchronized.
+        transferEnvelopesFromCoProcessors(lattice);
         lattice.duplicateOverlaps(modif::staticVariables);
+        transferEnvelopesToCoProcessors(lattice);
 
 
         // Access averages from internal statistics ( their value is defined
         //   only after the call to lattice.collideAndStream() )
         if (iT%parameters.nStep(logT)==0) {
+            transferFromCoProcessors(lattice);
             pcout << "; av energy="
                   << setprecision(10) << computeAverageEnergy<T>(lattice)
                   << "; av rho="
@@ -31,19 +31,33 @@ namespace plb{
                  IncomprFlowParam<T> const &param_,
                  T const xFactor_ = 0, T const tFactor_ = 0, 
                  T const velFactor_ = 0, T const rhoFactor_ = 0);
+    ~ProbeManager();
 
     void writeHeaders();
 
     void writeVelocityProbes(MultiBlockLattice3D<T,Descriptor> &lattice, plint const iT);
     void writeDensityProbes(MultiBlockLattice3D<T,Descriptor> &lattice, plint const iT);
+
+    // probe locations are resolved on first use, and again whenever
+    // the lattice gets new atomic blocks (e.g. through adaptSparsity)
+    void resetProbes();
   private:
     std::string velFname,rhoFname;
     ArrayVector velProbesOrig, rhoProbesOrig;
     ArrayVector velProbesLB, rhoProbesLB;
     IncomprFlowParam<T> parameters;
 
+    LatticeProbeSet3D<T,Descriptor> *velProbeSet, *rhoProbeSet;
+    // id and generation of the lattice the probe sets were resolved on
+    id_t probedLatticeId, probedGeneration;
+
+    void updateProbeSets(MultiBlockLattice3D<T,Descriptor> const &lattice);
     void writeProbeCoords(plb_ofstream &s, ArrayVector &probes);
 
+    // probe sets are owned, so copying is not allowed
+    ProbeManager(ProbeManager const &rhs);
+    ProbeManager& operator=(ProbeManager const &rhs);
+
     T xFactor, tFactor, velFactor, rhoFactor;
 
     static plint const linewidth = 14;
@@ -15,6 +15,7 @@ namespace plb{
       velProbesLB(velocityProbeLocations_),
       rhoProbesLB(densityProbeLocations_),
       parameters(param_),
+      velProbeSet(0), rhoProbeSet(0), probedLatticeId(0), probedGeneration(0),
       xFactor(xFactor_), tFactor(tFactor_),
       velFactor(velFactor_), rhoFactor(rhoFactor_)
   {
@@ -36,6 +37,33 @@ namespace plb{
     }
   }
   
+  template<typename T, template<typename U> class Descriptor>
+  ProbeManager<T,Descriptor>::~ProbeManager()
+  {
+    resetProbes();
+  }
+
+  template<typename T, template<typename U> class Descriptor>
+  void ProbeManager<T,Descriptor>::resetProbes()
+  {
+    delete velProbeSet; velProbeSet = 0;
+    delete rhoProbeSet; rhoProbeSet = 0;
+  }
+
+  template<typename T, template<typename U> class Descriptor>
+  void ProbeManager<T,Descriptor>::updateProbeSets(MultiBlockLattice3D<T,Descriptor> const &lattice)
+  {
+    if(velProbeSet && probedLatticeId == lattice.getId()
+       && probedGeneration == lattice.getGeneration()) return;
+    resetProbes();
+    // probe locations are rounded to the nearest node already, so
+    // no interpolation is needed
+    velProbeSet = new LatticeProbeSet3D<T,Descriptor>(lattice,velProbesLB,false);
+    rhoProbeSet = new LatticeProbeSet3D<T,Descriptor>(lattice,rhoProbesLB,false);
+    probedLatticeId = lattice.getId();
+    probedGeneration = lattice.getGeneration();
+  }
+
   template<typename T, template<typename U> class Descriptor>
   void ProbeManager<T,Descriptor>::writeHeaders() 
   {
@@ -54,9 +82,8 @@ namespace plb{
   template<typename T, template<typename U> class Descriptor>
   void ProbeManager<T,Descriptor>::writeVelocityProbes(MultiBlockLattice3D<T,Descriptor> &lattice, plint const iT)
   {
-    VelocitySingleProbe3D<T,Descriptor> p(velProbesLB);
-    applyProcessingFunctional(p,lattice.getBoundingBox(),lattice);
-    ArrayVector v = p.getVelocities();
+    updateProbeSets(lattice);
+    ArrayVector v = velProbeSet->computeVelocities(lattice);
 
     plb_ofstream s(velFname.c_str(),std::fstream::out | std::fstream::app);
     
@@ -75,9 +102,8 @@ namespace plb{
   template<typename T, template<typename U> class Descriptor>
   void ProbeManager<T,Descriptor>::writeDensityProbes(MultiBlockLattice3D<T,Descriptor> &lattice, plint const iT)
   {
-    DensitySingleProbe3D<T,Descriptor> probe(rhoProbesLB);
-    applyProcessingFunctional(probe,lattice.getBoundingBox(),lattice);
-    ScalarVector p = probe.getDensities();
+    updateProbeSets(lattice);
+    ScalarVector p = rhoProbeSet->computeDensities(lattice);
 
     plb_ofstream s(rhoFname.c_str(),std::fstream::out | std::fstream::app);
     
@@ -35,6 +35,7 @@ namespace plb {
 
 template class NTensorField2NumPy3D<PRECOMP_T>;
 template class NumPy2NTensorField3D<PRECOMP_T>;
+template class NTensorFieldView3D<PRECOMP_T>;
 
 }  // namespace plb
 
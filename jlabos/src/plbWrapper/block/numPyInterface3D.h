@@ -39,6 +39,7 @@ class NTensorField2NumPy3D {
 public:
     NTensorField2NumPy3D(MultiNTensorField3D<T>& field_);
     NTensorField2NumPy3D(MultiNTensorField3D<T>& field_, Box3D const& domain_);
+    /// Gather the domain into the array; it is filled on the main processor only.
     void execute(T* array, int size);
     int getSize() const;
 private:
@@ -58,6 +59,45 @@ private:
     Box3D domain;
 };
 
+/// Raw address and byte size of a memory area, handed over to the Java
+///   wrapper as a direct ByteBuffer (no copy).
+struct RawBlockBuffer3D {
+    RawBlockBuffer3D() : data(0), size(0) { }
+    RawBlockBuffer3D(void* data_, plint size_) : data(data_), size(size_) { }
+    void* data;
+    plint size;
+};
+
+/// Zero-copy, strided view on the local atomic blocks of a multi n-tensor field.
+/** The buffers point straight into the memory of the atomic blocks, envelope
+ *  included, and remain valid as long as the multi-block is neither destroyed
+ *  nor reallocated. Strides are expressed in bytes, in the order (x,y,z,ndim).
+ *  Only the blocks stored on the current MPI process are visible.
+ */
+template<typename T>
+class NTensorFieldView3D {
+public:
+    NTensorFieldView3D(MultiNTensorField3D<T>& field_);
+    /// Number of atomic blocks stored on the current process.
+    int getNumBlocks() const;
+    /// Extent of the buffer (bulk plus envelope), in absolute coordinates.
+    Box3D getDomain(int iBlock) const;
+    /// Part of the buffer owned by this block, in absolute coordinates.
+    Box3D getBulk(int iBlock) const;
+    int getNx(int iBlock) const;
+    int getNy(int iBlock) const;
+    int getNz(int iBlock) const;
+    int getNdim() const;
+    plint getStride(int iBlock, int direction) const;
+    T* getData(int iBlock);
+    RawBlockBuffer3D getBuffer(int iBlock);
+private:
+    NTensorField3D<T>& getBlock(int iBlock);
+    NTensorField3D<T> const& getBlock(int iBlock) const;
+private:
+    MultiNTensorField3D<T>& field;
+};
+
 }  // namespace plb
 
 #endif  // NUMPY_INTERFACE_3D_H
@@ -25,13 +25,17 @@
 /** \file
  * Interface to NumPy -- generic code.
  */
-#ifndef NUMPY_INTERFACE_3D_HH
-#define NUMPY_INTERFACE_3D_HH
+#ifndef BLOCK_NUMPY_INTERFACE_3D_HH
+#define BLOCK_NUMPY_INTERFACE_3D_HH
 
 #include "plbWrapper/block/numPyInterface3D.h"
 #include "core/serializer.h"
 #include "parallelism/mpiManager.h"
 #include "io/parallelIO.h"
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <vector>
 
 namespace plb {
 
@@ -51,11 +55,71 @@ NTensorField2NumPy3D<T>::NTensorField2NumPy3D(MultiNTensorField3D<T>& field_, Bo
 
 template<typename T>
 void NTensorField2NumPy3D<T>::execute(T* array, int size) {
-    serializerToSink (
-            field.getBlockSerializer(domain, IndexOrdering::forward),
-            new WriteToSerialArray<T>(array, (pluint)size)
-    );
-    global::mpi().bCast(array, size);
+    PLB_PRECONDITION( size == getSize() );
+    // Every process packs the cells it owns straight from the atomic blocks,
+    //   without going through the serializer, and the packages are gathered
+    //   on the main processor, which copies them into the array. The blocks
+    //   are visited in the same order everywhere, so that the main processor
+    //   can locate the cells of each package without further information.
+    plint ndim = field.getNdim();
+    plint nY = domain.getNy();
+    plint nZ = domain.getNz();
+    MultiBlockManagement3D const& management = field.getMultiBlockManagement();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
+    std::vector<int> counts(global::mpi().getSize(), 0);
+    std::vector<T> package;
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        plint blockId = it->first;
+        Box3D inters;
+        if (!intersect(management.getUniqueBulk(blockId), domain, inters)) continue;
+        counts[attribution.getMpiProcess(blockId)] += (int)(inters.nCells()*ndim);
+        if (!attribution.isLocal(blockId)) continue;
+        NTensorField3D<T> const& component = field.getComponent(blockId);
+        Dot3D location = component.getLocation();
+        plint rowSize = inters.getNz()*ndim;
+        for (plint iX=inters.x0; iX<=inters.x1; ++iX) {
+            for (plint iY=inters.y0; iY<=inters.y1; ++iY) {
+                T const* row = component.get(iX-location.x, iY-location.y, inters.z0-location.z);
+                package.insert(package.end(), row, row+rowSize);
+            }
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    std::vector<T> received;
+    if (global::mpi().isMainProcessor()) {
+        received.resize(std::accumulate(counts.begin(), counts.end(), (plint)0));
+    }
+    global::mpi().gatherV( package.empty() ? 0 : &package[0],
+                           received.empty() ? 0 : &received[0],
+                           &counts[0], global::mpi().bossId() );
+#else
+    std::vector<T>& received = package;
+#endif
+    if (!global::mpi().isMainProcessor()) {
+        return;
+    }
+    // Start of the package of each process in the received data.
+    std::vector<plint> offsets(counts.size(), 0);
+    for (pluint iProc=1; iProc<counts.size(); ++iProc) {
+        offsets[iProc] = offsets[iProc-1] + counts[iProc-1];
+    }
+    std::fill(array, array+size, T());
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        plint blockId = it->first;
+        Box3D inters;
+        if (!intersect(management.getUniqueBulk(blockId), domain, inters)) continue;
+        plint& offset = offsets[attribution.getMpiProcess(blockId)];
+        plint rowSize = inters.getNz()*ndim;
+        for (plint iX=inters.x0; iX<=inters.x1; ++iX) {
+            for (plint iY=inters.y0; iY<=inters.y1; ++iY) {
+                plint pos = ndim * ( (inters.z0-domain.z0) + nZ *
+                                     ( (iY-domain.y0) + nY*(iX-domain.x0) ) );
+                std::copy(received.begin()+offset, received.begin()+offset+rowSize, array+pos);
+                offset += rowSize;
+            }
+        }
+    }
 }
 
 template<typename T>
@@ -91,6 +155,91 @@ int NumPy2NTensorField3D<T>::getSize() const {
     return (int) (domain.nCells() * field.getNdim());
 }
 
+
+/* *************** Class NTensorFieldView3D ************************************ */
+
+template<typename T>
+NTensorFieldView3D<T>::NTensorFieldView3D(MultiNTensorField3D<T>& field_)
+    : field(field_)
+{ }
+
+template<typename T>
+int NTensorFieldView3D<T>::getNumBlocks() const {
+    return (int) field.getMultiBlockManagement().getLocalInfo().getBlocks().size();
+}
+
+template<typename T>
+Box3D NTensorFieldView3D<T>::getDomain(int iBlock) const {
+    NTensorField3D<T> const& block = getBlock(iBlock);
+    return block.getBoundingBox().shift (
+            block.getLocation().x, block.getLocation().y, block.getLocation().z );
+}
+
+template<typename T>
+Box3D NTensorFieldView3D<T>::getBulk(int iBlock) const {
+    PLB_PRECONDITION( iBlock>=0 && iBlock<getNumBlocks() );
+    MultiBlockManagement3D const& management = field.getMultiBlockManagement();
+    return management.getBulk(management.getLocalInfo().getBlocks()[iBlock]);
+}
+
+template<typename T>
+int NTensorFieldView3D<T>::getNx(int iBlock) const {
+    return (int) getBlock(iBlock).getNx();
+}
+
+template<typename T>
+int NTensorFieldView3D<T>::getNy(int iBlock) const {
+    return (int) getBlock(iBlock).getNy();
+}
+
+template<typename T>
+int NTensorFieldView3D<T>::getNz(int iBlock) const {
+    return (int) getBlock(iBlock).getNz();
+}
+
+template<typename T>
+int NTensorFieldView3D<T>::getNdim() const {
+    return (int) field.getNdim();
+}
+
+template<typename T>
+plint NTensorFieldView3D<T>::getStride(int iBlock, int direction) const {
+    PLB_PRECONDITION( direction>=0 && direction<4 );
+    NTensorField3D<T> const& block = getBlock(iBlock);
+    plint stride = (plint)sizeof(T);
+    switch(direction) {
+        case 0: stride *= block.getNy()*block.getNz()*block.getNdim(); break;
+        case 1: stride *= block.getNz()*block.getNdim(); break;
+        case 2: stride *= block.getNdim(); break;
+    }
+    return stride;
+}
+
+template<typename T>
+T* NTensorFieldView3D<T>::getData(int iBlock) {
+    return getBlock(iBlock).get(0,0,0);
+}
+
+template<typename T>
+RawBlockBuffer3D NTensorFieldView3D<T>::getBuffer(int iBlock) {
+    NTensorField3D<T>& block = getBlock(iBlock);
+    return RawBlockBuffer3D (
+            (void*) block.get(0,0,0),
+            block.getNx()*block.getNy()*block.getNz()*block.getNdim()*(plint)sizeof(T) );
+}
+
+template<typename T>
+NTensorField3D<T>& NTensorFieldView3D<T>::getBlock(int iBlock) {
+    PLB_PRECONDITION( iBlock>=0 && iBlock<getNumBlocks() );
+    return field.getComponent(field.getMultiBlockManagement().getLocalInfo().getBlocks()[iBlock]);
+}
+
+template<typename T>
+NTensorField3D<T> const& NTensorFieldView3D<T>::getBlock(int iBlock) const {
+    PLB_PRECONDITION( iBlock>=0 && iBlock<getNumBlocks() );
+    return field.getComponent(field.getMultiBlockManagement().getLocalInfo().getBlocks()[iBlock]);
+}
+
 }  // namespace plb
 
-#endif  // NUMPY_INTERFACE_3D_HH
+#endif  // BLOCK_NUMPY_INTERFACE_3D_HH
@@ -39,6 +39,7 @@ namespace plb {
 
 template class Lattice2NumPy3D<FLOAT_T, descriptors::DESCRIPTOR_3D>;
 template class NumPy2Lattice3D<FLOAT_T, descriptors::DESCRIPTOR_3D>;
+template class LatticeView3D<FLOAT_T, descriptors::DESCRIPTOR_3D>;
 
 }  // namespace plb
 
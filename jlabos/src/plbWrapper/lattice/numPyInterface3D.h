@@ -29,6 +29,7 @@
 #define NUMPY_INTERFACE_3D_H
 
 #include "multiBlock/multiBlockLattice3D.h"
+#include "plbWrapper/block/numPyInterface3D.h"
 
 // http://blog.dhananjaynene.com/2009/03/constructor-method-overloading-in-python/
 
@@ -39,6 +40,7 @@ class Lattice2NumPy3D {
 public:
     Lattice2NumPy3D(MultiBlockLattice3D<T,Descriptor>& lattice_);
     Lattice2NumPy3D(MultiBlockLattice3D<T,Descriptor>& lattice_, Box3D const& domain_);
+    /// Gather the domain into the array; it is filled on the main processor only.
     void execute(T* array, int size);
     int getSize() const;
 private:
@@ -58,6 +60,37 @@ private:
     Box3D domain;
 };
 
+/// Zero-copy, strided view on the populations of the local atomic blocks.
+/** The buffers point straight into the cells of the atomic blocks, envelope
+ *  included, and remain valid as long as the multi-block lattice is neither
+ *  destroyed nor reallocated. Strides are expressed in bytes, in the order
+ *  (x,y,z,iPop); consecutive cells are sizeof(Cell) bytes apart, so the
+ *  x, y and z strides are generally not multiples of the population stride.
+ */
+template<typename T, template<typename U> class Descriptor>
+class LatticeView3D {
+public:
+    LatticeView3D(MultiBlockLattice3D<T,Descriptor>& lattice_);
+    /// Number of atomic blocks stored on the current process.
+    int getNumBlocks() const;
+    /// Extent of the buffer (bulk plus envelope), in absolute coordinates.
+    Box3D getDomain(int iBlock) const;
+    /// Part of the buffer owned by this block, in absolute coordinates.
+    Box3D getBulk(int iBlock) const;
+    int getNx(int iBlock) const;
+    int getNy(int iBlock) const;
+    int getNz(int iBlock) const;
+    int getQ() const;
+    plint getStride(int iBlock, int direction) const;
+    T* getData(int iBlock);
+    RawBlockBuffer3D getBuffer(int iBlock);
+private:
+    BlockLattice3D<T,Descriptor>& getBlock(int iBlock);
+    BlockLattice3D<T,Descriptor> const& getBlock(int iBlock) const;
+private:
+    MultiBlockLattice3D<T,Descriptor>& lattice;
+};
+
 }  // namespace plb
 
 #endif  // NUMPY_INTERFACE_3D_H
@@ -32,6 +32,10 @@
 #include "core/serializer.h"
 #include "parallelism/mpiManager.h"
 #include "io/parallelIO.h"
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <vector>
 
 namespace plb {
 
@@ -51,11 +55,74 @@ Lattice2NumPy3D<T,Descriptor>::Lattice2NumPy3D(MultiBlockLattice3D<T,Descriptor>
 
 template<typename T, template<typename U> class Descriptor>
 void Lattice2NumPy3D<T,Descriptor>::execute(T* array, int size) {
-    serializerToSink (
-            lattice.getBlockSerializer(domain, IndexOrdering::forward),
-            new WriteToSerialArray<T>(array, (plint)size)
-    );
-    global::mpi().bCast(array, size);
+    PLB_PRECONDITION( size == getSize() );
+    // Every process packs the cells it owns straight from the atomic blocks,
+    //   and the packages are gathered on the main processor, which copies
+    //   them into the array. The blocks are visited in the same order
+    //   everywhere, so that the main processor can locate the cells of each
+    //   package without further information.
+    plint cellSize = lattice.sizeOfCell()/(plint)sizeof(T);
+    plint nY = domain.getNy();
+    plint nZ = domain.getNz();
+    MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
+    std::vector<int> counts(global::mpi().getSize(), 0);
+    std::vector<T> package;
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        plint blockId = it->first;
+        Box3D inters;
+        if (!intersect(management.getUniqueBulk(blockId), domain, inters)) continue;
+        counts[attribution.getMpiProcess(blockId)] += (int)(inters.nCells()*cellSize);
+        if (!attribution.isLocal(blockId)) continue;
+        BlockLattice3D<T,Descriptor> const& component = lattice.getComponent(blockId);
+        Dot3D location = component.getLocation();
+        plint pos = (plint)package.size();
+        package.resize(package.size() + inters.nCells()*cellSize);
+        for (plint iX=inters.x0; iX<=inters.x1; ++iX) {
+            for (plint iY=inters.y0; iY<=inters.y1; ++iY) {
+                for (plint iZ=inters.z0; iZ<=inters.z1; ++iZ, pos+=cellSize) {
+                    component.get(iX-location.x, iY-location.y, iZ-location.z)
+                             .serialize((char*)(&package[pos]));
+                }
+            }
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    std::vector<T> received;
+    if (global::mpi().isMainProcessor()) {
+        received.resize(std::accumulate(counts.begin(), counts.end(), (plint)0));
+    }
+    global::mpi().gatherV( package.empty() ? 0 : &package[0],
+                           received.empty() ? 0 : &received[0],
+                           &counts[0], global::mpi().bossId() );
+#else
+    std::vector<T>& received = package;
+#endif
+    if (!global::mpi().isMainProcessor()) {
+        return;
+    }
+    // Start of the package of each process in the received data.
+    std::vector<plint> offsets(counts.size(), 0);
+    for (pluint iProc=1; iProc<counts.size(); ++iProc) {
+        offsets[iProc] = offsets[iProc-1] + counts[iProc-1];
+    }
+    std::fill(array, array+size, T());
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        plint blockId = it->first;
+        Box3D inters;
+        if (!intersect(management.getUniqueBulk(blockId), domain, inters)) continue;
+        plint& offset = offsets[attribution.getMpiProcess(blockId)];
+        plint rowSize = inters.getNz()*cellSize;
+        for (plint iX=inters.x0; iX<=inters.x1; ++iX) {
+            for (plint iY=inters.y0; iY<=inters.y1; ++iY) {
+                plint pos = cellSize * ( (inters.z0-domain.z0) + nZ *
+                                         ( (iY-domain.y0) + nY*(iX-domain.x0) ) );
+                std::copy(received.begin()+offset, received.begin()+offset+rowSize, array+pos);
+                offset += rowSize;
+            }
+        }
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -91,6 +158,91 @@ int NumPy2Lattice3D<T,Descriptor>::getSize() const {
     return (int) (domain.nCells());
 }
 
+
+/* *************** Class LatticeView3D ************************************ */
+
+template<typename T, template<typename U> class Descriptor>
+LatticeView3D<T,Descriptor>::LatticeView3D(MultiBlockLattice3D<T,Descriptor>& lattice_)
+    : lattice(lattice_)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+int LatticeView3D<T,Descriptor>::getNumBlocks() const {
+    return (int) lattice.getMultiBlockManagement().getLocalInfo().getBlocks().size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+Box3D LatticeView3D<T,Descriptor>::getDomain(int iBlock) const {
+    BlockLattice3D<T,Descriptor> const& block = getBlock(iBlock);
+    return block.getBoundingBox().shift (
+            block.getLocation().x, block.getLocation().y, block.getLocation().z );
+}
+
+template<typename T, template<typename U> class Descriptor>
+Box3D LatticeView3D<T,Descriptor>::getBulk(int iBlock) const {
+    PLB_PRECONDITION( iBlock>=0 && iBlock<getNumBlocks() );
+    MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+    return management.getBulk(management.getLocalInfo().getBlocks()[iBlock]);
+}
+
+template<typename T, template<typename U> class Descriptor>
+int LatticeView3D<T,Descriptor>::getNx(int iBlock) const {
+    return (int) getBlock(iBlock).getNx();
+}
+
+template<typename T, template<typename U> class Descriptor>
+int LatticeView3D<T,Descriptor>::getNy(int iBlock) const {
+    return (int) getBlock(iBlock).getNy();
+}
+
+template<typename T, template<typename U> class Descriptor>
+int LatticeView3D<T,Descriptor>::getNz(int iBlock) const {
+    return (int) getBlock(iBlock).getNz();
+}
+
+template<typename T, template<typename U> class Descriptor>
+int LatticeView3D<T,Descriptor>::getQ() const {
+    return (int) Descriptor<T>::q;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint LatticeView3D<T,Descriptor>::getStride(int iBlock, int direction) const {
+    PLB_PRECONDITION( direction>=0 && direction<4 );
+    BlockLattice3D<T,Descriptor> const& block = getBlock(iBlock);
+    plint stride = (plint)sizeof(Cell<T,Descriptor>);
+    switch(direction) {
+        case 0: stride *= block.getNy()*block.getNz(); break;
+        case 1: stride *= block.getNz(); break;
+        case 3: stride = (plint)sizeof(T); break;
+    }
+    return stride;
+}
+
+template<typename T, template<typename U> class Descriptor>
+T* LatticeView3D<T,Descriptor>::getData(int iBlock) {
+    return &getBlock(iBlock).get(0,0,0)[0];
+}
+
+template<typename T, template<typename U> class Descriptor>
+RawBlockBuffer3D LatticeView3D<T,Descriptor>::getBuffer(int iBlock) {
+    BlockLattice3D<T,Descriptor>& block = getBlock(iBlock);
+    return RawBlockBuffer3D (
+            (void*) &block.get(0,0,0)[0],
+            block.getNx()*block.getNy()*block.getNz()*(plint)sizeof(Cell<T,Descriptor>) );
+}
+
+template<typename T, template<typename U> class Descriptor>
+BlockLattice3D<T,Descriptor>& LatticeView3D<T,Descriptor>::getBlock(int iBlock) {
+    PLB_PRECONDITION( iBlock>=0 && iBlock<getNumBlocks() );
+    return lattice.getComponent(lattice.getMultiBlockManagement().getLocalInfo().getBlocks()[iBlock]);
+}
+
+template<typename T, template<typename U> class Descriptor>
+BlockLattice3D<T,Descriptor> const& LatticeView3D<T,Descriptor>::getBlock(int iBlock) const {
+    PLB_PRECONDITION( iBlock>=0 && iBlock<getNumBlocks() );
+    return lattice.getComponent(lattice.getMultiBlockManagement().getLocalInfo().getBlocks()[iBlock]);
+}
+
 }  // namespace plb
 
 #endif  // NUMPY_INTERFACE_3D_HH
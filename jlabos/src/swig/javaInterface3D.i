@@ -12,6 +12,18 @@ namespace plb {
 %}
 
 
+/* Hand the raw memory of atomic blocks over to Java as a direct ByteBuffer
+ * (no copy), in native byte order. */
+%typemap(jni)     plb::RawBlockBuffer3D "jobject"
+%typemap(jtype)   plb::RawBlockBuffer3D "java.nio.ByteBuffer"
+%typemap(jstype)  plb::RawBlockBuffer3D "java.nio.ByteBuffer"
+%typemap(javaout) plb::RawBlockBuffer3D {
+    return $jnicall.order(java.nio.ByteOrder.nativeOrder());
+}
+%typemap(out)     plb::RawBlockBuffer3D {
+    $result = JCALL2(NewDirectByteBuffer, jenv, $1.data, (jlong)$1.size);
+}
+
 namespace plb {
 %include "arrays_java.i";
 %apply double[] {double *};
@@ -33,8 +45,27 @@ public:
     int getSize() const;
 };
 
+struct RawBlockBuffer3D;
+
+template<typename T, class Descriptor>
+class LatticeView3D {
+public:
+    LatticeView3D(MultiBlockLattice3D<T,Descriptor>& lattice_);
+    int getNumBlocks() const;
+    Box3D getDomain(int iBlock) const;
+    Box3D getBulk(int iBlock) const;
+    int getNx(int iBlock) const;
+    int getNy(int iBlock) const;
+    int getNz(int iBlock) const;
+    int getQ() const;
+    plint getStride(int iBlock, int direction) const;
+    RawBlockBuffer3D getBuffer(int iBlock);
+};
+
 }  // namespace plb
 
 %template(FLOAT_T_DESCRIPTOR_3D_LatticeSerializer) plb::Lattice2NumPy3D<FLOAT_T, plb::descriptors::DESCRIPTOR_3D>;
 
 %template(FLOAT_T_DESCRIPTOR_3D_LatticeUnSerializer) plb::NumPy2Lattice3D<FLOAT_T, plb::descriptors::DESCRIPTOR_3D>;
+
+%template(FLOAT_T_DESCRIPTOR_3D_LatticeView3D) plb::LatticeView3D<FLOAT_T, plb::descriptors::DESCRIPTOR_3D>;
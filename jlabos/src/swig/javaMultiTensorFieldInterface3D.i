@@ -10,6 +10,18 @@ namespace plb {
 %}
 
 
+/* Hand the raw memory of atomic blocks over to Java as a direct ByteBuffer
+ * (no copy), in native byte order. */
+%typemap(jni)     plb::RawBlockBuffer3D "jobject"
+%typemap(jtype)   plb::RawBlockBuffer3D "java.nio.ByteBuffer"
+%typemap(jstype)  plb::RawBlockBuffer3D "java.nio.ByteBuffer"
+%typemap(javaout) plb::RawBlockBuffer3D {
+    return $jnicall.order(java.nio.ByteOrder.nativeOrder());
+}
+%typemap(out)     plb::RawBlockBuffer3D {
+    $result = JCALL2(NewDirectByteBuffer, jenv, $1.data, (jlong)$1.size);
+}
+
 namespace plb {
 
 template<typename T> class MultiNTensorField3D;
@@ -24,8 +36,26 @@ public:
     void execute(T* array, int size);
     int getSize() const;
 };
-    
+
+struct RawBlockBuffer3D;
+
+template<typename T>
+class NTensorFieldView3D {
+public:
+    NTensorFieldView3D(MultiNTensorField3D<T>& field_);
+    int getNumBlocks() const;
+    Box3D getDomain(int iBlock) const;
+    Box3D getBulk(int iBlock) const;
+    int getNx(int iBlock) const;
+    int getNy(int iBlock) const;
+    int getNz(int iBlock) const;
+    int getNdim() const;
+    plint getStride(int iBlock, int direction) const;
+    RawBlockBuffer3D getBuffer(int iBlock);
+};
+
 
 }  // namespace plb
 
 %template(PRECOMP_T_NTensorFieldSerializer3D) plb::NTensorField2NumPy3D<PRECOMP_T>;
+%template(PRECOMP_T_NTensorFieldView3D) plb::NTensorFieldView3D<PRECOMP_T>;
@@ -88,6 +88,28 @@ struct BlockDataTransfer3D {
     {
         attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
     }
+    /// Size of the data sent per cell in a direction-selective envelope update.
+    /** The orientation indicates the position of the envelope cells with respect
+     *  to the bulk of the recipient (components -1, 0 or +1). By default, the
+     *  full static content of the cells is exchanged.
+     **/
+    virtual plint directionalCellSize(Dot3D const& orientation) const {
+        return staticCellSize();
+    }
+    /// Send the data required by a direction-selective envelope update.
+    virtual void sendDirectional(Box3D domain, std::vector<char>& buffer, Dot3D const& orientation) const {
+        send(domain, buffer, modif::staticVariables);
+    }
+    /// Receive the data of a direction-selective envelope update.
+    virtual void receiveDirectional(Box3D domain, std::vector<char> const& buffer, Dot3D const& orientation) {
+        receive(domain, buffer, modif::staticVariables);
+    }
+    /// Attribute the data of a direction-selective envelope update between two blocks.
+    virtual void attributeDirectional(Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
+                                      AtomicBlock3D const& from, Dot3D const& orientation)
+    {
+        attribute(toDomain, deltaX, deltaY, deltaZ, from, modif::staticVariables);
+    }
 };
 
 class AtomicBlock3D : public Block3D {
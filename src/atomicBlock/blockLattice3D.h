@@ -68,16 +68,40 @@ public:
     {
         attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
     }
+    /// Only the populations which stream from the envelope into the bulk are sent.
+    /** This exchange is meant to be executed between collide() and stream(). At
+     *  this point, the populations are reverted, and the post-collision population
+     *  which streams along c_i is stored in the slot of the opposite direction.
+     *  The selected slots are therefore those whose velocity points along the
+     *  orientation, i.e. away from the bulk of the recipient. External scalars
+     *  are not transmitted.
+     **/
+    virtual plint directionalCellSize(Dot3D const& orientation) const;
+    virtual void sendDirectional(Box3D domain, std::vector<char>& buffer, Dot3D const& orientation) const;
+    virtual void receiveDirectional(Box3D domain, std::vector<char> const& buffer, Dot3D const& orientation);
+    virtual void attributeDirectional(Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
+                                      AtomicBlock3D const& from, Dot3D const& orientation);
+private:
+    /// Slots of the populations exchanged in a direction-selective update.
+    static std::vector<plint> directionalPopulations(Dot3D const& orientation);
 private:
     void send_static(Box3D domain, std::vector<char>& buffer) const;
     void send_dynamic(Box3D domain, std::vector<char>& buffer) const;
     void send_all(Box3D domain, std::vector<char>& buffer) const;
 
+    pluint unserializeDynamics ( plint iX, plint iY, plint iZ,
+                                 std::vector<char> const& buffer, pluint serializerPos,
+                                 std::vector<char>& backgroundKey );
     void receive_static(Box3D domain, std::vector<char> const& buffer);
     void receive_dynamic(Box3D domain, std::vector<char> const& buffer);
     void receive_all(Box3D domain, std::vector<char> const& buffer);
+    void send_regenerate(Box3D domain, std::vector<char>& buffer) const;
     void receive_regenerate( Box3D domain, std::vector<char> const& buffer,
                              std::map<int,int> const& idIndirect = (std::map<int,int>()) );
+    /// Read a dataStructure message in the layout without dynamics table,
+    ///   in which every cell holds its serialized dynamics.
+    void receive_untabulated_regenerate( Box3D domain, std::vector<char> const& buffer,
+                                         std::map<int,int> const& idIndirect );
 
     void attribute_static (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
@@ -93,6 +117,11 @@ private:
         BlockLattice3D<T,Descriptor> const& from );
 private:
     BlockLattice3D<T,Descriptor>& lattice;
+    /// First int of a dataStructure message which starts with a dynamics table.
+    /** Messages without this tag start with the serialized dynamics of the
+     *  first cell, whose first int is a positive number of objects.
+     **/
+    static const int dynamicsTableTag = -0x64796e74;
 template<typename T_, template<typename U_> class Descriptor_>
     friend class ExternalRhoJcollideAndStream3D;
 };
@@ -159,7 +188,34 @@ public:
     virtual BlockLatticeDataTransfer3D<T,Descriptor> const& getDataTransfer() const;
 public:
     /// Attribute dynamics to a cell.
+    /** The lattice takes ownership of the dynamics object. Shareable dynamics
+     *  (see Dynamics::isShareable()) are interned in the dynamics table of the
+     *  lattice: if the table already holds an instance with identical serialized
+     *  content, the new object is deleted and the cell refers to the existing
+     *  one. An instance of the table (see internDynamics()) can be passed
+     *  directly, in which case it is not serialized again.
+     **/
     void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics);
+    /// Intern a shareable dynamics object, and return the instance of the table.
+    /** The lattice takes ownership of the argument. The returned instance is
+     *  meant to be attributed to many cells without the cost of a look-up by
+     *  content for each of them. It remains valid until it is handed back
+     *  through releaseInternedDynamics(), which must be called once per call
+     *  of internDynamics().
+     **/
+    Dynamics<T,Descriptor>* internDynamics(Dynamics<T,Descriptor>* dynamics);
+    /// Give back an instance obtained from internDynamics().
+    /** The instance remains valid as long as cells refer to it, and is
+     *  deleted with the last one of them.
+     **/
+    void releaseInternedDynamics(Dynamics<T,Descriptor>* dynamics);
+    /// Id of a cell's dynamics in the dynamics table of the lattice.
+    /** The id 0 stands for the background dynamics, and privateDynamicsId for
+     *  cells which own their dynamics object (cell-specific state).
+     **/
+    plint getDynamicsId(plint iX, plint iY, plint iZ) const;
+    /// Number of distinct shared dynamics instances held by the lattice.
+    plint getNumSharedDynamics() const;
     /// Get a reference to the background dynamics
     Dynamics<T,Descriptor>& getBackgroundDynamics();
     /// Get a const reference to the background dynamics
@@ -170,27 +226,76 @@ public:
     void boundaryStream(Box3D bound, Box3D domain);
     /// Apply collision and streaming step to bulk (non-boundary) cells
     void bulkCollideAndStream(Box3D domain);
+    /// Odd step of the in-place (AA-pattern) propagation.
+    /** The even step is a plain collide(), which leaves the post-collision
+     *  populations in the opposite slot of their own cell. The odd step reads
+     *  the incoming populations from the neighbors, collides, and writes the
+     *  result back to the very locations it read from, so that the standard
+     *  layout is restored after one memory pass. Each location is accessed by
+     *  exactly one cell, and the cells of the domain can be treated in any
+     *  order. Populations which would come from outside of bound are taken
+     *  from the cell itself, as in boundaryStream().
+     **/
+    void inPlaceCollideAndStream(Box3D domain, Box3D bound);
 private:
     /// Generic implementation of bulkCollideAndStream(domain).
     void linearBulkCollideAndStream(Box3D domain);
     /// Cache-efficient implementation of bulkCollideAndStream(domain)for
     ///   nearest-neighbor lattices.
     void blockwiseBulkCollideAndStream(Box3D domain);
+    /// Odd in-place step on cells whose neighbors are all inside the lattice.
+    void bulkInPlaceCollideAndStream(Box3D domain);
+    /// Odd in-place step on cells which have neighbors outside of bound.
+    void boundaryInPlaceCollideAndStream(Box3D bound, Box3D domain);
 private:
     /// Helper method for memory allocation
     void allocateAndInitialize();
     /// Helper method for memory de-allocation
     void releaseMemory();
+    /// Return the id of the table entry with the same content as the (shareable)
+    ///   argument, creating it if needed. The reference count is unchanged.
+    plint registerDynamics(Dynamics<T,Descriptor>* dynamics);
+    /// Attribute the table entry dynamicsId to a cell.
+    void attributeDynamicsId(plint iX, plint iY, plint iZ, plint dynamicsId);
+    /// Increment the reference count of a table entry.
+    void acquireDynamicsId(plint dynamicsId);
+    /// Decrement the reference count of a table entry, and remove it at zero.
+    void releaseDynamicsId(plint dynamicsId);
+    /// Delete a cell's dynamics, or decrement its count if it is shared.
+    void releaseDynamics(plint iX, plint iY, plint iZ);
+    int& dynamicsId(plint iX, plint iY, plint iZ) {
+        return dynamicsIds[iZ+this->getNz()*(iY+this->getNy()*iX)];
+    }
+    int dynamicsId(plint iX, plint iY, plint iZ) const {
+        return dynamicsIds[iZ+this->getNz()*(iY+this->getNy()*iX)];
+    }
     void implementPeriodicity();
 private:
     void periodicDomain(Box3D domain);
 private:
     Dynamics<T,Descriptor>* backgroundDynamics;
+    /// Table of the distinct dynamics instances, indexed by dynamics-id. Entry 0
+    ///   is the background dynamics; removed entries are null.
+    std::vector<Dynamics<T,Descriptor>*> dynamicsTable;
+    /// Serialized content of each entry of the table.
+    std::vector<std::vector<char> > dynamicsKeys;
+    /// Number of references (cells, or pending internDynamics()) to each entry of the table.
+    std::vector<plint> numSharingCells;
+    /// Ids of the entries of the table, indexed by their content and by their address.
+    std::map<std::vector<char>, plint> idFromContent;
+    std::map<Dynamics<T,Descriptor> const*, plint> idFromAddress;
+    /// Removed entries of the table, to be reused.
+    std::vector<plint> freeDynamicsIds;
+    /// Per-cell dynamics-id.
+    int                    *dynamicsIds;
     Cell<T,Descriptor>     *rawData;
     Cell<T,Descriptor>   ***grid;
     BlockLatticeDataTransfer3D<T,Descriptor> dataTransfer;
 public:
+    /// Dynamics-id of the cells which own their dynamics object.
+    static const plint privateDynamicsId = -1;
     static CachePolicy3D& cachePolicy();
+    friend class BlockLatticeDataTransfer3D<T,Descriptor>;
 template<typename T_, template<typename U_> class Descriptor_>
     friend class ExternalRhoJcollideAndStream3D;
 template<typename T_, template<typename U_> class Descriptor_>
@@ -40,11 +40,18 @@
 #include <algorithm>
 #include <typeinfo>
 #include <cmath>
+#include <cstring>
 
 namespace plb {
 
 // Class BlockLattice3D /////////////////////////
 
+template<typename T, template<typename U> class Descriptor>
+const plint BlockLattice3D<T,Descriptor>::privateDynamicsId;
+
+template<typename T, template<typename U> class Descriptor>
+const int BlockLatticeDataTransfer3D<T,Descriptor>::dynamicsTableTag;
+
 /** \param nx_ lattice width (first index)
  *  \param ny_ lattice height (second index)
  *  \param nz_ lattice depth (third index)
@@ -109,19 +116,34 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
     plint ny = this->getNy();
     plint nz = this->getNz();
     allocateAndInitialize();
+    // The dynamics table is cloned entry by entry, so that shared instances
+    //   remain shared and keep their ids.
+    dynamicsTable.resize(rhs.dynamicsTable.size());
+    for (pluint id=1; id<rhs.dynamicsTable.size(); ++id) {
+        if (rhs.dynamicsTable[id]) {
+            dynamicsTable[id] = rhs.dynamicsTable[id]->clone();
+            idFromAddress[dynamicsTable[id]] = id;
+        }
+    }
+    dynamicsKeys = rhs.dynamicsKeys;
+    numSharingCells = rhs.numSharingCells;
+    idFromContent = rhs.idFromContent;
+    freeDynamicsIds = rhs.freeDynamicsIds;
     for (plint iX=0; iX<nx; ++iX) {
         for (plint iY=0; iY<ny; ++iY) {
             for (plint iZ=0; iZ<nz; ++iZ) {
                 Cell<T,Descriptor>& cell = grid[iX][iY][iZ];
                 // Assign cell from rhs
                 cell = rhs.grid[iX][iY][iZ];
+                int id = rhs.dynamicsId(iX,iY,iZ);
+                dynamicsId(iX,iY,iZ) = id;
                 // Get an independent clone of the dynamics,
-                //   or assign backgroundDynamics
-                if (&cell.getDynamics()==rhs.backgroundDynamics) {
-                    cell.attributeDynamics(backgroundDynamics);
+                //   or refer to the table.
+                if (id==privateDynamicsId) {
+                    cell.attributeDynamics(cell.getDynamics().clone());
                 }
                 else {
-                    cell.attributeDynamics(cell.getDynamics().clone());
+                    cell.attributeDynamics(dynamicsTable[id]);
                 }
             }
         }
@@ -151,6 +173,13 @@ void BlockLattice3D<T,Descriptor>::swap(BlockLattice3D& rhs) {
     BlockLatticeBase3D<T,Descriptor>::swap(rhs);
     AtomicBlock3D::swap(rhs);
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
+    dynamicsTable.swap(rhs.dynamicsTable);
+    dynamicsKeys.swap(rhs.dynamicsKeys);
+    numSharingCells.swap(rhs.numSharingCells);
+    idFromContent.swap(rhs.idFromContent);
+    idFromAddress.swap(rhs.idFromAddress);
+    freeDynamicsIds.swap(rhs.freeDynamicsIds);
+    std::swap(dynamicsIds, rhs.dynamicsIds);
     std::swap(rawData, rhs.rawData);
     std::swap(grid, rhs.grid);
 }
@@ -340,6 +369,12 @@ void BlockLattice3D<T,Descriptor>::allocateAndInitialize() {
     plint ny = this->getNy();
     plint nz = this->getNz();
     rawData = new Cell<T,Descriptor> [nx*ny*nz];
+    // All cells start with the background dynamics, which is entry 0 of the table.
+    dynamicsIds = new int [nx*ny*nz];
+    std::fill(dynamicsIds, dynamicsIds+nx*ny*nz, 0);
+    dynamicsTable.assign(1, backgroundDynamics);
+    dynamicsKeys.assign(1, std::vector<char>());
+    numSharingCells.assign(1, 0);
     grid    = new Cell<T,Descriptor>** [nx];
     for (plint iX=0; iX<nx; ++iX) {
         grid[iX] = new Cell<T,Descriptor>* [ny];
@@ -357,14 +392,17 @@ void BlockLattice3D<T,Descriptor>::releaseMemory() {
     for (plint iX=0; iX<nx; ++iX) {
         for (plint iY=0; iY<ny; ++iY) {
             for (plint iZ=0; iZ<nz; ++iZ) {
-                Dynamics<T,Descriptor>* dynamics = &grid[iX][iY][iZ].getDynamics();
-                if (dynamics != backgroundDynamics) {
-                    delete dynamics;
+                if (dynamicsId(iX,iY,iZ)==privateDynamicsId) {
+                    delete &grid[iX][iY][iZ].getDynamics();
                 }
             }
         }
     }
+    for (pluint id=1; id<dynamicsTable.size(); ++id) {
+        delete dynamicsTable[id];
+    }
     delete backgroundDynamics;
+    delete [] dynamicsIds;
     delete [] rawData;
     for (plint iX=0; iX<nx; ++iX) {
         delete [] grid[iX];
@@ -376,11 +414,137 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::attributeDynamics (
         plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics )
 {
-    Dynamics<T,Descriptor>* previousDynamics = &grid[iX][iY][iZ].getDynamics();
-    if (previousDynamics != backgroundDynamics) {
-        delete previousDynamics;
+    if (dynamics == backgroundDynamics) {
+        attributeDynamicsId(iX,iY,iZ, 0);
+    }
+    else if (dynamics->isShareable()) {
+        attributeDynamicsId(iX,iY,iZ, registerDynamics(dynamics));
+    }
+    else {
+        releaseDynamics(iX,iY,iZ);
+        grid[iX][iY][iZ].attributeDynamics(dynamics);
+        dynamicsId(iX,iY,iZ) = privateDynamicsId;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* BlockLattice3D<T,Descriptor>::internDynamics (
+        Dynamics<T,Descriptor>* dynamics )
+{
+    if (dynamics == backgroundDynamics) {
+        return dynamics;
+    }
+    PLB_PRECONDITION( dynamics->isShareable() );
+    plint id = registerDynamics(dynamics);
+    // The reference held on behalf of the caller keeps the instance alive
+    //   until releaseInternedDynamics().
+    acquireDynamicsId(id);
+    return dynamicsTable[id];
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::releaseInternedDynamics (
+        Dynamics<T,Descriptor>* dynamics )
+{
+    if (dynamics == backgroundDynamics) {
+        return;
+    }
+    typename std::map<Dynamics<T,Descriptor> const*, plint>::const_iterator
+        address = idFromAddress.find(dynamics);
+    PLB_ASSERT( address != idFromAddress.end() );
+    releaseDynamicsId(address->second);
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint BlockLattice3D<T,Descriptor>::getDynamicsId(plint iX, plint iY, plint iZ) const {
+    return dynamicsId(iX,iY,iZ);
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint BlockLattice3D<T,Descriptor>::getNumSharedDynamics() const {
+    return (plint)(dynamicsTable.size()-1-freeDynamicsIds.size());
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint BlockLattice3D<T,Descriptor>::registerDynamics(Dynamics<T,Descriptor>* dynamics)
+{
+    // Instances of the table are recognized by their address, without serialization.
+    typename std::map<Dynamics<T,Descriptor> const*, plint>::const_iterator
+        address = idFromAddress.find(dynamics);
+    if (address != idFromAddress.end()) {
+        return address->second;
+    }
+    std::vector<char> key;
+    serialize(*dynamics, key);
+    typename std::map<std::vector<char>, plint>::const_iterator
+        content = idFromContent.find(key);
+    if (content != idFromContent.end()) {
+        delete dynamics;
+        return content->second;
+    }
+    plint id;
+    if (freeDynamicsIds.empty()) {
+        id = (plint)dynamicsTable.size();
+        dynamicsTable.push_back(dynamics);
+        dynamicsKeys.push_back(key);
+        numSharingCells.push_back(0);
+    }
+    else {
+        id = freeDynamicsIds.back();
+        freeDynamicsIds.pop_back();
+        dynamicsTable[id] = dynamics;
+        dynamicsKeys[id] = key;
+        numSharingCells[id] = 0;
+    }
+    idFromContent[key] = id;
+    idFromAddress[dynamics] = id;
+    return id;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::attributeDynamicsId (
+        plint iX, plint iY, plint iZ, plint id )
+{
+    // Acquiring before releasing the previous dynamics keeps the entry
+    //   alive if the cell already refers to it.
+    acquireDynamicsId(id);
+    releaseDynamics(iX,iY,iZ);
+    grid[iX][iY][iZ].attributeDynamics(dynamicsTable[id]);
+    dynamicsId(iX,iY,iZ) = (int)id;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::acquireDynamicsId(plint id)
+{
+    // The background dynamics is owned by the lattice, and is not counted.
+    if (id > 0) {
+        ++numSharingCells[id];
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::releaseDynamicsId(plint id)
+{
+    if (id > 0 && --numSharingCells[id] == 0) {
+        idFromContent.erase(dynamicsKeys[id]);
+        idFromAddress.erase(dynamicsTable[id]);
+        delete dynamicsTable[id];
+        dynamicsTable[id] = 0;
+        std::vector<char>().swap(dynamicsKeys[id]);
+        freeDynamicsIds.push_back(id);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::releaseDynamics(plint iX, plint iY, plint iZ)
+{
+    int id = dynamicsId(iX,iY,iZ);
+    if (id == privateDynamicsId) {
+        delete &grid[iX][iY][iZ].getDynamics();
+    }
+    else {
+        releaseDynamicsId(id);
     }
-    grid[iX][iY][iZ].attributeDynamics(dynamics);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -551,6 +715,136 @@ void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::inPlaceCollideAndStream(Box3D domain, Box3D bound) {
+    // Make sure bound is contained within current lattice
+    PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
+    // Make sure domain is contained within bound
+    PLB_PRECONDITION( contained(domain, bound) );
+
+    global::profiler().start("collStream");
+    global::profiler().increment("collStreamCells", domain.nCells());
+
+    static const plint vicinity = Descriptor<T>::vicinity;
+
+    // Cells whose neighbors are all inside bound are treated by the
+    //   efficient algorithm, the others by the one with boundary checks.
+    Box3D bulk ( std::max(domain.x0, bound.x0+vicinity), std::min(domain.x1, bound.x1-vicinity),
+                 std::max(domain.y0, bound.y0+vicinity), std::min(domain.y1, bound.y1-vicinity),
+                 std::max(domain.z0, bound.z0+vicinity), std::min(domain.z1, bound.z1-vicinity) );
+    if (bulk.x0>bulk.x1 || bulk.y0>bulk.y1 || bulk.z0>bulk.z1) {
+        boundaryInPlaceCollideAndStream(bound, domain);
+    }
+    else {
+        bulkInPlaceCollideAndStream(bulk);
+        boundaryInPlaceCollideAndStream(bound, Box3D(domain.x0,bulk.x0-1,
+                                                     domain.y0,domain.y1,
+                                                     domain.z0,domain.z1) );
+        boundaryInPlaceCollideAndStream(bound, Box3D(bulk.x1+1,domain.x1,
+                                                     domain.y0,domain.y1,
+                                                     domain.z0,domain.z1) );
+        boundaryInPlaceCollideAndStream(bound, Box3D(bulk.x0,bulk.x1,
+                                                     domain.y0,bulk.y0-1,
+                                                     domain.z0,domain.z1) );
+        boundaryInPlaceCollideAndStream(bound, Box3D(bulk.x0,bulk.x1,
+                                                     bulk.y1+1,domain.y1,
+                                                     domain.z0,domain.z1) );
+        boundaryInPlaceCollideAndStream(bound, Box3D(bulk.x0,bulk.x1,
+                                                     bulk.y0,bulk.y1,
+                                                     domain.z0,bulk.z0-1) );
+        boundaryInPlaceCollideAndStream(bound, Box3D(bulk.x0,bulk.x1,
+                                                     bulk.y0,bulk.y1,
+                                                     bulk.z1+1,domain.z1) );
+    }
+    global::profiler().stop("collStream");
+}
+
+/** The incoming populations are swapped into the cell, which is collided in
+ *  place. The previous content of the cell, parked at the neighbor locations
+ *  in the meantime, is then swapped back, and the neighbor locations receive
+ *  the outgoing populations.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::bulkInPlaceCollideAndStream(Box3D domain) {
+    static const plint half = Descriptor<T>::q/2;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = grid[iX][iY][iZ];
+                for (plint iPop=1; iPop<=half; ++iPop) {
+                    plint dX = Descriptor<T>::c[iPop][0];
+                    plint dY = Descriptor<T>::c[iPop][1];
+                    plint dZ = Descriptor<T>::c[iPop][2];
+                    std::swap(cell[iPop], grid[iX-dX][iY-dY][iZ-dZ][iPop+half]);
+                    std::swap(cell[iPop+half], grid[iX+dX][iY+dY][iZ+dZ][iPop]);
+                }
+
+                cell.collide(this->getInternalStatistics());
+
+                for (plint iPop=1; iPop<=half; ++iPop) {
+                    plint dX = Descriptor<T>::c[iPop][0];
+                    plint dY = Descriptor<T>::c[iPop][1];
+                    plint dZ = Descriptor<T>::c[iPop][2];
+                    T& fromPrev = grid[iX-dX][iY-dY][iZ-dZ][iPop+half];
+                    T& fromNext = grid[iX+dX][iY+dY][iZ+dZ][iPop];
+                    T fOut = cell[iPop];
+                    T fOutOpp = cell[iPop+half];
+                    cell[iPop] = fromPrev;
+                    cell[iPop+half] = fromNext;
+                    fromPrev = fOutOpp;
+                    fromNext = fOut;
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::boundaryInPlaceCollideAndStream(Box3D bound, Box3D domain) {
+    Array<T,Descriptor<T>::q> parked, collided;
+    Array<bool,Descriptor<T>::q> inside;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = grid[iX][iY][iZ];
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    plint prevX = iX - Descriptor<T>::c[iPop][0];
+                    plint prevY = iY - Descriptor<T>::c[iPop][1];
+                    plint prevZ = iZ - Descriptor<T>::c[iPop][2];
+                    inside[iPop] = prevX>=bound.x0 && prevX<=bound.x1 &&
+                                   prevY>=bound.y0 && prevY<=bound.y1 &&
+                                   prevZ>=bound.z0 && prevZ<=bound.z1;
+                    // Populations from outside of bound are the ones which are
+                    //   already on the cell.
+                    parked[iPop] = cell[iPop];
+                    if (inside[iPop]) {
+                        cell[iPop] = grid[prevX][prevY][prevZ]
+                                         [indexTemplates::opposite<Descriptor<T> >(iPop)];
+                    }
+                }
+
+                cell.collide(this->getInternalStatistics());
+
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    collided[iPop] = cell[iPop];
+                }
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    plint oppPop = indexTemplates::opposite<Descriptor<T> >(iPop);
+                    if (inside[iPop]) {
+                        grid[iX - Descriptor<T>::c[iPop][0]]
+                            [iY - Descriptor<T>::c[iPop][1]]
+                            [iZ - Descriptor<T>::c[iPop][2]][oppPop] = collided[oppPop];
+                        cell[iPop] = parked[iPop];
+                    }
+                    else {
+                        cell[iPop] = collided[oppPop];
+                    }
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::implementPeriodicity() {
     static const plint vicinity = Descriptor<T>::vicinity;
@@ -659,11 +953,10 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::send (
             send_static(domain, buffer); break;
         case modif::dynamicVariables:
             send_dynamic(domain, buffer); break;
-        // Serialization is the same no matter if the dynamics object
-        //   is being regenerated or not by the recipient.
-        case modif::allVariables:  
-        case modif::dataStructure:
+        case modif::allVariables:
             send_all(domain,buffer); break;
+        case modif::dataStructure:
+            send_regenerate(domain,buffer); break;
         default: PLB_ASSERT(false);
     }
 }
@@ -723,6 +1016,62 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::send_all (
     }
 }
 
+/** The dynamics are transmitted by id. The message starts with the tag
+ *  dynamicsTableTag and the entries of the dynamics table used in the domain,
+ *  each one serialized once. Then, every cell holds the index of its entry in
+ *  this list, followed by its static data. Cells which own their dynamics
+ *  object have the index -1, and their dynamics is serialized in place.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::send_regenerate (
+        Box3D domain, std::vector<char>& buffer ) const
+{
+    std::vector<int> entryOfId(lattice.dynamicsTable.size(), -1);
+    std::vector<plint> entries;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                int id = lattice.dynamicsId(iX,iY,iZ);
+                if (id!=BlockLattice3D<T,Descriptor>::privateDynamicsId && entryOfId[id]<0) {
+                    entryOfId[id] = (int)entries.size();
+                    entries.push_back(id);
+                }
+            }
+        }
+    }
+    int tag = dynamicsTableTag;
+    int numEntries = (int)entries.size();
+    buffer.resize(2*sizeof(int));
+    memcpy((void*)(&buffer[0]), (const void*)(&tag), sizeof(int));
+    memcpy((void*)(&buffer[sizeof(int)]), (const void*)(&numEntries), sizeof(int));
+    for (pluint iEntry=0; iEntry<entries.size(); ++iEntry) {
+        serialize(*lattice.dynamicsTable[entries[iEntry]], buffer);
+    }
+
+    plint cellSize = staticCellSize();
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                // 1. Send the entry of the dynamics, or the dynamics itself.
+                int id = lattice.dynamicsId(iX,iY,iZ);
+                int entry = id==BlockLattice3D<T,Descriptor>::privateDynamicsId ? -1 : entryOfId[id];
+                pluint pos = buffer.size();
+                buffer.resize(pos+sizeof(int));
+                memcpy((void*)(&buffer[pos]), (const void*)(&entry), sizeof(int));
+                if (entry<0) {
+                    serialize(lattice.get(iX,iY,iZ).getDynamics(), buffer);
+                }
+                // 2. Send static info.
+                if (cellSize>0) {
+                    pos = buffer.size();
+                    buffer.resize(pos+cellSize);
+                    lattice.get(iX,iY,iZ).serialize(&buffer[pos]);
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::receive (
         Box3D domain, std::vector<char> const& buffer,
@@ -777,19 +1126,52 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::receive_static (
     }
 }
 
+/** Shared dynamics instances must not be modified in place, because the change
+ *  would affect all cells which refer to them. If the incoming bytes are those
+ *  of the current instance, which is the usual case in an envelope update, they
+ *  are skipped: the serialization is self-delimiting, so that a matching prefix
+ *  is the whole message of the dynamics. Otherwise, the new content is
+ *  unserialized into a copy, which is interned again by the lattice. The
+ *  content of the background dynamics is serialized into backgroundKey the
+ *  first time it is needed, and reused in the subsequent calls.
+ */
+template<typename T, template<typename U> class Descriptor>
+pluint BlockLatticeDataTransfer3D<T,Descriptor>::unserializeDynamics (
+        plint iX, plint iY, plint iZ, std::vector<char> const& buffer, pluint serializerPos,
+        std::vector<char>& backgroundKey )
+{
+    Dynamics<T,Descriptor>& dynamics = lattice.get(iX,iY,iZ).getDynamics();
+    if (!dynamics.isShareable()) {
+        return unserialize(dynamics, buffer, serializerPos);
+    }
+    int id = lattice.dynamicsId(iX,iY,iZ);
+    if (id==0 && backgroundKey.empty()) {
+        serialize(dynamics, backgroundKey);
+    }
+    std::vector<char> const& key = id==0 ? backgroundKey : lattice.dynamicsKeys[id];
+    if ( serializerPos+key.size() <= buffer.size() &&
+         std::equal(key.begin(), key.end(), buffer.begin()+serializerPos) )
+    {
+        return serializerPos+key.size();
+    }
+    Dynamics<T,Descriptor>* newDynamics = dynamics.clone();
+    serializerPos = unserialize(*newDynamics, buffer, serializerPos);
+    lattice.attributeDynamics(iX,iY,iZ, newDynamics);
+    return serializerPos;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::receive_dynamic (
         Box3D domain, std::vector<char> const& buffer )
 {
     pluint serializerPos = 0;
+    std::vector<char> backgroundKey;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
                 // No assert is included here, because incompatible types of
                 //   dynamics are detected by asserts inside HierarchicUnserializer.
-                serializerPos = 
-                    unserialize (
-                        lattice.get(iX,iY,iZ).getDynamics(), buffer, serializerPos );
+                serializerPos = unserializeDynamics(iX,iY,iZ, buffer, serializerPos, backgroundKey);
             }
         }
     }
@@ -801,13 +1183,12 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::receive_all (
 {
     pluint posInBuffer = 0;
     plint cellSize = staticCellSize();
+    std::vector<char> backgroundKey;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
                 // 1. Unserialize dynamic data.
-                posInBuffer = 
-                    unserialize (
-                        lattice.get(iX,iY,iZ).getDynamics(), buffer, posInBuffer );
+                posInBuffer = unserializeDynamics(iX,iY,iZ, buffer, posInBuffer, backgroundKey);
                 // 2. Unserialize static data.
                 if (staticCellSize()>0) {
                     lattice.get(iX,iY,iZ).unSerialize(&buffer[posInBuffer]);
@@ -818,17 +1199,113 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::receive_all (
     }
 }
 
+/** Entries with the same content as the background dynamics of the recipient
+ *  are mapped to it, and shareable entries are interned in its dynamics table.
+ *  The other entries are cloned for each cell which refers to them. Messages
+ *  which do not start with dynamicsTableTag, such as the ones of checkpoints
+ *  written before the dynamics table was introduced, are read in the former
+ *  per-cell layout.
+ */
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::receive_regenerate (
         Box3D domain, std::vector<char> const& buffer, std::map<int,int> const& idIndirect )
 {
+    int tag = 0;
+    if (buffer.size()>=sizeof(int)) {
+        memcpy((void*)(&tag), (const void*)(&buffer[0]), sizeof(int));
+    }
+    if (tag!=dynamicsTableTag) {
+        receive_untabulated_regenerate(domain, buffer, idIndirect);
+        return;
+    }
+    std::map<int,int> const* indirectPtr = idIndirect.empty() ? 0 : &idIndirect;
+    PLB_ASSERT( buffer.size()>=2*sizeof(int) );
+    int numEntries;
+    memcpy((void*)(&numEntries), (const void*)(&buffer[sizeof(int)]), sizeof(int));
+    pluint posInBuffer = 2*sizeof(int);
+
+    std::vector<char> backgroundKey;
+    serialize(lattice.getBackgroundDynamics(), backgroundKey);
+    std::vector<plint> entryIds(numEntries);
+    std::vector<Dynamics<T,Descriptor>*> privateEntries(numEntries, (Dynamics<T,Descriptor>*)0);
+    for (int iEntry=0; iEntry<numEntries; ++iEntry) {
+        HierarchicUnserializer unserializer(buffer, posInBuffer, indirectPtr);
+        Dynamics<T,Descriptor>* newDynamics =
+            meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
+        posInBuffer = unserializer.getCurrentPos();
+        std::vector<char> key;
+        serialize(*newDynamics, key);
+        if (key==backgroundKey) {
+            delete newDynamics;
+            entryIds[iEntry] = 0;
+        }
+        else if (newDynamics->isShareable()) {
+            // The entry is held until all cells are attributed, because it
+            //   could otherwise be released by a cell which is overwritten.
+            entryIds[iEntry] = lattice.registerDynamics(newDynamics);
+            lattice.acquireDynamicsId(entryIds[iEntry]);
+        }
+        else {
+            entryIds[iEntry] = BlockLattice3D<T,Descriptor>::privateDynamicsId;
+            privateEntries[iEntry] = newDynamics;
+        }
+    }
+
+    plint cellSize = staticCellSize();
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                // 1. Attribute the dynamics from the table, or generate it.
+                PLB_ASSERT( posInBuffer+sizeof(int)<=buffer.size() );
+                int entry;
+                memcpy((void*)(&entry), (const void*)(&buffer[posInBuffer]), sizeof(int));
+                posInBuffer += sizeof(int);
+                if (entry<0) {
+                    HierarchicUnserializer unserializer(buffer, posInBuffer, indirectPtr);
+                    Dynamics<T,Descriptor>* newDynamics =
+                        meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
+                    posInBuffer = unserializer.getCurrentPos();
+                    lattice.attributeDynamics(iX,iY,iZ, newDynamics);
+                }
+                else if (privateEntries[entry]) {
+                    lattice.attributeDynamics(iX,iY,iZ, privateEntries[entry]->clone());
+                }
+                else {
+                    lattice.attributeDynamicsId(iX,iY,iZ, entryIds[entry]);
+                }
+
+                // 2. Unserialize static data.
+                if (cellSize>0) {
+                    PLB_ASSERT( posInBuffer+cellSize<=buffer.size() );
+                    lattice.get(iX,iY,iZ).unSerialize(&buffer[posInBuffer]);
+                    posInBuffer += cellSize;
+                }
+            }
+        }
+    }
+
+    for (int iEntry=0; iEntry<numEntries; ++iEntry) {
+        if (privateEntries[iEntry]) {
+            delete privateEntries[iEntry];
+        }
+        else {
+            lattice.releaseDynamicsId(entryIds[iEntry]);
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receive_untabulated_regenerate (
+        Box3D domain, std::vector<char> const& buffer, std::map<int,int> const& idIndirect )
+{
+    std::map<int,int> const* indirectPtr = idIndirect.empty() ? 0 : &idIndirect;
     pluint posInBuffer = 0;
     plint cellSize = staticCellSize();
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
                 // 1. Generate dynamics object, and unserialize dynamic data.
-                std::map<int,int> const* indirectPtr = idIndirect.empty() ? 0 : &idIndirect;
+                PLB_ASSERT( posInBuffer+sizeof(int)<=buffer.size() );
                 HierarchicUnserializer unserializer(buffer, posInBuffer, indirectPtr);
                 Dynamics<T,Descriptor>* newDynamics =
                     meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
@@ -836,8 +1313,7 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::receive_regenerate (
                 lattice.attributeDynamics(iX,iY,iZ, newDynamics);
 
                 // 2. Unserialize static data.
-                if (staticCellSize()>0) {
-                    PLB_ASSERT( !buffer.empty() );
+                if (cellSize>0) {
                     PLB_ASSERT( posInBuffer+cellSize<=buffer.size() );
                     lattice.get(iX,iY,iZ).unSerialize(&buffer[posInBuffer]);
                     posInBuffer += cellSize;
@@ -869,6 +1345,100 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+std::vector<plint> BlockLatticeDataTransfer3D<T,Descriptor>::directionalPopulations (
+        Dot3D const& orientation )
+{
+    std::vector<plint> populations;
+    for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+        if ( (orientation.x==0 || Descriptor<T>::c[iPop][0]==orientation.x) &&
+             (orientation.y==0 || Descriptor<T>::c[iPop][1]==orientation.y) &&
+             (orientation.z==0 || Descriptor<T>::c[iPop][2]==orientation.z) )
+        {
+            populations.push_back(iPop);
+        }
+    }
+    return populations;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint BlockLatticeDataTransfer3D<T,Descriptor>::directionalCellSize(Dot3D const& orientation) const
+{
+    return sizeof(T) * (plint)directionalPopulations(orientation).size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::sendDirectional (
+        Box3D domain, std::vector<char>& buffer, Dot3D const& orientation ) const
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    std::vector<plint> populations(directionalPopulations(orientation));
+    plint numPop = (plint)populations.size();
+    buffer.resize(domain.nCells()*numPop*sizeof(T));
+    if (buffer.empty()) return;
+
+    T* data = (T*)&buffer[0];
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor> const& cell = lattice.get(iX,iY,iZ);
+                for (plint i=0; i<numPop; ++i) {
+                    data[iData++] = cell[populations[i]];
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveDirectional (
+        Box3D domain, std::vector<char> const& buffer, Dot3D const& orientation )
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    std::vector<plint> populations(directionalPopulations(orientation));
+    plint numPop = (plint)populations.size();
+    PLB_PRECONDITION( (plint) buffer.size() == domain.nCells()*numPop*(plint)sizeof(T) );
+    if (buffer.empty()) return;
+
+    T const* data = (T const*)&buffer[0];
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = lattice.get(iX,iY,iZ);
+                for (plint i=0; i<numPop; ++i) {
+                    cell[populations[i]] = data[iData++];
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::attributeDirectional (
+        Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
+        AtomicBlock3D const& from, Dot3D const& orientation )
+{
+    PLB_PRECONDITION (typeid(from) == typeid(BlockLattice3D<T,Descriptor> const&));
+    PLB_PRECONDITION(contained(toDomain, lattice.getBoundingBox()));
+    BlockLattice3D<T,Descriptor> const& fromLattice = (BlockLattice3D<T,Descriptor> const&) from;
+    std::vector<plint> populations(directionalPopulations(orientation));
+    plint numPop = (plint)populations.size();
+    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
+        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
+            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = lattice.get(iX,iY,iZ);
+                Cell<T,Descriptor> const& fromCell =
+                    fromLattice.get(iX+deltaX,iY+deltaY,iZ+deltaZ);
+                for (plint i=0; i<numPop; ++i) {
+                    cell[populations[i]] = fromCell[populations[i]];
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_static (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
@@ -889,7 +1459,7 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_dynamic (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
-    std::vector<char> serializedData;
+    std::vector<char> serializedData, backgroundKey;
     for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
         for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
             for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
@@ -897,9 +1467,7 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_dynamic (
                 serialize (
                     from.get(iX+deltaX,iY+deltaY,iZ+deltaZ).getDynamics(),
                     serializedData );
-                unserialize (
-                    lattice.get(iX,iY,iZ).getDynamics(),
-                    serializedData );
+                unserializeDynamics(iX,iY,iZ, serializedData, 0, backgroundKey);
             }
         }
     }
@@ -910,7 +1478,7 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_all (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
-    std::vector<char> serializedData;
+    std::vector<char> serializedData, backgroundKey;
     for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
         for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
             for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
@@ -919,9 +1487,7 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_all (
                 serialize (
                     from.get(iX+deltaX,iY+deltaY,iZ+deltaZ).getDynamics(),
                     serializedData );
-                unserialize (
-                    lattice.get(iX,iY,iZ).getDynamics(),
-                    serializedData );
+                unserializeDynamics(iX,iY,iZ, serializedData, 0, backgroundKey);
 
                 // 2. Attribute static content.
                 lattice.get(iX,iY,iZ).attributeValues (
@@ -936,26 +1502,11 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_regenerate (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
-    std::vector<char> serializedData;
-    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
-        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
-            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
-                // 1. Generate new dynamics and attribute dynamic content.
-                serializedData.clear();
-                serialize (
-                    from.get(iX+deltaX,iY+deltaY,iZ+deltaZ).getDynamics(),
-                    serializedData );
-                HierarchicUnserializer unserializer(serializedData, 0);
-                Dynamics<T,Descriptor>* newDynamics =
-                    meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
-                lattice.attributeDynamics(iX,iY,iZ, newDynamics);
-
-                // 2. Attribute static content.
-                lattice.get(iX,iY,iZ).attributeValues (
-                        from.get(iX+deltaX,iY+deltaY,iZ+deltaZ) );
-            }
-        }
-    }
+    // Going through the id-based message clones each dynamics entry of the
+    //   domain once, instead of once per cell.
+    std::vector<char> buffer;
+    from.getDataTransfer().send(toDomain.shift(deltaX,deltaY,deltaZ), buffer, modif::dataStructure);
+    receive_regenerate(toDomain, buffer);
 }
 
 template<typename T, template<typename U> class Descriptor>
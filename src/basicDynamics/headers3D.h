@@ -29,5 +29,6 @@
 #include "basicDynamics/isoThermalDynamics.h"
 #include "basicDynamics/thermalDynamics.h"
 #include "basicDynamics/externalForceDynamics.h"
+#include "basicDynamics/mixedPrecisionDynamics.h"
 #include "basicDynamics/dynamicsProcessor3D.h"
 
@@ -28,5 +28,6 @@
 #include "basicDynamics/isoThermalDynamics.hh"
 #include "basicDynamics/thermalDynamics.hh"
 #include "basicDynamics/externalForceDynamics.hh"
+#include "basicDynamics/mixedPrecisionDynamics.hh"
 #include "basicDynamics/dynamicsProcessor3D.hh"
 
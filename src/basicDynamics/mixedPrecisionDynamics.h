@@ -0,0 +1,154 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Dynamics which store populations at a reduced precision and compute
+ * the collision at a higher precision -- header file.
+ */
+#ifndef MIXED_PRECISION_DYNAMICS_H
+#define MIXED_PRECISION_DYNAMICS_H
+
+#include "core/globalDefs.h"
+#include "core/dynamics.h"
+
+namespace plb {
+
+/// Wrapper which executes a dynamics of precision T on cells stored with precision S.
+/** The lattice is instantiated with the storage type S (typically float), and
+ *  all its data, including the envelope exchange and the checkpoints, have the
+ *  size of S. Each cell is converted to a temporary cell of type T (typically
+ *  double) on which the wrapped dynamics performs the collision or the computation
+ *  of the macroscopic variables, and the result is rounded back to S.
+ *
+ *  Palabos stores the populations shifted by the lattice weights
+ *  (f_i - t_i, such that rhoBar = rho-1), so that the stored values are small
+ *  and the rounding error of the storage is relative to the deviation from the
+ *  state at rest, not to the populations themselves. This is what makes a
+ *  single-precision storage usable at low Mach numbers.
+ *
+ *  Example: MultiBlockLattice3D<float,D3Q19Descriptor> lattice (nx,ny,nz,
+ *               new MixedPrecisionDynamics<float,double,D3Q19Descriptor> (
+ *                   new BGKdynamics<double,D3Q19Descriptor>(omega) ) );
+ *
+ *  User-defined moments (computeMoment, defineMoment) are not forwarded, because
+ *  their size is not known to the wrapper.
+ */
+template<typename S, typename T, template<typename U> class Descriptor>
+class MixedPrecisionDynamics : public Dynamics<S,Descriptor> {
+public:
+/* *************** Construction and Destruction ***************************** */
+
+    /// The wrapper takes ownership of the computation dynamics.
+    MixedPrecisionDynamics(Dynamics<T,Descriptor>* computationDynamics_);
+    MixedPrecisionDynamics(HierarchicUnserializer& unserializer);
+    MixedPrecisionDynamics(MixedPrecisionDynamics<S,T,Descriptor> const& rhs);
+    MixedPrecisionDynamics<S,T,Descriptor>& operator=(MixedPrecisionDynamics<S,T,Descriptor> const& rhs);
+    virtual ~MixedPrecisionDynamics();
+    virtual MixedPrecisionDynamics<S,T,Descriptor>* clone() const;
+    virtual int getId() const;
+    virtual bool velIsJ() const;
+    virtual bool isBoundary() const;
+    virtual bool isNonLocal() const;
+    virtual void serialize(HierarchicSerializer& serializer) const;
+    virtual void unserialize(HierarchicUnserializer& unserializer);
+
+/* *************** Access to the computation Dynamics *********************** */
+
+    Dynamics<T,Descriptor>& getComputationDynamics();
+    Dynamics<T,Descriptor> const& getComputationDynamics() const;
+
+/* *************** Collision, Equilibrium, and Non-equilibrium ************** */
+
+    virtual void collide(Cell<S,Descriptor>& cell, BlockStatistics& statistics);
+    virtual S computeEquilibrium(plint iPop, S rhoBar, Array<S,Descriptor<S>::d> const& j,
+                                 S jSqr, S thetaBar=S()) const;
+    virtual void regularize(Cell<S,Descriptor>& cell, S rhoBar, Array<S,Descriptor<S>::d> const& j,
+                            S jSqr, Array<S,SymmetricTensor<S,Descriptor>::n> const& PiNeq, S thetaBar=S() ) const;
+
+/* *************** Computation of macroscopic variables ********************* */
+
+    virtual S computeDensity(Cell<S,Descriptor> const& cell) const;
+    virtual S computePressure(Cell<S,Descriptor> const& cell) const;
+    virtual void computeVelocity( Cell<S,Descriptor> const& cell,
+                                  Array<S,Descriptor<S>::d>& u ) const;
+    virtual S computeTemperature(Cell<S,Descriptor> const& cell) const;
+    virtual void computePiNeq (
+        Cell<S,Descriptor> const& cell, Array<S,SymmetricTensor<S,Descriptor>::n>& PiNeq ) const;
+    virtual void computeShearStress (
+        Cell<S,Descriptor> const& cell, Array<S,SymmetricTensor<S,Descriptor>::n>& stress ) const;
+    virtual void computeHeatFlux( Cell<S,Descriptor> const& cell,
+                                  Array<S,Descriptor<S>::d>& q ) const;
+    /// User-defined moments are not forwarded: does nothing.
+    virtual void computeMoment( Cell<S,Descriptor> const& cell,
+                                plint momentId, S* moment ) const;
+
+/* *************** Access to Dynamics variables, e.g. omega ***************** */
+
+    virtual void setRelaxationFrequencies(Array<S, Descriptor<S>::q> const& frequencies);
+    virtual Array<S, Descriptor<S>::q> getRelaxationFrequencies() const;
+    virtual S getOmega() const;
+    virtual void setOmega(S omega_);
+    virtual S getParameter(plint whichParameter) const;
+    virtual S getDynamicParameter(plint whichParameter, Cell<S,Descriptor> const& cell) const;
+    virtual void setParameter(plint whichParameter, S value);
+
+/* *************** Switch between population and moment representation ****** */
+
+    virtual plint numDecomposedVariables(plint order) const;
+    virtual void decompose(Cell<S,Descriptor> const& cell, std::vector<S>& rawData, plint order) const;
+    virtual void recompose(Cell<S,Descriptor>& cell, std::vector<S> const& rawData, plint order) const;
+    virtual void rescale(std::vector<S>& rawData, S xDxInv, S xDt, plint order) const;
+    virtual void rescale(int dxScale, int dtScale);
+
+/* *************** Define macroscopic variables, e.g. on boundaries ********* */
+
+    virtual void defineDensity(Cell<S,Descriptor>& cell, S density);
+    virtual void defineVelocity(Cell<S,Descriptor>& cell, Array<S,Descriptor<S>::d> const& u);
+    virtual void defineTemperature(Cell<S,Descriptor>& cell, S temperature);
+    virtual void defineHeatFlux(Cell<S,Descriptor>& cell, Array<S,Descriptor<S>::d> const& q);
+    virtual void definePiNeq(Cell<S,Descriptor>& cell,
+                             Array<S,SymmetricTensor<S,Descriptor>::n> const& PiNeq);
+
+/* *************** Additional moments, intended for internal use ************ */
+
+    virtual S computeRhoBar(Cell<S,Descriptor> const& cell) const;
+    virtual void computeRhoBarJ(Cell<S,Descriptor> const& cell,
+                                S& rhoBar, Array<S,Descriptor<S>::d>& j) const;
+    virtual S computeEbar(Cell<S,Descriptor> const& cell) const;
+    virtual void computeRhoBarJPiNeq(Cell<S,Descriptor> const& cell,
+                                     S& rhoBar, Array<S,Descriptor<S>::d>& j,
+                                     Array<S,SymmetricTensor<S,Descriptor>::n>& PiNeq) const;
+private:
+    /// Copy populations, external scalars and statistics flag to a computation cell.
+    void toComputation(Cell<S,Descriptor> const& from, Cell<T,Descriptor>& to) const;
+    /// Round populations and external scalars back to the storage cell.
+    static void toStorage(Cell<T,Descriptor> const& from, Cell<S,Descriptor>& to);
+private:
+    Dynamics<T,Descriptor>* computationDynamics;
+    static int id;
+};
+
+}  // namespace plb
+
+#endif  // MIXED_PRECISION_DYNAMICS_H
@@ -0,0 +1,486 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Dynamics which store populations at a reduced precision and compute
+ * the collision at a higher precision -- generic implementation.
+ */
+#ifndef MIXED_PRECISION_DYNAMICS_HH
+#define MIXED_PRECISION_DYNAMICS_HH
+
+#include "basicDynamics/mixedPrecisionDynamics.h"
+#include "core/cell.h"
+#include "core/dynamicsIdentifiers.h"
+#include "core/hierarchicSerializer.h"
+#include "core/plbTypenames.h"
+#include <string>
+
+namespace plb {
+
+namespace mixedPrecision {
+
+template<typename T1, typename T2, pluint size>
+inline void convert(Array<T1,size> const& from, Array<T2,size>& to) {
+    for (pluint i=0; i<size; ++i) {
+        to[i] = (T2) from[i];
+    }
+}
+
+template<typename T1, typename T2>
+inline void convert(std::vector<T1> const& from, std::vector<T2>& to) {
+    to.resize(from.size());
+    for (pluint i=0; i<from.size(); ++i) {
+        to[i] = (T2) from[i];
+    }
+}
+
+}  // namespace mixedPrecision
+
+template<typename S, typename T, template<typename U> class Descriptor>
+int MixedPrecisionDynamics<S,T,Descriptor>::id =
+    meta::registerGeneralDynamics<S,Descriptor,MixedPrecisionDynamics<S,T,Descriptor> > (
+            std::string("MixedPrecision_")+NativeType<T>::getName() );
+
+template<typename S, typename T, template<typename U> class Descriptor>
+MixedPrecisionDynamics<S,T,Descriptor>::MixedPrecisionDynamics (
+        Dynamics<T,Descriptor>* computationDynamics_ )
+    : computationDynamics(computationDynamics_)
+{
+    PLB_PRECONDITION( computationDynamics );
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+MixedPrecisionDynamics<S,T,Descriptor>::MixedPrecisionDynamics (
+        HierarchicUnserializer& unserializer )
+    : computationDynamics(0)
+{
+    unserialize(unserializer);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+MixedPrecisionDynamics<S,T,Descriptor>::MixedPrecisionDynamics (
+        MixedPrecisionDynamics<S,T,Descriptor> const& rhs )
+    : Dynamics<S,Descriptor>(rhs),
+      computationDynamics(rhs.computationDynamics->clone())
+{ }
+
+template<typename S, typename T, template<typename U> class Descriptor>
+MixedPrecisionDynamics<S,T,Descriptor>& MixedPrecisionDynamics<S,T,Descriptor>::operator= (
+        MixedPrecisionDynamics<S,T,Descriptor> const& rhs )
+{
+    Dynamics<T,Descriptor>* newDynamics = rhs.computationDynamics->clone();
+    delete computationDynamics;
+    computationDynamics = newDynamics;
+    return *this;
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+MixedPrecisionDynamics<S,T,Descriptor>::~MixedPrecisionDynamics() {
+    delete computationDynamics;
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+MixedPrecisionDynamics<S,T,Descriptor>* MixedPrecisionDynamics<S,T,Descriptor>::clone() const {
+    return new MixedPrecisionDynamics<S,T,Descriptor>(*this);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+int MixedPrecisionDynamics<S,T,Descriptor>::getId() const {
+    return id;
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+bool MixedPrecisionDynamics<S,T,Descriptor>::velIsJ() const {
+    return computationDynamics->velIsJ();
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+bool MixedPrecisionDynamics<S,T,Descriptor>::isBoundary() const {
+    return computationDynamics->isBoundary();
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+bool MixedPrecisionDynamics<S,T,Descriptor>::isNonLocal() const {
+    return computationDynamics->isNonLocal();
+}
+
+/** The computation dynamics belongs to the registry of type T, and is therefore
+ *  serialized into a nested byte stream, which is stored as a value of the
+ *  present object.
+ */
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::serialize(HierarchicSerializer& serializer) const
+{
+    std::vector<char> nestedData;
+    plb::serialize(*computationDynamics, nestedData);
+    serializer.addValue((plint)nestedData.size());
+    serializer.addValues(nestedData);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::unserialize(HierarchicUnserializer& unserializer)
+{
+    std::vector<char> nestedData(unserializer.readValue<plint>());
+    unserializer.readValues(nestedData);
+    if (computationDynamics) {
+        plb::unserialize(*computationDynamics, nestedData, 0);
+    }
+    else {
+        HierarchicUnserializer nestedUnserializer(nestedData, 0);
+        computationDynamics = meta::dynamicsRegistration<T,Descriptor>().generate(nestedUnserializer);
+    }
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>& MixedPrecisionDynamics<S,T,Descriptor>::getComputationDynamics() {
+    return *computationDynamics;
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor> const& MixedPrecisionDynamics<S,T,Descriptor>::getComputationDynamics() const {
+    return *computationDynamics;
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::toComputation (
+        Cell<S,Descriptor> const& from, Cell<T,Descriptor>& to ) const
+{
+    mixedPrecision::convert(from.getRawPopulations(), to.getRawPopulations());
+    for (plint iExt=0; iExt<Descriptor<S>::ExternalField::numScalars; ++iExt) {
+        *to.getExternal(iExt) = (T) *from.getExternal(iExt);
+    }
+    to.specifyStatisticsStatus(from.takesStatistics());
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::toStorage (
+        Cell<T,Descriptor> const& from, Cell<S,Descriptor>& to )
+{
+    mixedPrecision::convert(from.getRawPopulations(), to.getRawPopulations());
+    for (plint iExt=0; iExt<Descriptor<S>::ExternalField::numScalars; ++iExt) {
+        *to.getExternal(iExt) = (S) *from.getExternal(iExt);
+    }
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::collide (
+        Cell<S,Descriptor>& cell, BlockStatistics& statistics )
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    computationDynamics->collide(computationCell, statistics);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::computeEquilibrium (
+        plint iPop, S rhoBar, Array<S,Descriptor<S>::d> const& j, S jSqr, S thetaBar ) const
+{
+    Array<T,Descriptor<T>::d> j_;
+    mixedPrecision::convert(j, j_);
+    return (S) computationDynamics->computeEquilibrium (
+            iPop, (T)rhoBar, j_, normSqr(j_), (T)thetaBar );
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::regularize (
+        Cell<S,Descriptor>& cell, S rhoBar, Array<S,Descriptor<S>::d> const& j,
+        S jSqr, Array<S,SymmetricTensor<S,Descriptor>::n> const& PiNeq, S thetaBar ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,Descriptor<T>::d> j_;
+    mixedPrecision::convert(j, j_);
+    Array<T,SymmetricTensor<T,Descriptor>::n> PiNeq_;
+    mixedPrecision::convert(PiNeq, PiNeq_);
+    computationDynamics->regularize(computationCell, (T)rhoBar, j_, normSqr(j_), PiNeq_, (T)thetaBar);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::computeDensity(Cell<S,Descriptor> const& cell) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    return (S) computationDynamics->computeDensity(computationCell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::computePressure(Cell<S,Descriptor> const& cell) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    return (S) computationDynamics->computePressure(computationCell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computeVelocity (
+        Cell<S,Descriptor> const& cell, Array<S,Descriptor<S>::d>& u ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,Descriptor<T>::d> u_;
+    computationDynamics->computeVelocity(computationCell, u_);
+    mixedPrecision::convert(u_, u);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::computeTemperature(Cell<S,Descriptor> const& cell) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    return (S) computationDynamics->computeTemperature(computationCell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computePiNeq (
+        Cell<S,Descriptor> const& cell, Array<S,SymmetricTensor<S,Descriptor>::n>& PiNeq ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,SymmetricTensor<T,Descriptor>::n> PiNeq_;
+    computationDynamics->computePiNeq(computationCell, PiNeq_);
+    mixedPrecision::convert(PiNeq_, PiNeq);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computeShearStress (
+        Cell<S,Descriptor> const& cell, Array<S,SymmetricTensor<S,Descriptor>::n>& stress ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,SymmetricTensor<T,Descriptor>::n> stress_;
+    computationDynamics->computeShearStress(computationCell, stress_);
+    mixedPrecision::convert(stress_, stress);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computeHeatFlux (
+        Cell<S,Descriptor> const& cell, Array<S,Descriptor<S>::d>& q ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,Descriptor<T>::d> q_;
+    computationDynamics->computeHeatFlux(computationCell, q_);
+    mixedPrecision::convert(q_, q);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computeMoment (
+        Cell<S,Descriptor> const& cell, plint momentId, S* moment ) const
+{ }
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::setRelaxationFrequencies (
+        Array<S, Descriptor<S>::q> const& frequencies )
+{
+    Array<T,Descriptor<T>::q> frequencies_;
+    mixedPrecision::convert(frequencies, frequencies_);
+    computationDynamics->setRelaxationFrequencies(frequencies_);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+Array<S, Descriptor<S>::q> MixedPrecisionDynamics<S,T,Descriptor>::getRelaxationFrequencies() const
+{
+    Array<S,Descriptor<S>::q> frequencies;
+    mixedPrecision::convert(computationDynamics->getRelaxationFrequencies(), frequencies);
+    return frequencies;
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::getOmega() const {
+    return (S) computationDynamics->getOmega();
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::setOmega(S omega_) {
+    computationDynamics->setOmega((T)omega_);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::getParameter(plint whichParameter) const {
+    return (S) computationDynamics->getParameter(whichParameter);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::getDynamicParameter (
+        plint whichParameter, Cell<S,Descriptor> const& cell ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    return (S) computationDynamics->getDynamicParameter(whichParameter, computationCell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::setParameter(plint whichParameter, S value) {
+    computationDynamics->setParameter(whichParameter, (T)value);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+plint MixedPrecisionDynamics<S,T,Descriptor>::numDecomposedVariables(plint order) const {
+    return computationDynamics->numDecomposedVariables(order);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::decompose (
+        Cell<S,Descriptor> const& cell, std::vector<S>& rawData, plint order ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    std::vector<T> rawData_;
+    computationDynamics->decompose(computationCell, rawData_, order);
+    mixedPrecision::convert(rawData_, rawData);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::recompose (
+        Cell<S,Descriptor>& cell, std::vector<S> const& rawData, plint order ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    std::vector<T> rawData_;
+    mixedPrecision::convert(rawData, rawData_);
+    computationDynamics->recompose(computationCell, rawData_, order);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::rescale (
+        std::vector<S>& rawData, S xDxInv, S xDt, plint order ) const
+{
+    std::vector<T> rawData_;
+    mixedPrecision::convert(rawData, rawData_);
+    computationDynamics->rescale(rawData_, (T)xDxInv, (T)xDt, order);
+    mixedPrecision::convert(rawData_, rawData);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::rescale(int dxScale, int dtScale) {
+    computationDynamics->rescale(dxScale, dtScale);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::defineDensity (
+        Cell<S,Descriptor>& cell, S density )
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    computationDynamics->defineDensity(computationCell, (T)density);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::defineVelocity (
+        Cell<S,Descriptor>& cell, Array<S,Descriptor<S>::d> const& u )
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,Descriptor<T>::d> u_;
+    mixedPrecision::convert(u, u_);
+    computationDynamics->defineVelocity(computationCell, u_);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::defineTemperature (
+        Cell<S,Descriptor>& cell, S temperature )
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    computationDynamics->defineTemperature(computationCell, (T)temperature);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::defineHeatFlux (
+        Cell<S,Descriptor>& cell, Array<S,Descriptor<S>::d> const& q )
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,Descriptor<T>::d> q_;
+    mixedPrecision::convert(q, q_);
+    computationDynamics->defineHeatFlux(computationCell, q_);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::definePiNeq (
+        Cell<S,Descriptor>& cell, Array<S,SymmetricTensor<S,Descriptor>::n> const& PiNeq )
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    Array<T,SymmetricTensor<T,Descriptor>::n> PiNeq_;
+    mixedPrecision::convert(PiNeq, PiNeq_);
+    computationDynamics->definePiNeq(computationCell, PiNeq_);
+    toStorage(computationCell, cell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::computeRhoBar(Cell<S,Descriptor> const& cell) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    return (S) computationDynamics->computeRhoBar(computationCell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computeRhoBarJ (
+        Cell<S,Descriptor> const& cell, S& rhoBar, Array<S,Descriptor<S>::d>& j ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    T rhoBar_;
+    Array<T,Descriptor<T>::d> j_;
+    computationDynamics->computeRhoBarJ(computationCell, rhoBar_, j_);
+    rhoBar = (S) rhoBar_;
+    mixedPrecision::convert(j_, j);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+S MixedPrecisionDynamics<S,T,Descriptor>::computeEbar(Cell<S,Descriptor> const& cell) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    return (S) computationDynamics->computeEbar(computationCell);
+}
+
+template<typename S, typename T, template<typename U> class Descriptor>
+void MixedPrecisionDynamics<S,T,Descriptor>::computeRhoBarJPiNeq (
+        Cell<S,Descriptor> const& cell, S& rhoBar, Array<S,Descriptor<S>::d>& j,
+        Array<S,SymmetricTensor<S,Descriptor>::n>& PiNeq ) const
+{
+    Cell<T,Descriptor> computationCell(computationDynamics);
+    toComputation(cell, computationCell);
+    T rhoBar_;
+    Array<T,Descriptor<T>::d> j_;
+    Array<T,SymmetricTensor<T,Descriptor>::n> PiNeq_;
+    computationDynamics->computeRhoBarJPiNeq(computationCell, rhoBar_, j_, PiNeq_);
+    rhoBar = (S) rhoBar_;
+    mixedPrecision::convert(j_, j);
+    mixedPrecision::convert(PiNeq_, PiNeq);
+}
+
+}  // namespace plb
+
+#endif  // MIXED_PRECISION_DYNAMICS_HH
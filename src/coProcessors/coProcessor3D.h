@@ -32,6 +32,7 @@
 #include "core/geometry3D.h"
 #include "atomicBlock/blockLattice3D.h"
 #include <map>
+#include <vector>
 
 namespace plb {
 
@@ -131,6 +132,40 @@ private:
 };
 
 
+/// A co-processor which runs on the CPU, with its own, compact representation
+///   of the data.
+/** The populations are stored in a structure-of-arrays layout (one contiguous
+ *  array per population), and the collision is formulated as loops over short
+ *  chunks of cells, so that the compiler can vectorize the BGK kernel. The
+ *  streaming step is a shifted copy of each population array. No dynamics
+ *  objects are involved, which makes this co-processor a fast path for blocks
+ *  which contain nothing else than BGK fluid cells.
+ **/
+template<typename T>
+class D3Q19CpuCoProcessor3D : public CoProcessor3D<T>
+{
+public:
+    virtual int addDomain(plint nx, plint ny, plint nz, T omega, int& domainHandle);
+    virtual int send(int domainHandle, Box3D const& subDomain, std::vector<char> const& data);
+    virtual int receive(int domainHandle, Box3D const& subDomain, std::vector<char>& data) const;
+    virtual int collideAndStream(int domainHandle);
+private:
+    struct Domain {
+        Domain(plint nx_, plint ny_, plint nz_, T omega_);
+        plint nCells() const { return nx*ny*nz; }
+        plint index(plint iX, plint iY, plint iZ) const { return iZ+nz*(iY+ny*iX); }
+        T* pop(plint iPop) { return &f[iPop*nCells()]; }
+        plint nx, ny, nz;
+        T omega;
+        std::vector<T> f, fTmp;
+    };
+    static void collide(Domain& domain);
+    static void stream(Domain& domain);
+private:
+    std::vector<Domain> domains;
+};
+
+
 template<typename T>
 class D3Q19CudaCoProcessor3D : public CoProcessor3D<T>
 {
@@ -177,10 +212,9 @@ namespace global {
 
 template<typename T>
 inline CoProcessor3D<T>& defaultCoProcessor3D() {
-    /// @Tomasz: At this stage, I'd suggest that you simply replace the
-    //  D3Q19ExampleCoProcessor3D singleton by a
-    //  D3Q19CudaCoProcessor3D singleton to get your code running.
-    static D3Q19CudaCoProcessor3D<T> singleton;
+    /// The CUDA co-processor is still a stub; swap the singleton for a
+    //  D3Q19CudaCoProcessor3D once the device code is available.
+    static D3Q19CpuCoProcessor3D<T> singleton;
     return singleton;
 };
 
@@ -27,6 +27,9 @@
 
 #include "coProcessors/coProcessor3D.h"
 #include "basicDynamics/isoThermalDynamics.h"
+#include "latticeBoltzmann/nearestNeighborLattices3D.h"
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 namespace plb {
@@ -77,6 +80,196 @@ int D3Q19ExampleCoProcessor3D<T>::collideAndStream(int domainHandle)
     return 1; // Success.
 }
 
+/* *************** Class D3Q19CpuCoProcessor3D ******************************** */
+
+template<typename T>
+D3Q19CpuCoProcessor3D<T>::Domain::Domain(plint nx_, plint ny_, plint nz_, T omega_)
+    : nx(nx_), ny(ny_), nz(nz_),
+      omega(omega_),
+      f(descriptors::D3Q19Descriptor<T>::q*nx_*ny_*nz_),
+      fTmp(f.size())
+{ }
+
+template<typename T>
+int D3Q19CpuCoProcessor3D<T>::addDomain(plint nx, plint ny, plint nz, T omega, int& domainHandle)
+{
+    PLB_ASSERT( domains.size() < (pluint)std::numeric_limits<int>::max() );
+    PLB_ASSERT( nx>=3 && ny>=3 && nz>=3 );
+    domainHandle = (int)domains.size();
+    domains.push_back(Domain(nx, ny, nz, omega));
+    return 1; // Success.
+}
+
+template<typename T>
+int D3Q19CpuCoProcessor3D<T>::send(int domainHandle, Box3D const& subDomain, std::vector<char> const& data)
+{
+    typedef descriptors::D3Q19Descriptor<T> D;
+    PLB_ASSERT( domainHandle>=0 && domainHandle<(int)domains.size() );
+    Domain& domain = domains[domainHandle];
+    PLB_ASSERT( subDomain.x0>=0 && subDomain.x1<domain.nx );
+    PLB_ASSERT( subDomain.y0>=0 && subDomain.y1<domain.ny );
+    PLB_ASSERT( subDomain.z0>=0 && subDomain.z1<domain.nz );
+    if ((plint)data.size() != subDomain.nCells()*D::q*(plint)sizeof(T)) {
+        return 0; // Failure.
+    }
+    plint nCells = domain.nCells();
+    T cellData[D::q];
+    char const* pos = data.empty() ? 0 : &data[0];
+    for (plint iX=subDomain.x0; iX<=subDomain.x1; ++iX) {
+        for (plint iY=subDomain.y0; iY<=subDomain.y1; ++iY) {
+            for (plint iZ=subDomain.z0; iZ<=subDomain.z1; ++iZ) {
+                memcpy((void*)cellData, (const void*)pos, D::q*sizeof(T));
+                pos += D::q*sizeof(T);
+                plint index = domain.index(iX,iY,iZ);
+                for (plint iPop=0; iPop<D::q; ++iPop) {
+                    domain.f[iPop*nCells+index] = cellData[iPop];
+                }
+            }
+        }
+    }
+    return 1; // Success.
+}
+
+template<typename T>
+int D3Q19CpuCoProcessor3D<T>::receive(int domainHandle, Box3D const& subDomain, std::vector<char>& data) const
+{
+    typedef descriptors::D3Q19Descriptor<T> D;
+    PLB_ASSERT( domainHandle>=0 && domainHandle<(int)domains.size() );
+    Domain const& domain = domains[domainHandle];
+    PLB_ASSERT( subDomain.x0>=0 && subDomain.x1<domain.nx );
+    PLB_ASSERT( subDomain.y0>=0 && subDomain.y1<domain.ny );
+    PLB_ASSERT( subDomain.z0>=0 && subDomain.z1<domain.nz );
+    data.resize(subDomain.nCells()*D::q*sizeof(T));
+    plint nCells = domain.nCells();
+    T cellData[D::q];
+    char* pos = data.empty() ? 0 : &data[0];
+    for (plint iX=subDomain.x0; iX<=subDomain.x1; ++iX) {
+        for (plint iY=subDomain.y0; iY<=subDomain.y1; ++iY) {
+            for (plint iZ=subDomain.z0; iZ<=subDomain.z1; ++iZ) {
+                plint index = domain.index(iX,iY,iZ);
+                for (plint iPop=0; iPop<D::q; ++iPop) {
+                    cellData[iPop] = domain.f[iPop*nCells+index];
+                }
+                memcpy((void*)pos, (const void*)cellData, D::q*sizeof(T));
+                pos += D::q*sizeof(T);
+            }
+        }
+    }
+    return 1; // Success.
+}
+
+template<typename T>
+int D3Q19CpuCoProcessor3D<T>::collideAndStream(int domainHandle)
+{
+    PLB_ASSERT( domainHandle>=0 && domainHandle<(int)domains.size() );
+    Domain& domain = domains[domainHandle];
+    collide(domain);
+    stream(domain);
+    return 1; // Success.
+}
+
+/// BGK collision, same arithmetics as dynamicsTemplates<T,D3Q19>::bgk_ma2_collision.
+/** The cells are processed in chunks: the moments of a chunk are accumulated
+ *  population by population into small local arrays, and each population array
+ *  is then relaxed in a separate loop. All inner loops have unit stride and no
+ *  dependencies, and are therefore vectorized by the compiler.
+ **/
+template<typename T>
+void D3Q19CpuCoProcessor3D<T>::collide(Domain& domain)
+{
+    typedef descriptors::D3Q19Descriptor<T> D;
+    static const plint chunkSize = 64;
+    T rhoBar[chunkSize], jX[chunkSize], jY[chunkSize], jZ[chunkSize];
+    T invRho[chunkSize], jSqr[chunkSize];
+    T omega = domain.omega;
+    T one_m_omega = (T)1 - omega;
+    plint nCells = domain.nCells();
+
+    for (plint start=0; start<nCells; start+=chunkSize) {
+        plint n = std::min(chunkSize, nCells-start);
+        for (plint k=0; k<n; ++k) {
+            rhoBar[k] = T();
+            jX[k] = T();
+            jY[k] = T();
+            jZ[k] = T();
+        }
+        for (plint iPop=0; iPop<D::q; ++iPop) {
+            T const* fi = domain.pop(iPop)+start;
+            T cx = (T)D::c[iPop][0];
+            T cy = (T)D::c[iPop][1];
+            T cz = (T)D::c[iPop][2];
+            for (plint k=0; k<n; ++k) {
+                rhoBar[k] += fi[k];
+                jX[k] += cx*fi[k];
+                jY[k] += cy*fi[k];
+                jZ[k] += cz*fi[k];
+            }
+        }
+        for (plint k=0; k<n; ++k) {
+            invRho[k] = (T)1 / (rhoBar[k] + (T)1);
+            jSqr[k] = jX[k]*jX[k] + jY[k]*jY[k] + jZ[k]*jZ[k];
+        }
+        for (plint iPop=0; iPop<D::q; ++iPop) {
+            T* fi = domain.pop(iPop)+start;
+            T cx = (T)D::c[iPop][0];
+            T cy = (T)D::c[iPop][1];
+            T cz = (T)D::c[iPop][2];
+            T t_omega = D::t[iPop]*omega;
+            for (plint k=0; k<n; ++k) {
+                T c_j = cx*jX[k] + cy*jY[k] + cz*jZ[k];
+                fi[k] = fi[k]*one_m_omega +
+                        t_omega * ( rhoBar[k] + (T)3*c_j +
+                                    invRho[k]*((T)4.5*c_j*c_j - (T)1.5*jSqr[k]) );
+            }
+        }
+    }
+}
+
+/// Streaming, implemented as a shifted copy of each population array.
+/** The one-cell layer at the border of the domain, which receives populations
+ *  from outside the domain, keeps its post-collision values.
+ **/
+template<typename T>
+void D3Q19CpuCoProcessor3D<T>::stream(Domain& domain)
+{
+    typedef descriptors::D3Q19Descriptor<T> D;
+    plint nx = domain.nx, ny = domain.ny, nz = domain.nz;
+    plint nCells = domain.nCells();
+    for (plint iPop=0; iPop<D::q; ++iPop) {
+        T const* src = &domain.f[iPop*nCells];
+        T* dst = &domain.fTmp[iPop*nCells];
+        plint shift = domain.index(D::c[iPop][0], D::c[iPop][1], D::c[iPop][2]);
+
+        // Outer layer: copy without streaming.
+        std::copy(src, src+ny*nz, dst);
+        std::copy(src+(nx-1)*ny*nz, src+nCells, dst+(nx-1)*ny*nz);
+        for (plint iX=1; iX<nx-1; ++iX) {
+            plint rowY0 = domain.index(iX,0,0);
+            plint rowY1 = domain.index(iX,ny-1,0);
+            std::copy(src+rowY0, src+rowY0+nz, dst+rowY0);
+            std::copy(src+rowY1, src+rowY1+nz, dst+rowY1);
+            for (plint iY=1; iY<ny-1; ++iY) {
+                plint row = domain.index(iX,iY,0);
+                dst[row] = src[row];
+                dst[row+nz-1] = src[row+nz-1];
+            }
+        }
+
+        // Bulk: pull from the upstream neighbor.
+        for (plint iX=1; iX<nx-1; ++iX) {
+            for (plint iY=1; iY<ny-1; ++iY) {
+                plint row = domain.index(iX,iY,0);
+                T const* from = src+row-shift;
+                T* to = dst+row;
+                for (plint iZ=1; iZ<nz-1; ++iZ) {
+                    to[iZ] = from[iZ];
+                }
+            }
+        }
+    }
+    domain.f.swap(domain.fTmp);
+}
+
 template<typename T>
 D3Q19CudaCoProcessor3D<T>::D3Q19CudaCoProcessor3D()
     {
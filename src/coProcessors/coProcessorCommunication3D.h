@@ -45,6 +45,27 @@ void transferToCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice);
 template<typename T, template<typename U> class Descriptor>
 void transferFromCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice);
 
+/// Send the envelopes of the CPU blocks to the co-processors.
+/** Together with transferEnvelopesFromCoProcessors(), this replaces the full
+ *  data transfer in the time loop, once the co-processors have been filled
+ *  with transferToCoProcessors(). A typical iteration reads:
+ *  \code
+ *  lattice.collideAndStream();
+ *  transferEnvelopesFromCoProcessors(lattice);
+ *  lattice.duplicateOverlaps(modif::staticVariables);
+ *  transferEnvelopesToCoProcessors(lattice);
+ *  \endcode
+ *  The interior of the CPU copy of a co-processor block is then out of date;
+ *  call transferFromCoProcessors() before accessing it (e.g. for output).
+ */
+template<typename T, template<typename U> class Descriptor>
+void transferEnvelopesToCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice);
+
+/// Copy the outer layers of the bulk of each co-processor block back to the
+///   CPU, for the neighboring blocks to pick them up in duplicateOverlaps().
+template<typename T, template<typename U> class Descriptor>
+void transferEnvelopesFromCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice);
+
 }  // namespace plb
 
 #endif  // CO_PROCESSOR_COMMUNICATION_3D_H
@@ -73,6 +73,60 @@ void transferFromCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice)
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void transferEnvelopesToCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice)
+{
+    MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+    ThreadAttribution const& threadAttribution = management.getThreadAttribution();
+    plint envelopeWidth = management.getEnvelopeWidth();
+
+    std::vector<char> data;
+    std::vector<Box3D> envelope;
+    for (pluint iBlock=0; iBlock<management.getLocalInfo().getBlocks().size(); ++iBlock) {
+        plint blockId = management.getLocalInfo().getBlocks()[iBlock];
+        plint handle = threadAttribution.getCoProcessorHandle(blockId);
+        if (handle>=0) {
+             BlockLattice3D<T,Descriptor>& component = lattice.getComponent(blockId);
+             Box3D bbox(component.getBoundingBox());
+             envelope.clear();
+             except(bbox, bbox.enlarge(-envelopeWidth), envelope);
+             for (pluint iBox=0; iBox<envelope.size(); ++iBox) {
+                 component.getDataTransfer().send (
+                         envelope[iBox], data, modif::staticVariables );
+                 global::defaultCoProcessor3D<T>().send (
+                         handle, envelope[iBox], data );
+             }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void transferEnvelopesFromCoProcessors(MultiBlockLattice3D<T,Descriptor>& lattice)
+{
+    MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+    ThreadAttribution const& threadAttribution = management.getThreadAttribution();
+    plint envelopeWidth = management.getEnvelopeWidth();
+
+    std::vector<char> data;
+    std::vector<Box3D> innerLayer;
+    for (pluint iBlock=0; iBlock<management.getLocalInfo().getBlocks().size(); ++iBlock) {
+        plint blockId = management.getLocalInfo().getBlocks()[iBlock];
+        plint handle = threadAttribution.getCoProcessorHandle(blockId);
+        if (handle>=0) {
+             BlockLattice3D<T,Descriptor>& component = lattice.getComponent(blockId);
+             Box3D bulk(component.getBoundingBox().enlarge(-envelopeWidth));
+             innerLayer.clear();
+             except(bulk, bulk.enlarge(-envelopeWidth), innerLayer);
+             for (pluint iBox=0; iBox<innerLayer.size(); ++iBox) {
+                 global::defaultCoProcessor3D<T>().receive (
+                         handle, innerLayer[iBox], data );
+                 component.getDataTransfer().receive (
+                         innerLayer[iBox], data, modif::staticVariables );
+             }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void initiateCoProcessors( MultiBlockLattice3D<T,Descriptor>& lattice,
                            plint dynamicsId, bool printInfo )
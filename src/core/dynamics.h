@@ -91,6 +91,10 @@ struct Dynamics {
     // Say if the dynamics has non-local components.
     virtual bool isNonLocal() const;
 
+    /// Say if the dynamics object holds no cell-specific state, so that a lattice
+    ///   can let all cells with identical content share a single instance.
+    virtual bool isShareable() const;
+
     /// Serialize the dynamics object.
     virtual void serialize(HierarchicSerializer& serializer) const;
     /// Un-Serialize the dynamics object.
@@ -655,6 +659,9 @@ public:
     /// BounceBack is a boundary.
     virtual bool isBoundary() const;
 
+    /// BounceBack has no cell-specific state.
+    virtual bool isShareable() const;
+
 /* *************** Additional moments, intended for internal use ************ */
 
     /// Yields fictitious density
@@ -765,6 +772,9 @@ public:
         Dynamics<T,Descriptor>::rescale(dxScale, dtScale);
     }
 
+    /// NoDynamics has no cell-specific state.
+    virtual bool isShareable() const;
+
 /* *************** Additional moments, intended for internal use ************ */
 
     /// Yields rho=1
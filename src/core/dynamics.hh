@@ -80,6 +80,11 @@ bool Dynamics<T,Descriptor>::isNonLocal() const {
     return false;
 }
 
+template<typename T, template<typename U> class Descriptor>
+bool Dynamics<T,Descriptor>::isShareable() const {
+    return false;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void Dynamics<T,Descriptor>::setRelaxationFrequencies(Array<T, Descriptor<T>::q> const& frequencies) {
     setOmega(frequencies[0]);
@@ -930,6 +935,11 @@ bool BounceBack<T,Descriptor>::isBoundary() const {
     return true;
 }
 
+template<typename T, template<typename U> class Descriptor>
+bool BounceBack<T,Descriptor>::isShareable() const {
+    return true;
+}
+
 /* *************** Class NoDynamics ********************************** */
 
 template<typename T, template<typename U> class Descriptor>
@@ -1106,6 +1116,11 @@ void NoDynamics<T,Descriptor>::rescale (
         std::vector<T>& rawData, T xDxInv, T xDt, plint order ) const
 { }
 
+template<typename T, template<typename U> class Descriptor>
+bool NoDynamics<T,Descriptor>::isShareable() const {
+    return true;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void constructIdChain(Dynamics<T,Descriptor> const& dynamics, std::vector<int>& chain)
 {
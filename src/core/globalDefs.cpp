@@ -23,6 +23,7 @@
 */
 
 #include "core/globalDefs.h"
+#include "core/plbDebug.h"
 
 namespace plb {
 
@@ -34,7 +35,9 @@ IOpolicyClass::IOpolicyClass()
       endianSwitchOnBase64in(false),
       stlLowerBoundFlag(false),
       stlLowerBound(-1.),
-      parallelIOflag(true)
+      parallelIOflag(true),
+      compressionLevel(0),
+      serializerMemoryBudget(48*1024*1024)
 { }
 
 void IOpolicyClass::setIndexOrderingForStreams(IndexOrdering::OrderingT streamOrdering_) {
@@ -85,6 +88,24 @@ bool IOpolicyClass::useParallelIO() const {
     return parallelIOflag;
 }
 
+void IOpolicyClass::setCompressionLevel(int level) {
+    PLB_ASSERT( level>=0 && level<=9 );
+    compressionLevel = level;
+}
+
+int IOpolicyClass::getCompressionLevel() const {
+    return compressionLevel;
+}
+
+void IOpolicyClass::setSerializerMemoryBudget(plint budget) {
+    PLB_ASSERT( budget>0 );
+    serializerMemoryBudget = budget;
+}
+
+plint IOpolicyClass::getSerializerMemoryBudget() const {
+    return serializerMemoryBudget;
+}
+
 /** Directories are default initialized to working directory.
  */
 Directories::Directories()
@@ -227,6 +227,17 @@ public:
 
     void activateParallelIO(bool activate);
     bool useParallelIO() const;
+
+    /// Compression level (0-9) of the data written by parallelIO::save,
+    ///   saveBinaryBlock and the VTK writers; 0 means no compression.
+    void setCompressionLevel(int level);
+    int getCompressionLevel() const;
+
+    /// Memory, in bytes, which the main processor may use to gather the data
+    ///   of a multi-block during serialization (e.g. saveBinaryBlock or VTK
+    ///   output). A larger budget means fewer, larger messages.
+    void setSerializerMemoryBudget(plint budget);
+    plint getSerializerMemoryBudget() const;
 private:
     IOpolicyClass();
 private:
@@ -236,6 +247,8 @@ private:
     bool stlLowerBoundFlag;
     double stlLowerBound;
     bool parallelIOflag;
+    int compressionLevel;
+    plint serializerMemoryBudget;
     friend IOpolicyClass& IOpolicy();
 };
     
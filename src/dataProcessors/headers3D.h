@@ -31,4 +31,5 @@
 #include "dataProcessors/dataInitializerWrapper3D.h"
 #include "dataProcessors/metaStuffFunctional3D.h"
 #include "dataProcessors/metaStuffWrapper3D.h"
+#include "dataProcessors/probeSet3D.h"
 
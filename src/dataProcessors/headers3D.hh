@@ -31,6 +31,7 @@
 #include "dataProcessors/dataInitializerWrapper3D.hh"
 #include "dataProcessors/metaStuffFunctional3D.hh"
 #include "dataProcessors/metaStuffWrapper3D.hh"
+#include "dataProcessors/probeSet3D.hh"
 // Include 2D versions, because they are required, for example to save 2D
 // images from 3D data.
 #include "dataProcessors/dataAnalysisFunctional2D.hh"
@@ -0,0 +1,91 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Batched evaluation of point probes on a multi-block lattice -- header file.
+ */
+
+#ifndef PROBE_SET_3D_H
+#define PROBE_SET_3D_H
+
+#include "core/globalDefs.h"
+#include "core/array.h"
+#include "core/cell.h"
+#include "multiBlock/multiBlockLattice3D.h"
+#include <vector>
+
+namespace plb {
+
+/// A fixed set of probe locations on a multi-block lattice.
+/** The owning block and the local coordinates of each probe are resolved once,
+ *  at construction. Each evaluation then visits the local probes in a single
+ *  pass, and combines the results of all processes with one collective
+ *  reduction. The locations are given in lattice units. With interpolation,
+ *  the eight surrounding cells are weighted trilinearly (this requires the
+ *  envelope to be up-to-date); otherwise the nearest cell is used.
+ *  Probes outside the allocated domain yield zero.
+ *
+ *  The resolution is tied to the data distribution of the lattice. It must
+ *  be recomputed (i.e. a new probe set must be created) after the lattice
+ *  has been redistributed, which is signaled by a change of
+ *  MultiBlock3D::getGeneration().
+ */
+template<typename T, template<typename U> class Descriptor>
+class LatticeProbeSet3D {
+public:
+    LatticeProbeSet3D( MultiBlockLattice3D<T,Descriptor> const& lattice,
+                       std::vector<Array<T,3> > const& positions_,
+                       bool interpolate_=true );
+    plint getNumProbes() const;
+    std::vector<Array<T,3> > const& getPositions() const;
+    /// Number of probes which are evaluated by the current process.
+    plint getNumLocalProbes() const;
+    std::vector<T> computeDensities(MultiBlockLattice3D<T,Descriptor>& lattice) const;
+    std::vector<Array<T,3> > computeVelocities(MultiBlockLattice3D<T,Descriptor>& lattice) const;
+private:
+    typedef void (*CellSampler)(Cell<T,Descriptor> const& cell, T* result);
+    /// Evaluate a cell quantity with dim components on all probes.
+    void sample (
+        MultiBlockLattice3D<T,Descriptor>& lattice, plint dim,
+        CellSampler sampler, std::vector<T>& result ) const;
+    static void sampleDensity(Cell<T,Descriptor> const& cell, T* result);
+    static void sampleVelocity(Cell<T,Descriptor> const& cell, T* result);
+private:
+    /// A probe in the bulk of a local block, and the cells it reads from.
+    struct LocalProbe {
+        plint probeId;
+        plint blockId;
+        plint numCells;
+        Array<Dot3D,8> cells;
+        Array<T,8> weights;
+    };
+    std::vector<Array<T,3> > positions;
+    bool interpolate;
+    /// Local probes, sorted by block.
+    std::vector<LocalProbe> localProbes;
+};
+
+}  // namespace plb
+
+#endif  // PROBE_SET_3D_H
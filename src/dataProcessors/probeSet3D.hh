@@ -0,0 +1,196 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Batched evaluation of point probes on a multi-block lattice -- generic implementation.
+ */
+
+#ifndef PROBE_SET_3D_HH
+#define PROBE_SET_3D_HH
+
+#include "dataProcessors/probeSet3D.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "atomicBlock/blockLattice3D.h"
+#include "parallelism/mpiManager.h"
+#include "core/util.h"
+#include <algorithm>
+#include <cmath>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+LatticeProbeSet3D<T,Descriptor>::LatticeProbeSet3D (
+        MultiBlockLattice3D<T,Descriptor> const& lattice,
+        std::vector<Array<T,3> > const& positions_, bool interpolate_ )
+    : positions(positions_),
+      interpolate(interpolate_)
+{
+    MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+
+    // Local probes are appended block by block, so that evaluation accesses
+    //   each block in one go.
+    std::vector<std::vector<LocalProbe> > probesPerBlock;
+    std::vector<plint> blockIds;
+    for (pluint iProbe=0; iProbe<positions.size(); ++iProbe) {
+        Array<T,3> const& position = positions[iProbe];
+        LocalProbe probe;
+        probe.probeId = (plint)iProbe;
+        Dot3D reference;
+        if (interpolate) {
+            reference = Dot3D( (plint)std::floor(position[0]),
+                               (plint)std::floor(position[1]),
+                               (plint)std::floor(position[2]) );
+        }
+        else {
+            reference = Dot3D( (plint)util::roundToInt(position[0]),
+                               (plint)util::roundToInt(position[1]),
+                               (plint)util::roundToInt(position[2]) );
+        }
+        probe.blockId = sparseBlock.locate(reference.x, reference.y, reference.z);
+        if (probe.blockId<0 || !attribution.isLocal(probe.blockId)) {
+            continue;
+        }
+        SmartBulk3D bulk(management, probe.blockId);
+        Dot3D local(bulk.toLocalX(reference.x), bulk.toLocalY(reference.y),
+                    bulk.toLocalZ(reference.z));
+        if (interpolate) {
+            T u = position[0]-(T)reference.x;
+            T v = position[1]-(T)reference.y;
+            T w = position[2]-(T)reference.z;
+            probe.numCells = 8;
+            for (plint iCell=0; iCell<8; ++iCell) {
+                plint dx = (iCell>>2)&1, dy = (iCell>>1)&1, dz = iCell&1;
+                probe.cells[iCell] = local + Dot3D(dx,dy,dz);
+                probe.weights[iCell] = (dx ? u : (T)1-u) *
+                                       (dy ? v : (T)1-v) *
+                                       (dz ? w : (T)1-w);
+            }
+        }
+        else {
+            probe.numCells = 1;
+            probe.cells[0] = local;
+            probe.weights[0] = (T)1;
+        }
+        std::vector<plint>::iterator it = std::find(blockIds.begin(), blockIds.end(), probe.blockId);
+        if (it==blockIds.end()) {
+            blockIds.push_back(probe.blockId);
+            probesPerBlock.push_back(std::vector<LocalProbe>());
+            probesPerBlock.back().push_back(probe);
+        }
+        else {
+            probesPerBlock[it-blockIds.begin()].push_back(probe);
+        }
+    }
+    for (pluint iBlock=0; iBlock<probesPerBlock.size(); ++iBlock) {
+        localProbes.insert(localProbes.end(), probesPerBlock[iBlock].begin(),
+                           probesPerBlock[iBlock].end());
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint LatticeProbeSet3D<T,Descriptor>::getNumProbes() const {
+    return (plint)positions.size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+std::vector<Array<T,3> > const& LatticeProbeSet3D<T,Descriptor>::getPositions() const {
+    return positions;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint LatticeProbeSet3D<T,Descriptor>::getNumLocalProbes() const {
+    return (plint)localProbes.size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeProbeSet3D<T,Descriptor>::sample (
+        MultiBlockLattice3D<T,Descriptor>& lattice, plint dim,
+        CellSampler sampler, std::vector<T>& result ) const
+{
+    result.assign(positions.size()*dim, T());
+    std::vector<T> cellResult(dim);
+    BlockLattice3D<T,Descriptor>* block = 0;
+    plint currentBlockId = -1;
+    for (pluint iProbe=0; iProbe<localProbes.size(); ++iProbe) {
+        LocalProbe const& probe = localProbes[iProbe];
+        if (probe.blockId != currentBlockId) {
+            currentBlockId = probe.blockId;
+            block = &lattice.getComponent(currentBlockId);
+        }
+        T* probeResult = &result[probe.probeId*dim];
+        for (plint iCell=0; iCell<probe.numCells; ++iCell) {
+            Dot3D const& pos = probe.cells[iCell];
+            sampler(block->get(pos.x,pos.y,pos.z), &cellResult[0]);
+            for (plint iDim=0; iDim<dim; ++iDim) {
+                probeResult[iDim] += probe.weights[iCell]*cellResult[iDim];
+            }
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    // Each probe is evaluated by exactly one process.
+    global::mpi().allReduceVect(result, MPI_SUM);
+#endif
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeProbeSet3D<T,Descriptor>::sampleDensity(Cell<T,Descriptor> const& cell, T* result)
+{
+    result[0] = cell.computeDensity();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeProbeSet3D<T,Descriptor>::sampleVelocity(Cell<T,Descriptor> const& cell, T* result)
+{
+    Array<T,3> u;
+    cell.computeVelocity(u);
+    u.to_cArray(result);
+}
+
+template<typename T, template<typename U> class Descriptor>
+std::vector<T> LatticeProbeSet3D<T,Descriptor>::computeDensities (
+        MultiBlockLattice3D<T,Descriptor>& lattice ) const
+{
+    std::vector<T> densities;
+    sample(lattice, 1, sampleDensity, densities);
+    return densities;
+}
+
+template<typename T, template<typename U> class Descriptor>
+std::vector<Array<T,3> > LatticeProbeSet3D<T,Descriptor>::computeVelocities (
+        MultiBlockLattice3D<T,Descriptor>& lattice ) const
+{
+    std::vector<T> data;
+    sample(lattice, 3, sampleVelocity, data);
+    std::vector<Array<T,3> > velocities(positions.size());
+    for (pluint iProbe=0; iProbe<positions.size(); ++iProbe) {
+        velocities[iProbe].from_cArray(&data[3*iProbe]);
+    }
+    return velocities;
+}
+
+}  // namespace plb
+
+#endif  // PROBE_SET_3D_HH
@@ -0,0 +1,802 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Compression in the zlib format (RFC 1950/1951), implemented without
+ * external dependencies, and filters which prepare numerical data for it.
+ */
+
+#include "io/compression.h"
+#include "core/runTimeDiagnostics.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace plb {
+
+namespace {
+
+const plint windowSize     = 32768;
+const plint minMatchLength = 3;
+const plint maxMatchLength = 258;
+const plint hashBits       = 15;
+const plint hashSize       = 1<<hashBits;
+const pluint maxBlockSymbols = 1<<15;
+const pluint maxStoredLength = 65535;
+
+const plint numLiteralCodes  = 286;
+const plint numDistanceCodes = 30;
+const plint numLengthCodes   = 19;
+
+const plint lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const int lengthExtraBits[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const plint distanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const int distanceExtraBits[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+/// Order in which the lengths of the code-length alphabet are transmitted.
+const plint lengthCodeOrder[numLengthCodes] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+/// Output of the LZ77 stage: a literal (distance==0) or a back-reference.
+struct LzSymbol {
+    LzSymbol(plint litLen_, plint distance_)
+        : litLen((unsigned short)litLen_), distance((unsigned short)distance_)
+    { }
+    unsigned short litLen;
+    unsigned short distance;
+};
+
+plint lengthCode(plint length) {
+    return std::upper_bound(lengthBase, lengthBase+29, length) - lengthBase - 1;
+}
+
+plint distanceCode(plint distance) {
+    return std::upper_bound(distanceBase, distanceBase+30, distance) - distanceBase - 1;
+}
+
+/// Deflate streams are written least significant bit first.
+class BitWriter {
+public:
+    BitWriter(std::vector<char>& out_)
+        : out(out_), buffer(0), numBits(0)
+    { }
+    void write(pluint bits, int length) {
+        buffer |= bits << numBits;
+        numBits += length;
+        while (numBits>=8) {
+            out.push_back((char)(buffer & 0xFF));
+            buffer >>= 8;
+            numBits -= 8;
+        }
+    }
+    void alignToByte() {
+        if (numBits>0) {
+            out.push_back((char)(buffer & 0xFF));
+            buffer = 0;
+            numBits = 0;
+        }
+    }
+private:
+    std::vector<char>& out;
+    pluint buffer;
+    int numBits;
+};
+
+/// Huffman code lengths for the given frequencies, limited to maxLength bits.
+/** At least two symbols are given a code, as some decoders reject trees
+ *  with a single code.
+ */
+void computeCodeLengths(std::vector<pluint> freq, int maxLength, std::vector<int>& lengths)
+{
+    plint numSymbols = (plint)freq.size();
+    plint numUsed = 0;
+    for (plint i=0; i<numSymbols; ++i) {
+        if (freq[i]>0) ++numUsed;
+    }
+    for (plint i=0; i<numSymbols && numUsed<2; ++i) {
+        if (freq[i]==0) {
+            freq[i] = 1;
+            ++numUsed;
+        }
+    }
+
+    while (true) {
+        // Nodes 0..numSymbols-1 are leaves, the following ones internal nodes.
+        typedef std::pair<pluint,plint> Node;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node> > queue;
+        std::vector<plint> parent(2*numSymbols, -1);
+        for (plint i=0; i<numSymbols; ++i) {
+            if (freq[i]>0) queue.push(Node(freq[i], i));
+        }
+        plint nextNode = numSymbols;
+        while (queue.size()>1) {
+            Node a = queue.top(); queue.pop();
+            Node b = queue.top(); queue.pop();
+            parent[a.second] = nextNode;
+            parent[b.second] = nextNode;
+            queue.push(Node(a.first+b.first, nextNode));
+            ++nextNode;
+        }
+        // Parents always have a larger index than their children.
+        std::vector<int> depth(nextNode, 0);
+        for (plint node=nextNode-2; node>=0; --node) {
+            if (parent[node]>=0) depth[node] = depth[parent[node]]+1;
+        }
+        lengths.assign(numSymbols, 0);
+        int longest = 0;
+        for (plint i=0; i<numSymbols; ++i) {
+            if (freq[i]>0) {
+                lengths[i] = depth[i];
+                longest = std::max(longest, depth[i]);
+            }
+        }
+        if (longest<=maxLength) break;
+        // Flatten the distribution and try again.
+        for (plint i=0; i<numSymbols; ++i) {
+            if (freq[i]>0) freq[i] = (freq[i]+1)/2;
+        }
+    }
+}
+
+/// Canonical Huffman codes, as specified in RFC 1951, section 3.2.2. The codes
+///   are returned bit-reversed, because Huffman codes are defined most significant
+///   bit first, while the rest of the stream is least significant bit first.
+void computeCanonicalCodes(std::vector<int> const& lengths, std::vector<pluint>& codes)
+{
+    int maxLength = *std::max_element(lengths.begin(), lengths.end());
+    std::vector<pluint> lengthCount(maxLength+1, 0);
+    for (pluint i=0; i<lengths.size(); ++i) {
+        if (lengths[i]>0) ++lengthCount[lengths[i]];
+    }
+    std::vector<pluint> nextCode(maxLength+1, 0);
+    pluint code = 0;
+    for (int bits=1; bits<=maxLength; ++bits) {
+        code = (code + lengthCount[bits-1]) << 1;
+        nextCode[bits] = code;
+    }
+    codes.assign(lengths.size(), 0);
+    for (pluint i=0; i<lengths.size(); ++i) {
+        if (lengths[i]>0) {
+            pluint code = nextCode[lengths[i]]++;
+            for (int bit=0; bit<lengths[i]; ++bit) {
+                codes[i] = (codes[i]<<1) | ((code>>bit) & 1);
+            }
+        }
+    }
+}
+
+void computeFixedLengths(std::vector<int>& literalLengths, std::vector<int>& distanceLengths)
+{
+    literalLengths.resize(288);
+    for (plint i=0;   i<144; ++i) literalLengths[i] = 8;
+    for (plint i=144; i<256; ++i) literalLengths[i] = 9;
+    for (plint i=256; i<280; ++i) literalLengths[i] = 7;
+    for (plint i=280; i<288; ++i) literalLengths[i] = 8;
+    distanceLengths.assign(numDistanceCodes, 5);
+}
+
+/// Run-length encoding of the concatenated literal and distance code lengths
+///   with the symbols 16 (repeat previous), 17 and 18 (repeat zero).
+void encodeCodeLengths(std::vector<int> const& lengths,
+                       std::vector<std::pair<int,int> >& rle)
+{
+    rle.clear();
+    pluint i = 0;
+    while (i<lengths.size()) {
+        int length = lengths[i];
+        pluint run = 1;
+        while (i+run<lengths.size() && lengths[i+run]==length) ++run;
+        if (length==0) {
+            pluint remaining = run;
+            while (remaining>=11) {
+                pluint chunk = std::min(remaining, (pluint)138);
+                rle.push_back(std::make_pair(18, (int)chunk-11));
+                remaining -= chunk;
+            }
+            if (remaining>=3) {
+                rle.push_back(std::make_pair(17, (int)remaining-3));
+                remaining = 0;
+            }
+            for (; remaining>0; --remaining) rle.push_back(std::make_pair(0, 0));
+        }
+        else {
+            rle.push_back(std::make_pair(length, 0));
+            pluint remaining = run-1;
+            while (remaining>=3) {
+                pluint chunk = std::min(remaining, (pluint)6);
+                rle.push_back(std::make_pair(16, (int)chunk-3));
+                remaining -= chunk;
+            }
+            for (; remaining>0; --remaining) rle.push_back(std::make_pair(length, 0));
+        }
+        i += run;
+    }
+}
+
+int rleExtraBits(int symbol) {
+    return symbol==16 ? 2 : (symbol==17 ? 3 : (symbol==18 ? 7 : 0));
+}
+
+class DeflateEncoder {
+public:
+    DeflateEncoder(std::vector<char>& out, int level_)
+        : writer(out), level(level_)
+    { }
+    void compress(unsigned char const* data, pluint size);
+private:
+    void writeBlock ( unsigned char const* data, pluint blockBegin, pluint blockEnd,
+                      std::vector<LzSymbol> const& symbols, bool last );
+    void writeStored(unsigned char const* data, pluint blockBegin, pluint blockEnd, bool last);
+    void writeSymbols ( std::vector<LzSymbol> const& symbols,
+                        std::vector<int> const& literalLengths,
+                        std::vector<int> const& distanceLengths );
+private:
+    BitWriter writer;
+    int level;
+};
+
+void DeflateEncoder::compress(unsigned char const* data, pluint size)
+{
+    if (level<=0 || size==0) {
+        writeStored(data, 0, size, true);
+        writer.alignToByte();
+        return;
+    }
+    // Length of the hash chains which are searched, and match length beyond
+    // which the search is abandoned, as a function of the compression level.
+    static const plint maxChainLengths[10] = { 0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096 };
+    static const plint niceLengths[10]     = { 0, 8, 16, 32, 64, 128, 128, 258, 258, 258 };
+    plint maxChain = maxChainLengths[std::min(level,9)];
+    plint niceLength = niceLengths[std::min(level,9)];
+
+    std::vector<plint> head(hashSize, -1);
+    std::vector<plint> previous(windowSize, -1);
+    std::vector<LzSymbol> symbols;
+    symbols.reserve(maxBlockSymbols);
+
+    plint numBytes = (plint)size;
+    pluint blockBegin = 0;
+    plint pos = 0;
+    while (pos<numBytes) {
+        plint bestLength = 0, bestDistance = 0;
+        if (pos+minMatchLength<=numBytes) {
+            plint hash = ( (data[pos]<<10) ^ (data[pos+1]<<5) ^ data[pos+2] ) & (hashSize-1);
+            plint maxLength = std::min(maxMatchLength, numBytes-pos);
+            plint goodEnough = std::min(niceLength, maxLength);
+            plint candidate = head[hash];
+            for (plint chain=0; chain<maxChain && candidate>=0 && pos-candidate<=windowSize; ++chain) {
+                if (data[candidate+bestLength]==data[pos+bestLength]) {
+                    plint length = 0;
+                    while (length<maxLength && data[candidate+length]==data[pos+length]) ++length;
+                    if (length>bestLength) {
+                        bestLength = length;
+                        bestDistance = pos-candidate;
+                        if (length>=goodEnough) break;
+                    }
+                }
+                candidate = previous[candidate & (windowSize-1)];
+            }
+            previous[pos & (windowSize-1)] = head[hash];
+            head[hash] = pos;
+        }
+        if (bestLength>=minMatchLength) {
+            symbols.push_back(LzSymbol(bestLength, bestDistance));
+            // Register all strings inside the match, for future references.
+            for (plint i=pos+1; i<pos+bestLength && i+minMatchLength<=numBytes; ++i) {
+                plint hash = ( (data[i]<<10) ^ (data[i+1]<<5) ^ data[i+2] ) & (hashSize-1);
+                previous[i & (windowSize-1)] = head[hash];
+                head[hash] = i;
+            }
+            pos += bestLength;
+        }
+        else {
+            symbols.push_back(LzSymbol(data[pos], 0));
+            ++pos;
+        }
+        if (symbols.size()>=maxBlockSymbols || pos==numBytes) {
+            writeBlock(data, blockBegin, (pluint)pos, symbols, pos==numBytes);
+            blockBegin = (pluint)pos;
+            symbols.clear();
+        }
+    }
+    writer.alignToByte();
+}
+
+void DeflateEncoder::writeBlock ( unsigned char const* data, pluint blockBegin, pluint blockEnd,
+                                  std::vector<LzSymbol> const& symbols, bool last )
+{
+    std::vector<pluint> literalFreq(numLiteralCodes, 0);
+    std::vector<pluint> distanceFreq(numDistanceCodes, 0);
+    pluint extraBits = 0;
+    for (pluint i=0; i<symbols.size(); ++i) {
+        if (symbols[i].distance==0) {
+            ++literalFreq[symbols[i].litLen];
+        }
+        else {
+            plint lCode = lengthCode(symbols[i].litLen);
+            plint dCode = distanceCode(symbols[i].distance);
+            ++literalFreq[257+lCode];
+            ++distanceFreq[dCode];
+            extraBits += lengthExtraBits[lCode] + distanceExtraBits[dCode];
+        }
+    }
+    ++literalFreq[256];
+
+    // Dynamic Huffman codes, with their header.
+    std::vector<int> literalLengths, distanceLengths;
+    computeCodeLengths(literalFreq, 15, literalLengths);
+    computeCodeLengths(distanceFreq, 15, distanceLengths);
+    plint numLiterals = numLiteralCodes;
+    while (numLiterals>257 && literalLengths[numLiterals-1]==0) --numLiterals;
+    plint numDistances = numDistanceCodes;
+    while (numDistances>1 && distanceLengths[numDistances-1]==0) --numDistances;
+
+    std::vector<int> allLengths(literalLengths.begin(), literalLengths.begin()+numLiterals);
+    allLengths.insert(allLengths.end(), distanceLengths.begin(), distanceLengths.begin()+numDistances);
+    std::vector<std::pair<int,int> > rle;
+    encodeCodeLengths(allLengths, rle);
+    std::vector<pluint> lengthCodeFreq(numLengthCodes, 0);
+    for (pluint i=0; i<rle.size(); ++i) {
+        ++lengthCodeFreq[rle[i].first];
+    }
+    std::vector<int> lengthCodeLengths;
+    computeCodeLengths(lengthCodeFreq, 7, lengthCodeLengths);
+    plint numLengthCodesUsed = numLengthCodes;
+    while (numLengthCodesUsed>4 && lengthCodeLengths[lengthCodeOrder[numLengthCodesUsed-1]]==0) {
+        --numLengthCodesUsed;
+    }
+
+    pluint dynamicBits = 3 + 5 + 5 + 4 + 3*numLengthCodesUsed + extraBits;
+    for (pluint i=0; i<rle.size(); ++i) {
+        dynamicBits += lengthCodeLengths[rle[i].first] + rleExtraBits(rle[i].first);
+    }
+    std::vector<int> fixedLiteralLengths, fixedDistanceLengths;
+    computeFixedLengths(fixedLiteralLengths, fixedDistanceLengths);
+    pluint fixedBits = 3 + extraBits;
+    for (plint i=0; i<numLiteralCodes; ++i) {
+        dynamicBits += literalFreq[i]*literalLengths[i];
+        fixedBits += literalFreq[i]*fixedLiteralLengths[i];
+    }
+    for (plint i=0; i<numDistanceCodes; ++i) {
+        dynamicBits += distanceFreq[i]*distanceLengths[i];
+        fixedBits += distanceFreq[i]*fixedDistanceLengths[i];
+    }
+    pluint storedBits = 8*(blockEnd-blockBegin) +
+                        40*((blockEnd-blockBegin)/maxStoredLength+1);
+
+    if (storedBits<=dynamicBits && storedBits<=fixedBits) {
+        writeStored(data, blockBegin, blockEnd, last);
+    }
+    else if (fixedBits<=dynamicBits) {
+        writer.write(last ? 1 : 0, 1);
+        writer.write(1, 2);
+        writeSymbols(symbols, fixedLiteralLengths, fixedDistanceLengths);
+    }
+    else {
+        writer.write(last ? 1 : 0, 1);
+        writer.write(2, 2);
+        writer.write(numLiterals-257, 5);
+        writer.write(numDistances-1, 5);
+        writer.write(numLengthCodesUsed-4, 4);
+        for (plint i=0; i<numLengthCodesUsed; ++i) {
+            writer.write(lengthCodeLengths[lengthCodeOrder[i]], 3);
+        }
+        std::vector<pluint> lengthCodes;
+        computeCanonicalCodes(lengthCodeLengths, lengthCodes);
+        for (pluint i=0; i<rle.size(); ++i) {
+            int symbol = rle[i].first;
+            writer.write(lengthCodes[symbol], lengthCodeLengths[symbol]);
+            if (rleExtraBits(symbol)>0) {
+                writer.write(rle[i].second, rleExtraBits(symbol));
+            }
+        }
+        writeSymbols(symbols, literalLengths, distanceLengths);
+    }
+}
+
+void DeflateEncoder::writeStored(unsigned char const* data, pluint blockBegin, pluint blockEnd, bool last)
+{
+    do {
+        pluint length = std::min(blockEnd-blockBegin, maxStoredLength);
+        bool lastChunk = last && blockBegin+length==blockEnd;
+        writer.write(lastChunk ? 1 : 0, 1);
+        writer.write(0, 2);
+        writer.alignToByte();
+        writer.write(length, 16);
+        writer.write(~length & 0xFFFF, 16);
+        for (pluint i=0; i<length; ++i) {
+            writer.write(data[blockBegin+i], 8);
+        }
+        blockBegin += length;
+    } while (blockBegin<blockEnd);
+}
+
+void DeflateEncoder::writeSymbols ( std::vector<LzSymbol> const& symbols,
+                                    std::vector<int> const& literalLengths,
+                                    std::vector<int> const& distanceLengths )
+{
+    std::vector<pluint> literalCodes, distanceCodes;
+    computeCanonicalCodes(literalLengths, literalCodes);
+    computeCanonicalCodes(distanceLengths, distanceCodes);
+    for (pluint i=0; i<symbols.size(); ++i) {
+        if (symbols[i].distance==0) {
+            plint literal = symbols[i].litLen;
+            writer.write(literalCodes[literal], literalLengths[literal]);
+        }
+        else {
+            plint length = symbols[i].litLen;
+            plint distance = symbols[i].distance;
+            plint lCode = lengthCode(length);
+            plint dCode = distanceCode(distance);
+            writer.write(literalCodes[257+lCode], literalLengths[257+lCode]);
+            writer.write(length-lengthBase[lCode], lengthExtraBits[lCode]);
+            writer.write(distanceCodes[dCode], distanceLengths[dCode]);
+            writer.write(distance-distanceBase[dCode], distanceExtraBits[dCode]);
+        }
+    }
+    writer.write(literalCodes[256], literalLengths[256]);
+}
+
+/// Reads a deflate stream least significant bit first. Reading beyond the
+///   end of the stream yields zeros; the caller checks for overruns.
+class BitReader {
+public:
+    BitReader(unsigned char const* data_, pluint size_)
+        : data(data_), size(size_), pos(0), buffer(0), numBits(0)
+    { }
+    pluint peek(int length) {
+        if (numBits<length) refill();
+        return (pluint)(buffer & ((1ULL<<length)-1));
+    }
+    void consume(int length) {
+        buffer >>= length;
+        numBits -= length;
+    }
+    pluint read(int length) {
+        pluint bits = peek(length);
+        consume(length);
+        return bits;
+    }
+    void alignToByte() {
+        consume(numBits % 8);
+    }
+    /// True if more bits were consumed than the stream contains.
+    bool overrun() const {
+        return pos*8 > size*8 + (pluint)numBits;
+    }
+    /// Number of bytes consumed so far.
+    pluint bytesConsumed() const {
+        return pos - numBits/8;
+    }
+private:
+    void refill() {
+        while (numBits<=56) {
+            unsigned long long byte = pos<size ? data[pos] : 0;
+            buffer |= byte << numBits;
+            ++pos;
+            numBits += 8;
+        }
+    }
+private:
+    unsigned char const* data;
+    pluint size, pos;
+    unsigned long long buffer;
+    int numBits;
+};
+
+/// Lookup table for the decoding of a canonical Huffman code: it is indexed
+///   by the next maxCodeLength bits of the stream, and yields the symbol
+///   and the length of its code.
+class HuffmanDecoder {
+public:
+    static const int maxCodeLength = 15;
+    HuffmanDecoder(std::vector<int> const& lengths)
+        : table(1<<maxCodeLength, -1)
+    {
+        std::vector<pluint> codes;
+        computeCanonicalCodes(lengths, codes);
+        for (pluint symbol=0; symbol<lengths.size(); ++symbol) {
+            int length = lengths[symbol];
+            if (length>0) {
+                for (pluint i=codes[symbol]; i<table.size(); i += (pluint)1<<length) {
+                    table[i] = (int)(symbol<<4) | length;
+                }
+            }
+        }
+    }
+    int decode(BitReader& reader) const {
+        int entry = table[reader.peek(maxCodeLength)];
+        if (entry<0) {
+            plbIOError("Invalid Huffman code in compressed stream.");
+        }
+        reader.consume(entry & 15);
+        return entry>>4;
+    }
+private:
+    std::vector<int> table;
+};
+
+void inflateBlock ( BitReader& reader, HuffmanDecoder const& literals,
+                    HuffmanDecoder const& distances, std::vector<char>& out, pluint outBegin )
+{
+    while (true) {
+        int symbol = literals.decode(reader);
+        if (symbol<256) {
+            out.push_back((char)symbol);
+        }
+        else if (symbol==256) {
+            return;
+        }
+        else {
+            plint lCode = symbol-257;
+            if (lCode>=29) plbIOError("Invalid length code in compressed stream.");
+            plint length = lengthBase[lCode] + (plint)reader.read(lengthExtraBits[lCode]);
+            int dCode = distances.decode(reader);
+            if (dCode>=numDistanceCodes) plbIOError("Invalid distance code in compressed stream.");
+            plint distance = distanceBase[dCode] + (plint)reader.read(distanceExtraBits[dCode]);
+            if (distance > (plint)(out.size()-outBegin)) {
+                plbIOError("Invalid back-reference in compressed stream.");
+            }
+            pluint from = out.size()-distance;
+            // Byte by byte, because the source and the target may overlap.
+            for (plint i=0; i<length; ++i) {
+                out.push_back(out[from+i]);
+            }
+        }
+        if (reader.overrun()) plbIOError("Truncated compressed stream.");
+    }
+}
+
+void readDynamicLengths(BitReader& reader, std::vector<int>& literalLengths, std::vector<int>& distanceLengths)
+{
+    plint numLiterals = (plint)reader.read(5)+257;
+    plint numDistances = (plint)reader.read(5)+1;
+    plint numLengthCodesUsed = (plint)reader.read(4)+4;
+    std::vector<int> lengthCodeLengths(numLengthCodes, 0);
+    for (plint i=0; i<numLengthCodesUsed; ++i) {
+        lengthCodeLengths[lengthCodeOrder[i]] = (int)reader.read(3);
+    }
+    HuffmanDecoder lengthDecoder(lengthCodeLengths);
+    std::vector<int> allLengths;
+    while ((plint)allLengths.size()<numLiterals+numDistances) {
+        int symbol = lengthDecoder.decode(reader);
+        if (symbol<16) {
+            allLengths.push_back(symbol);
+        }
+        else if (symbol==16) {
+            if (allLengths.empty()) plbIOError("Invalid code lengths in compressed stream.");
+            int previous = allLengths.back();
+            allLengths.insert(allLengths.end(), 3+reader.read(2), previous);
+        }
+        else if (symbol==17) {
+            allLengths.insert(allLengths.end(), 3+reader.read(3), 0);
+        }
+        else {
+            allLengths.insert(allLengths.end(), 11+reader.read(7), 0);
+        }
+        if (reader.overrun()) plbIOError("Truncated compressed stream.");
+    }
+    if ((plint)allLengths.size()!=numLiterals+numDistances) {
+        plbIOError("Invalid code lengths in compressed stream.");
+    }
+    literalLengths.assign(allLengths.begin(), allLengths.begin()+numLiterals);
+    distanceLengths.assign(allLengths.begin()+numLiterals, allLengths.end());
+}
+
+template<typename UInt, typename Float>
+void roundMantissaImpl(std::vector<char>& data, plint mantissaBits) {
+    static const plint numMantissaBits = sizeof(Float)==4 ? 23 : 52;
+    static const UInt one = 1;
+    static const UInt exponentMask = ((one<<(8*sizeof(Float)-1))-1) & ~((one<<numMantissaBits)-1);
+    plint droppedBits = numMantissaBits-mantissaBits;
+    if (droppedBits<=0) return;
+    UInt lowMask = (one<<droppedBits)-1;
+    UInt half = one<<(droppedBits-1);
+    pluint numElements = data.size()/sizeof(Float);
+    for (pluint i=0; i<numElements; ++i) {
+        UInt bits;
+        memcpy(&bits, &data[i*sizeof(Float)], sizeof(Float));
+        if ((bits & exponentMask)==exponentMask) continue; // Inf or NaN.
+        UInt rounded = (bits+half) & ~lowMask;
+        if ((rounded & exponentMask)==exponentMask) {
+            rounded = bits & ~lowMask; // Don't round up to infinity.
+        }
+        memcpy(&data[i*sizeof(Float)], &rounded, sizeof(Float));
+    }
+}
+
+}  // namespace
+
+void zlibCompress(char const* data, pluint size, std::vector<char>& compressed, int level)
+{
+    // Header: deflate with a 32K window; the check bits make it a multiple of 31.
+    compressed.push_back((char)0x78);
+    compressed.push_back((char)0x9C);
+
+    DeflateEncoder encoder(compressed, level);
+    encoder.compress(reinterpret_cast<unsigned char const*>(data), size);
+
+    unsigned char const* bytes = reinterpret_cast<unsigned char const*>(data);
+    pluint a = 1, b = 0;
+    for (pluint i=0; i<size; ) {
+        // 5552 is the largest block for which the sums cannot overflow 32 bits.
+        pluint end = std::min(size, i+5552);
+        for (; i<end; ++i) {
+            a += bytes[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    pluint adler = (b<<16) | a;
+    compressed.push_back((char)((adler>>24) & 0xFF));
+    compressed.push_back((char)((adler>>16) & 0xFF));
+    compressed.push_back((char)((adler>>8)  & 0xFF));
+    compressed.push_back((char)( adler      & 0xFF));
+}
+
+void zlibDecompress(char const* data, pluint size, std::vector<char>& decompressed)
+{
+    unsigned char const* bytes = reinterpret_cast<unsigned char const*>(data);
+    if (size<6 || (bytes[0] & 0x0F)!=8 || ((bytes[0]<<8) | bytes[1]) % 31 != 0 || (bytes[1] & 0x20)) {
+        plbIOError("Invalid header of compressed stream.");
+    }
+    pluint outBegin = decompressed.size();
+    BitReader reader(bytes+2, size-2);
+    std::vector<int> fixedLiteralLengths, fixedDistanceLengths;
+    bool last = false;
+    while (!last) {
+        last = reader.read(1)==1;
+        pluint type = reader.read(2);
+        if (type==0) {
+            reader.alignToByte();
+            pluint length = reader.read(16);
+            pluint complement = reader.read(16);
+            if (length != (~complement & 0xFFFF)) {
+                plbIOError("Invalid stored block in compressed stream.");
+            }
+            for (pluint i=0; i<length; ++i) {
+                decompressed.push_back((char)reader.read(8));
+            }
+        }
+        else if (type==1) {
+            if (fixedLiteralLengths.empty()) {
+                computeFixedLengths(fixedLiteralLengths, fixedDistanceLengths);
+            }
+            inflateBlock( reader, HuffmanDecoder(fixedLiteralLengths),
+                          HuffmanDecoder(fixedDistanceLengths), decompressed, outBegin );
+        }
+        else if (type==2) {
+            std::vector<int> literalLengths, distanceLengths;
+            readDynamicLengths(reader, literalLengths, distanceLengths);
+            inflateBlock( reader, HuffmanDecoder(literalLengths),
+                          HuffmanDecoder(distanceLengths), decompressed, outBegin );
+        }
+        else {
+            plbIOError("Invalid block type in compressed stream.");
+        }
+        if (reader.overrun()) plbIOError("Truncated compressed stream.");
+    }
+
+    reader.alignToByte();
+    pluint adlerPos = 2+reader.bytesConsumed();
+    if (adlerPos+4>size) plbIOError("Truncated compressed stream.");
+    pluint a = 1, b = 0;
+    for (pluint i=outBegin; i<decompressed.size(); ) {
+        pluint end = std::min(decompressed.size(), i+5552);
+        for (; i<end; ++i) {
+            a += (unsigned char)decompressed[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    pluint adler = ((pluint)bytes[adlerPos]<<24) | ((pluint)bytes[adlerPos+1]<<16) |
+                   ((pluint)bytes[adlerPos+2]<<8) | (pluint)bytes[adlerPos+3];
+    if (adler != ((b<<16) | a)) {
+        plbIOError("Checksum mismatch in compressed stream.");
+    }
+}
+
+void shuffleBytes(std::vector<char>& data, plint typeSize)
+{
+    if (typeSize<=1) return;
+    pluint numElements = data.size()/typeSize;
+    std::vector<char> shuffled(data.size());
+    for (plint iByte=0; iByte<typeSize; ++iByte) {
+        char* target = &shuffled[0] + iByte*numElements;
+        for (pluint i=0; i<numElements; ++i) {
+            target[i] = data[i*typeSize+iByte];
+        }
+    }
+    std::copy(data.begin()+numElements*typeSize, data.end(), shuffled.begin()+numElements*typeSize);
+    shuffled.swap(data);
+}
+
+void unshuffleBytes(std::vector<char>& data, plint typeSize)
+{
+    if (typeSize<=1) return;
+    pluint numElements = data.size()/typeSize;
+    std::vector<char> unshuffled(data.size());
+    for (plint iByte=0; iByte<typeSize; ++iByte) {
+        char const* source = &data[0] + iByte*numElements;
+        for (pluint i=0; i<numElements; ++i) {
+            unshuffled[i*typeSize+iByte] = source[i];
+        }
+    }
+    std::copy(data.begin()+numElements*typeSize, data.end(), unshuffled.begin()+numElements*typeSize);
+    unshuffled.swap(data);
+}
+
+void roundMantissa(std::vector<char>& data, plint typeSize, plint mantissaBits)
+{
+    PLB_ASSERT( mantissaBits>=0 );
+    if (typeSize==4) {
+        roundMantissaImpl<unsigned int, float>(data, mantissaBits);
+    }
+    else if (typeSize==8) {
+        roundMantissaImpl<unsigned long long, double>(data, mantissaBits);
+    }
+}
+
+void compressChunk(std::vector<char>& data, plint typeSize, int level)
+{
+    unsigned long long size = data.size();
+    shuffleBytes(data, typeSize);
+    std::vector<char> chunk;
+    chunk.reserve(data.size()/2+16);
+    for (int i=0; i<8; ++i) {
+        chunk.push_back((char)((size>>(8*i)) & 0xFF));
+    }
+    zlibCompress(data.empty() ? 0 : &data[0], data.size(), chunk, level);
+    chunk.swap(data);
+}
+
+void decompressChunk(std::vector<char>& data, plint typeSize)
+{
+    if (data.size()<8) plbIOError("Truncated compressed chunk.");
+    unsigned long long size = 0;
+    for (int i=0; i<8; ++i) {
+        size |= (unsigned long long)(unsigned char)data[i] << (8*i);
+    }
+    std::vector<char> decompressed;
+    decompressed.reserve(size);
+    zlibDecompress(&data[8], data.size()-8, decompressed);
+    if (decompressed.size()!=size) plbIOError("Size mismatch in compressed chunk.");
+    unshuffleBytes(decompressed, typeSize);
+    decompressed.swap(data);
+}
+
+}  // namespace plb
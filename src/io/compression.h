@@ -0,0 +1,72 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Compression in the zlib format (RFC 1950/1951), implemented without
+ * external dependencies, and filters which prepare numerical data for it.
+ */
+
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "core/globalDefs.h"
+#include <vector>
+
+namespace plb {
+
+/// Compress a buffer into a zlib stream, readable by any zlib-compatible tool.
+/** The compression level ranges from 0 (no compression) to 9 (slowest,
+ *  best compression). The result is appended to the vector "compressed".
+ */
+void zlibCompress(char const* data, pluint size, std::vector<char>& compressed, int level=6);
+
+/// Decompress a zlib stream, and append the result to the vector "decompressed".
+/** A PlbIOException is thrown if the stream is corrupt. */
+void zlibDecompress(char const* data, pluint size, std::vector<char>& decompressed);
+
+/// Reorder an array of elements of typeSize bytes, so that the bytes of equal
+///   significance are contiguous. Smooth numerical data compresses much better
+///   in this form. Trailing bytes which do not make up a full element are not moved.
+void shuffleBytes(std::vector<char>& data, plint typeSize);
+
+/// Inverse of shuffleBytes.
+void unshuffleBytes(std::vector<char>& data, plint typeSize);
+
+/// Round an array of floats (typeSize=4) or doubles (typeSize=8) to the
+///   given number of mantissa bits. The relative error is bounded by
+///   2^-(mantissaBits+1), and the zeroed low-order bits compress well.
+void roundMantissa(std::vector<char>& data, plint typeSize, plint mantissaBits);
+
+/// Replace the data by a self-contained compressed chunk: the uncompressed
+///   size (8 bytes, little endian), followed by the zlib stream of the
+///   byte-shuffled data.
+void compressChunk(std::vector<char>& data, plint typeSize, int level=6);
+
+/// Inverse of compressChunk.
+void decompressChunk(std::vector<char>& data, plint typeSize);
+
+}  // namespace plb
+
+#endif  // COMPRESSION_H
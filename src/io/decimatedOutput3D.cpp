@@ -0,0 +1,220 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Decimated output of lattice quantities on a region of interest -- implementation.
+ */
+
+#include "io/decimatedOutput3D.h"
+#include "multiBlock/sparseBlockStructure3D.h"
+#include "multiBlock/threadAttribution.h"
+#include "parallelism/mpiManager.h"
+#include <algorithm>
+
+namespace plb {
+
+namespace {
+
+/// Coarse cells whose first fine cell lies in the fine domain.
+bool coarseCellsOwnedBy( Box3D const& fineDomain, Box3D const& roi, plint stride,
+                         Box3D& coarseDomain )
+{
+    coarseDomain = Box3D (
+            (fineDomain.x0-roi.x0+stride-1)/stride, (fineDomain.x1-roi.x0)/stride,
+            (fineDomain.y0-roi.y0+stride-1)/stride, (fineDomain.y1-roi.y0)/stride,
+            (fineDomain.z0-roi.z0+stride-1)/stride, (fineDomain.z1-roi.z0)/stride );
+    return coarseDomain.x0<=coarseDomain.x1 &&
+           coarseDomain.y0<=coarseDomain.y1 &&
+           coarseDomain.z0<=coarseDomain.z1;
+}
+
+/// Coarse cells which represent at least one cell of the fine domain.
+Box3D coarseCellsTouchedBy(Box3D const& fineDomain, Box3D const& roi, plint stride)
+{
+    return Box3D (
+            (fineDomain.x0-roi.x0)/stride, (fineDomain.x1-roi.x0)/stride,
+            (fineDomain.y0-roi.y0)/stride, (fineDomain.y1-roi.y0)/stride,
+            (fineDomain.z0-roi.z0)/stride, (fineDomain.z1-roi.z0)/stride );
+}
+
+MultiBlockManagement3D createCoarseManagement( MultiBlockManagement3D const& fineManagement,
+                                               Box3D const& roi, plint stride,
+                                               decimation::Filter filter )
+{
+    SparseBlockStructure3D coarseStructure (
+            Box3D(0, (roi.getNx()-1)/stride, 0, (roi.getNy()-1)/stride,
+                  0, (roi.getNz()-1)/stride) );
+    ThreadAttribution const& fineAttribution = fineManagement.getThreadAttribution();
+    ExplicitThreadAttribution* coarseAttribution = new ExplicitThreadAttribution;
+    std::map<plint,Box3D> const& bulks = fineManagement.getSparseBlockStructure().getBulks();
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it != bulks.end(); ++it) {
+        Box3D fineDomain, coarseDomain;
+        if ( intersect(it->second, roi, fineDomain) &&
+             coarseCellsOwnedBy(fineDomain, roi, stride, coarseDomain) )
+        {
+            coarseStructure.addBlock(coarseDomain, it->first);
+            coarseAttribution->addBlock( it->first, fineAttribution.getMpiProcess(it->first),
+                                         fineAttribution.getLocalThreadId(it->first) );
+        }
+    }
+    if (filter==decimation::average) {
+        // The coarse cells touched by a fine block, but owned by no block
+        //   because their first fine cell lies in a hole, are gathered into
+        //   additional blocks, in the order of the fine blocks.
+        plint nextId = fineManagement.getSparseBlockStructure().nextIncrementalId();
+        for (it = bulks.begin(); it != bulks.end(); ++it) {
+            Box3D fineDomain;
+            if (!intersect(it->second, roi, fineDomain)) continue;
+            std::vector<Box3D> orphans(1, coarseCellsTouchedBy(fineDomain, roi, stride));
+            std::vector<plint> ids;
+            std::vector<Box3D> existing;
+            coarseStructure.intersect(orphans[0], ids, existing);
+            for (pluint iExisting=0; iExisting<existing.size(); ++iExisting) {
+                std::vector<Box3D> remaining;
+                for (pluint iOrphan=0; iOrphan<orphans.size(); ++iOrphan) {
+                    except(orphans[iOrphan], existing[iExisting], remaining);
+                }
+                orphans.swap(remaining);
+            }
+            for (pluint iOrphan=0; iOrphan<orphans.size(); ++iOrphan) {
+                coarseStructure.addBlock(orphans[iOrphan], nextId);
+                coarseAttribution->addBlock( nextId, fineAttribution.getMpiProcess(it->first),
+                                             fineAttribution.getLocalThreadId(it->first) );
+                ++nextId;
+            }
+        }
+    }
+    return MultiBlockManagement3D(coarseStructure, coarseAttribution, 0);
+}
+
+}  // namespace
+
+DecimationLayout3D::DecimationLayout3D (
+        MultiBlockManagement3D const& fineManagement,
+        Box3D const& regionOfInterest, plint stride_, decimation::Filter filter_ )
+    : roi(regionOfInterest),
+      stride(stride_),
+      filter(filter_),
+      coarseManagement(createCoarseManagement(fineManagement, roi, stride, filter))
+{
+    PLB_PRECONDITION( stride>0 );
+    PLB_PRECONDITION( contained(roi, fineManagement.getBoundingBox()) );
+    std::map<plint,Box3D> const& bulks = fineManagement.getSparseBlockStructure().getBulks();
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it != bulks.end(); ++it) {
+        Box3D fineDomain;
+        if (intersect(it->second, roi, fineDomain)) {
+            if (filter==decimation::average) {
+                contributionDomains[it->first] = coarseCellsTouchedBy(fineDomain, roi, stride);
+            }
+            else {
+                Box3D coarseDomain;
+                if (coarseCellsOwnedBy(fineDomain, roi, stride, coarseDomain)) {
+                    contributionDomains[it->first] = coarseDomain;
+                }
+            }
+        }
+    }
+
+    // With sub-sampling, the value of a coarse cell is taken in the block
+    //   which owns it, and no data is exchanged.
+    if (filter==decimation::subSample) return;
+
+    // The receiving block may be one of the additional coarse blocks, which
+    //   are only known to the coarse attribution.
+    ThreadAttribution const& attribution = fineManagement.getThreadAttribution();
+    ThreadAttribution const& coarseAttribution = coarseManagement.getThreadAttribution();
+    SparseBlockStructure3D const& coarseStructure = coarseManagement.getSparseBlockStructure();
+    int myRank = global::mpi().getRank();
+    std::map<plint,Box3D>::const_iterator itContrib = contributionDomains.begin();
+    for (; itContrib != contributionDomains.end(); ++itContrib) {
+        plint fromBlock = itContrib->first;
+        std::vector<plint> ids;
+        std::vector<Box3D> intersections;
+        coarseStructure.intersect(itContrib->second, ids, intersections);
+        // Order the transfers by the id of the receiving block, to obtain the
+        //   same sequence of messages on all processes.
+        std::map<plint,Box3D> sortedIntersections;
+        for (pluint iInters=0; iInters<ids.size(); ++iInters) {
+            if (ids[iInters]!=fromBlock) {
+                sortedIntersections[ids[iInters]] = intersections[iInters];
+            }
+        }
+        std::map<plint,Box3D>::const_iterator itInters = sortedIntersections.begin();
+        for (; itInters != sortedIntersections.end(); ++itInters) {
+            Transfer transfer;
+            transfer.fromBlock = fromBlock;
+            transfer.toBlock = itInters->first;
+            transfer.coarseDomain = itInters->second;
+            bool fromLocal = attribution.getMpiProcess(transfer.fromBlock)==myRank;
+            bool toLocal = coarseAttribution.getMpiProcess(transfer.toBlock)==myRank;
+            if (fromLocal && toLocal) {
+                localTransfers.push_back(transfer);
+            }
+            else if (fromLocal) {
+                sends.push_back(transfer);
+            }
+            else if (toLocal) {
+                receives.push_back(transfer);
+            }
+        }
+    }
+    // The partial sums of an additional coarse block cover its bulk.
+    std::map<plint,Box3D> const& coarseBulks = coarseStructure.getBulks();
+    for (it = coarseBulks.begin(); it != coarseBulks.end(); ++it) {
+        if (contributionDomains.find(it->first)==contributionDomains.end()) {
+            contributionDomains[it->first] = it->second;
+        }
+    }
+}
+
+bool DecimationLayout3D::getContributionDomain(plint blockId, Box3D& coarseDomain) const {
+    std::map<plint,Box3D>::const_iterator it = contributionDomains.find(blockId);
+    if (it==contributionDomains.end()) {
+        return false;
+    }
+    coarseDomain = it->second;
+    return true;
+}
+
+Box3D DecimationLayout3D::toFine(Box3D const& coarseDomain) const {
+    Box3D fineCover (
+            roi.x0+coarseDomain.x0*stride, roi.x0+(coarseDomain.x1+1)*stride-1,
+            roi.y0+coarseDomain.y0*stride, roi.y0+(coarseDomain.y1+1)*stride-1,
+            roi.z0+coarseDomain.z0*stride, roi.z0+(coarseDomain.z1+1)*stride-1 );
+    Box3D fineDomain;
+    intersect(fineCover, roi, fineDomain);
+    return fineDomain;
+}
+
+plint DecimationLayout3D::getNumFineCells(plint iX, plint iY, plint iZ) const {
+    if (filter==decimation::subSample) {
+        return 1;
+    }
+    return toFine(Box3D(iX,iX, iY,iY, iZ,iZ)).nCells();
+}
+
+}  // namespace plb
@@ -0,0 +1,144 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Decimated output of lattice quantities on a region of interest -- header file.
+ */
+#ifndef DECIMATED_OUTPUT_3D_H
+#define DECIMATED_OUTPUT_3D_H
+
+#include "core/globalDefs.h"
+#include "core/geometry3D.h"
+#include "core/array.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/multiBlockLattice3D.h"
+#include "atomicBlock/blockLattice3D.h"
+#include "io/xdmfOutput3D.h"
+#include <string>
+#include <vector>
+#include <map>
+
+namespace plb {
+
+namespace decimation {
+    /// Quantities which DecimatedOutput3D computes from the lattice.
+    enum Quantity { density, velocity, velocityNorm };
+    /// Reduction of the fine cells represented by a coarse cell: value at
+    ///   the first fine cell (subSample), or average over all fine cells (average).
+    enum Filter { subSample, average };
+}
+
+/// Coarse grid obtained by decimating a region of a multi-block by a constant stride.
+/** The coarse cell (iX,iY,iZ) represents the fine cells from
+ *  roi.x0+iX*stride to roi.x0+(iX+1)*stride-1 (clipped to the region of
+ *  interest roi), and likewise along y and z. It is attributed to the fine
+ *  block which contains its first fine cell, and the coarse blocks have the same
+ *  id and MPI process as their fine counterparts. With the average filter, a coarse
+ *  cell can straddle several fine blocks: the layout then lists the transfers of
+ *  partial sums from the contributing blocks to the owner, in the same order on
+ *  all processes. With this filter, a coarse cell exists as soon as any of its
+ *  fine cells exists. When its first fine cell lies in a hole of a sparse
+ *  multi-block, it belongs to an additional coarse block, with an id beyond those
+ *  of the fine blocks, on the process of the first fine block which touches it.
+ **/
+class DecimationLayout3D {
+public:
+    /// Partial coarse data which a fine block contributes to another one.
+    struct Transfer {
+        plint fromBlock, toBlock;
+        Box3D coarseDomain;
+    };
+public:
+    /// MPI tag of the messages which carry partial sums.
+    static const int transferTag = 3519;
+public:
+    DecimationLayout3D( MultiBlockManagement3D const& fineManagement,
+                        Box3D const& regionOfInterest, plint stride_,
+                        decimation::Filter filter_ );
+    MultiBlockManagement3D const& getCoarseManagement() const { return coarseManagement; }
+    /// Coarse cells to which a fine block contributes. Returns false if there are none.
+    bool getContributionDomain(plint blockId, Box3D& coarseDomain) const;
+    /// Fine cells represented by a domain of coarse cells.
+    Box3D toFine(Box3D const& coarseDomain) const;
+    /// Number of fine cells represented by a coarse cell, holes of the
+    ///   sparse structure included.
+    plint getNumFineCells(plint iX, plint iY, plint iZ) const;
+    plint getStride() const { return stride; }
+    decimation::Filter getFilter() const { return filter; }
+    /// Transfers from a block of the current process to a block of another one.
+    std::vector<Transfer> const& getSends() const { return sends; }
+    /// Transfers from a block of another process to a block of the current one.
+    std::vector<Transfer> const& getReceives() const { return receives; }
+    /// Transfers between two blocks of the current process.
+    std::vector<Transfer> const& getLocalTransfers() const { return localTransfers; }
+private:
+    Box3D roi;
+    plint stride;
+    decimation::Filter filter;
+    std::map<plint,Box3D> contributionDomains;
+    MultiBlockManagement3D coarseManagement;
+    std::vector<Transfer> sends, receives, localTransfers;
+};
+
+/// In-situ output of lattice quantities, decimated on a region of interest.
+/** The selected quantities are computed from the cells in a single pass over
+ *  the local atomic-blocks, and reduced on each process by the given stride
+ *  before any data is communicated: only the partial sums of coarse cells which
+ *  straddle two blocks are exchanged between neighbors. The result is written as
+ *  an XDMF time series (see XdmfOutput3D), at the iterations of the time window
+ *  only.
+ **/
+template<typename T, template<typename U> class Descriptor>
+class DecimatedOutput3D {
+public:
+    DecimatedOutput3D( std::string fName, Box3D const& regionOfInterest_, plint stride,
+                       decimation::Filter filter_=decimation::average, double deltaX=1.,
+                       Array<double,3> offset=Array<double,3>(0.,0.,0.) );
+    void addQuantity(decimation::Quantity quantity, std::string name);
+    /// Output is written at iterations iterStart, iterStart+period, ..., up to iterEnd.
+    void setTimeWindow(plint iterStart_, plint iterEnd_, plint period_=1);
+    bool isActive(plint iter) const;
+    /// Write the selected quantities if iter is in the time window; return true if written.
+    bool write(MultiBlockLattice3D<T,Descriptor>& lattice, plint iter, double time);
+private:
+    plint getNumComponents() const;
+    void computePartialSums( BlockLattice3D<T,Descriptor> const& block, Box3D const& fineDomain,
+                             Box3D const& coarseDomain, std::vector<T>& sums ) const;
+    static void addSums( std::vector<T> const& from, Box3D const& fromDomain,
+                         std::vector<T>& to, Box3D const& toDomain,
+                         Box3D const& coarseDomain, plint nComp );
+private:
+    Box3D regionOfInterest;
+    plint stride;
+    decimation::Filter filter;
+    std::vector<decimation::Quantity> quantities;
+    std::vector<std::string> names;
+    plint iterStart, iterEnd, period;
+    XdmfOutput3D<T> xdmfOut;
+};
+
+}  // namespace plb
+
+#endif  // DECIMATED_OUTPUT_3D_H
@@ -0,0 +1,311 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Decimated output of lattice quantities on a region of interest -- generic implementation.
+ */
+#ifndef DECIMATED_OUTPUT_3D_HH
+#define DECIMATED_OUTPUT_3D_HH
+
+#include "io/decimatedOutput3D.h"
+#include "io/xdmfOutput3D.hh"
+#include "multiBlock/multiDataField3D.h"
+#include "multiBlock/defaultMultiBlockPolicy3D.h"
+#include "parallelism/mpiManager.h"
+#include "core/util.h"
+#include <limits>
+#include <cmath>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+DecimatedOutput3D<T,Descriptor>::DecimatedOutput3D (
+        std::string fName, Box3D const& regionOfInterest_, plint stride_,
+        decimation::Filter filter_, double deltaX, Array<double,3> offset )
+    : regionOfInterest(regionOfInterest_),
+      stride(stride_),
+      filter(filter_),
+      iterStart(0),
+      iterEnd(std::numeric_limits<plint>::max()),
+      period(1),
+      // A coarse cell is located at its first fine cell when sub-sampling,
+      //   and at the center of its fine cells when averaging.
+      xdmfOut( fName, deltaX*(double)stride,
+               offset + deltaX*( Array<double,3>( (double)regionOfInterest_.x0,
+                                                  (double)regionOfInterest_.y0,
+                                                  (double)regionOfInterest_.z0 ) +
+                                 (filter_==decimation::average ? 0.5*(double)(stride_-1) : 0.) ) )
+{
+    PLB_PRECONDITION( stride>0 );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DecimatedOutput3D<T,Descriptor>::addQuantity(decimation::Quantity quantity, std::string name) {
+    quantities.push_back(quantity);
+    names.push_back(name);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DecimatedOutput3D<T,Descriptor>::setTimeWindow(plint iterStart_, plint iterEnd_, plint period_) {
+    PLB_PRECONDITION( period_>0 );
+    iterStart = iterStart_;
+    iterEnd = iterEnd_;
+    period = period_;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool DecimatedOutput3D<T,Descriptor>::isActive(plint iter) const {
+    return iter>=iterStart && iter<=iterEnd && (iter-iterStart)%period==0;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint DecimatedOutput3D<T,Descriptor>::getNumComponents() const {
+    plint nComp = 0;
+    for (pluint iQuantity=0; iQuantity<quantities.size(); ++iQuantity) {
+        nComp += quantities[iQuantity]==decimation::velocity ? Descriptor<T>::d : 1;
+    }
+    return nComp;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DecimatedOutput3D<T,Descriptor>::computePartialSums (
+        BlockLattice3D<T,Descriptor> const& block, Box3D const& fineDomain,
+        Box3D const& coarseDomain, std::vector<T>& sums ) const
+{
+    // The last component counts the fine cells visited.
+    plint nComp = getNumComponents()+1;
+    plint nx = coarseDomain.getNx();
+    plint ny = coarseDomain.getNy();
+    plint nz = coarseDomain.getNz();
+    sums.assign(nx*ny*nz*nComp, T());
+    bool needsVelocity = false;
+    for (pluint iQuantity=0; iQuantity<quantities.size(); ++iQuantity) {
+        needsVelocity = needsVelocity || quantities[iQuantity]!=decimation::density;
+    }
+    Dot3D location = block.getLocation();
+    // When sub-sampling, only the first fine cell of each coarse cell is visited.
+    plint step = filter==decimation::average ? 1 : stride;
+    Box3D visited(fineDomain);
+    if (filter==decimation::subSample) {
+        visited.x0 = regionOfInterest.x0+coarseDomain.x0*stride;
+        visited.y0 = regionOfInterest.y0+coarseDomain.y0*stride;
+        visited.z0 = regionOfInterest.z0+coarseDomain.z0*stride;
+    }
+    Array<T,Descriptor<T>::d> u;
+    for (plint iX=visited.x0; iX<=visited.x1; iX+=step) {
+        plint cX = (iX-regionOfInterest.x0)/stride - coarseDomain.x0;
+        for (plint iY=visited.y0; iY<=visited.y1; iY+=step) {
+            plint cY = (iY-regionOfInterest.y0)/stride - coarseDomain.y0;
+            for (plint iZ=visited.z0; iZ<=visited.z1; iZ+=step) {
+                plint cZ = (iZ-regionOfInterest.z0)/stride - coarseDomain.z0;
+                Cell<T,Descriptor> const& cell =
+                    block.get(iX-location.x, iY-location.y, iZ-location.z);
+                if (needsVelocity) {
+                    cell.computeVelocity(u);
+                }
+                T* cellSums = &sums[nComp*(cZ+nz*(cY+ny*cX))];
+                for (pluint iQuantity=0; iQuantity<quantities.size(); ++iQuantity) {
+                    switch(quantities[iQuantity]) {
+                        case decimation::density:
+                            *cellSums++ += cell.computeDensity();
+                            break;
+                        case decimation::velocity:
+                            for (plint iD=0; iD<Descriptor<T>::d; ++iD) {
+                                *cellSums++ += u[iD];
+                            }
+                            break;
+                        case decimation::velocityNorm:
+                            *cellSums++ += std::sqrt(normSqr(u));
+                            break;
+                    }
+                }
+                *cellSums += (T)1;
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DecimatedOutput3D<T,Descriptor>::addSums (
+        std::vector<T> const& from, Box3D const& fromDomain,
+        std::vector<T>& to, Box3D const& toDomain,
+        Box3D const& coarseDomain, plint nComp )
+{
+    for (plint iX=coarseDomain.x0; iX<=coarseDomain.x1; ++iX) {
+        for (plint iY=coarseDomain.y0; iY<=coarseDomain.y1; ++iY) {
+            for (plint iZ=coarseDomain.z0; iZ<=coarseDomain.z1; ++iZ) {
+                plint iFrom = nComp*( iZ-fromDomain.z0 + fromDomain.getNz()*
+                                     (iY-fromDomain.y0 + fromDomain.getNy()*(iX-fromDomain.x0)) );
+                plint iTo = nComp*( iZ-toDomain.z0 + toDomain.getNz()*
+                                   (iY-toDomain.y0 + toDomain.getNy()*(iX-toDomain.x0)) );
+                for (plint iComp=0; iComp<nComp; ++iComp) {
+                    to[iTo+iComp] += from[iFrom+iComp];
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool DecimatedOutput3D<T,Descriptor>::write (
+        MultiBlockLattice3D<T,Descriptor>& lattice, plint iter, double time )
+{
+    if (!isActive(iter) || quantities.empty()) {
+        return false;
+    }
+    MultiBlockManagement3D const& fineManagement = lattice.getMultiBlockManagement();
+    DecimationLayout3D layout(fineManagement, regionOfInterest, stride, filter);
+    MultiBlockManagement3D const& coarseManagement = layout.getCoarseManagement();
+    // The partial sums are followed by the number of fine cells, by which they
+    //   are divided in the end. Fine cells in holes of the sparse structure
+    //   are thereby left out of the average.
+    plint nComp = getNumComponents()+1;
+
+    // 1. Each process reduces its own blocks to partial sums on coarse cells.
+    std::map<plint, std::vector<T> > sums;
+    std::vector<plint> const& localBlocks = fineManagement.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        plint blockId = localBlocks[iBlock];
+        Box3D fineDomain, coarseDomain;
+        if ( layout.getContributionDomain(blockId, coarseDomain) &&
+             intersect(fineManagement.getBulk(blockId), regionOfInterest, fineDomain) )
+        {
+            computePartialSums( lattice.getComponent(blockId), fineDomain,
+                                coarseDomain, sums[blockId] );
+        }
+    }
+    // Coarse blocks without fine counterpart only receive partial sums.
+    std::vector<plint> const& localCoarseBlocks = coarseManagement.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localCoarseBlocks.size(); ++iBlock) {
+        plint blockId = localCoarseBlocks[iBlock];
+        if (sums.find(blockId)==sums.end()) {
+            Box3D sumDomain;
+            layout.getContributionDomain(blockId, sumDomain);
+            sums[blockId].assign(sumDomain.nCells()*nComp, T());
+        }
+    }
+
+    // 2. Partial sums of coarse cells which straddle several blocks are
+    //    added up in the block which owns the coarse cell.
+    std::vector<DecimationLayout3D::Transfer> const& sends = layout.getSends();
+    std::vector<DecimationLayout3D::Transfer> const& receives = layout.getReceives();
+    std::vector<std::vector<T> > sendBuffers(sends.size()), recvBuffers(receives.size());
+#ifdef PLB_MPI_PARALLEL
+    ThreadAttribution const& attribution = fineManagement.getThreadAttribution();
+    ThreadAttribution const& coarseAttribution = coarseManagement.getThreadAttribution();
+    std::vector<MPI_Request> sendRequests(sends.size()), recvRequests(receives.size());
+    for (pluint iRecv=0; iRecv<receives.size(); ++iRecv) {
+        recvBuffers[iRecv].resize(receives[iRecv].coarseDomain.nCells()*nComp);
+        global::mpi().iRecv( &recvBuffers[iRecv][0], (int)recvBuffers[iRecv].size(),
+                             attribution.getMpiProcess(receives[iRecv].fromBlock),
+                             &recvRequests[iRecv], DecimationLayout3D::transferTag );
+    }
+    for (pluint iSend=0; iSend<sends.size(); ++iSend) {
+        Box3D const& domain = sends[iSend].coarseDomain;
+        Box3D fromDomain;
+        layout.getContributionDomain(sends[iSend].fromBlock, fromDomain);
+        sendBuffers[iSend].assign(domain.nCells()*nComp, T());
+        addSums(sums[sends[iSend].fromBlock], fromDomain, sendBuffers[iSend], domain, domain, nComp);
+        global::mpi().iSend( &sendBuffers[iSend][0], (int)sendBuffers[iSend].size(),
+                             coarseAttribution.getMpiProcess(sends[iSend].toBlock),
+                             &sendRequests[iSend], DecimationLayout3D::transferTag );
+    }
+#endif
+    std::vector<DecimationLayout3D::Transfer> const& localTransfers = layout.getLocalTransfers();
+    for (pluint iTransfer=0; iTransfer<localTransfers.size(); ++iTransfer) {
+        DecimationLayout3D::Transfer const& transfer = localTransfers[iTransfer];
+        Box3D fromDomain, toDomain;
+        layout.getContributionDomain(transfer.fromBlock, fromDomain);
+        layout.getContributionDomain(transfer.toBlock, toDomain);
+        addSums( sums[transfer.fromBlock], fromDomain, sums[transfer.toBlock], toDomain,
+                 transfer.coarseDomain, nComp );
+    }
+#ifdef PLB_MPI_PARALLEL
+    for (pluint iRecv=0; iRecv<receives.size(); ++iRecv) {
+        MPI_Status status;
+        global::mpi().wait(&recvRequests[iRecv], &status);
+        Box3D const& domain = receives[iRecv].coarseDomain;
+        Box3D toDomain;
+        layout.getContributionDomain(receives[iRecv].toBlock, toDomain);
+        addSums(recvBuffers[iRecv], domain, sums[receives[iRecv].toBlock], toDomain, domain, nComp);
+    }
+    for (pluint iSend=0; iSend<sends.size(); ++iSend) {
+        MPI_Status status;
+        global::mpi().wait(&sendRequests[iSend], &status);
+    }
+#endif
+
+    // 3. The coarse cells are normalized and copied into one field per quantity.
+    std::vector<MultiNTensorField3D<T>*> fields(quantities.size());
+    std::vector<plint> offsets(quantities.size());
+    plint nextOffset = 0;
+    for (pluint iQuantity=0; iQuantity<quantities.size(); ++iQuantity) {
+        plint nDim = quantities[iQuantity]==decimation::velocity ? Descriptor<T>::d : 1;
+        fields[iQuantity] = new MultiNTensorField3D<T> (
+                nDim, coarseManagement,
+                defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                defaultMultiBlockPolicy3D().getMultiNTensorAccess<T>() );
+        offsets[iQuantity] = nextOffset;
+        nextOffset += nDim;
+    }
+    for (pluint iBlock=0; iBlock<localCoarseBlocks.size(); ++iBlock) {
+        plint blockId = localCoarseBlocks[iBlock];
+        Box3D bulk = coarseManagement.getBulk(blockId);
+        Box3D sumDomain;
+        layout.getContributionDomain(blockId, sumDomain);
+        std::vector<T> const& blockSums = sums[blockId];
+        for (plint iX=bulk.x0; iX<=bulk.x1; ++iX) {
+            for (plint iY=bulk.y0; iY<=bulk.y1; ++iY) {
+                for (plint iZ=bulk.z0; iZ<=bulk.z1; ++iZ) {
+                    T const* cellSums = &blockSums[nComp*( iZ-sumDomain.z0 + sumDomain.getNz()*
+                            (iY-sumDomain.y0 + sumDomain.getNy()*(iX-sumDomain.x0)) )];
+                    T weight = (T)1 / cellSums[nComp-1];
+                    for (pluint iQuantity=0; iQuantity<quantities.size(); ++iQuantity) {
+                        NTensorField3D<T>& component = fields[iQuantity]->getComponent(blockId);
+                        Dot3D location = component.getLocation();
+                        T* cell = component.get(iX-location.x, iY-location.y, iZ-location.z);
+                        for (plint iDim=0; iDim<component.getNdim(); ++iDim) {
+                            cell[iDim] = weight*cellSums[offsets[iQuantity]+iDim];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 4. Output.
+    xdmfOut.startSnapshot(time);
+    for (pluint iQuantity=0; iQuantity<quantities.size(); ++iQuantity) {
+        xdmfOut.writeData(*fields[iQuantity], names[iQuantity]);
+        delete fields[iQuantity];
+    }
+    xdmfOut.endSnapshot();
+    return true;
+}
+
+}  // namespace plb
+
+#endif  // DECIMATED_OUTPUT_3D_HH
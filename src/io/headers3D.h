@@ -31,6 +31,8 @@
 #include "io/serializerIO_3D.h"
 #include "io/vtkDataOutput.h"
 #include "io/vtkStructuredDataOutput.h"
+#include "io/xdmfOutput3D.h"
+#include "io/decimatedOutput3D.h"
 #include "io/parallelIO.h"
 #include "io/colormaps.h"
 #include "io/imageWriter.h"
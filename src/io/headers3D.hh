@@ -31,6 +31,8 @@
 #include "io/serializerIO_3D.hh"
 #include "io/vtkDataOutput.hh"
 #include "io/vtkStructuredDataOutput.hh"
+#include "io/xdmfOutput3D.hh"
+#include "io/decimatedOutput3D.hh"
 #include "io/imageWriter.hh"
 #include "io/transientStatistics3D.hh"
 
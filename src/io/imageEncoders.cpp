@@ -0,0 +1,430 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Encoders for the images produced by the ImageWriter: binary PPM, PNG
+ * and GIF, written directly from memory without external tools.
+ */
+
+#include "io/imageEncoders.h"
+#include "io/compression.h"
+#include "core/runTimeDiagnostics.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#ifdef PLB_USE_POSIX
+#include <pthread.h>
+#endif
+
+namespace plb {
+
+namespace imageIO {
+
+namespace {
+
+void writeBigEndian32(std::ostream& out, pluint value) {
+    char bytes[4] = { (char)((value>>24) & 0xFF), (char)((value>>16) & 0xFF),
+                      (char)((value>>8) & 0xFF),  (char)(value & 0xFF) };
+    out.write(bytes, 4);
+}
+
+void writeLittleEndian16(std::ostream& out, plint value) {
+    char bytes[2] = { (char)(value & 0xFF), (char)((value>>8) & 0xFF) };
+    out.write(bytes, 2);
+}
+
+void encodePpm(std::ostream& out, ImageBuffer const& image) {
+    out << "P6\n" << image.nx << " " << image.ny << "\n" << image.maxValue << "\n";
+    out.write((char const*)&image.pixels[0], image.pixels.size());
+}
+
+/// CRC-32 of PNG chunks (ISO 3309), computed with a lookup table.
+class Crc32 {
+public:
+    Crc32() {
+        for (pluint n=0; n<256; ++n) {
+            pluint c = n;
+            for (int k=0; k<8; ++k) {
+                c = (c & 1) ? (0xEDB88320UL ^ (c>>1)) : (c>>1);
+            }
+            table[n] = c;
+        }
+    }
+    pluint compute(char const* data, pluint size, pluint crc=0) const {
+        crc ^= 0xFFFFFFFFUL;
+        for (pluint i=0; i<size; ++i) {
+            crc = table[(crc ^ (unsigned char)data[i]) & 0xFF] ^ (crc>>8);
+        }
+        return crc ^ 0xFFFFFFFFUL;
+    }
+private:
+    pluint table[256];
+};
+
+void writePngChunk(std::ostream& out, char const* type, std::vector<char> const& data) {
+    static const Crc32 crc32;
+    writeBigEndian32(out, data.size());
+    out.write(type, 4);
+    if (!data.empty()) {
+        out.write(&data[0], data.size());
+    }
+    pluint crc = crc32.compute(type, 4);
+    if (!data.empty()) {
+        crc = crc32.compute(&data[0], data.size(), crc);
+    }
+    writeBigEndian32(out, crc);
+}
+
+int paethPredictor(int a, int b, int c) {
+    int p = a+b-c;
+    int pa = std::abs(p-a), pb = std::abs(p-b), pc = std::abs(p-c);
+    if (pa<=pb && pa<=pc) return a;
+    if (pb<=pc) return b;
+    return c;
+}
+
+/// Every row is preceded by the PNG filter which minimizes the sum of
+///   the absolute values of the filtered bytes, as suggested by the PNG
+///   specification.
+void filterPngRows(ImageBuffer const& image, std::vector<char>& filtered) {
+    static const plint bytesPerPixel = 3;
+    plint rowSize = bytesPerPixel*image.nx;
+    filtered.resize((rowSize+1)*image.ny);
+    std::vector<unsigned char> zeroRow(rowSize, 0);
+    std::vector<unsigned char> candidate(rowSize);
+    std::vector<unsigned char> best(rowSize);
+    for (plint iY=0; iY<image.ny; ++iY) {
+        unsigned char const* row = &image.pixels[iY*rowSize];
+        unsigned char const* above = iY>0 ? &image.pixels[(iY-1)*rowSize] : &zeroRow[0];
+        pluint bestSum = 0;
+        int bestFilter = -1;
+        for (int filter=0; filter<5; ++filter) {
+            pluint sum = 0;
+            for (plint i=0; i<rowSize; ++i) {
+                int left = i>=bytesPerPixel ? row[i-bytesPerPixel] : 0;
+                int upperLeft = i>=bytesPerPixel ? above[i-bytesPerPixel] : 0;
+                int prediction = 0;
+                switch(filter) {
+                    case 1: prediction = left; break;
+                    case 2: prediction = above[i]; break;
+                    case 3: prediction = (left+above[i])/2; break;
+                    case 4: prediction = paethPredictor(left, above[i], upperLeft); break;
+                }
+                candidate[i] = (unsigned char)(row[i]-prediction);
+                sum += std::abs((int)(signed char)candidate[i]);
+            }
+            if (bestFilter<0 || sum<bestSum) {
+                bestSum = sum;
+                bestFilter = filter;
+                best.swap(candidate);
+            }
+        }
+        filtered[iY*(rowSize+1)] = (char)bestFilter;
+        std::copy(best.begin(), best.end(), filtered.begin()+iY*(rowSize+1)+1);
+    }
+}
+
+void encodePng(std::ostream& out, ImageBuffer const& image) {
+    static const char signature[8] = { (char)137, 'P', 'N', 'G', '\r', '\n', (char)26, '\n' };
+    out.write(signature, 8);
+
+    std::vector<char> header;
+    for (int i=3; i>=0; --i) header.push_back((char)((image.nx>>(8*i)) & 0xFF));
+    for (int i=3; i>=0; --i) header.push_back((char)((image.ny>>(8*i)) & 0xFF));
+    header.push_back(8);  // Bit depth.
+    header.push_back(2);  // Color type: RGB.
+    header.push_back(0);  // Compression method: deflate.
+    header.push_back(0);  // Filter method: adaptive.
+    header.push_back(0);  // No interlacing.
+    writePngChunk(out, "IHDR", header);
+
+    std::vector<char> filtered;
+    filterPngRows(image, filtered);
+    std::vector<char> compressed;
+    zlibCompress(filtered.empty() ? 0 : &filtered[0], filtered.size(), compressed);
+    writePngChunk(out, "IDAT", compressed);
+    writePngChunk(out, "IEND", std::vector<char>());
+}
+
+/// Packs the variable-length LZW codes of the GIF format into
+///   sub-blocks of at most 255 bytes.
+class GifCodeWriter {
+public:
+    GifCodeWriter(std::ostream& out_)
+        : out(out_), buffer(0), numBits(0)
+    { }
+    void write(plint code, int codeSize) {
+        buffer |= (pluint)code << numBits;
+        numBits += codeSize;
+        while (numBits>=8) {
+            pushByte((char)(buffer & 0xFF));
+            buffer >>= 8;
+            numBits -= 8;
+        }
+    }
+    void finish() {
+        if (numBits>0) {
+            pushByte((char)(buffer & 0xFF));
+        }
+        flushBlock();
+        out.put(0);
+    }
+private:
+    void pushByte(char byte) {
+        block.push_back(byte);
+        if (block.size()==255) flushBlock();
+    }
+    void flushBlock() {
+        if (!block.empty()) {
+            out.put((char)block.size());
+            out.write(&block[0], block.size());
+            block.clear();
+        }
+    }
+private:
+    std::ostream& out;
+    pluint buffer;
+    int numBits;
+    std::vector<char> block;
+};
+
+void encodeGif(std::ostream& out, ImageBuffer const& image) {
+    PLB_ASSERT( image.nx<65536 && image.ny<65536 );
+    PLB_ASSERT( image.palette.size()==3*256 );
+    out.write("GIF89a", 6);
+    writeLittleEndian16(out, image.nx);
+    writeLittleEndian16(out, image.ny);
+    out.put((char)0xF7);  // Global color table of 256 entries, 8 bits per channel.
+    out.put(0);           // Background color.
+    out.put(0);           // Pixel aspect ratio.
+    out.write((char const*)&image.palette[0], image.palette.size());
+
+    out.put(',');         // Image descriptor.
+    writeLittleEndian16(out, 0);
+    writeLittleEndian16(out, 0);
+    writeLittleEndian16(out, image.nx);
+    writeLittleEndian16(out, image.ny);
+    out.put(0);
+
+    static const int minCodeSize  = 8;
+    static const plint clearCode  = 1<<minCodeSize;
+    static const plint endCode    = clearCode+1;
+    static const plint maxNumCodes = 4096;
+    // Open-addressing hash table from (prefix code, pixel) to code.
+    static const plint tableSize  = 5003;
+    std::vector<plint> tableKeys(tableSize);
+    std::vector<plint> tableCodes(tableSize);
+
+    out.put((char)minCodeSize);
+    GifCodeWriter writer(out);
+    int codeSize = minCodeSize+1;
+    plint nextCode = endCode+1;
+    std::fill(tableKeys.begin(), tableKeys.end(), -1);
+    writer.write(clearCode, codeSize);
+
+    plint numPixels = image.nx*image.ny;
+    plint prefix = numPixels>0 ? image.pixels[0] : 0;
+    for (plint iPixel=1; iPixel<numPixels; ++iPixel) {
+        plint pixel = image.pixels[iPixel];
+        plint key = (prefix<<8) | pixel;
+        plint slot = key % tableSize;
+        while (tableKeys[slot]!=-1 && tableKeys[slot]!=key) {
+            slot = (slot+1) % tableSize;
+        }
+        if (tableKeys[slot]==key) {
+            prefix = tableCodes[slot];
+            continue;
+        }
+        writer.write(prefix, codeSize);
+        if (nextCode<maxNumCodes) {
+            tableKeys[slot] = key;
+            tableCodes[slot] = nextCode++;
+            // The decoder adds its entries one code later than the encoder.
+            if (nextCode>(1<<codeSize) && codeSize<12) ++codeSize;
+        }
+        else {
+            writer.write(clearCode, codeSize);
+            std::fill(tableKeys.begin(), tableKeys.end(), -1);
+            codeSize = minCodeSize+1;
+            nextCode = endCode+1;
+        }
+        prefix = pixel;
+    }
+    if (numPixels>0) {
+        writer.write(prefix, codeSize);
+    }
+    writer.write(endCode, codeSize);
+    writer.finish();
+    out.put(';');         // Trailer.
+}
+
+#ifdef PLB_USE_POSIX
+
+/// A thread which encodes the images of a queue, in the order of their arrival.
+class BackgroundImageEncoder {
+public:
+    static BackgroundImageEncoder& get() {
+        static BackgroundImageEncoder instance;
+        return instance;
+    }
+    /// Images which are still in the queue at the end of the program are
+    ///   written before the thread is terminated.
+    ~BackgroundImageEncoder() {
+        pthread_mutex_lock(&mutex);
+        terminate = true;
+        pthread_cond_broadcast(&changed);
+        pthread_mutex_unlock(&mutex);
+        if (running) pthread_join(thread, 0);
+        pthread_cond_destroy(&changed);
+        pthread_mutex_destroy(&mutex);
+    }
+    void push(ImageBuffer* image) {
+        pthread_mutex_lock(&mutex);
+        if (!running) {
+            running = pthread_create(&thread, 0, &BackgroundImageEncoder::run, this)==0;
+        }
+        if (!running) {
+            pthread_mutex_unlock(&mutex);
+            reportFailure(!encodeImage(*image), image->fileName);
+            delete image;
+            return;
+        }
+        // Limit the memory held by images that are not yet written.
+        while (queue.size()>=maxQueueSize) {
+            pthread_cond_wait(&changed, &mutex);
+        }
+        queue.push_back(image);
+        pthread_cond_broadcast(&changed);
+        pthread_mutex_unlock(&mutex);
+        reportFailures();
+    }
+    void waitForAll() {
+        pthread_mutex_lock(&mutex);
+        while (!queue.empty() || busy) {
+            pthread_cond_wait(&changed, &mutex);
+        }
+        pthread_mutex_unlock(&mutex);
+        reportFailures();
+    }
+private:
+    BackgroundImageEncoder()
+        : running(false), busy(false), terminate(false)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&changed, 0);
+    }
+    static void* run(void* self) {
+        static_cast<BackgroundImageEncoder*>(self)->processQueue();
+        return 0;
+    }
+    void processQueue() {
+        pthread_mutex_lock(&mutex);
+        while (true) {
+            while (queue.empty() && !terminate) {
+                pthread_cond_wait(&changed, &mutex);
+            }
+            if (queue.empty()) break;
+            ImageBuffer* image = queue.front();
+            queue.pop_front();
+            busy = true;
+            pthread_cond_broadcast(&changed);
+            pthread_mutex_unlock(&mutex);
+
+            bool success = encodeImage(*image);
+
+            pthread_mutex_lock(&mutex);
+            if (!success) failedFiles.push_back(image->fileName);
+            delete image;
+            busy = false;
+            pthread_cond_broadcast(&changed);
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+    /// Warnings are only issued from the main thread.
+    void reportFailures() {
+        pthread_mutex_lock(&mutex);
+        std::vector<std::string> failed;
+        failed.swap(failedFiles);
+        pthread_mutex_unlock(&mutex);
+        for (pluint i=0; i<failed.size(); ++i) {
+            reportFailure(true, failed[i]);
+        }
+    }
+    static void reportFailure(bool failed, std::string const& fileName) {
+        if (failed) {
+            plbWarning("Could not write image file " + fileName);
+        }
+    }
+private:
+    static const pluint maxQueueSize = 4;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    std::deque<ImageBuffer*> queue;
+    std::vector<std::string> failedFiles;
+    bool running, busy, terminate;
+};
+
+#endif  // PLB_USE_POSIX
+
+}  // namespace
+
+bool encodeImage(ImageBuffer const& image) {
+    std::ofstream out(image.fileName.c_str(), std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    switch(image.format) {
+        case ppm: encodePpm(out, image); break;
+        case png: encodePng(out, image); break;
+        case gif: encodeGif(out, image); break;
+    }
+    return !out.fail();
+}
+
+void writeImage(ImageBuffer* image, bool inBackground) {
+#ifdef PLB_USE_POSIX
+    if (inBackground) {
+        BackgroundImageEncoder::get().push(image);
+        return;
+    }
+#endif
+    if (!encodeImage(*image)) {
+        plbWarning("Could not write image file " + image->fileName);
+    }
+    delete image;
+}
+
+void waitForBackgroundImages() {
+#ifdef PLB_USE_POSIX
+    BackgroundImageEncoder::get().waitForAll();
+#endif
+}
+
+}  // namespace imageIO
+
+}  // namespace plb
@@ -0,0 +1,81 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Encoders for the images produced by the ImageWriter: binary PPM, PNG
+ * and GIF, written directly from memory without external tools.
+ */
+
+#ifndef IMAGE_ENCODERS_H
+#define IMAGE_ENCODERS_H
+
+#include "core/globalDefs.h"
+#include <string>
+#include <vector>
+
+namespace plb {
+
+namespace imageIO {
+
+enum ImageFormat { ppm, png, gif };
+
+/// A colormapped image which is ready to be encoded.
+/** The pixels are stored row by row, from the top left corner. For the PPM
+ *  format, every pixel has three samples in the range [0,maxValue], stored
+ *  on one byte, or two bytes (big endian) if maxValue exceeds 255. For
+ *  the PNG format, every pixel has three 8-bit samples. For the GIF format,
+ *  every pixel is an index into the palette, which contains 256 RGB triples.
+ */
+struct ImageBuffer {
+    ImageBuffer(ImageFormat format_, std::string const& fileName_, plint nx_, plint ny_)
+        : format(format_), fileName(fileName_), nx(nx_), ny(ny_), maxValue(255)
+    { }
+    ImageFormat format;
+    std::string fileName;
+    plint nx, ny;
+    plint maxValue;
+    std::vector<unsigned char> pixels;
+    std::vector<unsigned char> palette;
+};
+
+/// Encode the image and write it to the file image.fileName. Returns false
+///   if the file could not be written.
+bool encodeImage(ImageBuffer const& image);
+
+/// Encode and write the image. The ImageWriter takes ownership of the buffer.
+/** If inBackground is true and POSIX threads are available, the encoding
+ *  takes place on a separate thread, and the function returns immediately
+ *  unless too many images are already waiting.
+ */
+void writeImage(ImageBuffer* image, bool inBackground);
+
+/// Block until all images handed over to the background thread are written.
+void waitForBackgroundImages();
+
+}  // namespace imageIO
+
+}  // namespace plb
+
+#endif  // IMAGE_ENCODERS_H
@@ -31,12 +31,19 @@
 #include "atomicBlock/dataField3D.h"
 #include "multiBlock/multiDataField3D.h"
 #include "io/colormaps.h"
+#include "io/imageEncoders.h"
 #include <sstream>
 #include <iomanip>
 #include <vector>
 
 namespace plb {
 
+/// Write 2D scalar fields, or 2D slices of 3D scalar fields, as colormapped images.
+/** The images are encoded in-process. PPM images are written in binary form, with
+ *  colorRange levels per channel; PNG and GIF images use 8 bits per channel. With
+ *  the optional sizeX and sizeY, the image is resampled to fit into this size,
+ *  with preserved aspect ratio.
+ */
 template<typename T>
 class ImageWriter {
 public:
@@ -60,6 +67,17 @@ public:
     void writeScaledGif(std::string const& fName,
                         ScalarField2D<T>& field,
                         plint sizeX, plint sizeY) const;
+    void writePng(std::string const& fName,
+                  ScalarField2D<T>& field,
+                  T minVal, T maxVal) const;
+    void writePng(std::string const& fName,
+                  ScalarField2D<T>& field,
+                  T minVal, T maxVal, plint sizeX, plint sizeY) const;
+    void writeScaledPng(std::string const& fName,
+                        ScalarField2D<T>& field) const;
+    void writeScaledPng(std::string const& fName,
+                        ScalarField2D<T>& field,
+                        plint sizeX, plint sizeY) const;
 
     void writePpm(std::string const& fName,
                   MultiScalarField2D<T>& field,
@@ -77,6 +95,17 @@ public:
     void writeScaledGif(std::string const& fName,
                         MultiScalarField2D<T>& field,
                         plint sizeX, plint sizeY) const;
+    void writePng(std::string const& fName,
+                  MultiScalarField2D<T>& field,
+                  T minVal, T maxVal) const;
+    void writePng(std::string const& fName,
+                  MultiScalarField2D<T>& field,
+                  T minVal, T maxVal, plint sizeX, plint sizeY) const;
+    void writeScaledPng(std::string const& fName,
+                        MultiScalarField2D<T>& field) const;
+    void writeScaledPng(std::string const& fName,
+                        MultiScalarField2D<T>& field,
+                        plint sizeX, plint sizeY) const;
 
 
     void writePpm(std::string const& fName,
@@ -95,6 +124,17 @@ public:
     void writeScaledGif(std::string const& fName,
                         ScalarField3D<T>& field,
                         plint sizeX, plint sizeY) const;
+    void writePng(std::string const& fName,
+                  ScalarField3D<T>& field,
+                  T minVal, T maxVal) const;
+    void writePng(std::string const& fName,
+                  ScalarField3D<T>& field,
+                  T minVal, T maxVal, plint sizeX, plint sizeY) const;
+    void writeScaledPng(std::string const& fName,
+                        ScalarField3D<T>& field) const;
+    void writeScaledPng(std::string const& fName,
+                        ScalarField3D<T>& field,
+                        plint sizeX, plint sizeY) const;
 
     void writePpm(std::string const& fName,
                   MultiScalarField3D<T>& field,
@@ -112,17 +152,47 @@ public:
     void writeScaledGif(std::string const& fName,
                         MultiScalarField3D<T>& field,
                         plint sizeX, plint sizeY) const;
+    void writePng(std::string const& fName,
+                  MultiScalarField3D<T>& field,
+                  T minVal, T maxVal) const;
+    void writePng(std::string const& fName,
+                  MultiScalarField3D<T>& field,
+                  T minVal, T maxVal, plint sizeX, plint sizeY) const;
+    void writeScaledPng(std::string const& fName,
+                        MultiScalarField3D<T>& field) const;
+    void writeScaledPng(std::string const& fName,
+                        MultiScalarField3D<T>& field,
+                        plint sizeX, plint sizeY) const;
 
+    /// Hand the encoding of the images over to a background thread (only
+    ///   available with PLB_USE_POSIX), so that the simulation can proceed
+    ///   while the file is written. Use imageIO::waitForBackgroundImages()
+    ///   before reading the images from within the program.
+    void setBackgroundEncoding(bool flag) { backgroundEncoding = flag; }
+    bool usesBackgroundEncoding() const { return backgroundEncoding; }
 private:
-    void writePpmImplementation (
+    void writeImage(std::string const& fName, ScalarField2D<T>& field,
+                    T minVal, T maxVal, imageIO::ImageFormat format,
+                    plint sizeX, plint sizeY) const;
+    void writeImage(std::string const& fName, MultiScalarField2D<T>& field,
+                    T minVal, T maxVal, imageIO::ImageFormat format,
+                    plint sizeX, plint sizeY) const;
+    void writeImage(std::string const& fName, ScalarField3D<T>& field,
+                    T minVal, T maxVal, imageIO::ImageFormat format,
+                    plint sizeX, plint sizeY) const;
+    void writeImage(std::string const& fName, MultiScalarField3D<T>& field,
+                    T minVal, T maxVal, imageIO::ImageFormat format,
+                    plint sizeX, plint sizeY) const;
+    template<class Field3D>
+    ScalarField2D<T>* extractSlice(Field3D& field) const;
+    void writeImageImplementation (
         std::string const& fName,
-        ScalarField2D<T>& localField, T minVal, T maxVal) const;
-    void imageMagickPpmToGif(std::string const& fName) const;
-    void imageMagickResize(std::string const& fName,
-                           plint sizeX, plint sizeY) const;
+        ScalarField2D<T>& localField, T minVal, T maxVal,
+        imageIO::ImageFormat format, plint sizeX, plint sizeY) const;
 private:
     plint colorRange, numColors;
     ColorMap colorMap;
+    bool backgroundEncoding;
 };
 
 
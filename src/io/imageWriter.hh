@@ -30,12 +30,13 @@
 #include "core/plbProfiler.h"
 #include "io/imageWriter.h"
 #include "io/colormaps.h"
+#include "io/imageEncoders.h"
 #include "atomicBlock/dataField2D.h"
 #include "atomicBlock/dataField3D.h"
 #include "core/runTimeDiagnostics.h"
+#include "core/util.h"
 #include "dataProcessors/dataAnalysisWrapper2D.h"
-#include <fstream>
-#include <cstdlib>
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <string>
@@ -49,14 +50,16 @@ template<typename T>
 ImageWriter<T>::ImageWriter(std::string const& map)
     : colorRange(1024),
       numColors(1024),
-      colorMap( mapGenerators::generateMap(map) )
+      colorMap( mapGenerators::generateMap(map) ),
+      backgroundEncoding(false)
 { }
 
 template<typename T>
 ImageWriter<T>::ImageWriter(std::string const& map, plint colorRange_, plint numColors_)
     : colorRange(colorRange_),
       numColors(numColors_),
-      colorMap( mapGenerators::generateMap(map) )
+      colorMap( mapGenerators::generateMap(map) ),
+      backgroundEncoding(false)
 { }
 
 template<typename T>
@@ -67,12 +70,18 @@ void ImageWriter<T>::setMap(std::string const& map, plint colorRange_, plint num
 }
 
 template<typename T>
-void ImageWriter<T>::writePpm (
-        std::string const& fName,
-        ScalarField2D<T>& field,
-        T minVal, T maxVal) const
+void ImageWriter<T>::writePpm(std::string const& fName,
+                              ScalarField2D<T>& field,
+                              T minVal, T maxVal) const
 {
-    writePpmImplementation(fName, field, minVal, maxVal);
+    writeImage(fName, field, minVal, maxVal, imageIO::ppm, 0, 0);
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+                                    ScalarField2D<T>& field) const
+{
+    writePpm(fName, field, T(), T());
 }
 
 template<typename T>
@@ -80,8 +89,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               ScalarField2D<T>& field,
                               T minVal, T maxVal) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickPpmToGif(fName);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, 0, 0);
 }
 
 template<typename T>
@@ -90,8 +98,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               T minVal, T maxVal,
                               plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickResize(fName, sizeX, sizeY);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, sizeX, sizeY);
 }
 
 template<typename T>
@@ -110,24 +117,51 @@ void ImageWriter<T>::writeScaledGif(std::string const& fName,
 }
 
 template<typename T>
-void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+void ImageWriter<T>::writePng(std::string const& fName,
+                              ScalarField2D<T>& field,
+                              T minVal, T maxVal) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, 0, 0);
+}
+
+template<typename T>
+void ImageWriter<T>::writePng(std::string const& fName,
+                              ScalarField2D<T>& field,
+                              T minVal, T maxVal,
+                              plint sizeX, plint sizeY) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
                                     ScalarField2D<T>& field) const
 {
-    writePpm(fName, field, T(), T());
+    writePng(fName, field, T(), T());
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
+                                    ScalarField2D<T>& field,
+                                    plint sizeX, plint sizeY) const
+{
+    writePng(fName, field, T(), T(), sizeX, sizeY);
 }
 
 
 template<typename T>
-void ImageWriter<T>::writePpm (
-        std::string const& fName,
-        MultiScalarField2D<T>& field,
-        T minVal, T maxVal) const
+void ImageWriter<T>::writePpm(std::string const& fName,
+                              MultiScalarField2D<T>& field,
+                              T minVal, T maxVal) const
 {
-    global::profiler().start("io");
-    ScalarField2D<T> localField(field.getNx(), field.getNy());
-    copySerializedBlock(field, localField);
-    writePpmImplementation(fName, localField, minVal, maxVal);
-    global::profiler().stop("io");
+    writeImage(fName, field, minVal, maxVal, imageIO::ppm, 0, 0);
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+                                    MultiScalarField2D<T>& field) const
+{
+    writePpm(fName, field, T(), T());
 }
 
 template<typename T>
@@ -135,8 +169,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               MultiScalarField2D<T>& field,
                               T minVal, T maxVal) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickPpmToGif(fName);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, 0, 0);
 }
 
 template<typename T>
@@ -145,8 +178,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               T minVal, T maxVal,
                               plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickResize(fName, sizeX, sizeY);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, sizeX, sizeY);
 }
 
 template<typename T>
@@ -165,41 +197,51 @@ void ImageWriter<T>::writeScaledGif(std::string const& fName,
 }
 
 template<typename T>
-void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+void ImageWriter<T>::writePng(std::string const& fName,
+                              MultiScalarField2D<T>& field,
+                              T minVal, T maxVal) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, 0, 0);
+}
+
+template<typename T>
+void ImageWriter<T>::writePng(std::string const& fName,
+                              MultiScalarField2D<T>& field,
+                              T minVal, T maxVal,
+                              plint sizeX, plint sizeY) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
                                     MultiScalarField2D<T>& field) const
 {
-    writePpm(fName, field, T(), T());
+    writePng(fName, field, T(), T());
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
+                                    MultiScalarField2D<T>& field,
+                                    plint sizeX, plint sizeY) const
+{
+    writePng(fName, field, T(), T(), sizeX, sizeY);
 }
 
 
 template<typename T>
-void ImageWriter<T>::writePpm (
-        std::string const& fName,
-        ScalarField3D<T>& field,
-        T minVal, T maxVal) const
+void ImageWriter<T>::writePpm(std::string const& fName,
+                              ScalarField3D<T>& field,
+                              T minVal, T maxVal) const
 {
-    plint nx=0, ny=0;
-    if (field.getNx()==1) {
-        nx = field.getNy();
-        ny = field.getNz();
-    }
-    else if (field.getNy()==1) {
-        nx = field.getNx();
-        ny = field.getNz();
-    }
-    else if (field.getNz()==1) {
-        nx = field.getNx();
-        ny = field.getNy();
-    }
-    else {
-        return;
-    }
+    writeImage(fName, field, minVal, maxVal, imageIO::ppm, 0, 0);
+}
 
-    ScalarField2D<T> localField(nx,ny);
-    serializerToUnSerializer(
-            field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward),
-            localField.getBlockUnSerializer(localField.getBoundingBox(), IndexOrdering::forward) );
-    writePpmImplementation(fName, localField, minVal, maxVal);
+template<typename T>
+void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+                                    ScalarField3D<T>& field) const
+{
+    writePpm(fName, field, T(), T());
 }
 
 template<typename T>
@@ -207,8 +249,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               ScalarField3D<T>& field,
                               T minVal, T maxVal) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickPpmToGif(fName);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, 0, 0);
 }
 
 template<typename T>
@@ -217,8 +258,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               T minVal, T maxVal,
                               plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickResize(fName, sizeX, sizeY);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, sizeX, sizeY);
 }
 
 template<typename T>
@@ -237,42 +277,51 @@ void ImageWriter<T>::writeScaledGif(std::string const& fName,
 }
 
 template<typename T>
-void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+void ImageWriter<T>::writePng(std::string const& fName,
+                              ScalarField3D<T>& field,
+                              T minVal, T maxVal) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, 0, 0);
+}
+
+template<typename T>
+void ImageWriter<T>::writePng(std::string const& fName,
+                              ScalarField3D<T>& field,
+                              T minVal, T maxVal,
+                              plint sizeX, plint sizeY) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
                                     ScalarField3D<T>& field) const
 {
-    writePpm(fName, field, T(), T());
+    writePng(fName, field, T(), T());
 }
 
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
+                                    ScalarField3D<T>& field,
+                                    plint sizeX, plint sizeY) const
+{
+    writePng(fName, field, T(), T(), sizeX, sizeY);
+}
 
 
 template<typename T>
-void ImageWriter<T>::writePpm (
-        std::string const& fName,
-        MultiScalarField3D<T>& field,
-        T minVal, T maxVal) const
+void ImageWriter<T>::writePpm(std::string const& fName,
+                              MultiScalarField3D<T>& field,
+                              T minVal, T maxVal) const
 {
-    plint nx=0, ny=0;
-    if (field.getNx()==1) {
-        nx = field.getNy();
-        ny = field.getNz();
-    }
-    else if (field.getNy()==1) {
-        nx = field.getNx();
-        ny = field.getNz();
-    }
-    else if (field.getNz()==1) {
-        nx = field.getNx();
-        ny = field.getNy();
-    }
-    else {
-        return;
-    }
+    writeImage(fName, field, minVal, maxVal, imageIO::ppm, 0, 0);
+}
 
-    ScalarField2D<T> localField(nx,ny);
-    serializerToUnSerializer(
-            field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward),
-            localField.getBlockUnSerializer(localField.getBoundingBox(), IndexOrdering::forward) );
-    writePpmImplementation(fName, localField, minVal, maxVal);
+template<typename T>
+void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+                                    MultiScalarField3D<T>& field) const
+{
+    writePpm(fName, field, T(), T());
 }
 
 template<typename T>
@@ -280,8 +329,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               MultiScalarField3D<T>& field,
                               T minVal, T maxVal) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickPpmToGif(fName);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, 0, 0);
 }
 
 template<typename T>
@@ -290,8 +338,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               T minVal, T maxVal,
                               plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickResize(fName, sizeX, sizeY);
+    writeImage(fName, field, minVal, maxVal, imageIO::gif, sizeX, sizeY);
 }
 
 template<typename T>
@@ -310,10 +357,116 @@ void ImageWriter<T>::writeScaledGif(std::string const& fName,
 }
 
 template<typename T>
-void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+void ImageWriter<T>::writePng(std::string const& fName,
+                              MultiScalarField3D<T>& field,
+                              T minVal, T maxVal) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, 0, 0);
+}
+
+template<typename T>
+void ImageWriter<T>::writePng(std::string const& fName,
+                              MultiScalarField3D<T>& field,
+                              T minVal, T maxVal,
+                              plint sizeX, plint sizeY) const
+{
+    writeImage(fName, field, minVal, maxVal, imageIO::png, sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
                                     MultiScalarField3D<T>& field) const
 {
-    writePpm(fName, field, T(), T());
+    writePng(fName, field, T(), T());
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
+                                    MultiScalarField3D<T>& field,
+                                    plint sizeX, plint sizeY) const
+{
+    writePng(fName, field, T(), T(), sizeX, sizeY);
+}
+
+
+template<typename T>
+void ImageWriter<T>::writeImage (
+        std::string const& fName, ScalarField2D<T>& field,
+        T minVal, T maxVal, imageIO::ImageFormat format,
+        plint sizeX, plint sizeY ) const
+{
+    writeImageImplementation(fName, field, minVal, maxVal, format, sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeImage (
+        std::string const& fName, MultiScalarField2D<T>& field,
+        T minVal, T maxVal, imageIO::ImageFormat format,
+        plint sizeX, plint sizeY ) const
+{
+    global::profiler().start("io");
+    ScalarField2D<T> localField(field.getNx(), field.getNy());
+    copySerializedBlock(field, localField);
+    writeImageImplementation(fName, localField, minVal, maxVal, format, sizeX, sizeY);
+    global::profiler().stop("io");
+}
+
+template<typename T>
+void ImageWriter<T>::writeImage (
+        std::string const& fName, ScalarField3D<T>& field,
+        T minVal, T maxVal, imageIO::ImageFormat format,
+        plint sizeX, plint sizeY ) const
+{
+    ScalarField2D<T>* localField = extractSlice(field);
+    if (localField) {
+        writeImageImplementation(fName, *localField, minVal, maxVal, format, sizeX, sizeY);
+        delete localField;
+    }
+}
+
+template<typename T>
+void ImageWriter<T>::writeImage (
+        std::string const& fName, MultiScalarField3D<T>& field,
+        T minVal, T maxVal, imageIO::ImageFormat format,
+        plint sizeX, plint sizeY ) const
+{
+    global::profiler().start("io");
+    ScalarField2D<T>* localField = extractSlice(field);
+    if (localField) {
+        writeImageImplementation(fName, *localField, minVal, maxVal, format, sizeX, sizeY);
+        delete localField;
+    }
+    global::profiler().stop("io");
+}
+
+/// Copy a 3D field which is one cell thick in one direction into a 2D field.
+///   Returns 0 if the 3D field is not flat.
+template<typename T>
+template<class Field3D>
+ScalarField2D<T>* ImageWriter<T>::extractSlice(Field3D& field) const
+{
+    plint nx=0, ny=0;
+    if (field.getNx()==1) {
+        nx = field.getNy();
+        ny = field.getNz();
+    }
+    else if (field.getNy()==1) {
+        nx = field.getNx();
+        ny = field.getNz();
+    }
+    else if (field.getNz()==1) {
+        nx = field.getNx();
+        ny = field.getNy();
+    }
+    else {
+        return 0;
+    }
+
+    ScalarField2D<T>* localField = new ScalarField2D<T>(nx,ny);
+    serializerToUnSerializer(
+            field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward),
+            localField->getBlockUnSerializer(localField->getBoundingBox(), IndexOrdering::forward) );
+    return localField;
 }
 
 template<typename T>
@@ -330,89 +483,107 @@ template<> inline bool equals(double a, double b) {
 }
 
 template<typename T>
-void ImageWriter<T>::writePpmImplementation (
+void ImageWriter<T>::writeImageImplementation (
         std::string const& fName,
         ScalarField2D<T>& localField,
-        T minVal, T maxVal) const
+        T minVal, T maxVal,
+        imageIO::ImageFormat format,
+        plint sizeX, plint sizeY) const
 {
     if (global::mpi().isMainProcessor()) {
         if (equals(minVal,maxVal)) {
             minVal = computeMin(localField);
             maxVal = computeMax(localField);
         }
-        std::string fullName = global::directories().getImageOutDir() + fName+".ppm";
-        std::ofstream fout(fullName.c_str());
-        fout << "P3\n";
-        fout << localField.getNx() << " " << localField.getNy() << "\n";
-        fout << (colorRange-1) << "\n";
-
-        for (plint iY=localField.getNy()-1; iY>=0; --iY) {
-            for (plint iX=0; iX<localField.getNx(); ++iX) {
+        plint nx = localField.getNx();
+        plint ny = localField.getNy();
+        plint imageNx = nx, imageNy = ny;
+        if (sizeX>0 && sizeY>0) {
+            double scale = std::min((double)sizeX/(double)nx, (double)sizeY/(double)ny);
+            imageNx = std::max((plint)1, util::roundToInt(scale*(double)nx));
+            imageNy = std::max((plint)1, util::roundToInt(scale*(double)ny));
+        }
+
+        static const char* extensions[] = { ".ppm", ".png", ".gif" };
+        std::string fullName = global::directories().getImageOutDir() + fName + extensions[format];
+        imageIO::ImageBuffer* image = new imageIO::ImageBuffer(format, fullName, imageNx, imageNy);
+        double maxOutputValue = (double) (numColors-1) / (double) numColors;
+        if (format==imageIO::ppm) {
+            image->maxValue = colorRange-1;
+            image->pixels.reserve(3*imageNx*imageNy*(image->maxValue>255 ? 2 : 1));
+        }
+        else if (format==imageIO::png) {
+            image->pixels.reserve(3*imageNx*imageNy);
+        }
+        else {
+            // The 256 colors of the palette sample the colormap uniformly.
+            image->pixels.reserve(imageNx*imageNy);
+            for (plint iColor=0; iColor<256; ++iColor) {
+                rgb color = colorMap.get(std::min(((double)iColor+0.5)/256., maxOutputValue));
+                image->palette.push_back((unsigned char) (color.r*255.));
+                image->palette.push_back((unsigned char) (color.g*255.));
+                image->palette.push_back((unsigned char) (color.b*255.));
+            }
+        }
+
+        for (plint iRow=0; iRow<imageNy; ++iRow) {
+            for (plint iCol=0; iCol<imageNx; ++iCol) {
+                double value = 0.;
+                if (imageNx==nx && imageNy==ny) {
+                    value = (double) localField.get(iCol, ny-1-iRow);
+                }
+                else {
+                    // Bilinear interpolation, between the pixel centers.
+                    double x = std::max(0., std::min((double)(nx-1),
+                                   ((double)iCol+0.5)*(double)nx/(double)imageNx-0.5));
+                    double y = std::max(0., std::min((double)(ny-1),
+                                   ((double)(imageNy-1-iRow)+0.5)*(double)ny/(double)imageNy-0.5));
+                    plint x0 = std::min((plint)x, std::max((plint)0, nx-2));
+                    plint y0 = std::min((plint)y, std::max((plint)0, ny-2));
+                    plint x1 = std::min(x0+1, nx-1);
+                    plint y1 = std::min(y0+1, ny-1);
+                    double ux = x-(double)x0, uy = y-(double)y0;
+                    value = (1.-ux)*(1.-uy)*(double)localField.get(x0,y0) +
+                            ux*(1.-uy)*(double)localField.get(x1,y0) +
+                            (1.-ux)*uy*(double)localField.get(x0,y1) +
+                            ux*uy*(double)localField.get(x1,y1);
+                }
                 double outputValue = 0.;
                 if (! (minVal==maxVal) ) {
-                    outputValue = ( (double) (localField.get(iX,iY)-minVal) /
+                    outputValue = ( (value-(double)minVal) /
                                     (double) (maxVal-minVal) *
-                                    (double) (numColors-1) / (double) numColors );
+                                    maxOutputValue );
                 }
                 if (outputValue <   0.) outputValue = 0.;
-                if (outputValue >=  1.) outputValue = (double) (numColors-1) / (double) numColors;
+                if (outputValue >=  1.) outputValue = maxOutputValue;
+
+                if (format==imageIO::gif) {
+                    image->pixels.push_back((unsigned char) std::min(255, (int)(outputValue*256.)));
+                    continue;
+                }
                 rgb color = colorMap.get(outputValue);
-                fout << (int) (color.r*(colorRange-1)) << " "
-                     << (int) (color.g*(colorRange-1)) << " "
-                     << (int) (color.b*(colorRange-1)) << "\n";
+                if (format==imageIO::png) {
+                    image->pixels.push_back((unsigned char) (color.r*255.));
+                    image->pixels.push_back((unsigned char) (color.g*255.));
+                    image->pixels.push_back((unsigned char) (color.b*255.));
+                }
+                else {
+                    plint samples[3] = { (plint) (color.r*(colorRange-1)),
+                                         (plint) (color.g*(colorRange-1)),
+                                         (plint) (color.b*(colorRange-1)) };
+                    for (int iSample=0; iSample<3; ++iSample) {
+                        if (image->maxValue>255) {
+                            image->pixels.push_back((unsigned char) (samples[iSample]>>8));
+                        }
+                        image->pixels.push_back((unsigned char) (samples[iSample] & 0xFF));
+                    }
+                }
             }
         }
+        imageIO::writeImage(image, backgroundEncoding);
     }
 }
 
-template<typename T>
-void ImageWriter<T>::imageMagickPpmToGif(std::string const& fName) const {
-    if (global::mpi().isMainProcessor()) {
-#ifdef PLB_USE_POSIX
-        std::string convCommand =
-            std::string("convert ") +
-            global::directories().getImageOutDir() + fName + ".ppm " +
-            global::directories().getImageOutDir() + fName + ".gif ";
-            
-        std::string rmCommand =
-            std::string("/bin/rm ") +
-            global::directories().getImageOutDir() + fName + ".ppm";
-
-        plint errorConv = system(convCommand.c_str());
-        if (errorConv != 0) plbWarning("Error in using ImageMagick convert command.");
-        plint errorRm = system(rmCommand.c_str());
-        if (errorRm != 0) plbWarning("Error in removing temporary ppm file.");
-#endif  // PLB_USE_POSIX
-    }
-}
-
-template<typename T>
-void ImageWriter<T>::imageMagickResize( std::string const& fName,
-                                        plint sizeX, plint sizeY) const
-{
-    global::profiler().start("io");
-#ifdef PLB_USE_POSIX
-    if (global::mpi().isMainProcessor()) {
-        std::stringstream imStream;
-        imStream << "convert -resize "
-                 << sizeX << "x" << sizeY << " "
-                 << global::directories().getImageOutDir()
-                 << fName << ".ppm "
-                 << global::directories().getImageOutDir()
-                 << fName << ".gif";
-        plint errorConv = system(imStream.str().c_str());
-        if (errorConv != 0) plbWarning("Error in using ImageMagick convert command.");
-
-        std::string rmCommand =
-            std::string("/bin/rm ") +
-            global::directories().getImageOutDir() + fName + ".ppm";
-        plint errorRm = system(rmCommand.c_str());
-        if (errorRm != 0) plbWarning("Error in removing temporary ppm file.");
-    }
-#endif  // PLB_USE_POSIX
-    global::profiler().stop("io");
-}
-
 }  // namespace plb
 
 #endif
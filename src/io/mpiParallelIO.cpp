@@ -81,6 +81,14 @@ void writeRawData_mpi( FileName fName, std::vector<plint> const& myBlockIds,
         }
         if (ioError) break;
     }
+    // Cut off the remains of a previous, larger file with the same name. This
+    //   matters for compressed data, whose size varies from one save to the other.
+    if (!ioError && global::mpi().isMainProcessor() && !offset.empty()) {
+        err = MPI_File_set_size(fh, offset.back());
+        if (err != MPI_SUCCESS) {
+            ioError = true;
+        }
+    }
     err = MPI_File_close(&fh);
     if (err != MPI_SUCCESS) {
         ioError = true;
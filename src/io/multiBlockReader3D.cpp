@@ -29,6 +29,7 @@
 #include "core/globalDefs.h"
 #include "io/multiBlockReader3D.h"
 #include "io/mpiParallelIO.h"
+#include "io/compression.h"
 #include "parallelism/mpiManager.h"
 #include "libraryInterfaces/TINYXML_xmlIO.h"
 #include "libraryInterfaces/TINYXML_xmlIO.hh"
@@ -88,6 +89,46 @@ void createDynamicsForeignIds3D(FileName fName, std::map<int,std::string>& forei
     }
 }
 
+/// Read the compression parameters. Returns false if the data is not compressed.
+bool readXmlCompression3D(FileName fName, plint& typeSize)
+{
+    fName.defaultPath(global::directories().getInputDir());
+    fName.defaultExt("plb");
+    XMLreader reader(fName);
+    std::string codec;
+    try {
+        reader["Block3D"]["Data"]["Compression"]["Codec"].read(codec);
+    }
+    catch(PlbIOException const&) {
+        return false;
+    }
+    if (codec != "shuffle-zlib") {
+        plbIOError(std::string("Unknown compression codec: ")+codec);
+    }
+    reader["Block3D"]["Data"]["Compression"]["TypeSize"].read(typeSize);
+    return true;
+}
+
+void decompressData3D(FileName fName, std::vector<std::vector<char> >& data)
+{
+    plint typeSize;
+    if (!readXmlCompression3D(fName, typeSize)) {
+        return;
+    }
+    bool errorFlag = false;
+    std::string message;
+    for (pluint iBlock=0; iBlock<data.size() && !errorFlag; ++iBlock) {
+        try {
+            decompressChunk(data[iBlock], typeSize);
+        }
+        catch(PlbIOException const& exception) {
+            errorFlag = true;
+            message = exception.what();
+        }
+    }
+    plbIOError(errorFlag, std::string("Corrupt data in file ")+fName.get()+": "+message);
+}
+
 void readXmlProcessors(FileName fName, MultiBlock3D& block) {
     std::vector<MultiBlock3D::ProcessorStorage3D> processors;
     fName.defaultPath(global::directories().getInputDir());
@@ -211,7 +252,9 @@ void readXmlSpec (
     }
 }
 
-MultiBlock3D* load3D(FileName fName)
+/// Load all components of a saved multi-block if fullDomain is true, and
+///   otherwise only those which intersect the domain.
+MultiBlock3D* loadComponents3D(FileName fName, Box3D const& domain, bool fullDomain)
 {
     Box3D boundingBox;
     std::vector<plint> offsets;
@@ -224,21 +267,31 @@ MultiBlock3D* load3D(FileName fName)
                  descriptor, family, components, dynamicContent, data_fName );
 
     SparseBlockStructure3D blockStructure(boundingBox);
+    std::vector<plint> selectedIds;
     for( plint iComponent=0; iComponent<(plint)components.size(); ++iComponent) {
-        blockStructure.addBlock(components[iComponent], iComponent);
+        Box3D intersection;
+        if (fullDomain || intersect(components[iComponent], domain, intersection)) {
+            blockStructure.addBlock(components[iComponent], iComponent);
+            selectedIds.push_back(iComponent);
+        }
+    }
+    if (selectedIds.empty()) {
+        plbIOError(std::string("The requested domain does not intersect the data in file ")+fName.get());
     }
 
+    // The selected blocks keep their original ID, which indexes the offsets
+    //   into the data file.
     ExplicitThreadAttribution* threadAttribution = new ExplicitThreadAttribution;
     std::vector<std::pair<plint,plint> > blockRanges;
-    plint numBlocks = offsets.size();
+    plint numBlocks = selectedIds.size();
     plint numRanges = std::min(numBlocks, (plint)global::mpi().getSize());
     util::linearRepartition(0, numBlocks-1, numRanges, blockRanges);
     std::vector<plint> myBlockIds;
     for (plint iThread=0; iThread<(plint)blockRanges.size(); ++iThread) {
         for (plint iBlock=blockRanges[iThread].first; iBlock<=blockRanges[iThread].second; ++iBlock) {
-            threadAttribution->addBlock(iBlock, iThread);
+            threadAttribution->addBlock(selectedIds[iBlock], iThread);
             if (iThread==global::mpi().getRank()) {
-                myBlockIds.push_back(iBlock);
+                myBlockIds.push_back(selectedIds[iBlock]);
             }
         }
     }
@@ -251,6 +304,7 @@ MultiBlock3D* load3D(FileName fName)
     PLB_ASSERT( newBlock );
     std::vector<std::vector<char> > data(myBlockIds.size());
     loadRawData( data_fName, myBlockIds, offsets, data);
+    decompressData3D(fName, data);
     std::map<int,std::string> foreignIds;
     createDynamicsForeignIds3D(fName, foreignIds);
     dumpRestoreData(*newBlock, dynamicContent, myBlockIds, data, foreignIds);
@@ -258,6 +312,16 @@ MultiBlock3D* load3D(FileName fName)
     return newBlock;
 }
 
+MultiBlock3D* load3D(FileName fName)
+{
+    return loadComponents3D(fName, Box3D(), true);
+}
+
+MultiBlock3D* load3D(FileName fName, Box3D const& domain)
+{
+    return loadComponents3D(fName, domain, false);
+}
+
 void load(FileName fName, MultiBlock3D& intoBlock, bool dynamicContent )
 {
     std::auto_ptr<MultiBlock3D> loadedBlock ( load3D(fName) );
@@ -267,6 +331,14 @@ void load(FileName fName, MultiBlock3D& intoBlock, bool dynamicContent )
                   intoBlock, intoBlock.getBoundingBox(), typeOfVariables );
 }
 
+void load(FileName fName, MultiBlock3D& intoBlock, Box3D const& domain, bool dynamicContent )
+{
+    std::auto_ptr<MultiBlock3D> loadedBlock ( load3D(fName, domain) );
+    modif::ModifT typeOfVariables = dynamicContent ?
+            modif::dataStructure : modif::staticVariables;
+    copy_generic( *loadedBlock, domain, intoBlock, domain, typeOfVariables );
+}
+
 
 SavedFullMultiBlockSerializer3D::SavedFullMultiBlockSerializer3D(FileName fName)
 {
@@ -49,8 +49,18 @@ void readkXmlSpec (
 
 MultiBlock3D* load3D(FileName fName);
 
+/// Load only those atomic-blocks of a saved multi-block which intersect the
+///   given domain. The returned multi-block has the bounding box of the saved
+///   one, but is sparse. With compressed files, only the chunks of the
+///   selected atomic-blocks are read and decompressed.
+MultiBlock3D* load3D(FileName fName, Box3D const& domain);
+
 void load(FileName fName, MultiBlock3D& intoBlock, bool dynamicContent = true );
 
+/// Restore the content of intoBlock on the given domain only, for example to
+///   restart a sub-region of a simulation from a checkpoint.
+void load(FileName fName, MultiBlock3D& intoBlock, Box3D const& domain, bool dynamicContent = true );
+
 class SavedFullMultiBlockSerializer3D : public DataSerializer {
 public:
     SavedFullMultiBlockSerializer3D(FileName fName);
@@ -30,6 +30,7 @@
 #include "parallelism/mpiManager.h"
 #include "io/multiBlockWriter3D.h"
 #include "io/mpiParallelIO.h"
+#include "io/compression.h"
 #include "libraryInterfaces/TINYXML_xmlIO.h"
 #include "libraryInterfaces/TINYXML_xmlIO.hh"
 #include "core/util.h"
@@ -43,6 +44,7 @@
 #include <numeric>
 #include <algorithm>
 #include <memory>
+#include <cmath>
 
 namespace plb {
 
@@ -51,7 +53,8 @@ namespace parallelIO {
 /***** 1. Multi-Block Writer **************************************************/
 
 void writeXmlSpec( MultiBlock3D& multiBlock, FileName fName,
-                   std::vector<plint> const& offset, bool dynamicContent )
+                   std::vector<plint> const& offset, bool dynamicContent,
+                   int compressionLevel, plint mantissaBits )
 {
     fName.defaultExt("plb");
     MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
@@ -91,6 +94,13 @@ void writeXmlSpec( MultiBlock3D& multiBlock, FileName fName,
     if (!offset.empty()) {
         xmlMultiBlock["Data"]["Offsets"].set(offset);
     }
+    if (compressionLevel>0) {
+        xmlMultiBlock["Data"]["Compression"]["Codec"].setString("shuffle-zlib");
+        xmlMultiBlock["Data"]["Compression"]["TypeSize"].set(shuffleTypeSize(typeInfo[0]));
+        if (mantissaBits>0) {
+            xmlMultiBlock["Data"]["Compression"]["MantissaBits"].set(mantissaBits);
+        }
+    }
 
     // The following prints a unique list of dynamics-id pairs for all dynamics
     //   classes used in the multi-block. This is necessary, because dynamics
@@ -198,16 +208,69 @@ void transposeToBackward(plint sizeOfCell, Box3D const& domain, std::vector<char
     transp.swap(data);
 }
 
+plint shuffleTypeSize(std::string const& dataType)
+{
+    if (dataType=="float" || dataType=="int") {
+        return 4;
+    }
+    else if (dataType=="double" || dataType=="long-long" || dataType=="complex-float") {
+        return 8;
+    }
+    else if (dataType=="long") {
+        return (plint)sizeof(long);
+    }
+    else if (dataType=="long-double") {
+        return (plint)sizeof(long double);
+    }
+    else if (dataType=="complex-double") {
+        return 16;
+    }
+    return 1;
+}
+
 void save( MultiBlock3D& multiBlock, FileName fName, bool dynamicContent )
 {
     global::profiler().start("io");
     std::vector<plint> offset;
     std::vector<plint> myBlockIds;
     std::vector<std::vector<char> > data;
+    int compressionLevel = global::IOpolicy().getCompressionLevel();
+
+    dumpData(multiBlock, dynamicContent, offset, myBlockIds, data, compressionLevel);
+
+    writeXmlSpec(multiBlock, fName, offset, dynamicContent, compressionLevel);
+    writeRawData(fName, myBlockIds, offset, data);
+    global::profiler().stop("io");
+}
+
+void saveLossy( MultiBlock3D& multiBlock, FileName fName, double relativeError )
+{
+    std::string blockName = multiBlock.getBlockName();
+    std::string dataType = multiBlock.getTypeInfo()[0];
+    if (!( (blockName=="ScalarField3D") || (blockName=="TensorField3D") ||
+           (blockName=="NTensorField3D") ) )
+    {
+        plbIOError( std::string("Lossy compression is only available for scalar-fields, "\
+                                "tensor-fields and ntensor-fields, not for ")+blockName );
+    }
+    if (!( (dataType=="float") || (dataType=="double") )) {
+        plbIOError( std::string("Lossy compression is only available for float or double "\
+                                "data, not for ")+dataType );
+    }
+    PLB_ASSERT( relativeError>0. );
+    // Rounding to k mantissa bits yields a relative error of at most 2^-(k+1).
+    plint mantissaBits = std::max((plint)1, (plint)std::ceil(-std::log(relativeError)/std::log(2.)-1.));
+
+    global::profiler().start("io");
+    std::vector<plint> offset;
+    std::vector<plint> myBlockIds;
+    std::vector<std::vector<char> > data;
+    int compressionLevel = std::max(1, global::IOpolicy().getCompressionLevel());
+    bool dynamicContent = false;
 
-    dumpData(multiBlock, dynamicContent, offset, myBlockIds, data);
+    dumpData(multiBlock, dynamicContent, offset, myBlockIds, data, compressionLevel, mantissaBits);
 
-    writeXmlSpec(multiBlock, fName, offset, dynamicContent);
+    writeXmlSpec(multiBlock, fName, offset, dynamicContent, compressionLevel, mantissaBits);
     writeRawData(fName, myBlockIds, offset, data);
     global::profiler().stop("io");
 }
@@ -272,7 +335,8 @@ void saveFull( MultiBlock3D& multiBlock, FileName fName, IndexOrdering::Ordering
 
 void dumpData( MultiBlock3D& multiBlock, bool dynamicContent,
                std::vector<plint>& offset, std::vector<plint>& myBlockIds,
-               std::vector<std::vector<char> >& data )
+               std::vector<std::vector<char> >& data,
+               int compressionLevel, plint mantissaBits )
 {
     MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
     std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
@@ -291,6 +355,7 @@ void dumpData( MultiBlock3D& multiBlock, bool dynamicContent,
     data.resize(myBlocks.size());
     std::vector<plint> blockSize(numBlocks);
     std::fill(blockSize.begin(), blockSize.end(), 0);
+    plint typeSize = shuffleTypeSize(multiBlock.getTypeInfo()[0]);
     for (pluint iBlock=0; iBlock<myBlocks.size(); ++iBlock) {
         plint blockId = myBlocks[iBlock];
         SmartBulk3D bulk(management, blockId);
@@ -298,6 +363,12 @@ void dumpData( MultiBlock3D& multiBlock, bool dynamicContent,
         AtomicBlock3D const& block = multiBlock.getComponent(blockId);
         modif::ModifT typeOfVariables = dynamicContent ? modif::dataStructure : modif::staticVariables;
         block.getDataTransfer().send(localBulk, data[iBlock], typeOfVariables);
+        if (mantissaBits>0) {
+            roundMantissa(data[iBlock], typeSize, mantissaBits);
+        }
+        if (compressionLevel>0) {
+            compressChunk(data[iBlock], typeSize, compressionLevel);
+        }
         plint contiguousId = toContiguousId[blockId];
         myBlockIds[iBlock] = contiguousId;
         blockSize[contiguousId] = (plint)data[iBlock].size();
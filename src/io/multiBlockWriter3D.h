@@ -39,9 +39,20 @@ namespace plb {
 
 namespace parallelIO {
 
+/// Save the multi-block in parallel. The data of each atomic-block is
+///   compressed separately if a compression level was selected through
+///   global::IOpolicy().setCompressionLevel().
 void save( MultiBlock3D& multiBlock, FileName fName,
            bool dynamicContent = true );
 
+/// Save the static content of a scalar-field, tensor-field or ntensor-field
+///   of floating-point type, with a bounded loss of precision: the relative
+///   error of each value does not exceed relativeError. This is meant for
+///   visualization data, for which the full precision is rarely needed, and
+///   which compresses much better after the rounding. The file is read with
+///   the usual load functions.
+void saveLossy( MultiBlock3D& multiBlock, FileName fName, double relativeError );
+
 void saveFull( MultiBlock3D& multiBlock, FileName fName,
                IndexOrdering::OrderingT=IndexOrdering::forward );
 
@@ -55,13 +66,25 @@ void saveFull( MultiBlock3D& multiBlock, FileName fName,
  *  @var myBlockIds: New, contiguously numbered IDs of the atomic-blocks
  *                   which are local to the current MPI thread.
  *  @var data: The serialized data of the local atomic-blocks.
+ *  @var compressionLevel: If non-zero, the data of each atomic-block is
+ *                         byte-shuffled and compressed into a self-contained
+ *                         chunk (see compressChunk), and the offsets refer to
+ *                         the compressed chunks.
+ *  @var mantissaBits: If non-zero, floating-point data is rounded to this
+ *                     number of mantissa bits before the compression.
  **/
 void dumpData( MultiBlock3D& multiBlock, bool dynamicContent,
                std::vector<plint>& offset, std::vector<plint>& myBlockIds,
-               std::vector<std::vector<char> >& data );
+               std::vector<std::vector<char> >& data,
+               int compressionLevel=0, plint mantissaBits=0 );
 
 void writeXmlSpec( MultiBlock3D& multiBlock, FileName fName,
-                   std::vector<plint> const& offset, bool dynamicContent );
+                   std::vector<plint> const& offset, bool dynamicContent,
+                   int compressionLevel=0, plint mantissaBits=0 );
+
+/// Size of the elements on which the byte-shuffle filter operates for
+///   the serialized data of the given type (1 if the type is unknown).
+plint shuffleTypeSize(std::string const& dataType);
 
 }  // namespace parallelIO
 
@@ -26,10 +26,14 @@
 #include "io/base64.h"
 #include "io/base64.hh"
 #include "io/endianness.h"
+#include "io/compression.h"
 #include "core/plbDebug.h"
 #include "core/plbProfiler.h"
 #include "core/globalDefs.h"
+#include "core/runTimeDiagnostics.h"
+#include "parallelism/mpiManager.h"
 #include <vector>
+#include <algorithm>
 #include <limits>
 #include <iomanip>
 #include <istream>
@@ -183,6 +187,227 @@ void Base64Reader::readData(char* dataBuffer, pluint bufferSize) const
 }
 
 
+/* *************** Class ZlibBase64Writer ******************************** */
+
+// Writes the data in the layout of the vtkZLibDataCompressor: the data is cut
+// into blocks which are compressed separately, and the header lists the number
+// of blocks, the block size, the size of the last block (0 if it is full) and
+// the compressed size of each block. The header is encoded separately from the
+// compressed data, as required by VTK.
+class ZlibBase64Writer : public SerializedWriter {
+public:
+    ZlibBase64Writer(std::ostream* ostr_, int compressionLevel_, bool enforceUint_, bool switchEndianness_);
+    virtual ZlibBase64Writer* clone() const;
+    virtual void writeHeader(pluint dataSize_);
+    virtual void writeData(char const* dataBuffer, pluint bufferSize);
+private:
+    void compressBlock();
+    void flush();
+    template<typename UInt> void encodeHeader();
+private:
+    std::ostream* ostr;
+    int compressionLevel;
+    bool enforceUint;
+    bool switchEndianness;
+    pluint dataSize, numReceived;
+    std::vector<char> block;
+    std::vector<char> compressed;
+    std::vector<pluint> compressedSizes;
+    static const pluint blockSize = 32768;
+};
+
+const pluint ZlibBase64Writer::blockSize;
+
+ZlibBase64Writer::ZlibBase64Writer(std::ostream* ostr_, int compressionLevel_, bool enforceUint_, bool switchEndianness_)
+    : ostr(ostr_),
+      compressionLevel(compressionLevel_),
+      enforceUint(enforceUint_),
+      switchEndianness(switchEndianness_),
+      dataSize(0),
+      numReceived(0)
+{ }
+
+ZlibBase64Writer* ZlibBase64Writer::clone() const {
+    return new ZlibBase64Writer(*this);
+}
+
+void ZlibBase64Writer::writeHeader(pluint dataSize_) {
+    PLB_PRECONDITION( ostr && (bool)(*ostr) );
+    dataSize = dataSize_;
+    numReceived = 0;
+    block.reserve(std::min(dataSize, blockSize));
+    compressed.reserve(dataSize/4);
+    if (dataSize==0) {
+        flush();
+    }
+}
+
+void ZlibBase64Writer::writeData(char const* dataBuffer, pluint bufferSize)
+{
+    global::profiler().start("io");
+    pluint pos = 0;
+    while (pos<bufferSize) {
+        pluint numCopied = std::min(bufferSize-pos, blockSize-block.size());
+        block.insert(block.end(), dataBuffer+pos, dataBuffer+pos+numCopied);
+        pos += numCopied;
+        numReceived += numCopied;
+        if (block.size()==blockSize || numReceived==dataSize) {
+            compressBlock();
+        }
+    }
+    if (numReceived==dataSize) {
+        flush();
+    }
+    global::profiler().stop("io");
+}
+
+void ZlibBase64Writer::compressBlock() {
+    pluint previousSize = compressed.size();
+    zlibCompress(&block[0], block.size(), compressed, compressionLevel);
+    compressedSizes.push_back(compressed.size()-previousSize);
+    block.clear();
+}
+
+template<typename UInt>
+void ZlibBase64Writer::encodeHeader() {
+    std::vector<UInt> header(3+compressedSizes.size());
+    header[0] = (UInt)compressedSizes.size();
+    header[1] = (UInt)blockSize;
+    header[2] = (UInt)(dataSize%blockSize);
+    for (pluint iBlock=0; iBlock<compressedSizes.size(); ++iBlock) {
+        PLB_PRECONDITION( compressedSizes[iBlock] <= std::numeric_limits<UInt>::max() );
+        header[3+iBlock] = (UInt)compressedSizes[iBlock];
+    }
+    if (switchEndianness) {
+        for (pluint i=0; i<header.size(); ++i) {
+            endianByteSwap(header[i]);
+        }
+    }
+    Base64Encoder<UInt> headerEncoder(*ostr, header.size());
+    headerEncoder.encode(&header[0], header.size());
+}
+
+void ZlibBase64Writer::flush() {
+    if (enforceUint) {
+        encodeHeader<unsigned int>();
+    }
+    else {
+        encodeHeader<pluint>();
+    }
+    if (!compressed.empty()) {
+        Base64Encoder<char> dataEncoder(*ostr, compressed.size());
+        dataEncoder.encode(&compressed[0], compressed.size());
+    }
+    std::vector<char>().swap(compressed);
+    compressedSizes.clear();
+}
+
+
+/* *************** Class ZlibBase64Reader ******************************** */
+
+class ZlibBase64Reader : public SerializedReader {
+public:
+    ZlibBase64Reader(std::istream* istr_, bool enforceUint_, bool switchEndianness_);
+    virtual ZlibBase64Reader* clone() const;
+    virtual void readHeader(pluint dataSize) const;
+    virtual void readData(char* dataBuffer, pluint bufferSize) const;
+private:
+    template<typename UInt> void decodeHeader(pluint dataSize) const;
+private:
+    std::istream* istr;
+    bool enforceUint;
+    bool switchEndianness;
+    mutable std::vector<pluint> compressedSizes;
+    mutable std::vector<char> compressed;
+    mutable std::vector<char> block;
+    mutable pluint nextBlock, posInCompressed, posInBlock;
+};
+
+ZlibBase64Reader::ZlibBase64Reader(std::istream* istr_, bool enforceUint_, bool switchEndianness_)
+    : istr(istr_),
+      enforceUint(enforceUint_),
+      switchEndianness(switchEndianness_),
+      nextBlock(0),
+      posInCompressed(0),
+      posInBlock(0)
+{ }
+
+ZlibBase64Reader* ZlibBase64Reader::clone() const {
+    return new ZlibBase64Reader(*this);
+}
+
+template<typename UInt>
+void ZlibBase64Reader::decodeHeader(pluint dataSize) const {
+    // The number of blocks is not known in advance; it is bounded by dataSize+1.
+    Base64Decoder<UInt> headerDecoder(*istr, 4+dataSize);
+    UInt header[3];
+    headerDecoder.decode(header, 3);
+    if (switchEndianness) {
+        for (int i=0; i<3; ++i) {
+            endianByteSwap(header[i]);
+        }
+    }
+    pluint numBlocks = header[0];
+    // header[1] is the block size, and header[2] the size of the last block.
+    PLB_PRECONDITION( numBlocks==0 ||
+                      (numBlocks-1)*(pluint)header[1] +
+                      (header[2]==0 ? (pluint)header[1] : (pluint)header[2]) == dataSize );
+    compressedSizes.resize(numBlocks);
+    pluint totalSize = 0;
+    if (numBlocks>0) {
+        std::vector<UInt> sizes(numBlocks);
+        headerDecoder.decode(&sizes[0], numBlocks);
+        for (pluint iBlock=0; iBlock<numBlocks; ++iBlock) {
+            if (switchEndianness) {
+                endianByteSwap(sizes[iBlock]);
+            }
+            compressedSizes[iBlock] = sizes[iBlock];
+            totalSize += sizes[iBlock];
+        }
+    }
+    compressed.resize(totalSize);
+    if (totalSize>0) {
+        Base64Decoder<char> dataDecoder(*istr, totalSize);
+        dataDecoder.decode(&compressed[0], totalSize);
+    }
+}
+
+void ZlibBase64Reader::readHeader(pluint dataSize) const {
+    PLB_PRECONDITION( istr && (bool)(*istr) );
+    if (enforceUint) {
+        decodeHeader<unsigned int>(dataSize);
+    }
+    else {
+        decodeHeader<pluint>(dataSize);
+    }
+    block.clear();
+    nextBlock = 0;
+    posInCompressed = 0;
+    posInBlock = 0;
+}
+
+void ZlibBase64Reader::readData(char* dataBuffer, pluint bufferSize) const
+{
+    global::profiler().start("io");
+    pluint pos = 0;
+    while (pos<bufferSize) {
+        if (posInBlock==block.size()) {
+            PLB_PRECONDITION( nextBlock<compressedSizes.size() );
+            block.clear();
+            zlibDecompress(&compressed[posInCompressed], compressedSizes[nextBlock], block);
+            posInCompressed += compressedSizes[nextBlock];
+            ++nextBlock;
+            posInBlock = 0;
+        }
+        pluint numCopied = std::min(bufferSize-pos, block.size()-posInBlock);
+        std::copy(block.begin()+posInBlock, block.begin()+posInBlock+numCopied, dataBuffer+pos);
+        pos += numCopied;
+        posInBlock += numCopied;
+    }
+    global::profiler().stop("io");
+}
+
+
 /* *************** Free functions ************************************ */
 
 void serializerToBase64Stream(DataSerializer const* serializer, std::ostream* ostr, bool enforceUint)
@@ -200,4 +425,59 @@ void base64StreamToUnSerializer(std::istream* istr, DataUnSerializer* unSerializ
             unSerializer);
 }
 
+void serializerToCompressedBase64Stream( DataSerializer const* serializer, std::ostream* ostr,
+                                         int compressionLevel, bool enforceUint )
+{
+    serializerToSink (
+            serializer,
+            new ZlibBase64Writer(ostr, compressionLevel, enforceUint,
+                                 global::IOpolicy().getEndianSwitchOnBase64out()) );
+}
+
+void compressedBase64StreamToUnSerializer( std::istream* istr, DataUnSerializer* unSerializer,
+                                           bool enforceUint )
+{
+    sourceToUnSerializer (
+            new ZlibBase64Reader(istr, enforceUint,
+                                 global::IOpolicy().getEndianSwitchOnBase64in()),
+            unSerializer);
+}
+
+// '#' is not part of the Base64 alphabet.
+static const std::string zlibBase64Tag("#plb-zlib-base64");
+
+void serializerToTaggedBase64Stream( DataSerializer const* serializer, std::ostream* ostr,
+                                     int compressionLevel, bool enforceUint )
+{
+    if (compressionLevel>0) {
+        if (ostr) {
+            *ostr << zlibBase64Tag << "\n";
+        }
+        serializerToCompressedBase64Stream(serializer, ostr, compressionLevel, enforceUint);
+    }
+    else {
+        serializerToBase64Stream(serializer, ostr, enforceUint);
+    }
+}
+
+void taggedBase64StreamToUnSerializer( std::istream* istr, DataUnSerializer* unSerializer,
+                                       bool enforceUint )
+{
+    // 0: no tag, 1: compressed, -1: unknown tag.
+    int format = 0;
+    std::string tag;
+    if (global::mpi().isMainProcessor() && istr && istr->peek()=='#') {
+        std::getline(*istr, tag);
+        format = tag==zlibBase64Tag ? 1 : -1;
+    }
+    global::mpi().bCast(&format, 1);
+    plbIOError( format<0, std::string("Unknown data format in Base64 stream: ")+tag );
+    if (format==1) {
+        compressedBase64StreamToUnSerializer(istr, unSerializer, enforceUint);
+    }
+    else {
+        base64StreamToUnSerializer(istr, unSerializer, enforceUint);
+    }
+}
+
 } // namespace plb
@@ -48,6 +48,34 @@ void serializerToBase64Stream(DataSerializer const* serializer, std::ostream* os
  */
 void base64StreamToUnSerializer(std::istream* istr, DataUnSerializer* unSerializer, bool enforceUint=false);
 
+/// Same as serializerToBase64Stream, but the data is compressed with zlib.
+/** The data is cut into blocks of 32 KB which are compressed separately, in the
+ *  layout of the vtkZLibDataCompressor of VTK. The header (number of blocks,
+ *  block size, size of the last block and compressed size of each block) is
+ *  encoded separately, ahead of the data. With enforceUint, the integers of the
+ *  header are of type "unsigned int", as expected by VTK.
+ */
+void serializerToCompressedBase64Stream( DataSerializer const* serializer, std::ostream* ostr,
+                                         int compressionLevel, bool enforceUint=false );
+
+/// Inverse of serializerToCompressedBase64Stream.
+void compressedBase64StreamToUnSerializer( std::istream* istr, DataUnSerializer* unSerializer,
+                                           bool enforceUint=false );
+
+/// Stream a Serializer in Base64 format, compressed if compressionLevel>0.
+/** Compressed data is preceded by a line with a tag which starts with a character
+ *  outside the Base64 alphabet, so that it cannot be mistaken for uncompressed
+ *  data. Uncompressed data is written without tag, in the format of
+ *  serializerToBase64Stream.
+ */
+void serializerToTaggedBase64Stream( DataSerializer const* serializer, std::ostream* ostr,
+                                     int compressionLevel, bool enforceUint=false );
+
+/// Inverse of serializerToTaggedBase64Stream. The decoder is chosen according to
+///   the tag found in the stream, and an IO error is raised if the tag is unknown.
+void taggedBase64StreamToUnSerializer( std::istream* istr, DataUnSerializer* unSerializer,
+                                       bool enforceUint=false );
+
 /// Take a Serializer, convert and stream into output in ASCII format.
 /** Number of digits in the ASCII representation of numbers is given by the variable numDigits.
  */
@@ -42,8 +42,10 @@ void saveBinaryBlock(Block2D const& block, std::string fName, bool enforceUint)
     }
     plbMainProcIOError( !isOK, std::string("Could not open binary file ")+
                                fName+std::string(" for saving") );
-    serializerToBase64Stream( block.getBlockSerializer(block.getBoundingBox(),
-                              global::IOpolicy().getIndexOrderingForStreams()), ostr, enforceUint );
+    DataSerializer const* serializer = block.getBlockSerializer (
+            block.getBoundingBox(), global::IOpolicy().getIndexOrderingForStreams() );
+    serializerToTaggedBase64Stream (
+            serializer, ostr, global::IOpolicy().getCompressionLevel(), enforceUint );
     delete ostr;
 }
 
@@ -56,11 +58,9 @@ void loadBinaryBlock(Block2D& block, std::string fName, bool enforceUint) {
     }
     plbMainProcIOError( !isOK, std::string("Could not open binary file ")+
                                fName+std::string(" for reading") );
-    base64StreamToUnSerializer (
-            istr, block.getBlockUnSerializer (
-                block.getBoundingBox(),
-                global::IOpolicy().getIndexOrderingForStreams()),
-            enforceUint );
+    DataUnSerializer* unSerializer = block.getBlockUnSerializer (
+            block.getBoundingBox(), global::IOpolicy().getIndexOrderingForStreams() );
+    taggedBase64StreamToUnSerializer(istr, unSerializer, enforceUint);
     delete istr;
 }
 
@@ -44,6 +44,9 @@ namespace plb {
  *
  *  Index-ordering for this operation can be chosen through a call to
  *  global::IOpolicy().setIndexOrderingForStreams(IndexOrdering::OrderingT).
+ *
+ *  The data is compressed if a compression level was selected through
+ *  global::IOpolicy().setCompressionLevel().
  */
 void saveBinaryBlock(Block3D const& block, std::string fName, bool enforceUint=false);
 
@@ -54,6 +57,9 @@ void saveBinaryBlock(Block3D const& block, std::string fName, bool enforceUint=f
  *
  *  Index-ordering for this operation can be chosen through a call to
  *  global::IOpolicy().setIndexOrderingForStreams(IndexOrdering::OrderingT).
+ *
+ *  Compressed and uncompressed files are both read, independently of the
+ *  compression level currently selected in global::IOpolicy().
  */
 void loadBinaryBlock(Block3D& block, std::string fName, bool enforceUint=false);
 
@@ -38,7 +38,8 @@ namespace plb {
 
 VtkDataWriter3D::VtkDataWriter3D(std::string const& fileName_)
     : fileName(fileName_),
-      ostr(0)
+      ostr(0),
+      compressionLevel(global::IOpolicy().getCompressionLevel())
 {
     if (global::mpi().isMainProcessor()) {
         ostr = new std::ofstream(fileName.c_str());
@@ -58,10 +59,14 @@ void VtkDataWriter3D::writeHeader(Box3D domain, Array<double,3> origin, double d
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "<?xml version=\"1.0\"?>\n";
 #ifdef PLB_BIG_ENDIAN
-        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"BigEndian\"";
 #else
-        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\"";
 #endif
+        if (compressionLevel>0) {
+            (*ostr) << " compressor=\"vtkZLibDataCompressor\"";
+        }
+        (*ostr) << ">\n";
         (*ostr) << "<ImageData WholeExtent=\""
                 << domain.x0 << " " << domain.x1 << " "
                 << domain.y0 << " " << domain.y1 << " "
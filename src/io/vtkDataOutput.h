@@ -58,6 +58,7 @@ private:
 private:
     std::string fileName;
     std::ofstream *ostr;
+    int compressionLevel;
 };
 
 template<typename T>
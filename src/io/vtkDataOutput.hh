@@ -89,7 +89,12 @@ void VtkDataWriter3D::writeDataField(DataSerializer const* serializer,
     // there must be no newline between the encoded length indicator and the encoded data block.
 
     bool enforceUint=true; // VTK uses "unsigned" to indicate the size of data, even on a 64-bit machine.
-    serializerToBase64Stream(serializer, ostr, enforceUint);
+    if (compressionLevel>0) {
+        serializerToCompressedBase64Stream(serializer, ostr, compressionLevel, enforceUint);
+    }
+    else {
+        serializerToBase64Stream(serializer, ostr, enforceUint);
+    }
 
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "\n</DataArray>\n";
@@ -41,7 +41,8 @@ namespace plb {
 ////////// class VtkStructuredWriter3D ////////////////////////////////////////
 
 VtkStructuredWriter3D::VtkStructuredWriter3D(std::string const& fileName_)
-    : fileName(fileName_), ostr(0)
+    : fileName(fileName_), ostr(0),
+      compressionLevel(global::IOpolicy().getCompressionLevel())
 {
     if (global::mpi().isMainProcessor()) {
         ostr = new std::ofstream(fileName.c_str());
@@ -61,10 +62,14 @@ void VtkStructuredWriter3D::writeHeader(Box3D domain)
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "<?xml version=\"1.0\"?>\n";
 #ifdef PLB_BIG_ENDIAN
-        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\"";
 #else
-        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\"";
 #endif
+        if (compressionLevel>0) {
+            (*ostr) << " compressor=\"vtkZLibDataCompressor\"";
+        }
+        (*ostr) << ">\n";
         (*ostr) << "<StructuredGrid WholeExtent=\""
         << domain.x0 << " " << domain.x1 << " "
         << domain.y0 << " " << domain.y1 << " "
@@ -67,7 +67,12 @@ void VtkStructuredWriter3D::writeDataField(DataSerializer const* serializer,
     // equal to UInt32. If not, you are on your own.
     
     bool enforceUint=true; // VTK uses "unsigned" to indicate the size of data, even on a 64-bit machine.
-    serializerToBase64Stream(serializer, ostr, enforceUint);
+    if (compressionLevel>0) {
+        serializerToCompressedBase64Stream(serializer, ostr, compressionLevel, enforceUint);
+    }
+    else {
+        serializerToBase64Stream(serializer, ostr, enforceUint);
+    }
     
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "\n</DataArray>\n";
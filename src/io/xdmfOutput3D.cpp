@@ -0,0 +1,345 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Parallel time-series output in the XDMF format -- implementation.
+ */
+
+#include "io/xdmfOutput3D.h"
+#include "parallelism/mpiManager.h"
+#include "libraryInterfaces/TINYXML_xmlIO.h"
+#include "libraryInterfaces/TINYXML_xmlIO.hh"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "core/runTimeDiagnostics.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace plb {
+
+namespace {
+
+std::string toXmlString(double value) {
+    std::stringstream valuestr;
+    valuestr << std::setprecision(17) << value;
+    return valuestr.str();
+}
+
+/// The XDMF dimensions are ordered as z, y, x, followed by the components.
+std::string xdmfDimensions(plint nx, plint ny, plint nz, plint nDim) {
+    std::stringstream dimstr;
+    dimstr << nz << " " << ny << " " << nx;
+    if (nDim>1) {
+        dimstr << " " << nDim;
+    }
+    return dimstr.str();
+}
+
+std::string xdmfAttributeType(plint nDim) {
+    switch(nDim) {
+        case 1: return "Scalar";
+        case 3: return "Vector";
+        case 6: return "Tensor6";
+        case 9: return "Tensor";
+        default: return "Matrix";
+    }
+}
+
+/// Convert data serialized with z as fastest index into data with x as fastest index.
+void transposeToXfastest(plint sizeOfCell, Box3D const& domain, std::vector<char> const& data,
+                         std::vector<char>& transposed)
+{
+    plint nx = domain.getNx();
+    plint ny = domain.getNy();
+    plint nz = domain.getNz();
+    transposed.resize(data.size());
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                plint iForward = sizeOfCell*(iZ + nz*(iY + ny*iX));
+                plint iBackward = sizeOfCell*(iX + nx*(iY + ny*iZ));
+                std::copy( data.begin()+iForward, data.begin()+iForward+sizeOfCell,
+                           transposed.begin()+iBackward );
+            }
+        }
+    }
+}
+
+}  // namespace
+
+XdmfWriter3D::XdmfWriter3D(std::string const& fName_, double deltaX_, Array<double,3> const& offset_)
+    : fullName(global::directories().getVtkOutDir() + fName_),
+      deltaX(deltaX_),
+      offset(offset_),
+      iSnapshot(0),
+      snapshotActive(false),
+      snapshotTime(0.),
+      dataFile(0)
+{
+    std::string::size_type slashPos = fullName.find_last_of('/');
+    baseName = slashPos==std::string::npos ? fullName : fullName.substr(slashPos+1);
+    readExistingSeries();
+}
+
+void XdmfWriter3D::readExistingSeries() {
+    // The main processor scans the index and the snapshot files written by a
+    //   previous run; they are short and have been written by this class.
+    int numSnapshots = 0;
+    if (global::mpi().isMainProcessor()) {
+        std::ifstream indexFile((fullName+".xmf").c_str());
+        std::string line;
+        while (std::getline(indexFile, line)) {
+            if (line.find("<xi:include")!=std::string::npos) {
+                ++numSnapshots;
+            }
+        }
+    }
+    global::mpi().bCast(&numSnapshots, 1);
+    existingTimes.resize(numSnapshots);
+    if (numSnapshots==0) return;
+    bool ioError = false;
+    if (global::mpi().isMainProcessor()) {
+        std::string path = fullName.substr(0, fullName.size()-baseName.size());
+        static const std::string timeTag("<Time Value=\"");
+        for (iSnapshot=0; iSnapshot<numSnapshots; ++iSnapshot) {
+            std::ifstream snapshotFile((path + snapshotName() + ".xmf").c_str());
+            std::string line;
+            std::string::size_type pos = std::string::npos;
+            while (pos==std::string::npos && std::getline(snapshotFile, line)) {
+                pos = line.find(timeTag);
+            }
+            if (pos==std::string::npos) {
+                ioError = true;
+                break;
+            }
+            std::stringstream timestr(line.substr(pos+timeTag.size()));
+            timestr >> existingTimes[iSnapshot];
+        }
+        iSnapshot = 0;
+    }
+    plbIOError(ioError, std::string("Could not read the existing XDMF time series ")+fullName+".xmf");
+    global::mpi().bCast(&existingTimes[0], numSnapshots);
+}
+
+XdmfWriter3D::~XdmfWriter3D() {
+    endSnapshot();
+}
+
+std::string XdmfWriter3D::snapshotName() const {
+    std::stringstream namestr;
+    namestr << baseName << "_" << std::setfill('0') << std::setw(6) << iSnapshot;
+    return namestr.str();
+}
+
+std::string XdmfWriter3D::dataFileName(int rank) const {
+    std::stringstream namestr;
+    namestr << snapshotName() << "_" << rank << ".bin";
+    return namestr.str();
+}
+
+void XdmfWriter3D::startSnapshot(double time) {
+    endSnapshot();
+    // At the first snapshot, the series written by a previous run is resumed
+    //   up to the current time. Later snapshots of that series (for example
+    //   when restarting from an older checkpoint) are overwritten.
+    if (!existingTimes.empty()) {
+        while (iSnapshot<(plint)existingTimes.size() && existingTimes[iSnapshot]<time) {
+            times.push_back(existingTimes[iSnapshot]);
+            ++iSnapshot;
+        }
+        existingTimes.clear();
+    }
+    snapshotActive = true;
+    snapshotTime = time;
+}
+
+void XdmfWriter3D::writeField( MultiBlock3D& field, std::string const& name,
+                               std::string const& numberType, plint precision )
+{
+    if (!snapshotActive) {
+        startSnapshot((double)iSnapshot);
+    }
+    MultiBlockManagement3D const& management = field.getMultiBlockManagement();
+    plint nDim = field.getCellDim();
+    plint sizeOfCell = field.sizeOfCell();
+    PLB_ASSERT( sizeOfCell == nDim*precision );
+
+    // 1. Every process appends the bulk of its blocks to its data file, in
+    //    increasing order of the block IDs.
+    std::vector<plint> localBlocks(management.getLocalInfo().getBlocks());
+    std::sort(localBlocks.begin(), localBlocks.end());
+    bool ioError = false;
+    if (!localBlocks.empty()) {
+        if (!dataFile) {
+            std::string dataFileFullName =
+                fullName.substr(0, fullName.size()-baseName.size()) +
+                dataFileName(global::mpi().getRank());
+            dataFile = new std::ofstream(dataFileFullName.c_str(), std::ios::binary);
+        }
+        std::vector<char> data, transposed;
+        for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+            SmartBulk3D bulk(management, localBlocks[iBlock]);
+            field.getComponent(localBlocks[iBlock]).getDataTransfer().send (
+                    bulk.toLocal(bulk.getBulk()), data, modif::staticVariables );
+            transposeToXfastest(sizeOfCell, bulk.getBulk(), data, transposed);
+            dataFile->write(&transposed[0], transposed.size());
+        }
+        ioError = !(*dataFile);
+    }
+    plbIOError(ioError, std::string("Could not write data of the XDMF output ")+fullName);
+
+    // 2. The main processor infers the position of every block in the data files.
+    if (global::mpi().isMainProcessor()) {
+        ThreadAttribution const& attribution = management.getThreadAttribution();
+        std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
+        std::map<plint,Box3D>::const_iterator it = bulks.begin();
+        for (; it != bulks.end(); ++it) {
+            Box3D const& bulk = it->second;
+            Array<plint,6> coordinates = bulk.to_plbArray();
+            std::vector<plint> key(&coordinates[0], &coordinates[0]+6);
+            std::map<std::vector<plint>, plint>::const_iterator gridIt = gridIds.find(key);
+            plint gridId;
+            if (gridIt==gridIds.end()) {
+                gridId = (plint)grids.size();
+                gridIds[key] = gridId;
+                grids.push_back(bulk);
+                attributes.push_back(std::vector<AttributeRecord>());
+            }
+            else {
+                gridId = gridIt->second;
+            }
+            AttributeRecord record;
+            record.name = name;
+            record.numberType = numberType;
+            record.nDim = nDim;
+            record.precision = precision;
+            record.rank = attribution.getMpiProcess(it->first);
+            record.fileOffset = fileSizes[record.rank];
+            fileSizes[record.rank] += bulk.nCells()*sizeOfCell;
+            attributes[gridId].push_back(record);
+        }
+    }
+}
+
+void XdmfWriter3D::endSnapshot() {
+    if (!snapshotActive) return;
+    delete dataFile;
+    dataFile = 0;
+    // The XML files are printed by the main processor, but the call is collective.
+    times.push_back(snapshotTime);
+    writeSnapshotXml();
+    writeIndexXml();
+    grids.clear();
+    gridIds.clear();
+    attributes.clear();
+    fileSizes.clear();
+    snapshotActive = false;
+    ++iSnapshot;
+}
+
+void XdmfWriter3D::writeSnapshotXml() const {
+    XMLwriter xml;
+    XMLwriter& xdmf = xml["Xdmf"];
+    xdmf.setAttribute("Version", "2.0");
+    XMLwriter& collection = xdmf["Domain"]["Grid"];
+    collection.setAttribute("Name", snapshotName());
+    collection.setAttribute("GridType", "Collection");
+    collection.setAttribute("CollectionType", "Spatial");
+    collection["Time"].setAttribute("Value", toXmlString(snapshotTime));
+#ifdef PLB_BIG_ENDIAN
+    std::string endianness("Big");
+#else
+    std::string endianness("Little");
+#endif
+    for (pluint iGrid=0; iGrid<grids.size(); ++iGrid) {
+        Box3D const& bulk = grids[iGrid];
+        XMLwriter& grid = collection["Grid"][iGrid];
+        std::stringstream gridName;
+        gridName << "Block" << iGrid;
+        grid.setAttribute("Name", gridName.str());
+        grid.setAttribute("GridType", "Uniform");
+        grid["Topology"].setAttribute("TopologyType", "3DCoRectMesh");
+        grid["Topology"].setAttribute("Dimensions",
+                xdmfDimensions(bulk.getNx()+1, bulk.getNy()+1, bulk.getNz()+1, 1));
+        // The cells are centered on the lattice nodes. Like the dimensions,
+        //   the origin and the spacing are ordered as z, y, x.
+        XMLwriter& geometry = grid["Geometry"];
+        geometry.setAttribute("GeometryType", "ORIGIN_DXDYDZ");
+        std::stringstream originStr, spacingStr;
+        originStr << std::setprecision(17)
+                  << offset[2]+((double)bulk.z0-0.5)*deltaX << " "
+                  << offset[1]+((double)bulk.y0-0.5)*deltaX << " "
+                  << offset[0]+((double)bulk.x0-0.5)*deltaX;
+        spacingStr << std::setprecision(17) << deltaX << " " << deltaX << " " << deltaX;
+        geometry["DataItem"][0].setAttribute("Dimensions", "3");
+        geometry["DataItem"][0].setAttribute("Format", "XML");
+        geometry["DataItem"][0].setString(originStr.str());
+        geometry["DataItem"][1].setAttribute("Dimensions", "3");
+        geometry["DataItem"][1].setAttribute("Format", "XML");
+        geometry["DataItem"][1].setString(spacingStr.str());
+
+        std::vector<AttributeRecord> const& gridAttributes = attributes[iGrid];
+        for (pluint iAttribute=0; iAttribute<gridAttributes.size(); ++iAttribute) {
+            AttributeRecord const& record = gridAttributes[iAttribute];
+            XMLwriter& attribute = grid["Attribute"][iAttribute];
+            attribute.setAttribute("Name", record.name);
+            attribute.setAttribute("AttributeType", xdmfAttributeType(record.nDim));
+            attribute.setAttribute("Center", "Cell");
+            XMLwriter& dataItem = attribute["DataItem"];
+            dataItem.setAttribute("Dimensions",
+                    xdmfDimensions(bulk.getNx(), bulk.getNy(), bulk.getNz(), record.nDim));
+            dataItem.setAttribute("NumberType", record.numberType);
+            dataItem.setAttribute("Precision", util::val2str(record.precision));
+            dataItem.setAttribute("Format", "Binary");
+            dataItem.setAttribute("Endian", endianness);
+            dataItem.setAttribute("Seek", util::val2str(record.fileOffset));
+            dataItem.setString(dataFileName(record.rank));
+        }
+    }
+    xml.print(fullName.substr(0, fullName.size()-baseName.size()) + snapshotName() + ".xmf");
+}
+
+void XdmfWriter3D::writeIndexXml() const {
+    XMLwriter xml;
+    XMLwriter& xdmf = xml["Xdmf"];
+    xdmf.setAttribute("Version", "2.0");
+    xdmf.setAttribute("xmlns:xi", "http://www.w3.org/2001/XInclude");
+    XMLwriter& series = xdmf["Domain"]["Grid"];
+    series.setAttribute("Name", baseName);
+    series.setAttribute("GridType", "Collection");
+    series.setAttribute("CollectionType", "Temporal");
+    // The snapshots already written are included by reference, so that
+    //   adding a time step only rewrites this short list.
+    for (pluint iTime=0; iTime<times.size(); ++iTime) {
+        std::stringstream namestr;
+        namestr << baseName << "_" << std::setfill('0') << std::setw(6) << iTime << ".xmf";
+        XMLwriter& include = series["xi:include"][iTime];
+        include.setAttribute("href", namestr.str());
+        include.setAttribute("xpointer", "xpointer(//Xdmf/Domain/Grid)");
+    }
+    xml.print(fullName+".xmf");
+}
+
+}  // namespace plb
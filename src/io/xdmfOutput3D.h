@@ -0,0 +1,129 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Parallel time-series output in the XDMF format -- header file.
+ */
+#ifndef XDMF_OUTPUT_3D_H
+#define XDMF_OUTPUT_3D_H
+
+#include "core/globalDefs.h"
+#include "core/array.h"
+#include "core/geometry3D.h"
+#include "multiBlock/multiBlock3D.h"
+#include "multiBlock/multiDataField3D.h"
+#include <string>
+#include <fstream>
+#include <vector>
+#include <map>
+
+namespace plb {
+
+/// XDMF NumberType of the scalar type T.
+template<typename T>
+std::string xdmfNumberType();
+
+/// Low-level, type-independent part of XdmfOutput3D.
+class XdmfWriter3D {
+public:
+    XdmfWriter3D(std::string const& fName_, double deltaX_, Array<double,3> const& offset_);
+    ~XdmfWriter3D();
+    void startSnapshot(double time);
+    void writeField( MultiBlock3D& field, std::string const& name,
+                     std::string const& numberType, plint precision );
+    void endSnapshot();
+private:
+    XdmfWriter3D(XdmfWriter3D const& rhs);
+    XdmfWriter3D operator=(XdmfWriter3D const& rhs);
+    std::string snapshotName() const;
+    std::string dataFileName(int rank) const;
+    void writeSnapshotXml() const;
+    void writeIndexXml() const;
+    /// Read the times of the snapshots referenced by an existing index file.
+    void readExistingSeries();
+private:
+    /// One field on one atomic-block, as stored in the data file of a process.
+    struct AttributeRecord {
+        std::string name, numberType;
+        plint nDim, precision;
+        int rank;
+        plint fileOffset;
+    };
+    std::string fullName, baseName;
+    double deltaX;
+    Array<double,3> offset;
+    plint iSnapshot;
+    bool snapshotActive;
+    double snapshotTime;
+    /// Data file of the current snapshot, opened by each process at its first write.
+    std::ofstream* dataFile;
+    std::vector<double> times;
+    /// Snapshots of a previous run, not yet taken over into the series.
+    std::vector<double> existingTimes;
+    // The following variables are only used on the main processor, which
+    //   reconstructs the layout of all data files without communication.
+    std::vector<Box3D> grids;
+    std::map<std::vector<plint>, plint> gridIds;
+    std::vector<std::vector<AttributeRecord> > attributes;
+    std::map<int,plint> fileSizes;
+};
+
+/// Time-series output for ParaView or VisIt, in the XDMF format with raw binary data.
+/** Every MPI process writes the bulk of its atomic-blocks, without any
+ *  communication, into its own data file for each snapshot
+ *  (fName_<snapshot>_<rank>.bin). The main processor describes them in a small
+ *  XDMF file per snapshot (fName_<snapshot>.xmf), and in the index fName.xmf
+ *  which includes all snapshots written so far and is the file to open in the
+ *  post-processing tool. Each atomic-block is a uniform grid whose cells are
+ *  the lattice nodes, so that neighboring blocks join without gaps. The data is
+ *  stored in the native precision, in little-endian byte order except on
+ *  big-endian platforms (PLB_BIG_ENDIAN).
+ *
+ *  Usage: call startSnapshot() once per time step, followed by writeData()
+ *  for every field. The snapshot is completed by the next call to
+ *  startSnapshot(), by endSnapshot(), or by the destructor.
+ *
+ *  If the index already exists, for example after a restart from a
+ *  checkpoint, the series is continued: the snapshots written earlier than the
+ *  time of the first new snapshot are kept, and the later ones are replaced.
+ **/
+template<typename T>
+class XdmfOutput3D {
+public:
+    XdmfOutput3D(std::string fName, double deltaX=1.);
+    XdmfOutput3D(std::string fName, double deltaX, Array<double,3> offset);
+    void startSnapshot(double time);
+    void endSnapshot();
+    void writeData(MultiScalarField3D<T>& scalarField, std::string name);
+    template<int nDim>
+    void writeData(MultiTensorField3D<T,nDim>& tensorField, std::string name);
+    void writeData(MultiNTensorField3D<T>& nTensorField, std::string name);
+private:
+    XdmfWriter3D xdmfOut;
+};
+
+}  // namespace plb
+
+#endif  // XDMF_OUTPUT_3D_H
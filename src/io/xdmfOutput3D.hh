@@ -0,0 +1,86 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Parallel time-series output in the XDMF format -- generic implementation.
+ */
+#ifndef XDMF_OUTPUT_3D_HH
+#define XDMF_OUTPUT_3D_HH
+
+#include "io/xdmfOutput3D.h"
+#include <limits>
+
+namespace plb {
+
+template<typename T>
+std::string xdmfNumberType() {
+    if (!std::numeric_limits<T>::is_integer) {
+        return "Float";
+    }
+    if (sizeof(T)==1) {
+        return std::numeric_limits<T>::is_signed ? "Char" : "UChar";
+    }
+    return std::numeric_limits<T>::is_signed ? "Int" : "UInt";
+}
+
+template<typename T>
+XdmfOutput3D<T>::XdmfOutput3D(std::string fName, double deltaX)
+    : xdmfOut(fName, deltaX, Array<double,3>(0.,0.,0.))
+{ }
+
+template<typename T>
+XdmfOutput3D<T>::XdmfOutput3D(std::string fName, double deltaX, Array<double,3> offset)
+    : xdmfOut(fName, deltaX, offset)
+{ }
+
+template<typename T>
+void XdmfOutput3D<T>::startSnapshot(double time) {
+    xdmfOut.startSnapshot(time);
+}
+
+template<typename T>
+void XdmfOutput3D<T>::endSnapshot() {
+    xdmfOut.endSnapshot();
+}
+
+template<typename T>
+void XdmfOutput3D<T>::writeData(MultiScalarField3D<T>& scalarField, std::string name) {
+    xdmfOut.writeField(scalarField, name, xdmfNumberType<T>(), sizeof(T));
+}
+
+template<typename T>
+template<int nDim>
+void XdmfOutput3D<T>::writeData(MultiTensorField3D<T,nDim>& tensorField, std::string name) {
+    xdmfOut.writeField(tensorField, name, xdmfNumberType<T>(), sizeof(T));
+}
+
+template<typename T>
+void XdmfOutput3D<T>::writeData(MultiNTensorField3D<T>& nTensorField, std::string name) {
+    xdmfOut.writeField(nTensorField, name, xdmfNumberType<T>(), sizeof(T));
+}
+
+}  // namespace plb
+
+#endif  // XDMF_OUTPUT_3D_HH
@@ -373,6 +373,18 @@ void XMLwriter::setString(std::string const& value)
 }
 
 
+void XMLwriter::setAttribute(std::string const& attributeName, std::string const& value)
+{
+    std::vector<std::pair<std::string,std::string> >& attributes = data_map[currentId].attributes;
+    for (pluint iAttr=0; iAttr<attributes.size(); ++iAttr) {
+        if (attributes[iAttr].first == attributeName) {
+            attributes[iAttr].second = value;
+            return;
+        }
+    }
+    attributes.push_back(std::make_pair(attributeName, value));
+}
+
 XMLwriter& XMLwriter::operator[] (std::string name) {
     std::vector<XMLwriter*>& children = data_map[currentId].children;
     // If node already exists, simply return it.
@@ -101,6 +101,8 @@ public:
     void setString(std::string const& value);
     template<typename T> void set(std::vector<T> const& values);
     template<typename T, int N> void set(Array<T,N> const& values);
+    /// Add an attribute to the tag, or replace its value if it already exists.
+    void setAttribute(std::string const& attributeName, std::string const& value);
     XMLwriter& operator[] (std::string name);
     XMLwriter& operator[] (plint id);
     template<typename ostrT>
@@ -111,6 +113,7 @@ private:
 private:
     struct Data {
         std::string text;
+        std::vector<std::pair<std::string,std::string> > attributes;
         std::vector<XMLwriter*> children;
     };
 private: 
@@ -248,6 +248,10 @@ void XMLwriter::toOutputStream(ostrT& ostr, int indent) const {
             if (data_map.size()>1 || it->first!=0) {
                 ostr << " id=\"" << it->first << "\"";
             }
+            std::vector<std::pair<std::string,std::string> > const& attributes = it->second.attributes;
+            for (pluint iAttr=0; iAttr<attributes.size(); ++iAttr) {
+                ostr << " " << attributes[iAttr].first << "=\"" << attributes[iAttr].second << "\"";
+            }
             if (children.empty()) {
                 ostr << ">";
             }
@@ -45,6 +45,29 @@ struct BlockCommunicator3D {
      *  is being transmitted.
      **/
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const =0;
+    /// Fill the envelopes of several multi-blocks with the same type of content.
+    /** Communicators which support it aggregate the data of all multi-blocks
+     *  into a single message per pair of processes. By default, each multi-block
+     *  is treated separately by its own communicator. The order of the multi-blocks
+     *  must be the same on all processes.
+     **/
+    virtual void duplicateOverlapsInGroup( std::vector<MultiBlock3D*> const& multiBlocks,
+                                           modif::ModifT whichData ) const;
+    /// Non-blocking version of duplicateOverlapsInGroup: start the update.
+    /** The update is completed by completeDuplicateOverlapsInGroup, called on
+     *  the same communicator with the same arguments. In between, the envelopes
+     *  of the multi-blocks must not be accessed, and no other communication may
+     *  be initiated. By default, the full update is executed here.
+     **/
+    virtual void startDuplicateOverlapsInGroup( std::vector<MultiBlock3D*> const& multiBlocks,
+                                                modif::ModifT whichData ) const
+    {
+        duplicateOverlapsInGroup(multiBlocks, whichData);
+    }
+    /// Complete an update started by startDuplicateOverlapsInGroup.
+    virtual void completeDuplicateOverlapsInGroup( std::vector<MultiBlock3D*> const& multiBlocks,
+                                                   modif::ModifT whichData ) const
+    { }
     /// Transmit data between two multi-blocks, according to a user-defined pattern.
     /** The variable whichData specifies which type of content (static/dynamic/full dynamics object)
      *  is being transmitted.
@@ -53,6 +76,15 @@ struct BlockCommunicator3D {
                               MultiBlock3D const& originMultiBlock,
                               MultiBlock3D& destinationMultiBlock,
                               modif::ModifT whichData ) const =0;
+    /// Fill the envelopes with the populations which stream into the bulk of
+    ///   the recipient, after a collision step and before streaming.
+    /** By default, a full update of the static content is executed. Communicators
+     *  which know better ship only the data required by the orientation of each
+     *  overlap (see BlockDataTransfer3D::sendDirectional).
+     **/
+    virtual void duplicateOverlapsDirectionally(MultiBlock3D& multiBlock) const {
+        duplicateOverlaps(multiBlock, modif::staticVariables);
+    }
     virtual void signalPeriodicity() const =0;
 };
 
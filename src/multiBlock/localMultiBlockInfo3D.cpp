@@ -46,7 +46,8 @@ LocalMultiBlockInfo3D::LocalMultiBlockInfo3D (
         SparseBlockStructure3D const& sparseBlock,
         ThreadAttribution const& attribution,
         plint envelopeWidth_ )
-    : envelopeWidth(envelopeWidth_)
+    : envelopeWidth(envelopeWidth_),
+      firstLocalId(0)
 {
     computeMyBlocks(sparseBlock,attribution);
     computeAllNormalOverlaps(sparseBlock);
@@ -64,6 +65,15 @@ std::vector<plint> const&
     return myBlocks;
 }
 
+plint LocalMultiBlockInfo3D::getLocalIndex(plint blockId) const
+{
+    plint pos = blockId-firstLocalId;
+    if (pos<0 || pos>=(plint)localIndices.size()) {
+        return -1;
+    }
+    return localIndices[pos];
+}
+
 std::vector<Overlap3D> const&
     LocalMultiBlockInfo3D::getNormalOverlaps() const
 {
@@ -85,6 +95,8 @@ std::vector<PeriodicOverlap3D> const&
 void LocalMultiBlockInfo3D::swap(LocalMultiBlockInfo3D& rhs) {
     std::swap(envelopeWidth, rhs.envelopeWidth);
     myBlocks.swap(rhs.myBlocks);
+    std::swap(firstLocalId, rhs.firstLocalId);
+    localIndices.swap(rhs.localIndices);
     normalOverlaps.swap(rhs.normalOverlaps);
     periodicOverlaps.swap(rhs.periodicOverlaps);
     periodicOverlapWithRemoteData.swap(rhs.periodicOverlapWithRemoteData);
@@ -94,6 +106,14 @@ void LocalMultiBlockInfo3D::computeMyBlocks(SparseBlockStructure3D const& sparse
                                             ThreadAttribution const& attribution)
 {
     myBlocks = sparseBlock.getLocalBlocks(attribution);
+    if (!myBlocks.empty()) {
+        plint lastLocalId = *std::max_element(myBlocks.begin(), myBlocks.end());
+        firstLocalId = *std::min_element(myBlocks.begin(), myBlocks.end());
+        localIndices.assign(lastLocalId-firstLocalId+1, -1);
+        for (pluint iBlock=0; iBlock<myBlocks.size(); ++iBlock) {
+            localIndices[myBlocks[iBlock]-firstLocalId] = (plint)iBlock;
+        }
+    }
 }
 
 void LocalMultiBlockInfo3D::computeAllNormalOverlaps (
@@ -117,6 +117,9 @@ public:
                            plint envelopeWidth_ );
     /// Index of all blocks local to current processor
     std::vector<plint> const& getBlocks() const;
+    /// Position of a block in getBlocks(), or -1 if the block is not local.
+    ///   This is a constant-time lookup in a precomputed table.
+    plint getLocalIndex(plint blockId) const;
     /// Index of all overlaps for which original or overlap data are on current processor
     std::vector<Overlap3D> const& getNormalOverlaps() const;
     /// Index of all periodic overlaps for which original or overlap data are
@@ -140,6 +143,10 @@ private:
 private:
     plint                          envelopeWidth;
     std::vector<plint>             myBlocks;
+    /// Dense id-to-local-index table, covering the range of ids from
+    ///   firstLocalId to the largest local id.
+    plint                          firstLocalId;
+    std::vector<plint>             localIndices;
     std::vector<Overlap3D>         normalOverlaps;
     std::vector<PeriodicOverlap3D> periodicOverlaps;
     std::vector<PeriodicOverlap3D> periodicOverlapWithRemoteData;
@@ -250,10 +250,12 @@ MultiBlock3D::MultiBlock3D( MultiBlockManagement3D const& multiBlockManagement_,
       combinedStatistics(combinedStatistics_),
       statSubscriber(*this),
       statisticsOn(true),
+      nonBlockingEnvelopeUpdate(false),
       periodicitySwitch(*this),
       internalModifT(modif::staticVariables)
 { 
     id = multiBlockRegistration3D().announce(*this);
+    generation = nextGeneration();
 }
 
 MultiBlock3D::MultiBlock3D(plint nx, plint ny, plint nz, plint envelopeWidth)
@@ -265,10 +267,12 @@ MultiBlock3D::MultiBlock3D(plint nx, plint ny, plint nz, plint envelopeWidth)
       combinedStatistics(defaultMultiBlockPolicy3D().getCombinedStatistics()),
       statSubscriber(*this),
       statisticsOn(true),
+      nonBlockingEnvelopeUpdate(false),
       periodicitySwitch(*this),
       internalModifT(modif::staticVariables)
 { 
     id = multiBlockRegistration3D().announce(*this);
+    generation = nextGeneration();
 }
 
 MultiBlock3D::MultiBlock3D(MultiBlock3D const& rhs)
@@ -282,10 +286,12 @@ MultiBlock3D::MultiBlock3D(MultiBlock3D const& rhs)
       combinedStatistics(rhs.combinedStatistics -> clone()),
       statSubscriber(*this),
       statisticsOn(rhs.statisticsOn),
+      nonBlockingEnvelopeUpdate(rhs.nonBlockingEnvelopeUpdate),
       periodicitySwitch(*this, rhs.periodicitySwitch),
       internalModifT(rhs.internalModifT)
 { 
     id = multiBlockRegistration3D().announce(*this);
+    generation = nextGeneration();
 }
 
 MultiBlock3D::MultiBlock3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
@@ -297,10 +303,12 @@ MultiBlock3D::MultiBlock3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
       combinedStatistics(rhs.combinedStatistics->clone()),
       statSubscriber(*this),
       statisticsOn(true),
+      nonBlockingEnvelopeUpdate(false),
       periodicitySwitch(*this),
       internalModifT(rhs.internalModifT)
 { 
     id = multiBlockRegistration3D().announce(*this);
+    generation = nextGeneration();
 }
 
 void MultiBlock3D::swap(MultiBlock3D& rhs) {
@@ -313,8 +321,11 @@ void MultiBlock3D::swap(MultiBlock3D& rhs) {
     std::swap(internalStatistics, rhs.internalStatistics);
     std::swap(combinedStatistics, rhs.combinedStatistics);
     std::swap(statisticsOn, rhs.statisticsOn);
+    std::swap(nonBlockingEnvelopeUpdate, rhs.nonBlockingEnvelopeUpdate);
     std::swap(periodicitySwitch, rhs.periodicitySwitch);
     std::swap(internalModifT, rhs.internalModifT);
+    std::swap(generation, rhs.generation);
+    localComponents.swap(rhs.localComponents);
 }
 
 MultiBlock3D::~MultiBlock3D() {
@@ -327,6 +338,15 @@ id_t MultiBlock3D::getId() const {
     return id;
 }
 
+id_t MultiBlock3D::getGeneration() const {
+    return generation;
+}
+
+id_t MultiBlock3D::nextGeneration() {
+    static id_t currentGeneration = 0;
+    return currentGeneration++;
+}
+
 void MultiBlock3D::initialize() {
     executeInternalProcessors();
 }
@@ -359,6 +379,53 @@ LocalMultiBlockInfo3D const& MultiBlock3D::getLocalInfo() const {
     return multiBlockManagement.getLocalInfo();
 }
 
+AtomicBlock3D& MultiBlock3D::getLocalComponent(plint blockId) {
+    plint localIndex = getLocalInfo().getLocalIndex(blockId);
+    // Fall back to the generic access if the derived class has not
+    //   (yet) resolved its components.
+    if (localIndex<0 || localIndex>=(plint)localComponents.size()) {
+        return getComponent(blockId);
+    }
+    return *localComponents[localIndex];
+}
+
+AtomicBlock3D const& MultiBlock3D::getLocalComponent(plint blockId) const {
+    plint localIndex = getLocalInfo().getLocalIndex(blockId);
+    if (localIndex<0 || localIndex>=(plint)localComponents.size()) {
+        return getComponent(blockId);
+    }
+    return *localComponents[localIndex];
+}
+
+void MultiBlock3D::resolveLocalComponents() {
+    std::vector<plint> const& blocks = getLocalInfo().getBlocks();
+    localComponents.resize(blocks.size());
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        localComponents[iBlock] = &getComponent(blocks[iBlock]);
+    }
+}
+
+void MultiBlock3D::reshapeManagement (
+        MultiBlockManagement3D const& newManagement, std::vector<plint>& droppedBlocks )
+{
+    droppedBlocks.clear();
+    bool sameEnvelope = newManagement.getEnvelopeWidth() == multiBlockManagement.getEnvelopeWidth();
+    std::vector<plint> const& blocks = getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        plint blockId = blocks[iBlock];
+        bool isKept = sameEnvelope &&
+                      newManagement.getLocalInfo().getLocalIndex(blockId) >= 0 &&
+                      newManagement.getBulk(blockId) == multiBlockManagement.getBulk(blockId);
+        if (!isKept) {
+            droppedBlocks.push_back(blockId);
+        }
+    }
+    multiBlockManagement = newManagement;
+    localComponents.clear();
+    generation = nextGeneration();
+    signalPeriodicity();
+}
+
 SparseBlockStructure3D const& MultiBlock3D::getSparseBlockStructure() const {
     return multiBlockManagement.getSparseBlockStructure();
 }
@@ -387,6 +454,10 @@ void MultiBlock3D::duplicateOverlaps(modif::ModifT whichData) {
     this->getBlockCommunicator().duplicateOverlaps(*this, whichData);
 }
 
+void MultiBlock3D::duplicateOverlapsDirectionally() {
+    this->getBlockCommunicator().duplicateOverlapsDirectionally(*this);
+}
+
 void MultiBlock3D::signalPeriodicity() {
     getBlockCommunicator().signalPeriodicity();
 }
@@ -452,6 +523,14 @@ bool MultiBlock3D::isInternalStatisticsOn() const {
     return statisticsOn;
 }
 
+void MultiBlock3D::toggleNonBlockingEnvelopeUpdate(bool nonBlocking) {
+    nonBlockingEnvelopeUpdate = nonBlocking;
+}
+
+bool MultiBlock3D::usesNonBlockingEnvelopeUpdate() const {
+    return nonBlockingEnvelopeUpdate;
+}
+
 PeriodicitySwitch3D const& MultiBlock3D::periodicity() const {
     return periodicitySwitch;
 }
@@ -478,8 +557,21 @@ void MultiBlock3D::setRefinementLevel(plint newLevel)
 void MultiBlock3D::executeInternalProcessors() {
     global::profiler().start("dataProcessor");
     // Execute all automatic internal processors.
+    std::vector<MultiBlock3D*> pendingGroup;
+    modif::ModifT pendingType = modif::nothing;
     for (plint iLevel=0; iLevel<=maxProcessorLevel; ++iLevel) {
-        executeInternalProcessors(iLevel);
+        executeInternalProcessors(iLevel, false);
+        if (!pendingGroup.empty()) {
+            pendingGroup[0]->getBlockCommunicator().completeDuplicateOverlapsInGroup (
+                    pendingGroup, pendingType );
+            pendingGroup.clear();
+        }
+        if (nonBlockingEnvelopeUpdate && iLevel<maxProcessorLevel) {
+            startOverlapsInModifiedMultiBlocks(iLevel, pendingGroup, pendingType);
+        }
+        else {
+            duplicateOverlapsInModifiedMultiBlocks(iLevel);
+        }
     }
     // Duplicate boundaries at least once in case there is no automatic processor.
     if (maxProcessorLevel==-1) {
@@ -494,7 +586,7 @@ void MultiBlock3D::executeInternalProcessors(plint level, bool communicate) {
     std::vector<plint> const& blocks = getLocalInfo().getBlocks();
     for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
         plint blockId = blocks[iBlock];
-        getComponent(blockId).executeInternalProcessors(level);
+        getLocalComponent(blockId).executeInternalProcessors(level);
     }
     if (communicate) {
         duplicateOverlapsInModifiedMultiBlocks(level);
@@ -534,6 +626,21 @@ std::vector<MultiBlock3D::ProcessorStorage3D> const&
     return storedProcessors;
 }
 
+void MultiBlock3D::clearProcessors() {
+    std::vector<plint> const& blocks = getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        getLocalComponent(blocks[iBlock]).clearDataProcessors();
+    }
+    multiBlocksChangedByManualProcessors.clear();
+    multiBlocksChangedByAutomaticProcessors.clear();
+    maxProcessorLevel = -1;
+    storedProcessors.clear();
+}
+
+plint MultiBlock3D::getMaxProcessorLevel() const {
+    return maxProcessorLevel;
+}
+
 void MultiBlock3D::addModifiedBlocks (
         plint level,
         std::vector<MultiBlock3D*> modifiedBlocks,
@@ -599,35 +706,130 @@ void MultiBlock3D::duplicateOverlapsInModifiedMultiBlocks(plint level) {
 void MultiBlock3D::duplicateOverlapsInModifiedMultiBlocks (
         std::vector<BlockAndModif>& multiBlocks )
 {
-    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
-        multiBlocks[iBlock].first->duplicateOverlaps (
-                multiBlocks[iBlock].second );
-    }
+    duplicateOverlapsInGroups(multiBlocks);
 }
 
 
 void MultiBlock3D::duplicateOverlapsAtLevelZero (
         std::vector<BlockAndModif>& multiBlocks )
 {
+    duplicateOverlapsInGroups(includeCurrentBlock(multiBlocks));
+}
+
+std::vector<MultiBlock3D::BlockAndModif> MultiBlock3D::includeCurrentBlock (
+        std::vector<BlockAndModif> const& multiBlocks )
+{
+    std::vector<BlockAndModif> toDuplicate(multiBlocks);
     bool treatedThis = false;
-    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
-        MultiBlock3D* modifiedBlock = multiBlocks[iBlock].first;
-        modif::ModifT modificationType = multiBlocks[iBlock].second;
-        if (modifiedBlock==this) {
+    for (pluint iBlock=0; iBlock<toDuplicate.size(); ++iBlock) {
+        if (toDuplicate[iBlock].first==this) {
             treatedThis = true;
             // If it's the current multi-block we are treating, make sure
             //   type of modification is equal to internalModifT or stronger.
-            this->duplicateOverlaps(combine(modificationType, internalModifT));
-        }
-        else {
-            modifiedBlock->duplicateOverlaps(modificationType);
+            toDuplicate[iBlock].second = combine(toDuplicate[iBlock].second, internalModifT);
         }
     }
     // If current multi-block has not already been treated, duplicate
     //   overlaps explicitly (because overlaps are expected to be duplicated
     //   in any case at level 0).
     if (!treatedThis) {
-        this->duplicateOverlaps(internalModifT);
+        toDuplicate.push_back(BlockAndModif(this, internalModifT));
+    }
+    return toDuplicate;
+}
+
+void MultiBlock3D::groupByModification (
+        std::vector<BlockAndModif> const& multiBlocks,
+        std::vector<std::vector<MultiBlock3D*> >& groups,
+        std::vector<modif::ModifT>& types ) const
+{
+    std::vector<bool> treated(multiBlocks.size(), false);
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        if (treated[iBlock]) continue;
+        modif::ModifT modificationType = multiBlocks[iBlock].second;
+        std::vector<MultiBlock3D*> group;
+        for (pluint jBlock=iBlock; jBlock<multiBlocks.size(); ++jBlock) {
+            if (!treated[jBlock] && multiBlocks[jBlock].second==modificationType) {
+                treated[jBlock] = true;
+                if (std::find(group.begin(), group.end(), multiBlocks[jBlock].first)==group.end()) {
+                    group.push_back(multiBlocks[jBlock].first);
+                }
+            }
+        }
+        groups.push_back(group);
+        types.push_back(modificationType);
+    }
+}
+
+void MultiBlock3D::duplicateOverlapsInGroups (
+        std::vector<BlockAndModif> const& multiBlocks )
+{
+    // Multi-blocks with the same type of modification are grouped, so that
+    //   the communicator can send their data in a common message. The order
+    //   of the groups, and inside the groups, is the same on all processes.
+    std::vector<std::vector<MultiBlock3D*> > groups;
+    std::vector<modif::ModifT> types;
+    groupByModification(multiBlocks, groups, types);
+    for (pluint iGroup=0; iGroup<groups.size(); ++iGroup) {
+        groups[iGroup][0]->getBlockCommunicator().duplicateOverlapsInGroup(groups[iGroup], types[iGroup]);
+    }
+}
+
+void MultiBlock3D::startOverlapsInModifiedMultiBlocks (
+        plint level, std::vector<MultiBlock3D*>& pendingGroup, modif::ModifT& pendingType )
+{
+    PLB_PRECONDITION( level>=0 && level<maxProcessorLevel );
+    pendingGroup.clear();
+    std::vector<BlockAndModif> multiBlocks;
+    if (level==0) {
+        multiBlocks = includeCurrentBlock(multiBlocksChangedByAutomaticProcessors[level]);
+    }
+    else if (level < (plint)multiBlocksChangedByAutomaticProcessors.size()) {
+        multiBlocks = multiBlocksChangedByAutomaticProcessors[level];
+    }
+    std::vector<std::vector<MultiBlock3D*> > groups;
+    std::vector<modif::ModifT> types;
+    groupByModification(multiBlocks, groups, types);
+
+    // All multi-blocks accessed by the processors of the next level, as
+    //   declared when they were added.
+    std::vector<id_t> nextLevelBlocks;
+    for (pluint iProcessor=0; iProcessor<storedProcessors.size(); ++iProcessor) {
+        if (storedProcessors[iProcessor].getLevel()==level+1) {
+            std::vector<id_t> const& args = storedProcessors[iProcessor].getMultiBlockIds();
+            nextLevelBlocks.insert(nextLevelBlocks.end(), args.begin(), args.end());
+        }
+    }
+
+    // Only one update at a time can be in flight. The last group which is
+    //   independent of the next level is chosen; the decision is the same on
+    //   all processes.
+    plint deferredGroup = -1;
+    if (!nextLevelBlocks.empty()) {
+        for (plint iGroup=(plint)groups.size()-1; iGroup>=0 && deferredGroup<0; --iGroup) {
+            bool independent = true;
+            for (pluint iBlock=0; iBlock<groups[iGroup].size(); ++iBlock) {
+                if (std::find(nextLevelBlocks.begin(), nextLevelBlocks.end(),
+                              groups[iGroup][iBlock]->getId()) != nextLevelBlocks.end())
+                {
+                    independent = false;
+                }
+            }
+            if (independent) {
+                deferredGroup = iGroup;
+            }
+        }
+    }
+
+    for (plint iGroup=0; iGroup<(plint)groups.size(); ++iGroup) {
+        if (iGroup!=deferredGroup) {
+            groups[iGroup][0]->getBlockCommunicator().duplicateOverlapsInGroup(groups[iGroup], types[iGroup]);
+        }
+    }
+    if (deferredGroup>=0) {
+        pendingGroup = groups[deferredGroup];
+        pendingType = types[deferredGroup];
+        pendingGroup[0]->getBlockCommunicator().startDuplicateOverlapsInGroup(pendingGroup, pendingType);
     }
 }
 
@@ -664,6 +866,15 @@ MultiBlock3D* MultiBlockRegistration3D::find(id_t id) {
 }
 
 
+std::vector<MultiBlock3D*> MultiBlockRegistration3D::getMultiBlocks() const {
+    std::vector<MultiBlock3D*> result;
+    std::map<id_t,MultiBlock3D*>::const_iterator it = multiBlocks.begin();
+    for (; it != multiBlocks.end(); ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
 MultiBlockRegistration3D::MultiBlockRegistration3D(MultiBlockRegistration3D const& rhs)
 { }
 
@@ -122,6 +122,13 @@ public:
     void swap(MultiBlock3D& rhs);
     virtual ~MultiBlock3D();
     id_t getId() const;
+    /// Identifier of the current set of atomic-blocks.
+    /** It changes each time the atomic-blocks are reallocated (e.g. by
+     *  reshape() or by an assignment), and is never reused. Together with
+     *  getId(), it tells whether data which refers to the atomic-blocks, such
+     *  as pre-resolved data processors, is still valid.
+     **/
+    id_t getGeneration() const;
     virtual int getStaticId() const =0;
     virtual MultiBlock3D* clone() const =0;
     virtual MultiBlock3D* clone(MultiBlockManagement3D const& newManagement) const =0;
@@ -136,6 +143,11 @@ public:
     /// Get number of cells in z-direction.
     plint getNz() const;
     /// Execute all internal dataProcessors at positive or zero level.
+    /** With non-blocking envelope updates (enabled through
+     *  toggleNonBlockingEnvelopeUpdate), the envelope update which follows a
+     *  level is left in flight while the processors of the next level execute,
+     *  provided that they involve none of the multi-blocks being updated.
+     **/
     void executeInternalProcessors();
     /// Execute all internal dataProcessors at a given level.
     void executeInternalProcessors(plint level, bool communicate=true);
@@ -148,6 +160,11 @@ public:
     void storeProcessor(DataProcessorGenerator3D const& generator,
                         std::vector<MultiBlock3D*> multiBlocks, plint level);
     std::vector<ProcessorStorage3D> const& getStoredProcessors() const;
+    /// Remove the internal processors from the atomic-blocks, and discard
+    ///   the stored processors and their envelope-update subscriptions.
+    void clearProcessors();
+    /// Highest level of the automatic internal processors, or -1 if there are none.
+    plint getMaxProcessorLevel() const;
 public:
     MultiBlockManagement3D const& getMultiBlockManagement() const;
     void setCoProcessors(std::map<plint,int> const& coProcessors);
@@ -165,6 +182,10 @@ public:
     CombinedStatistics const& getCombinedStatistics() const;
     void toggleInternalStatistics(bool statisticsOn_);
     bool isInternalStatisticsOn() const;
+    /// Overlap the envelope updates between processor levels with the
+    ///   execution of the next level, where possible. Off by default.
+    void toggleNonBlockingEnvelopeUpdate(bool nonBlocking);
+    bool usesNonBlockingEnvelopeUpdate() const;
     PeriodicitySwitch3D const& periodicity() const;
     PeriodicitySwitch3D& periodicity();
     /// Returns: which kind of data is modified by level-0 processors and by
@@ -177,8 +198,31 @@ public:
 public:
     virtual AtomicBlock3D& getComponent(plint blockId) =0;
     virtual AtomicBlock3D const& getComponent(plint blockId) const =0;
+    /// Same as getComponent, for a block which is local to the current
+    ///   process, but through a constant-time table lookup instead of a
+    ///   search in the id-to-block map of the derived class.
+    AtomicBlock3D& getLocalComponent(plint blockId);
+    /// Same as getComponent, for a block which is local to the current
+    ///   process, but through a constant-time table lookup.
+    AtomicBlock3D const& getLocalComponent(plint blockId) const;
     virtual plint sizeOfCell() const =0;
     virtual plint getCellDim() const =0;
+protected:
+    /// Store pointers to the local components in a dense table, indexed as
+    ///   getLocalInfo().getBlocks(). Must be called by the derived classes
+    ///   each time the local components are (re-)allocated.
+    void resolveLocalComponents();
+    /// Replace the block-structure, in view of a reshape() of the derived class.
+    /** A local block is kept if it is local in the new structure as well, with
+     *  the same bulk, and if the envelope width is unchanged. The ids of the
+     *  other local blocks of the current structure are returned in
+     *  droppedBlocks. The derived class must deallocate them, allocate the
+     *  new local blocks, and call resolveLocalComponents().
+     **/
+    void reshapeManagement( MultiBlockManagement3D const& newManagement,
+                            std::vector<plint>& droppedBlocks );
+private:
+    static id_t nextGeneration();
 private:
     void addModifiedBlocks(plint level,
                            std::vector<MultiBlock3D*> modifiedBlocks,
@@ -188,6 +232,24 @@ private:
     void duplicateOverlapsInModifiedMultiBlocks(plint level);
     void duplicateOverlapsInModifiedMultiBlocks(std::vector<BlockAndModif>& multiBlocks);
     void duplicateOverlapsAtLevelZero(std::vector<BlockAndModif>& multiBlocks);
+    /// Add the current multi-block to the blocks modified at level 0, as
+    ///   its overlaps are duplicated in any case at this level.
+    std::vector<BlockAndModif> includeCurrentBlock(std::vector<BlockAndModif> const& multiBlocks);
+    /// Split a list of modified multi-blocks into groups with the same type
+    ///   of modification, in the same order on all processes.
+    void groupByModification( std::vector<BlockAndModif> const& multiBlocks,
+                              std::vector<std::vector<MultiBlock3D*> >& groups,
+                              std::vector<modif::ModifT>& types ) const;
+    /// Update the envelopes after the processors of a given level, but leave
+    ///   the update of one group of multi-blocks pending if none of them is
+    ///   involved in the processors of the next level. The pending group is
+    ///   returned, and is empty if all updates have been completed.
+    void startOverlapsInModifiedMultiBlocks( plint level,
+                                             std::vector<MultiBlock3D*>& pendingGroup,
+                                             modif::ModifT& pendingType );
+    /// Duplicate the overlaps of all multi-blocks which share the same type
+    ///   of modification in a single, aggregated communication step.
+    void duplicateOverlapsInGroups(std::vector<BlockAndModif> const& multiBlocks);
     void reduceStatistics();
 public:
     BlockCommunicator3D const& getBlockCommunicator() const;
@@ -195,6 +257,9 @@ public:
                 MultiBlock3D const& fromBlock, Box3D const& fromDomain,
                 Box3D const& toDomain, modif::ModifT whichData=modif::dataStructure ) =0;
     void duplicateOverlaps(modif::ModifT whichData);
+    /// Update the envelopes with the populations which stream into the bulk only
+    ///   (see BlockCommunicator3D::duplicateOverlapsDirectionally).
+    void duplicateOverlapsDirectionally();
     void signalPeriodicity();
     virtual DataSerializer* getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const;
@@ -224,9 +289,13 @@ private:
     CombinedStatistics* combinedStatistics;
     MultiStatSubscriber3D statSubscriber;
     bool statisticsOn;
+    bool nonBlockingEnvelopeUpdate;
     PeriodicitySwitch3D periodicitySwitch;
     modif::ModifT internalModifT;
     id_t id;
+    id_t generation;
+    /// Local components, indexed like getLocalInfo().getBlocks().
+    std::vector<AtomicBlock3D*> localComponents;
 };
 
 class MultiBlockRegistration3D {
@@ -234,6 +303,8 @@ public:
     id_t announce(MultiBlock3D& block);
     void release(MultiBlock3D& block);
     MultiBlock3D* find(id_t id);
+    /// All registered multi-blocks, in the order of their ids.
+    std::vector<MultiBlock3D*> getMultiBlocks() const;
 private:
     MultiBlockRegistration3D();
     MultiBlockRegistration3D(MultiBlockRegistration3D const& rhs);
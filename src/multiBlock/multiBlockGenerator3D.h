@@ -452,10 +452,13 @@ std::auto_ptr<MultiTensorField3D<T,nDim> > reparallelize (
 
 /// Generate a multi-block-lattice from scratch. As opposed to the standard
 ///   constructor, this factory function takes a full bounding-box, as well
-///   as the envelope-width, as arguments.
+///   as the envelope-width, as arguments. With inPlaceStreaming, the lattice
+///   uses the in-place (AA-pattern) propagation, and the envelope is widened
+///   as required by it (see MultiBlockLattice3D::toggleInPlaceStreaming()).
 template<typename T, template<typename U> class Descriptor>
 std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
-        Box3D boundingBox, Dynamics<T,Descriptor>* backgroundDynamics, plint envelopeWidth=1 );
+        Box3D boundingBox, Dynamics<T,Descriptor>* backgroundDynamics, plint envelopeWidth=1,
+        bool inPlaceStreaming=false );
 
 /// Generate a multi-block-lattice from scratch. As opposed to the standard
 ///   constructor, this factory function takes the explicit block-management
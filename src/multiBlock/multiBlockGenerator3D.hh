@@ -43,6 +43,7 @@
 #include "multiBlock/multiBlockOperations3D.h"
 #include "dataProcessors/dataAnalysisWrapper3D.h"
 #include "dataProcessors/ntensorAnalysisWrapper3D.h"
+#include <algorithm>
 
 namespace plb {
 
@@ -944,9 +945,13 @@ void transferBlockLatticeNonLocal (
 
 template<typename T, template<typename U> class Descriptor>
 std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
-        Box3D boundingBox, Dynamics<T,Descriptor>* backgroundDynamics, plint envelopeWidth )
+        Box3D boundingBox, Dynamics<T,Descriptor>* backgroundDynamics, plint envelopeWidth,
+        bool inPlaceStreaming )
 {
-    return std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > (
+    if (inPlaceStreaming) {
+        envelopeWidth = std::max(envelopeWidth, (plint)2*Descriptor<T>::vicinity);
+    }
+    std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > lattice (
         new MultiBlockLattice3D<T,Descriptor> (
             defaultMultiBlockPolicy3D().getMultiBlockManagement(boundingBox, envelopeWidth),
             defaultMultiBlockPolicy3D().getBlockCommunicator(),
@@ -954,6 +959,8 @@ std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
             defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>(),
             backgroundDynamics )
     );
+    lattice->toggleInPlaceStreaming(inPlaceStreaming);
+    return lattice;
 }
 
 template<typename T, template<typename U> class Descriptor>
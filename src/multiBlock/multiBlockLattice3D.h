@@ -94,6 +94,11 @@ public:
     /// Attention: data-processors of rhs, which were pointing at rhs, will continue pointing
     /// to rhs, and not to *this.
     MultiBlockLattice3D<T,Descriptor>& operator=(MultiBlockLattice3D<T,Descriptor> const& rhs);
+    /// Move to a new block-structure, keeping the atomic-blocks which are
+    ///   unchanged (see MultiBlock3D::reshapeManagement()). The atomic-blocks
+    ///   which are new are filled with the background dynamics at rest. A
+    ///   pending in-place streaming step is completed first.
+    void reshape(MultiBlockManagement3D const& newManagement);
 
     Dynamics<T,Descriptor> const& getBackgroundDynamics() const;
     virtual Cell<T,Descriptor>& get(plint iX, plint iY, plint iZ);
@@ -105,6 +110,42 @@ public:
     virtual void stream();
     virtual void collideAndStream(Box3D domain);
     virtual void collideAndStream();
+    /// Replace the full envelope update by a direction-selective exchange.
+    /** In this mode, collideAndStream() collides the bulk only, ships the
+     *  post-collision populations which stream into the bulk of the neighbors,
+     *  and then streams. After a time step, the envelopes are therefore not
+     *  up-to-date: call duplicateOverlaps(modif::staticVariables) before
+     *  evaluating non-local quantities. The full update is kept automatically
+     *  when the block has internal data processors or co-processors, or when
+     *  dynamics objects modify more than the static cell content.
+     **/
+    void toggleDirectionalExchange(bool flag);
+    bool usesDirectionalExchange() const;
+    /// Replace the swap-based streaming by an in-place (AA-pattern) propagation.
+    /** Time steps alternate between an even step, which collides every cell
+     *  locally and leaves the post-collision populations in the opposite slot,
+     *  and an odd step, which streams, collides and streams again in a single
+     *  memory pass (see BlockLattice3D::inPlaceCollideAndStream()). The envelope
+     *  is updated once every two steps, after the odd step; the odd step
+     *  recomputes the inner layer of the envelope instead of receiving it, and
+     *  therefore requires an envelope width of at least twice the vicinity of
+     *  the lattice (see generateMultiBlockLattice()).
+     *
+     *  After an even step, the populations are not in their standard layout:
+     *  only evaluate the lattice after an odd step, or call
+     *  completeInPlaceStreaming() first. The standard algorithm is used whenever
+     *  the block has internal data processors or co-processors, when dynamics
+     *  objects modify more than the static cell content, or when the envelope
+     *  is too thin.
+     **/
+    void toggleInPlaceStreaming(bool flag);
+    bool usesInPlaceStreaming() const;
+    /// Say if the last time step was an even in-place step, which leaves
+    ///   the populations in a non-standard layout.
+    bool hasPendingInPlaceStreaming() const;
+    /// Conclude a pending even in-place step by streaming the populations
+    ///   and updating the envelope. Does nothing if no step is pending.
+    void completeInPlaceStreaming();
     virtual void incrementTime();
     virtual void resetTime(pluint value);
     virtual BlockLattice3D<T,Descriptor>& getComponent(plint blockId);
@@ -126,12 +167,23 @@ public:
     static std::string descriptorType();
 private:
     void allocateAndInitialize();
+    void allocateBlocks();
     void eliminateStatisticsInEnvelope();
     Box3D extendPeriodic(Box3D const& box, plint envelopeWidth) const;
+    bool canExchangeDirectionally() const;
+    void collideAndStreamDirectionally();
+    bool canStreamInPlace() const;
+    void collideAndStreamInPlace();
+    /// Domain of a block on which collision and streaming is applied,
+    ///   including the currently active envelopes.
+    Box3D computeCollideAndStreamDomain(plint blockId) const;
 private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     MultiCellAccess3D<T,Descriptor>* multiCellAccess;
     BlockMap blockLattices;
+    bool directionalExchange;
+    bool inPlaceStreaming;
+    bool pendingInPlaceStreaming;
 public:
     static const int staticId;
 };
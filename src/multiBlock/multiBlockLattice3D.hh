@@ -65,7 +65,10 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(multiBlockManagement_, blockCommunicator_, combinedStatistics_ ),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(multiCellAccess_)
+      multiCellAccess(multiCellAccess_),
+      directionalExchange(false),
+      inPlaceStreaming(false),
+      pendingInPlaceStreaming(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -78,7 +81,10 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(nx,ny,nz,Descriptor<T>::vicinity),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      directionalExchange(false),
+      inPlaceStreaming(false),
+      pendingInPlaceStreaming(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -101,13 +107,17 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlockLattice3D<T,Des
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       MultiBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
-      multiCellAccess(rhs.multiCellAccess->clone())
+      multiCellAccess(rhs.multiCellAccess->clone()),
+      directionalExchange(rhs.directionalExchange),
+      inPlaceStreaming(rhs.inPlaceStreaming),
+      pendingInPlaceStreaming(rhs.pendingInPlaceStreaming)
 {
     for ( typename  BlockMap::const_iterator it = rhs.blockLattices.begin();
           it != rhs.blockLattices.end(); ++it )
     {
         blockLattices[it->first] = new BlockLattice3D<T,Descriptor>(*it->second);
     }
+    this->resolveLocalComponents();
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -115,7 +125,10 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs)
       // Use MultiBlock's sub-domain constructor to avoid that the data-processors are copied
     : MultiBlock3D(rhs, rhs.getBoundingBox(), false),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      directionalExchange(false),
+      inPlaceStreaming(false),
+      pendingInPlaceStreaming(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -125,7 +138,10 @@ template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
     : MultiBlock3D(rhs, subDomain, crop),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      directionalExchange(false),
+      inPlaceStreaming(false),
+      pendingInPlaceStreaming(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -138,6 +154,9 @@ void MultiBlockLattice3D<T,Descriptor>::swap(MultiBlockLattice3D<T,Descriptor>&
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(multiCellAccess, rhs.multiCellAccess);
     blockLattices.swap(rhs.blockLattices);
+    std::swap(directionalExchange, rhs.directionalExchange);
+    std::swap(inPlaceStreaming, rhs.inPlaceStreaming);
+    std::swap(pendingInPlaceStreaming, rhs.pendingInPlaceStreaming);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -305,6 +324,15 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
+    if (inPlaceStreaming && canStreamInPlace()) {
+        collideAndStreamInPlace();
+        return;
+    }
+    completeInPlaceStreaming();
+    if (directionalExchange && canExchangeDirectionally()) {
+        collideAndStreamDirectionally();
+        return;
+    }
     global::profiler().start("cycle");
     ThreadAttribution const& threadAttribution=this->getMultiBlockManagement().getThreadAttribution();
     if (threadAttribution.hasCoProcessors()) {
@@ -347,6 +375,163 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
     global::profiler().stop("cycle");
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::toggleDirectionalExchange(bool flag) {
+    directionalExchange = flag;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::usesDirectionalExchange() const {
+    return directionalExchange;
+}
+
+/** The direction-selective exchange leaves parts of the envelope outdated,
+ *  which is only acceptable if nobody but the streaming step reads it.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::canExchangeDirectionally() const {
+    bool canExchange =
+           this->getMaxProcessorLevel() < 0 &&
+           this->getInternalTypeOfModification() == modif::staticVariables &&
+           !this->getMultiBlockManagement().getThreadAttribution().hasCoProcessors();
+    // The decision must be the same on all processes, as the directional
+    //   exchange uses a different communication pattern.
+#ifdef PLB_MPI_PARALLEL
+    int canExchangeEverywhere = canExchange ? 1 : 0;
+    global::mpi().reduceAndBcast(canExchangeEverywhere, MPI_LAND);
+    canExchange = canExchangeEverywhere != 0;
+#endif
+    return canExchange;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::collideAndStreamDirectionally() {
+    global::profiler().start("cycle");
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+        it->second -> collide( bulk.toLocal(bulk.getBulk()) );
+    }
+    global::profiler().start("envelope-update");
+    this->duplicateOverlapsDirectionally();
+    global::profiler().stop("envelope-update");
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+        Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(),
+                                      this->getMultiBlockManagement().getEnvelopeWidth());
+        it->second -> stream( bulk.toLocal(domain) );
+    }
+    this->evaluateStatistics();
+    this->incrementTime();
+    if (global::profiler().cyclingIsAutomatic()) {
+        global::profiler().cycle();
+    }
+    global::profiler().stop("cycle");
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::toggleInPlaceStreaming(bool flag) {
+    if (!flag) {
+        completeInPlaceStreaming();
+    }
+    inPlaceStreaming = flag;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::usesInPlaceStreaming() const {
+    return inPlaceStreaming;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::hasPendingInPlaceStreaming() const {
+    return pendingInPlaceStreaming;
+}
+
+/** The odd step must be able to recompute all cells which stream into the
+ *  bulk, which requires twice the vicinity in the envelope.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::canStreamInPlace() const {
+    return this->getMaxProcessorLevel() < 0 &&
+           this->getInternalTypeOfModification() == modif::staticVariables &&
+           !this->getMultiBlockManagement().getThreadAttribution().hasCoProcessors() &&
+           this->getMultiBlockManagement().getEnvelopeWidth() >= 2*Descriptor<T>::vicinity;
+}
+
+template<typename T, template<typename U> class Descriptor>
+Box3D MultiBlockLattice3D<T,Descriptor>::computeCollideAndStreamDomain(plint blockId) const
+{
+    SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
+    return extendPeriodic(bulk.computeNonPeriodicEnvelope(),
+                          this->getMultiBlockManagement().getEnvelopeWidth());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::collideAndStreamInPlace() {
+    global::profiler().start("cycle");
+    if (!pendingInPlaceStreaming) {
+        // Even step: purely local, including the envelope, which is up-to-date.
+        for ( typename BlockMap::iterator it = blockLattices.begin();
+              it != blockLattices.end(); ++it)
+        {
+            SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+            it->second -> collide( bulk.toLocal(computeCollideAndStreamDomain(it->first)) );
+        }
+        pendingInPlaceStreaming = true;
+    }
+    else {
+        // Odd step: cells are treated up to a distance of "vicinity" from the
+        //   outer edge of the envelope. On the sides on which the domain ends
+        //   at the non-periodic boundary of the lattice, cells are treated
+        //   up to the edge, and populations from outside are taken from the
+        //   cell itself, just like in the swap-based algorithm.
+        static const plint vicinity = Descriptor<T>::vicinity;
+        Box3D boundingBox(this->getBoundingBox());
+        for ( typename BlockMap::iterator it = blockLattices.begin();
+              it != blockLattices.end(); ++it)
+        {
+            SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+            Box3D bound = computeCollideAndStreamDomain(it->first);
+            Box3D domain (
+                    bound.x0==boundingBox.x0 ? bound.x0 : bound.x0+vicinity,
+                    bound.x1==boundingBox.x1 ? bound.x1 : bound.x1-vicinity,
+                    bound.y0==boundingBox.y0 ? bound.y0 : bound.y0+vicinity,
+                    bound.y1==boundingBox.y1 ? bound.y1 : bound.y1-vicinity,
+                    bound.z0==boundingBox.z0 ? bound.z0 : bound.z0+vicinity,
+                    bound.z1==boundingBox.z1 ? bound.z1 : bound.z1-vicinity );
+            it->second -> inPlaceCollideAndStream( bulk.toLocal(domain), bulk.toLocal(bound) );
+        }
+        pendingInPlaceStreaming = false;
+        this->executeInternalProcessors();
+    }
+    this->evaluateStatistics();
+    this->incrementTime();
+    if (global::profiler().cyclingIsAutomatic()) {
+        global::profiler().cycle();
+    }
+    global::profiler().stop("cycle");
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::completeInPlaceStreaming() {
+    if (!pendingInPlaceStreaming) {
+        return;
+    }
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+        it->second -> stream( bulk.toLocal(computeCollideAndStreamDomain(it->first)) );
+    }
+    pendingInPlaceStreaming = false;
+    global::profiler().start("envelope-update");
+    this->duplicateOverlaps(modif::staticVariables);
+    global::profiler().stop("envelope-update");
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
     for ( typename BlockMap::iterator it = blockLattices.begin();
@@ -374,9 +559,17 @@ void MultiBlockLattice3D<T,Descriptor>::allocateAndInitialize()
     this->getInternalStatistics().subscribeAverage(); // Subscribe average rho-bar
     this->getInternalStatistics().subscribeAverage(); // Subscribe average uSqr
     this->getInternalStatistics().subscribeMax();     // Subscribe max uSqr
+    allocateBlocks();
+}
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::allocateBlocks()
+{
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock) {
         plint blockId = this->getLocalInfo().getBlocks()[iBlock];
+        if (blockLattices.find(blockId) != blockLattices.end()) {
+            continue; // Kept by reshape().
+        }
         SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
         Box3D envelope = bulk.computeEnvelope();
         BlockLattice3D<T,Descriptor>* newLattice
@@ -384,8 +577,26 @@ void MultiBlockLattice3D<T,Descriptor>::allocateAndInitialize()
                     envelope.getNx(), envelope.getNy(), envelope.getNz(),
                     backgroundDynamics->clone() );
         newLattice -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
+        // Same subscriptions as the multi-block, including the ones added after construction.
+        newLattice -> getInternalStatistics() = this->getInternalStatistics();
         blockLattices[blockId] = newLattice;
     }
+    this->resolveLocalComponents();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::reshape(MultiBlockManagement3D const& newManagement)
+{
+    completeInPlaceStreaming();
+    std::vector<plint> droppedBlocks;
+    this->reshapeManagement(newManagement, droppedBlocks);
+    for (pluint iBlock=0; iBlock<droppedBlocks.size(); ++iBlock) {
+        typename BlockMap::iterator it = blockLattices.find(droppedBlocks[iBlock]);
+        delete it->second;
+        blockLattices.erase(it);
+    }
+    allocateBlocks();
+    eliminateStatisticsInEnvelope();
 }
 
 template<typename T, template<typename U> class Descriptor>
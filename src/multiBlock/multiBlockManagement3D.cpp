@@ -419,6 +419,13 @@ Box3D SmartBulk3D::computeNonPeriodicEnvelope() const
                    std::min(bulk.z1+envelopeWidth, boundingBox.z1) );
 }
 
+Dot3D SmartBulk3D::computeOrientation(Box3D const& domain) const
+{
+    return Dot3D ( domain.x1<bulk.x0 ? -1 : (domain.x0>bulk.x1 ? 1 : 0),
+                   domain.y1<bulk.y0 ? -1 : (domain.y0>bulk.y1 ? 1 : 0),
+                   domain.z1<bulk.z0 ? -1 : (domain.z0>bulk.z1 ? 1 : 0) );
+}
+
 Box3D SmartBulk3D::toLocal(Box3D const& coord) const
 {
     return Box3D( coord.shift(-bulk.x0+envelopeWidth, -bulk.y0+envelopeWidth,
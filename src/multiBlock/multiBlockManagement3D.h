@@ -151,6 +151,9 @@ public:
     Box3D computeEnvelope() const;
     /// Compute envelope of a given block, exluding margins of the outer domain.
     Box3D computeNonPeriodicEnvelope() const;
+    /// Position of a domain in the envelope with respect to the bulk: each
+    ///   component is -1 (below), +1 (above), or 0 (overlapping with the bulk).
+    Dot3D computeOrientation(Box3D const& domain) const;
     /// Convert to local coordinates of a given block.
     Box3D toLocal(Box3D const& coord) const;
     /// Convert to local x-coordinate of a given block.
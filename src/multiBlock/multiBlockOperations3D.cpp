@@ -34,6 +34,7 @@
 #include "atomicBlock/atomicBlockOperations3D.h"
 #include "multiGrid/multiScale.h"
 #include "core/plbDebug.h"
+#include <algorithm>
 
 namespace plb {
 
@@ -328,7 +329,7 @@ void executeDataProcessor( DataProcessorGenerator3D const& generator,
         std::vector<AtomicBlock3D*> extractedAtomicBlocks(multiBlocks.size());
         for (pluint iBlock=0; iBlock<extractedAtomicBlocks.size(); ++iBlock) {
             extractedAtomicBlocks[iBlock]
-                = &multiBlocks[iBlock]->getComponent(atomicBlockNumbers[iGenerator][iBlock]);
+                = &multiBlocks[iBlock]->getLocalComponent(atomicBlockNumbers[iGenerator][iBlock]);
         }
         // Delegate to the "AtomicBlock version" of executeDataProcessor.
         plb::executeDataProcessor(*retainedGenerators[iGenerator], extractedAtomicBlocks);
@@ -368,7 +369,7 @@ void executeDataProcessor( ReductiveDataProcessorGenerator3D& generator,
     for (pluint iGenerator=0; iGenerator<retainedGenerators.size(); ++iGenerator) {
         std::vector<AtomicBlock3D*> extractedAtomicBlocks(multiBlocks.size());
         for (pluint iBlock=0; iBlock<extractedAtomicBlocks.size(); ++iBlock) {
-            extractedAtomicBlocks[iBlock] = &multiBlocks[iBlock]->getComponent(atomicBlockNumbers[iGenerator][iBlock]);
+            extractedAtomicBlocks[iBlock] = &multiBlocks[iBlock]->getLocalComponent(atomicBlockNumbers[iGenerator][iBlock]);
         }
         // Delegate to the "AtomicBlock Reductive version" of executeDataProcessor.
         plb::executeDataProcessor(*retainedGenerators[iGenerator], extractedAtomicBlocks);
@@ -399,6 +400,107 @@ void executeDataProcessor( ReductiveDataProcessorGenerator3D& generator,
 }
 
 
+/* *************** Class CompiledDataProcessor3D ********************* */
+
+CompiledDataProcessor3D::CompiledDataProcessor3D (
+        DataProcessorGenerator3D const& generator_,
+        std::vector<MultiBlock3D*> multiBlocks_ )
+    : generator(generator_.clone()),
+      multiBlocks(multiBlocks_)
+{
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlockIds.push_back(multiBlocks[iBlock]->getId());
+    }
+    compile();
+}
+
+CompiledDataProcessor3D::~CompiledDataProcessor3D() {
+    clear();
+    delete generator;
+}
+
+void CompiledDataProcessor3D::compile() {
+    generations.resize(multiBlocks.size());
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        generations[iBlock] = multiBlocks[iBlock]->getGeneration();
+    }
+
+    MultiProcessing3D<DataProcessorGenerator3D const, DataProcessorGenerator3D >
+        multiProcessing(*generator, multiBlocks);
+    std::vector<DataProcessorGenerator3D*> const& retainedGenerators = multiProcessing.getRetainedGenerators();
+    std::vector<std::vector<plint> > const& atomicBlockNumbers = multiProcessing.getAtomicBlockNumbers();
+
+    std::vector<AtomicBlock3D*> extractedAtomicBlocks(multiBlocks.size());
+    for (pluint iGenerator=0; iGenerator<retainedGenerators.size(); ++iGenerator) {
+        for (pluint iBlock=0; iBlock<extractedAtomicBlocks.size(); ++iBlock) {
+            extractedAtomicBlocks[iBlock]
+                = &multiBlocks[iBlock]->getLocalComponent(atomicBlockNumbers[iGenerator][iBlock]);
+        }
+        processors.push_back(retainedGenerators[iGenerator]->generate(extractedAtomicBlocks));
+    }
+
+    std::vector<MultiBlock3D*> updatedMultiBlocks;
+    std::vector<modif::ModifT> typesOfModification;
+    multiProcessing.multiBlocksWhichRequireUpdate(updatedMultiBlocks, typesOfModification);
+    for (pluint iBlock=0; iBlock<updatedMultiBlocks.size(); ++iBlock) {
+        pluint iGroup = std::find(updateTypes.begin(), updateTypes.end(), typesOfModification[iBlock])
+                        - updateTypes.begin();
+        if (iGroup==updateTypes.size()) {
+            updateTypes.push_back(typesOfModification[iBlock]);
+            updateGroups.push_back(std::vector<MultiBlock3D*>());
+        }
+        if (std::find(updateGroups[iGroup].begin(), updateGroups[iGroup].end(),
+                      updatedMultiBlocks[iBlock]) == updateGroups[iGroup].end())
+        {
+            updateGroups[iGroup].push_back(updatedMultiBlocks[iBlock]);
+        }
+    }
+}
+
+void CompiledDataProcessor3D::clear() {
+    for (pluint iProcessor=0; iProcessor<processors.size(); ++iProcessor) {
+        delete processors[iProcessor];
+    }
+    processors.clear();
+    updateGroups.clear();
+    updateTypes.clear();
+}
+
+bool CompiledDataProcessor3D::isOutdated() const {
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        if (multiBlocks[iBlock]->getGeneration() != generations[iBlock]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CompiledDataProcessor3D::execute() {
+#ifdef PLB_DEBUG
+    for (pluint iBlock=0; iBlock<multiBlockIds.size(); ++iBlock) {
+        PLB_ASSERT( multiBlockRegistration3D().find(multiBlockIds[iBlock]) == multiBlocks[iBlock] );
+    }
+#endif
+    // The generations are the same on all processes, so that the
+    //   (collective) recompilation is triggered consistently.
+    if (isOutdated()) {
+        clear();
+        compile();
+    }
+    for (pluint iProcessor=0; iProcessor<processors.size(); ++iProcessor) {
+        processors[iProcessor]->process();
+    }
+    for (pluint iGroup=0; iGroup<updateGroups.size(); ++iGroup) {
+        updateGroups[iGroup][0]->getBlockCommunicator().duplicateOverlapsInGroup (
+                updateGroups[iGroup], updateTypes[iGroup] );
+    }
+}
+
+plint CompiledDataProcessor3D::getNumLocalProcessors() const {
+    return (plint)processors.size();
+}
+
+
 void addInternalProcessor( DataProcessorGenerator3D const& generator, MultiBlock3D& actor,
                            std::vector<MultiBlock3D*> multiBlockArgs, plint level )
 {
@@ -411,11 +513,11 @@ void addInternalProcessor( DataProcessorGenerator3D const& generator, MultiBlock
         std::vector<AtomicBlock3D*> extractedAtomicBlocks(multiBlockArgs.size());
         for (pluint iBlock=0; iBlock<extractedAtomicBlocks.size(); ++iBlock) {
             extractedAtomicBlocks[iBlock] =
-                &multiBlockArgs[iBlock]->getComponent(atomicBlockNumbers[iGenerator][iBlock]);
+                &multiBlockArgs[iBlock]->getLocalComponent(atomicBlockNumbers[iGenerator][iBlock]);
         }
         // It is assumed that the actor has the same distribution as block 0.
         PLB_ASSERT(!atomicBlockNumbers[iGenerator].empty());
-        AtomicBlock3D& atomicActor = actor.getComponent(atomicBlockNumbers[iGenerator][0]);
+        AtomicBlock3D& atomicActor = actor.getLocalComponent(atomicBlockNumbers[iGenerator][0]);
         // Delegate to the "AtomicBlock version" of addInternal.
         plb::addInternalProcessor(*retainedGenerators[iGenerator], atomicActor, extractedAtomicBlocks, level);
     }
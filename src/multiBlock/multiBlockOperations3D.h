@@ -38,6 +38,7 @@ namespace plb {
 class MultiBlock3D;
 struct DataProcessorGenerator3D;
 class ReductiveDataProcessorGenerator3D;
+struct DataProcessor3D;
 
 void executeDataProcessor( DataProcessorGenerator3D const& generator,
                            std::vector<MultiBlock3D*> multiBlocks );
@@ -72,6 +73,42 @@ void addInternalProcessor( DataProcessorGenerator3D const& generator,
                            MultiBlock3D& object1, MultiBlock3D& object2,
                            plint level=0 );
 
+/// A data processor which is resolved once on a given set of multi-blocks,
+///   and can then be executed repeatedly at the cost of the processing
+///   itself. The decomposition of the domain over the atomic-blocks, the
+///   atomic-block arguments, and the envelope updates which are required
+///   after execution are all computed at construction time. The multi-blocks
+///   must outlive this object. If one of them gets new atomic-blocks in the
+///   meantime (see MultiBlock3D::getGeneration()), the processor is resolved
+///   again on the next execution.
+class CompiledDataProcessor3D {
+public:
+    CompiledDataProcessor3D( DataProcessorGenerator3D const& generator,
+                             std::vector<MultiBlock3D*> multiBlocks );
+    ~CompiledDataProcessor3D();
+    /// Execute the data processor, and update the envelopes of the
+    ///   multi-blocks it modifies, just like executeDataProcessor().
+    void execute();
+    /// Number of atomic data processors executed on the current MPI process.
+    plint getNumLocalProcessors() const;
+private:
+    CompiledDataProcessor3D(CompiledDataProcessor3D const& rhs);
+    CompiledDataProcessor3D& operator=(CompiledDataProcessor3D const& rhs);
+    void compile();
+    void clear();
+    bool isOutdated() const;
+private:
+    DataProcessorGenerator3D* generator;
+    std::vector<MultiBlock3D*> multiBlocks;
+    std::vector<id_t> multiBlockIds;
+    std::vector<id_t> generations;
+    std::vector<DataProcessor3D*> processors;
+    /// Modified multi-blocks, grouped by the type of modification, in
+    ///   view of an aggregated envelope update.
+    std::vector<std::vector<MultiBlock3D*> > updateGroups;
+    std::vector<modif::ModifT> updateTypes;
+};
+
 } // namespace plb
 
 #endif  // MULTI_BLOCK_OPERATIONS_3D_H
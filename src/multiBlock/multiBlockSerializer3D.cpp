@@ -29,9 +29,17 @@
 #include "multiBlock/multiBlockSerializer3D.h"
 #include "atomicBlock/atomicBlock3D.h"
 #include "core/plbDebug.h"
+#include <algorithm>
+#include <map>
 
 namespace plb {
 
+namespace {
+    /// Tag of the slab messages, distinct from the default tag used by the
+    ///   block communicators, which may be active between two slabs.
+    const int slabTransferTag = 3517;
+}
+
 ////////// class MultiBlockSerializer3D ////////////////////////////
 
 MultiBlockSerializer3D::MultiBlockSerializer3D (
@@ -469,16 +477,7 @@ MultiBlockFastSerializer3D::MultiBlockFastSerializer3D (
       ordering(ordering_),
       domain(multiBlock.getBoundingBox())
 {
-    if (ordering==IndexOrdering::forward) {
-        pos = domain.x0;
-    }
-    else if (ordering==IndexOrdering::backward) {
-        pos = domain.z0;
-    }
-    else {
-        // Sparse ordering not implemented.
-        PLB_ASSERT( false );
-    }
+    initialize();
 }
 
 MultiBlockFastSerializer3D::MultiBlockFastSerializer3D (
@@ -488,19 +487,42 @@ MultiBlockFastSerializer3D::MultiBlockFastSerializer3D (
       ordering(ordering_),
       domain(domain_)
 {
+    initialize();
+}
+
+MultiBlockFastSerializer3D::~MultiBlockFastSerializer3D() {
+    // If the traversal was interrupted, the transfer of the next slab must
+    //   be completed before the buffers are released.
+    if (transferStarted) {
+        waitForTransfer(currentBuffer);
+    }
+}
+
+void MultiBlockFastSerializer3D::initialize() {
+    plint sliceSize = 0;
     if (ordering==IndexOrdering::forward) {
         pos = domain.x0;
+        sliceSize = domain.getNy()*domain.getNz()*multiBlock.sizeOfCell();
     }
     else if (ordering==IndexOrdering::backward) {
         pos = domain.z0;
+        sliceSize = domain.getNx()*domain.getNy()*multiBlock.sizeOfCell();
     }
     else {
         // Sparse ordering not implemented.
         PLB_ASSERT( false );
     }
+    // The main processor holds three slabs at a time: the one which is
+    //   returned to the caller, and the receive buffers of the current
+    //   and of the next slab.
+    slabThickness = std::max((plint)1,
+            global::IOpolicy().getSerializerMemoryBudget() / (3*std::max((plint)1,sliceSize)));
+    currentBuffer = 0;
+    transferStarted = false;
 }
 
 MultiBlockFastSerializer3D* MultiBlockFastSerializer3D::clone() const {
+    PLB_ASSERT( !transferStarted );
     return new MultiBlockFastSerializer3D(*this);
 }
 
@@ -509,64 +531,198 @@ pluint MultiBlockFastSerializer3D::getSize() const {
 }
 
 const char* MultiBlockFastSerializer3D::getNextDataBuffer(pluint& bufferSize) const {
-    bufferSize = computeSlice();
+    PLB_PRECONDITION( !isEmpty() );
+    if (!transferStarted) {
+        startSlabTransfer(pos, currentBuffer);
+    }
+    plint nextPos = std::min(pos+slabThickness, getEnd()+1);
+    // Get the next slab on the way before waiting for the current one.
+    transferStarted = nextPos<=getEnd();
+    if (transferStarted) {
+        startSlabTransfer(nextPos, 1-currentBuffer);
+    }
+    completeSlabTransfer(pos, currentBuffer);
+    bufferSize = getSlab(pos).nCells()*multiBlock.sizeOfCell();
+    pos = nextPos;
+    currentBuffer = 1-currentBuffer;
     if (buffer.empty()) buffer.resize(1);
     return &buffer[0];
 }
 
 bool MultiBlockFastSerializer3D::isEmpty() const {
+    return pos > getEnd();
+}
+
+plint MultiBlockFastSerializer3D::getEnd() const {
+    return ordering==IndexOrdering::forward ? domain.x1 : domain.z1;
+}
+
+Box3D MultiBlockFastSerializer3D::getSlab(plint slabStart) const {
+    Box3D slab(domain);
+    plint slabEnd = std::min(slabStart+slabThickness-1, getEnd());
     if (ordering==IndexOrdering::forward) {
-        return pos > domain.x1;
+        slab.x0 = slabStart;
+        slab.x1 = slabEnd;
     }
     else {
-        return pos > domain.z1;
+        slab.z0 = slabStart;
+        slab.z1 = slabEnd;
     }
+    return slab;
 }
 
-pluint MultiBlockFastSerializer3D::computeSlice() const
+void MultiBlockFastSerializer3D::computePieces (
+        Box3D const& slab, std::vector<plint>& ids, std::vector<Box3D>& pieces ) const
 {
-    Box3D slice(domain);
-    if (ordering==IndexOrdering::forward) {
-        slice.x0=slice.x1=pos;
+    std::vector<plint> unsortedIds;
+    std::vector<Box3D> unsortedPieces;
+    multiBlock.getMultiBlockManagement().getSparseBlockStructure().intersect (
+            slab, unsortedIds, unsortedPieces );
+    std::map<plint,Box3D> sortedPieces;
+    for (pluint iPiece=0; iPiece<unsortedIds.size(); ++iPiece) {
+        sortedPieces[unsortedIds[iPiece]] = unsortedPieces[iPiece];
     }
-    else if (ordering==IndexOrdering::backward) {
-        slice.z0=slice.z1=pos;
+    ids.clear();
+    pieces.clear();
+    std::map<plint,Box3D>::const_iterator it = sortedPieces.begin();
+    for (; it != sortedPieces.end(); ++it) {
+        ids.push_back(it->first);
+        pieces.push_back(it->second);
+    }
+}
+
+void MultiBlockFastSerializer3D::startSlabTransfer(plint slabStart, plint iBuffer) const
+{
+#ifdef PLB_MPI_PARALLEL
+    std::vector<plint> ids;
+    std::vector<Box3D> pieces;
+    computePieces(getSlab(slabStart), ids, pieces);
+    ThreadAttribution const& attribution =
+        multiBlock.getMultiBlockManagement().getThreadAttribution();
+    plint sizeOfCell = multiBlock.sizeOfCell();
+    requests[iBuffer].clear();
+    if (global::mpi().isMainProcessor()) {
+        // One message per process, containing its pieces in the order of the block IDs.
+        std::map<int,plint> messageSizes;
+        for (pluint iPiece=0; iPiece<ids.size(); ++iPiece) {
+            if (!attribution.isLocal(ids[iPiece])) {
+                messageSizes[attribution.getMpiProcess(ids[iPiece])] += pieces[iPiece].nCells()*sizeOfCell;
+            }
+        }
+        recvBuffers[iBuffer].resize(messageSizes.size());
+        requests[iBuffer].resize(messageSizes.size());
+        std::map<int,plint>::const_iterator it = messageSizes.begin();
+        for (plint iMessage=0; it != messageSizes.end(); ++it, ++iMessage) {
+            recvBuffers[iBuffer][iMessage].resize(it->second);
+            global::mpi().iRecv( &recvBuffers[iBuffer][iMessage][0], it->second, it->first,
+                                 &requests[iBuffer][iMessage], slabTransferTag );
+        }
     }
     else {
-        // Sparse ordering not implemented.
-        PLB_ASSERT( false );
+        sendBuffer[iBuffer].clear();
+        std::vector<char> pieceData;
+        for (pluint iPiece=0; iPiece<ids.size(); ++iPiece) {
+            if (attribution.isLocal(ids[iPiece])) {
+                SmartBulk3D bulk(multiBlock.getMultiBlockManagement(), ids[iPiece]);
+                multiBlock.getComponent(ids[iPiece]).getDataTransfer().send (
+                        bulk.toLocal(pieces[iPiece]), pieceData, modif::staticVariables );
+                sendBuffer[iBuffer].insert(sendBuffer[iBuffer].end(), pieceData.begin(), pieceData.end());
+            }
+        }
+        if (!sendBuffer[iBuffer].empty()) {
+            requests[iBuffer].resize(1);
+            global::mpi().iSend( &sendBuffer[iBuffer][0], sendBuffer[iBuffer].size(),
+                                 global::mpi().bossId(), &requests[iBuffer][0], slabTransferTag );
+        }
     }
-    SparseBlockStructure3D blockStructure(multiBlock.getBoundingBox());
-    blockStructure.addBlock(slice, 0);
-    plint envelopeWidth=1;
-    MultiBlockManagement3D serialMultiBlockManagement (
-            blockStructure, new OneToOneThreadAttribution, envelopeWidth );
-    MultiBlock3D* multiSerialBlock = multiBlock.clone(serialMultiBlockManagement);
+#endif  // PLB_MPI_PARALLEL
+}
 
-    pluint bufferSize = slice.nCells()*multiBlock.sizeOfCell();
-    if (global::mpi().isMainProcessor()) {
-        AtomicBlock3D& atomicSerialBlock = multiSerialBlock->getComponent(0);
-        if (ordering==IndexOrdering::forward) {
-            SmartBulk3D oneBlockSlice(serialMultiBlockManagement, 0);
-            Box3D localSlice(oneBlockSlice.toLocal(slice));
-            atomicSerialBlock.getDataTransfer().send(localSlice, buffer, modif::staticVariables);
+void MultiBlockFastSerializer3D::waitForTransfer(plint iBuffer) const
+{
+#ifdef PLB_MPI_PARALLEL
+    MPI_Status status;
+    for (pluint iRequest=0; iRequest<requests[iBuffer].size(); ++iRequest) {
+        global::mpi().wait(&requests[iBuffer][iRequest], &status);
+    }
+    requests[iBuffer].clear();
+#endif  // PLB_MPI_PARALLEL
+}
+
+void MultiBlockFastSerializer3D::completeSlabTransfer(plint slabStart, plint iBuffer) const
+{
+    waitForTransfer(iBuffer);
+    if (!global::mpi().isMainProcessor()) {
+        buffer.clear();
+        return;
+    }
+    Box3D slab(getSlab(slabStart));
+    std::vector<plint> ids;
+    std::vector<Box3D> pieces;
+    computePieces(slab, ids, pieces);
+    ThreadAttribution const& attribution =
+        multiBlock.getMultiBlockManagement().getThreadAttribution();
+    plint sizeOfCell = multiBlock.sizeOfCell();
+
+    // Cells which are not covered by any atomic-block are set to zero.
+    buffer.assign(slab.nCells()*sizeOfCell, 0);
+    // The messages are stored in increasing order of the process ID.
+    std::map<int,plint> messageIndex, messagePos;
+    for (pluint iPiece=0; iPiece<ids.size(); ++iPiece) {
+        if (!attribution.isLocal(ids[iPiece])) {
+            messageIndex[attribution.getMpiProcess(ids[iPiece])] = 0;
+        }
+    }
+    plint iMessage = 0;
+    for (std::map<int,plint>::iterator it = messageIndex.begin(); it != messageIndex.end(); ++it) {
+        it->second = iMessage++;
+    }
+    std::vector<char> pieceData;
+    for (pluint iPiece=0; iPiece<ids.size(); ++iPiece) {
+        if (attribution.isLocal(ids[iPiece])) {
+            SmartBulk3D bulk(multiBlock.getMultiBlockManagement(), ids[iPiece]);
+            multiBlock.getComponent(ids[iPiece]).getDataTransfer().send (
+                    bulk.toLocal(pieces[iPiece]), pieceData, modif::staticVariables );
+            copyPieceToSlab(&pieceData[0], pieces[iPiece], slab);
         }
         else {
-            buffer.clear();
-            std::vector<char> tmpBuf;
-            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-                Box3D subSlice(domain.x0, domain.x1, iY,iY, pos,pos);
-                SmartBulk3D oneBlockSlice(serialMultiBlockManagement, 0);
-                Box3D localSlice(oneBlockSlice.toLocal(subSlice));
-                atomicSerialBlock.getDataTransfer().send(localSlice, tmpBuf, modif::staticVariables);
-                buffer.insert(buffer.end(), tmpBuf.begin(), tmpBuf.end());
+            int proc = attribution.getMpiProcess(ids[iPiece]);
+            plint& messageOffset = messagePos[proc];
+            copyPieceToSlab(&recvBuffers[iBuffer][messageIndex[proc]][messageOffset], pieces[iPiece], slab);
+            messageOffset += pieces[iPiece].nCells()*sizeOfCell;
+        }
+    }
+}
+
+void MultiBlockFastSerializer3D::copyPieceToSlab (
+        char const* pieceData, Box3D const& piece, Box3D const& slab ) const
+{
+    plint sizeOfCell = multiBlock.sizeOfCell();
+    plint nx = slab.getNx();
+    plint ny = slab.getNy();
+    plint nz = slab.getNz();
+    // The piece is serialized with z as fastest and x as slowest index.
+    if (ordering==IndexOrdering::forward) {
+        plint lineSize = piece.getNz()*sizeOfCell;
+        for (plint iX=piece.x0; iX<=piece.x1; ++iX) {
+            for (plint iY=piece.y0; iY<=piece.y1; ++iY) {
+                plint slabPos = sizeOfCell*(piece.z0-slab.z0 + nz*(iY-slab.y0 + ny*(iX-slab.x0)));
+                std::copy(pieceData, pieceData+lineSize, &buffer[slabPos]);
+                pieceData += lineSize;
+            }
+        }
+    }
+    else {
+        for (plint iX=piece.x0; iX<=piece.x1; ++iX) {
+            for (plint iY=piece.y0; iY<=piece.y1; ++iY) {
+                for (plint iZ=piece.z0; iZ<=piece.z1; ++iZ) {
+                    plint slabPos = sizeOfCell*(iX-slab.x0 + nx*(iY-slab.y0 + ny*(iZ-slab.z0)));
+                    std::copy(pieceData, pieceData+sizeOfCell, &buffer[slabPos]);
+                    pieceData += sizeOfCell;
+                }
             }
         }
-        PLB_ASSERT(bufferSize == buffer.size());
     }
-    delete multiSerialBlock;
-    ++pos;
-    return bufferSize;
 }
 
 MultiBlockFastUnSerializer3D::MultiBlockFastUnSerializer3D (
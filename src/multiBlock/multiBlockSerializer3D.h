@@ -89,6 +89,15 @@ private:
     mutable std::vector<char> buffer;
 };
 
+/// Serializer which gathers the data on the main processor by slabs: ranges of
+///   x-planes in forward ordering, and of z-planes in backward ordering. The
+///   thickness of the slabs is adjusted to global::IOpolicy().getSerializerMemoryBudget().
+///   Every process sends its contribution to a slab in a single message, and
+///   the transfer of the next slab is under way while the current one is
+///   processed by the caller.
+/** Like all serializers, it must be traversed collectively by all processes.
+ *  It must not be cloned once the traversal has started.
+ */
 class MultiBlockFastSerializer3D : public DataSerializer {
 public:
     MultiBlockFastSerializer3D(MultiBlock3D const& multiBlock_,
@@ -96,18 +105,38 @@ public:
     MultiBlockFastSerializer3D(MultiBlock3D const& multiBlock_,
                                Box3D domain_,
                                IndexOrdering::OrderingT ordering_);
+    virtual ~MultiBlockFastSerializer3D();
     virtual MultiBlockFastSerializer3D* clone() const;
     virtual pluint getSize() const;
     virtual const char* getNextDataBuffer(pluint& bufferSize) const;
     virtual bool isEmpty() const;
 private:
-    pluint computeSlice() const;
+    void initialize();
+    plint getEnd() const;
+    Box3D getSlab(plint slabStart) const;
+    /// Intersections of the slab with the atomic-blocks, in increasing order of the block IDs.
+    void computePieces( Box3D const& slab, std::vector<plint>& ids,
+                        std::vector<Box3D>& pieces ) const;
+    void startSlabTransfer(plint slabStart, plint iBuffer) const;
+    void completeSlabTransfer(plint slabStart, plint iBuffer) const;
+    void copyPieceToSlab( char const* pieceData, Box3D const& piece,
+                          Box3D const& slab ) const;
+    void waitForTransfer(plint iBuffer) const;
 private:
     MultiBlock3D const& multiBlock;
     IndexOrdering::OrderingT ordering;
     Box3D domain;
+    plint slabThickness;
     mutable plint pos;
+    mutable plint currentBuffer;
+    mutable bool transferStarted;
     mutable std::vector<char> buffer;
+    // Two sets of communication buffers, for the current and the next slab.
+    mutable std::vector<char> sendBuffer[2];
+    mutable std::vector<std::vector<char> > recvBuffers[2];
+#ifdef PLB_MPI_PARALLEL
+    mutable std::vector<MPI_Request> requests[2];
+#endif
 };
 
 class MultiBlockFastUnSerializer3D : public DataUnSerializer {
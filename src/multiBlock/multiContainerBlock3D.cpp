@@ -106,11 +106,26 @@ void MultiContainerBlock3D::swap(MultiContainerBlock3D& rhs) {
     MultiBlock3D::swap(rhs);
 }
 
+void MultiContainerBlock3D::reshape(MultiBlockManagement3D const& newManagement)
+{
+    std::vector<plint> droppedBlocks;
+    this->reshapeManagement(newManagement, droppedBlocks);
+    for (pluint iBlock=0; iBlock<droppedBlocks.size(); ++iBlock) {
+        BlockMap::iterator it = blocks.find(droppedBlocks[iBlock]);
+        delete it->second;
+        blocks.erase(it);
+    }
+    allocateBlocks();
+}
+
 void MultiContainerBlock3D::allocateBlocks() 
 {
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock)
     {
         plint blockId = this->getLocalInfo().getBlocks()[iBlock];
+        if (blocks.find(blockId) != blocks.end()) {
+            continue; // Kept by reshape().
+        }
         SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
         Box3D envelope = bulk.computeEnvelope();
         AtomicContainerBlock3D* newBlock =
@@ -119,6 +134,7 @@ void MultiContainerBlock3D::allocateBlocks()
         newBlock -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
         blocks[blockId] = newBlock;
     }
+    this->resolveLocalComponents();
 }
 
 void MultiContainerBlock3D::deAllocateBlocks() 
@@ -52,6 +52,10 @@ public:
     MultiContainerBlock3D* clone() const;
     MultiContainerBlock3D* clone(MultiBlockManagement3D const& multiBlockManagement) const;
     void swap(MultiContainerBlock3D& rhs);
+    /// Move to a new block-structure, keeping the atomic-blocks which are
+    ///   unchanged (see MultiBlock3D::reshapeManagement()). The atomic-blocks
+    ///   which are new are initialized with default values.
+    void reshape(MultiBlockManagement3D const& newManagement);
 public:
     virtual AtomicContainerBlock3D& getComponent(plint iBlock);
     virtual AtomicContainerBlock3D const& getComponent(plint iBlock) const;
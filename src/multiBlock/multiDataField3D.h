@@ -78,6 +78,10 @@ public:
     MultiScalarField3D<T>* clone() const;
     MultiScalarField3D<T>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
     void swap(MultiScalarField3D<T>& rhs);
+    /// Move to a new block-structure, keeping the atomic-blocks which are
+    ///   unchanged (see MultiBlock3D::reshapeManagement()). The atomic-blocks
+    ///   which are new are initialized with default values.
+    void reshape(MultiBlockManagement3D const& newManagement);
 public: 
     virtual void reset();
     virtual T& get(plint iX, plint iY, plint iZ);
@@ -154,6 +158,10 @@ public:
     MultiTensorField3D<T,nDim>* clone() const;
     MultiTensorField3D<T,nDim>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
     void swap(MultiTensorField3D<T,nDim>& rhs);
+    /// Move to a new block-structure, keeping the atomic-blocks which are
+    ///   unchanged (see MultiBlock3D::reshapeManagement()). The atomic-blocks
+    ///   which are new are initialized with default values.
+    void reshape(MultiBlockManagement3D const& newManagement);
 public:
     virtual void reset();
     virtual Array<T,nDim>& get(plint iX, plint iY, plint iZ);
@@ -232,6 +240,10 @@ public:
     MultiNTensorField3D<T>* clone() const;
     MultiNTensorField3D<T>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
     void swap(MultiNTensorField3D<T>& rhs);
+    /// Move to a new block-structure, keeping the atomic-blocks which are
+    ///   unchanged (see MultiBlock3D::reshapeManagement()). The atomic-blocks
+    ///   which are new are initialized with default values.
+    void reshape(MultiBlockManagement3D const& newManagement);
 public:
     virtual void reset();
     virtual T* get(plint iX, plint iY, plint iZ);
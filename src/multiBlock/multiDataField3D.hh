@@ -143,6 +143,19 @@ void MultiScalarField3D<T>::swap(MultiScalarField3D<T>& rhs) {
     std::swap(multiScalarAccess, rhs.multiScalarAccess);
 }
 
+template<typename T>
+void MultiScalarField3D<T>::reshape(MultiBlockManagement3D const& newManagement)
+{
+    std::vector<plint> droppedBlocks;
+    this->reshapeManagement(newManagement, droppedBlocks);
+    for (pluint iBlock=0; iBlock<droppedBlocks.size(); ++iBlock) {
+        typename BlockMap::iterator it = fields.find(droppedBlocks[iBlock]);
+        delete it->second;
+        fields.erase(it);
+    }
+    allocateFields();
+}
+
 template<typename T>
 void MultiScalarField3D<T>::reset() {
     for ( typename BlockMap::iterator it = fields.begin();
@@ -157,6 +170,9 @@ void MultiScalarField3D<T>::allocateFields(T iniVal)
 {
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock) {
         plint blockId = this->getLocalInfo().getBlocks()[iBlock];
+        if (fields.find(blockId) != fields.end()) {
+            continue; // Kept by reshape().
+        }
         SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
         Box3D envelope = bulk.computeEnvelope();
         ScalarField3D<T>* newField =
@@ -165,6 +181,7 @@ void MultiScalarField3D<T>::allocateFields(T iniVal)
         newField -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
         fields[blockId] = newField;
     }
+    this->resolveLocalComponents();
 }
 
 template<typename T>
@@ -388,6 +405,19 @@ void MultiTensorField3D<T,nDim>::swap(MultiTensorField3D<T,nDim>& rhs) {
     std::swap(multiTensorAccess, rhs.multiTensorAccess);
 }
 
+template<typename T, int nDim>
+void MultiTensorField3D<T,nDim>::reshape(MultiBlockManagement3D const& newManagement)
+{
+    std::vector<plint> droppedBlocks;
+    this->reshapeManagement(newManagement, droppedBlocks);
+    for (pluint iBlock=0; iBlock<droppedBlocks.size(); ++iBlock) {
+        typename BlockMap::iterator it = fields.find(droppedBlocks[iBlock]);
+        delete it->second;
+        fields.erase(it);
+    }
+    allocateFields();
+}
+
 template<typename T, int nDim>
 void MultiTensorField3D<T,nDim>::reset() {
     for ( typename BlockMap::iterator it = fields.begin();
@@ -410,6 +440,9 @@ void MultiTensorField3D<T,nDim>::allocateFields(Array<T,nDim> const& iniVal)
 {
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock) {
         plint blockId = this->getLocalInfo().getBlocks()[iBlock];
+        if (fields.find(blockId) != fields.end()) {
+            continue; // Kept by reshape().
+        }
         SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
         Box3D envelope = bulk.computeEnvelope();
         TensorField3D<T,nDim>* newField =
@@ -418,6 +451,7 @@ void MultiTensorField3D<T,nDim>::allocateFields(Array<T,nDim> const& iniVal)
         newField -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
         fields[blockId] = newField;
     }
+    this->resolveLocalComponents();
 }
 
 template<typename T, int nDim>
@@ -650,6 +684,19 @@ void MultiNTensorField3D<T>::swap(MultiNTensorField3D<T>& rhs) {
     std::swap(multiNTensorAccess, rhs.multiNTensorAccess);
 }
 
+template<typename T>
+void MultiNTensorField3D<T>::reshape(MultiBlockManagement3D const& newManagement)
+{
+    std::vector<plint> droppedBlocks;
+    this->reshapeManagement(newManagement, droppedBlocks);
+    for (pluint iBlock=0; iBlock<droppedBlocks.size(); ++iBlock) {
+        typename BlockMap::iterator it = fields.find(droppedBlocks[iBlock]);
+        delete it->second;
+        fields.erase(it);
+    }
+    allocateFields();
+}
+
 template<typename T>
 void MultiNTensorField3D<T>::reset() {
     for ( typename BlockMap::iterator it = fields.begin();
@@ -671,6 +718,9 @@ void MultiNTensorField3D<T>::allocateFields(T const* iniVal)
 {
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock) {
         plint blockId = this->getLocalInfo().getBlocks()[iBlock];
+        if (fields.find(blockId) != fields.end()) {
+            continue; // Kept by reshape().
+        }
         SmartBulk3D bulk(this->getMultiBlockManagement(), blockId );
         Box3D envelope = bulk.computeEnvelope();
         NTensorField3D<T>* newField =
@@ -680,6 +730,7 @@ void MultiNTensorField3D<T>::allocateFields(T const* iniVal)
         newField -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
         fields[blockId] = newField;
     }
+    this->resolveLocalComponents();
 }
 
 template<typename T>
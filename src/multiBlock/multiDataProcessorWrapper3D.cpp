@@ -40,6 +40,14 @@ void applyProcessingFunctional(BoxProcessingFunctional3D* functional,
                           multiBlocks );
 }
 
+CompiledDataProcessor3D* compileProcessingFunctional (
+        BoxProcessingFunctional3D* functional,
+        Box3D domain, std::vector<MultiBlock3D*> multiBlocks )
+{
+    return new CompiledDataProcessor3D( BoxProcessorGenerator3D(functional, domain),
+                                        multiBlocks );
+}
+
 void integrateProcessingFunctional(BoxProcessingFunctional3D* functional,
                                    Box3D domain,
                                    std::vector<MultiBlock3D*> multiBlocks,
@@ -44,6 +44,7 @@
 namespace plb {
 
 class MultiBlock3D;
+class CompiledDataProcessor3D;
 template<typename T, template<typename U> class Descriptor> class MultiBlockLattice3D;
 template<typename T> class MultiScalarField3D;
 template<typename T, int nDim> class MultiTensorField3D;
@@ -64,6 +65,14 @@ void integrateProcessingFunctional(BoxProcessingFunctional3D* functional,
                                    std::vector<MultiBlock3D*> multiBlocks,
                                    plint level=0);
 
+/// Resolve a 3D boxed data functional once on the given multi-blocks, for
+/// repeated execution through CompiledDataProcessor3D::execute(), with the
+/// same effect as applyProcessingFunctional. The returned object must be
+/// deleted by the caller.
+CompiledDataProcessor3D* compileProcessingFunctional (
+        BoxProcessingFunctional3D* functional,
+        Box3D domain, std::vector<MultiBlock3D*> multiBlocks );
+
 /// This is the most general wrapper for integrating a 3D boxed data
 /// functional. Use this if none of the more specific wrappers works.
 void integrateProcessingFunctional(BoxProcessingFunctional3D* functional, Box3D domain,
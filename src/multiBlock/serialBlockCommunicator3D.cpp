@@ -64,8 +64,8 @@ void SerialBlockCommunicator3D::copyOverlap (
     PLB_PRECONDITION(originalCoords.y1-originalCoords.y0 == overlapCoords.y1-overlapCoords.y0);
     PLB_PRECONDITION(originalCoords.z1-originalCoords.z0 == overlapCoords.z1-overlapCoords.z0);
 
-    AtomicBlock3D const* originalBlock = &fromMultiBlock.getComponent(originalId);
-    AtomicBlock3D* overlapBlock = &toMultiBlock.getComponent(overlapId);
+    AtomicBlock3D const* originalBlock = &fromMultiBlock.getLocalComponent(originalId);
+    AtomicBlock3D* overlapBlock = &toMultiBlock.getLocalComponent(overlapId);
     plint deltaX = originalCoords.x0 - overlapCoords.x0;
     plint deltaY = originalCoords.y0 - overlapCoords.y0;
     plint deltaZ = originalCoords.z0 - overlapCoords.z0;
@@ -94,6 +94,46 @@ void SerialBlockCommunicator3D::duplicateOverlaps(MultiBlock3D& multiBlock, modi
     }
 }
 
+void SerialBlockCommunicator3D::copyOverlapDirectionally (
+        Overlap3D const& overlap, MultiBlock3D& multiBlock ) const
+{
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    plint envelopeWidth = management.getEnvelopeWidth();
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+    plint originalId = overlap.getOriginalId();
+    plint overlapId  = overlap.getOverlapId();
+    SmartBulk3D originalBulk(sparseBlock, envelopeWidth, originalId);
+    SmartBulk3D overlapBulk(sparseBlock, envelopeWidth, overlapId);
+
+    Box3D originalCoords(originalBulk.toLocal(overlap.getOriginalCoordinates()));
+    Box3D overlapCoords(overlapBulk.toLocal(overlap.getOverlapCoordinates()));
+    Dot3D orientation(overlapBulk.computeOrientation(overlap.getOverlapCoordinates()));
+
+    AtomicBlock3D const* originalBlock = &multiBlock.getLocalComponent(originalId);
+    AtomicBlock3D* overlapBlock = &multiBlock.getLocalComponent(overlapId);
+    plint deltaX = originalCoords.x0 - overlapCoords.x0;
+    plint deltaY = originalCoords.y0 - overlapCoords.y0;
+    plint deltaZ = originalCoords.z0 - overlapCoords.z0;
+
+    overlapBlock -> getDataTransfer().attributeDirectional (
+            overlapCoords, deltaX, deltaY, deltaZ, *originalBlock, orientation );
+}
+
+void SerialBlockCommunicator3D::duplicateOverlapsDirectionally(MultiBlock3D& multiBlock) const
+{
+    LocalMultiBlockInfo3D const& localInfo = multiBlock.getMultiBlockManagement().getLocalInfo();
+    for (pluint iOverlap=0; iOverlap<localInfo.getNormalOverlaps().size(); ++iOverlap) {
+        copyOverlapDirectionally(localInfo.getNormalOverlaps()[iOverlap], multiBlock);
+    }
+    PeriodicitySwitch3D const& periodicity = multiBlock.periodicity();
+    for (pluint iOverlap=0; iOverlap<localInfo.getPeriodicOverlaps().size(); ++iOverlap) {
+        PeriodicOverlap3D const& pOverlap = localInfo.getPeriodicOverlaps()[iOverlap];
+        if (periodicity.get(pOverlap.normalX, pOverlap.normalY, pOverlap.normalZ)) {
+            copyOverlapDirectionally(pOverlap.overlap, multiBlock);
+        }
+    }
+}
+
 void SerialBlockCommunicator3D::communicate (
         std::vector<Overlap3D> const& overlaps,
         MultiBlock3D const& originMultiBlock, MultiBlock3D& destinationMultiBlock,
@@ -44,11 +44,13 @@ public:
                               MultiBlock3D const& originMultiBlock,
                               MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void duplicateOverlapsDirectionally(MultiBlock3D& multiBlock) const;
     virtual void signalPeriodicity() const;
 private:
     void copyOverlap( Overlap3D const& overlap,
                       MultiBlock3D const& fromMultiBlock,
                       MultiBlock3D& toMultiBlock, modif::ModifT whichData ) const;
+    void copyOverlapDirectionally( Overlap3D const& overlap, MultiBlock3D& multiBlock ) const;
 };
 
 }  // namespace plb
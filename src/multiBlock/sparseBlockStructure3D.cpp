@@ -28,7 +28,8 @@
 
 #include "multiBlock/sparseBlockStructure3D.h"
 #include "multiBlock/defaultMultiBlockPolicy3D.h"
-#include <set>
+#include "parallelism/mpiManager.h"
+#include <algorithm>
 
 namespace plb {
 
@@ -77,6 +78,7 @@ SparseBlockStructure3D::SparseBlockStructure3D (
     gridNz = (plint)( 0.5 + (double)rhs.gridNz * (double)boundingBox.getNz()
                                                / (double)rhs.boundingBox.getNz() );
     if (gridNz < 1) gridNz = 1;
+    iniGridParameters();
 }
 
 void SparseBlockStructure3D::addBlock(Box3D const& bulk, plint blockId) 
@@ -98,6 +100,7 @@ void SparseBlockStructure3D::addBlock(Box3D const& bulk,
     bulks[blockId] = bulk;
     uniqueBulks[blockId] = uniqueBulk;
     integrateBlock(blockId, bulk);
+    refineGridIfNeeded();
 }
 
 void SparseBlockStructure3D::removeBlock(plint blockId) {
@@ -175,15 +178,15 @@ std::vector<plint> SparseBlockStructure3D::getLocalBlocks(ThreadAttribution cons
 }
 
 plint SparseBlockStructure3D::locate(plint iX, plint iY, plint iZ) const {
-    GridT::const_iterator gridIter
-        = grid.find(Dot3D(gridPosX(iX), gridPosY(iY), gridPosZ(iZ)));
-    if (gridIter != grid.end()) {
-        std::vector<plint> const& blockList = gridIter->second;
-        for (pluint iBlock=0; iBlock<blockList.size(); ++iBlock) {
-            Box3D const& bulk = bulks.find(blockList[iBlock])->second;
-            if (contained(iX,iY,iZ, bulk)) {
-                return blockList[iBlock];
-            }
+    if (!contained(iX,iY,iZ, boundingBox)) {
+        return -1;
+    }
+    std::vector<plint> const& blockList
+        = grid[gridIndex(gridPosX(iX), gridPosY(iY), gridPosZ(iZ))];
+    for (pluint iBlock=0; iBlock<blockList.size(); ++iBlock) {
+        Box3D const& bulk = bulks.find(blockList[iBlock])->second;
+        if (contained(iX,iY,iZ, bulk)) {
+            return blockList[iBlock];
         }
     }
     return -1;
@@ -215,18 +218,35 @@ void SparseBlockStructure3D::iniGridParameters()
     if (boundingBox.getNz() % gridNz != 0) {
         ++gridLz;
     }
+    // Because of the rounding up of the cell size, the last cells in a
+    //   direction may end up entirely outside the bounding box.
+    gridNx = (boundingBox.getNx()+gridLx-1) / gridLx;
+    gridNy = (boundingBox.getNy()+gridLy-1) / gridLy;
+    gridNz = (boundingBox.getNz()+gridLz-1) / gridLz;
+    grid.assign(gridNx*gridNy*gridNz, std::vector<plint>());
 }
 
+// Coordinates outside the bounding box are clamped to the outermost grid
+//   cells. Blocks and queries which exceed the bounding box are therefore
+//   still matched against each other, as the final intersection test is
+//   always carried out on the actual bulks.
 plint SparseBlockStructure3D::gridPosX(plint realX) const {
-    return (realX-boundingBox.x0) / gridLx;
+    if (realX <= boundingBox.x0) return 0;
+    return std::min((realX-boundingBox.x0) / gridLx, gridNx-1);
 }
 
 plint SparseBlockStructure3D::gridPosY(plint realY) const {
-    return (realY-boundingBox.y0) / gridLy;
+    if (realY <= boundingBox.y0) return 0;
+    return std::min((realY-boundingBox.y0) / gridLy, gridNy-1);
 }
 
 plint SparseBlockStructure3D::gridPosZ(plint realZ) const {
-    return (realZ-boundingBox.z0) / gridLz;
+    if (realZ <= boundingBox.z0) return 0;
+    return std::min((realZ-boundingBox.z0) / gridLz, gridNz-1);
+}
+
+plint SparseBlockStructure3D::gridIndex(plint gridX, plint gridY, plint gridZ) const {
+    return gridX + gridNx*(gridY + gridNy*gridZ);
 }
 
 Box3D SparseBlockStructure3D::getGridBox(Box3D const& realBlock) const
@@ -236,35 +256,39 @@ Box3D SparseBlockStructure3D::getGridBox(Box3D const& realBlock) const
                    gridPosZ(realBlock.z0), gridPosZ(realBlock.z1) );
 }
 
-void SparseBlockStructure3D::intersect (
-        Box3D const& bulk,
-        std::vector<plint>& ids, std::vector<Box3D>& intersections ) const
+void SparseBlockStructure3D::collectCandidates (
+        Box3D const& domain, std::vector<plint>& candidates ) const
 {
-    Box3D gridBox = getGridBox(bulk);
-    Box3D intersection; // Temporary variable.
-
-    std::set<plint> idsToTest;
-    for (plint gridX=gridBox.x0; gridX<=gridBox.x1; ++gridX) {
+    Box3D gridBox = getGridBox(domain);
+    for (plint gridZ=gridBox.z0; gridZ<=gridBox.z1; ++gridZ) {
         for (plint gridY=gridBox.y0; gridY<=gridBox.y1; ++gridY) {
-            for (plint gridZ=gridBox.z0; gridZ<=gridBox.z1; ++gridZ) {
-                GridT::const_iterator gridIter
-                    = grid.find(Dot3D(gridX,gridY,gridZ));
-                if (gridIter != grid.end()) {
-                    std::vector<plint> const& blockList = gridIter->second;
-                    idsToTest.insert(blockList.begin(), blockList.end());
-                }
+            for (plint gridX=gridBox.x0; gridX<=gridBox.x1; ++gridX) {
+                std::vector<plint> const& blockList = grid[gridIndex(gridX,gridY,gridZ)];
+                candidates.insert(candidates.end(), blockList.begin(), blockList.end());
             }
         }
     }
+    // A block extending over several grid cells is listed several times.
+    //   Sorting also keeps the ids in increasing order, as expected by the callers.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+void SparseBlockStructure3D::intersect (
+        Box3D const& bulk,
+        std::vector<plint>& ids, std::vector<Box3D>& intersections ) const
+{
+    Box3D intersection; // Temporary variable.
 
+    std::vector<plint> idsToTest;
+    collectCandidates(bulk, idsToTest);
 
-    std::set<plint>::const_iterator it = idsToTest.begin();
-    for (; it != idsToTest.end(); ++it) {
-        Box3D testBlock = bulks.find(*it)->second;
+    for (pluint iTest=0; iTest<idsToTest.size(); ++iTest) {
+        Box3D const& testBlock = bulks.find(idsToTest[iTest])->second;
         if (plb::intersect(bulk, testBlock, intersection) )
         {
             intersections.push_back(intersection);
-            ids.push_back(*it);
+            ids.push_back(idsToTest[iTest]);
         }
     }
 }
@@ -333,35 +357,16 @@ void SparseBlockStructure3D::findNeighbors (
         std::vector<plint>& neighbors, plint excludeId ) const
 {
     Box3D extendedBlock(bulk.enlarge(neighborhoodWidth));
-    Box3D gridBox = getGridBox(extendedBlock);
 
-    std::set<plint> idsToTest;
-    for (plint gridX=gridBox.x0; gridX<=gridBox.x1; ++gridX) {
-        for (plint gridY=gridBox.y0; gridY<=gridBox.y1; ++gridY) {
-            for (plint gridZ=gridBox.z0; gridZ<=gridBox.z1; ++gridZ) {
-                GridT::const_iterator gridIter
-                    = grid.find(Dot3D(gridX,gridY,gridZ));
-                if (gridIter != grid.end()) {
-                    std::vector<plint> const& blockList = gridIter->second;
-                    idsToTest.insert(blockList.begin(), blockList.end());
-                }
-            }
-        }
-    }
-
-    if (excludeId>=0) {
-        std::set<plint>::iterator excludeIter = idsToTest.find(excludeId);
-        if (excludeIter != idsToTest.end()) {
-            idsToTest.erase(excludeIter);
-        }
-    }
+    std::vector<plint> idsToTest;
+    collectCandidates(extendedBlock, idsToTest);
 
-    std::set<plint>::const_iterator it = idsToTest.begin();
-    for (; it != idsToTest.end(); ++it) {
-        Box3D testBlock = bulks.find(*it)->second;
-        if (plb::doesIntersect(extendedBlock, testBlock) )
+    for (pluint iTest=0; iTest<idsToTest.size(); ++iTest) {
+        plint testId = idsToTest[iTest];
+        if (testId != excludeId &&
+            plb::doesIntersect(extendedBlock, bulks.find(testId)->second) )
         {
-            neighbors.push_back(*it);
+            neighbors.push_back(testId);
         }
     }
 }
@@ -390,15 +395,40 @@ void SparseBlockStructure3D::swap(SparseBlockStructure3D& rhs) {
 void SparseBlockStructure3D::integrateBlock(plint blockId, Box3D bulk) {
     Box3D gridBox = getGridBox(bulk);
 
-    for (plint gridX=gridBox.x0; gridX<=gridBox.x1; ++gridX) {
+    for (plint gridZ=gridBox.z0; gridZ<=gridBox.z1; ++gridZ) {
         for (plint gridY=gridBox.y0; gridY<=gridBox.y1; ++gridY) {
-            for (plint gridZ=gridBox.z0; gridZ<=gridBox.z1; ++gridZ) {
-                grid[Dot3D(gridX,gridY,gridZ)].push_back(blockId);
+            for (plint gridX=gridBox.x0; gridX<=gridBox.x1; ++gridX) {
+                grid[gridIndex(gridX,gridY,gridZ)].push_back(blockId);
             }
         }
     }
 }
 
+void SparseBlockStructure3D::refineGridIfNeeded() {
+    // Average number of blocks per grid cell beyond which the grid is refined.
+    //   The resolution is doubled in each direction at every refinement, so
+    //   that the total cost of building a structure with N blocks remains O(N),
+    //   and the cost of a query remains bounded independently of N.
+    static const plint maxBlocksPerGridCell = 4;
+    if ( (plint)bulks.size() <= maxBlocksPerGridCell*(plint)grid.size() ) {
+        return;
+    }
+    plint newGridNx = std::min(2*gridNx, boundingBox.getNx());
+    plint newGridNy = std::min(2*gridNy, boundingBox.getNy());
+    plint newGridNz = std::min(2*gridNz, boundingBox.getNz());
+    if (newGridNx==gridNx && newGridNy==gridNy && newGridNz==gridNz) {
+        return;
+    }
+    gridNx = newGridNx;
+    gridNy = newGridNy;
+    gridNz = newGridNz;
+    iniGridParameters();
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it != bulks.end(); ++it) {
+        integrateBlock(it->first, it->second);
+    }
+}
+
 void SparseBlockStructure3D::extractBlock(plint blockId) {
     Box3D const& bulk = bulks[blockId];
     Box3D gridBox = getGridBox(bulk);
@@ -406,7 +436,7 @@ void SparseBlockStructure3D::extractBlock(plint blockId) {
     for (plint gridX=gridBox.x0; gridX<=gridBox.x1; ++gridX) {
         for (plint gridY=gridBox.y0; gridY<=gridBox.y1; ++gridY) {
             for (plint gridZ=gridBox.z0; gridZ<=gridBox.z1; ++gridZ) {
-                std::vector<plint>& blockList = grid[Dot3D(gridX,gridY,gridZ)];
+                std::vector<plint>& blockList = grid[gridIndex(gridX,gridY,gridZ)];
                 // Use remove-erase idiom (because blockList is a std::vector).
                 blockList.erase(std::remove(blockList.begin(), blockList.end(), blockId),
                                 blockList.end());
@@ -779,6 +809,161 @@ SparseBlockStructure3D alignDistribution3D (
 }
 
 
+namespace {
+
+/// Number of plint values used to transmit a block: id, bulk, unique bulk
+///   and MPI process.
+const plint blockRecordSize = 14;
+
+void appendBox(std::vector<plint>& data, Box3D const& box) {
+    data.push_back(box.x0); data.push_back(box.x1);
+    data.push_back(box.y0); data.push_back(box.y1);
+    data.push_back(box.z0); data.push_back(box.z1);
+}
+
+Box3D readBox(plint const* data) {
+    return Box3D(data[0],data[1], data[2],data[3], data[4],data[5]);
+}
+
+/// The blocks are registered in the directory by slabs along the x-direction:
+///   every process is in charge of one slab of the bounding box.
+plint directorySlab(Box3D const& boundingBox, plint iX) {
+    plint numProc = global::mpi().getSize();
+    plint slab = (iX-boundingBox.x0)*numProc / boundingBox.getNx();
+    return std::max((plint)0, std::min(slab, numProc-1));
+}
+
+/// Send the chunks of data, one per process, and concatenate the received ones.
+void exchangeChunks( std::vector<std::vector<plint> > const& toSend,
+                     std::vector<plint>& received )
+{
+#ifdef PLB_MPI_PARALLEL
+    std::vector<plint> sendBuf;
+    std::vector<int> sendCounts(toSend.size());
+    for (pluint iProc=0; iProc<toSend.size(); ++iProc) {
+        sendBuf.insert(sendBuf.end(), toSend[iProc].begin(), toSend[iProc].end());
+        sendCounts[iProc] = (int)toSend[iProc].size();
+    }
+    std::vector<int> recvCounts;
+    global::mpi().allToAllV(sendBuf, sendCounts, received, recvCounts);
+#else
+    received = toSend[0];
+#endif
+}
+
+}  // namespace
+
+SparseBlockStructure3D buildLocalStructure (
+        Box3D const& boundingBox,
+        std::map<plint,Box3D> const& localBulks,
+        std::map<plint,Box3D> const& localUniqueBulks,
+        plint neighborhoodWidth,
+        std::map<plint,plint>& mpiProcesses )
+{
+    PLB_PRECONDITION( localBulks.size() == localUniqueBulks.size() );
+    plint numProc = global::mpi().getSize();
+    plint myRank = global::mpi().getRank();
+    std::map<plint,Box3D>::const_iterator it;
+
+    // 1. Register the local blocks in the directory, with every slab they touch.
+    std::vector<std::vector<plint> > toSend(numProc);
+    for (it = localBulks.begin(); it != localBulks.end(); ++it) {
+        Box3D const& bulk = it->second;
+        std::map<plint,Box3D>::const_iterator uniqueIt = localUniqueBulks.find(it->first);
+        PLB_ASSERT( uniqueIt != localUniqueBulks.end() );
+        for ( plint iSlab=directorySlab(boundingBox, bulk.x0);
+              iSlab<=directorySlab(boundingBox, bulk.x1); ++iSlab )
+        {
+            toSend[iSlab].push_back(it->first);
+            appendBox(toSend[iSlab], bulk);
+            appendBox(toSend[iSlab], uniqueIt->second);
+            toSend[iSlab].push_back(myRank);
+        }
+    }
+    std::vector<plint> received;
+    exchangeChunks(toSend, received);
+    SparseBlockStructure3D directory(boundingBox);
+    std::map<plint,plint> directoryProcesses;
+    for (pluint pos=0; pos<received.size(); pos+=blockRecordSize) {
+        directory.addBlock(readBox(&received[pos+1]), readBox(&received[pos+7]), received[pos]);
+        directoryProcesses[received[pos]] = received[pos+13];
+    }
+
+    // 2. Query the neighborhood of the local blocks, including their periodic
+    //    images, from the slabs it touches. A query is sent as the requesting
+    //    process, followed by the queried domain.
+    for (plint iProc=0; iProc<numProc; ++iProc) {
+        toSend[iProc].clear();
+    }
+    for (it = localBulks.begin(); it != localBulks.end(); ++it) {
+        Box3D neighborhood(it->second.enlarge(neighborhoodWidth));
+        for (plint dx=-1; dx<=+1; ++dx) {
+            for (plint dy=-1; dy<=+1; ++dy) {
+                for (plint dz=-1; dz<=+1; ++dz) {
+                    Box3D domain(neighborhood.shift( dx*boundingBox.getNx(),
+                                                     dy*boundingBox.getNy(),
+                                                     dz*boundingBox.getNz() ));
+                    if ( (dx!=0 || dy!=0 || dz!=0) &&
+                         !intersect(domain, boundingBox, domain) )
+                    {
+                        continue;
+                    }
+                    for ( plint iSlab=directorySlab(boundingBox, domain.x0);
+                          iSlab<=directorySlab(boundingBox, domain.x1); ++iSlab )
+                    {
+                        toSend[iSlab].push_back(myRank);
+                        appendBox(toSend[iSlab], domain);
+                    }
+                }
+            }
+        }
+    }
+    exchangeChunks(toSend, received);
+
+    // 3. Answer the queries, sending each block at most once to each process.
+    std::vector<std::vector<plint> > answers(numProc);
+    std::vector<plint> ids;
+    std::vector<Box3D> intersections;
+    for (pluint pos=0; pos<received.size(); pos+=7) {
+        directory.intersect(readBox(&received[pos+1]), answers[received[pos]], intersections);
+        intersections.clear();
+    }
+    for (plint iProc=0; iProc<numProc; ++iProc) {
+        ids.swap(answers[iProc]);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        toSend[iProc].clear();
+        for (pluint iBlock=0; iBlock<ids.size(); ++iBlock) {
+            Box3D bulk, uniqueBulk;
+            directory.getBulk(ids[iBlock], bulk);
+            directory.getUniqueBulk(ids[iBlock], uniqueBulk);
+            toSend[iProc].push_back(ids[iBlock]);
+            appendBox(toSend[iProc], bulk);
+            appendBox(toSend[iProc], uniqueBulk);
+            toSend[iProc].push_back(directoryProcesses[ids[iBlock]]);
+        }
+        ids.clear();
+    }
+    exchangeChunks(toSend, received);
+
+    // 4. Assemble the local blocks and their neighbors.
+    SparseBlockStructure3D localStructure(boundingBox);
+    mpiProcesses.clear();
+    for (it = localBulks.begin(); it != localBulks.end(); ++it) {
+        localStructure.addBlock(it->second, localUniqueBulks.find(it->first)->second, it->first);
+        mpiProcesses[it->first] = myRank;
+    }
+    for (pluint pos=0; pos<received.size(); pos+=blockRecordSize) {
+        plint blockId = received[pos];
+        if (!localStructure.exists(blockId)) {
+            localStructure.addBlock(readBox(&received[pos+1]), readBox(&received[pos+7]), blockId);
+            mpiProcesses[blockId] = received[pos+13];
+        }
+    }
+    return localStructure;
+}
+
+
 EuclideanIterator3D::EuclideanIterator3D(SparseBlockStructure3D const& sparseBlock_)
     : sparseBlock(sparseBlock_)
 { }
@@ -40,7 +40,10 @@ namespace plb {
 
 class SparseBlockStructure3D {
 public:
-    typedef std::map<Dot3D, std::vector<plint> > GridT;
+    /// Flat, dense array of grid cells, each of which holds the ids of the
+    ///   blocks it intersects. The cell (gridX,gridY,gridZ) is found at
+    ///   position gridX + gridNx*(gridY + gridNy*gridZ).
+    typedef std::vector<std::vector<plint> > GridT;
 public:
     /// Sparse grid structure with default internal implementation.
     SparseBlockStructure3D(plint nx, plint ny, plint nz);
@@ -111,8 +114,17 @@ private:
     plint gridPosY(plint realY) const;
     /// Convert block z-coordinate into coordinate of the sparse-block grid.
     plint gridPosZ(plint realZ) const;
-    /// Convert block coordinates into coordinates of the sparse-block grid.
+    /// Convert block coordinates into coordinates of the sparse-block grid,
+    ///   clipped to the extent of the grid.
     Box3D getGridBox(Box3D const& realBlock) const;
+    /// Position of a grid cell in the flat grid array.
+    plint gridIndex(plint gridX, plint gridY, plint gridZ) const;
+    /// Collect the (sorted and unique) ids of all blocks registered in the
+    ///   grid cells covered by a given domain.
+    void collectCandidates(Box3D const& domain, std::vector<plint>& candidates) const;
+    /// Increase the resolution of the sparse grid when the average number of
+    ///   blocks per grid cell becomes too large, and re-integrate all blocks.
+    void refineGridIfNeeded();
     /// Extend bulk by an envelope layer in a given direction, in view of
     ///   computing overlaps with neighbors.
     void computeEnvelopeTerm (
@@ -184,6 +196,24 @@ SparseBlockStructure3D alignDistribution3D (
                            std::vector<plint>& newIds,
                            std::map<plint,std::vector<plint> >& remappedFromPartner );
 
+/// Collectively build the local view of a distributed block-structure.
+/** Every process provides only the blocks it is in charge of. The result
+ *  holds these blocks, plus the blocks of other processes lying within a
+ *  distance neighborhoodWidth of them (periodic images included), and
+ *  mpiProcesses gives the owner of each of them. This is all that is needed
+ *  by LocalMultiBlockInfo3D to compute the overlaps of the local blocks, and
+ *  the memory and work per process scale with the number of local blocks
+ *  instead of the total number of blocks. The remote blocks are looked up
+ *  through a directory distributed over all processes, each of which keeps
+ *  the blocks touching one slab of the bounding box along x.
+ */
+SparseBlockStructure3D buildLocalStructure (
+                           Box3D const& boundingBox,
+                           std::map<plint,Box3D> const& localBulks,
+                           std::map<plint,Box3D> const& localUniqueBulks,
+                           plint neighborhoodWidth,
+                           std::map<plint,plint>& mpiProcesses );
+
 
 /// Iterate in a structured way over a sparse multi-block structure.
 class EuclideanIterator3D {
@@ -50,6 +50,7 @@
 #include "multiPhysics/freeSurfaceUtil3D.h"
 #include "parallelism/parallelMultiDataField3D.h"
 #include "parallelism/parallelMultiDataField3D.hh"
+#include <algorithm>
 #include <limits>
 
 
@@ -59,18 +60,16 @@ namespace plb {
 /* ************** class BubbleMatch3D ********************************** */
 
 BubbleMatch3D::BubbleMatch3D(MultiBlock3D& templ, bool matchEmpty_)
-    : bubbleContainer (createContainerBlock(templ, new BubbleCounterData3D(maxNumBubbles))),
-      bubbleAnalysisContainer (createContainerBlock(templ, new BubbleAnalysisData3D())),
+    : bubbleAnalysisContainer (createContainerBlock(templ, new BubbleAnalysisData3D())),
       bubbleRemapContainer (createContainerBlock(templ, new BubbleRemapData3D(maxNumBubbles))),
-      mpiData(*bubbleContainer),
-      tagMatrix (new MultiScalarField3D<plint>(*bubbleContainer)),
+      mpiData(*bubbleRemapContainer),
+      tagMatrix (new MultiScalarField3D<plint>(*bubbleRemapContainer)),
       matchEmpty(matchEmpty_)
 {
     setToConstant(*tagMatrix, tagMatrix->getBoundingBox(), (plint)-1);
 }
 
 BubbleMatch3D::~BubbleMatch3D() {
-    delete bubbleContainer;
     delete bubbleAnalysisContainer;
     delete bubbleRemapContainer;
     delete tagMatrix;
@@ -81,7 +80,7 @@ pluint BubbleMatch3D::countAndTagBubbles()
     std::vector<MultiBlock3D*> args;
     args.push_back(tagMatrix);
     args.push_back(bubbleRemapContainer);
-    applyProcessingFunctional(new CollectBubbleTags3D(), bubbleRemapContainer->getBoundingBox(), args);
+    applyProcessingFunctional(new CollectBubbleContacts3D(), bubbleRemapContainer->getBoundingBox(), args);
     plint numBubbles=globalBubbleIds();
     applyProcessingFunctional(new ApplyTagRemap3D(), bubbleRemapContainer->getBoundingBox(), args);
     return numBubbles;
@@ -89,41 +88,62 @@ pluint BubbleMatch3D::countAndTagBubbles()
 
 void BubbleMatch3D::computeBubbleData(pluint numBubbles)
 {
-    std::vector<double> bubbleCenterX(numBubbles), bubbleCenterY(numBubbles), bubbleCenterZ(numBubbles);
-    bubbleVolume.resize(numBubbles);
-    bubbleCenter.resize(numBubbles);
-
+    // Every block holds a sparse list of contributions, for the bubbles it
+    // intersects. These lists are concatenated over all processes, each process
+    // writing into its own slot of a zero-initialized vector, and summed up.
+    static const plint entrySize = 5; // id, volume, and three components of the center.
     std::vector<plint> const& localIds = mpiData.getLocalIds();
+    plint localNumEntries = 0;
     for (pluint i=0; i<localIds.size(); ++i) {
-        plint id = localIds[i];
-        AtomicContainerBlock3D& atomicDataContainer = bubbleAnalysisContainer->getComponent(id);
+        AtomicContainerBlock3D& atomicDataContainer = bubbleAnalysisContainer->getComponent(localIds[i]);
         BubbleAnalysisData3D* pData = dynamic_cast<BubbleAnalysisData3D*>(atomicDataContainer.getData());
         PLB_ASSERT(pData);
-        BubbleAnalysisData3D& data = *pData;
-
-        std::vector<double> const& nextVolume = data.bubbleVolume;
-        std::vector<Array<double,3> > const& nextCenter = data.bubbleCenter;
-        PLB_ASSERT(nextVolume.size() == numBubbles);
-        PLB_ASSERT(nextCenter.size() == numBubbles);
-
-        for (pluint i=0; i<numBubbles; ++i) {
-            bubbleVolume[i] += nextVolume[i];
-            bubbleCenterX[i] += nextCenter[i][0];
-            bubbleCenterY[i] += nextCenter[i][1];
-            bubbleCenterZ[i] += nextCenter[i][2];
+        localNumEntries += pData->bubbleIds.size();
+    }
+
+    std::vector<plint> allNumEntries(global::mpi().getSize());
+    allNumEntries[global::mpi().getRank()] = localNumEntries;
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(allNumEntries, MPI_SUM);
+#endif
+    plint totNumEntries = 0;
+    plint offset = 0;
+    for (plint iProc=0; iProc<(plint)allNumEntries.size(); ++iProc) {
+        if (iProc==global::mpi().getRank()) {
+            offset = totNumEntries;
         }
+        totNumEntries += allNumEntries[iProc];
     }
 
+    std::vector<double> entries(entrySize*totNumEntries, 0.);
+    for (pluint i=0; i<localIds.size(); ++i) {
+        AtomicContainerBlock3D& atomicDataContainer = bubbleAnalysisContainer->getComponent(localIds[i]);
+        BubbleAnalysisData3D& data = *dynamic_cast<BubbleAnalysisData3D*>(atomicDataContainer.getData());
+        for (pluint iBubble=0; iBubble<data.bubbleIds.size(); ++iBubble, ++offset) {
+            entries[entrySize*offset]   = (double)data.bubbleIds[iBubble];
+            entries[entrySize*offset+1] = data.bubbleVolume[iBubble];
+            entries[entrySize*offset+2] = data.bubbleCenter[iBubble][0];
+            entries[entrySize*offset+3] = data.bubbleCenter[iBubble][1];
+            entries[entrySize*offset+4] = data.bubbleCenter[iBubble][2];
+        }
+    }
 #ifdef PLB_MPI_PARALLEL
-    global::mpi().allReduceVect(bubbleVolume, MPI_SUM);
-    global::mpi().allReduceVect(bubbleCenterX, MPI_SUM);
-    global::mpi().allReduceVect(bubbleCenterY, MPI_SUM);
-    global::mpi().allReduceVect(bubbleCenterZ, MPI_SUM);
+    global::mpi().allReduceVect(entries, MPI_SUM);
 #endif
 
+    bubbleVolume.assign(numBubbles, 0.);
+    bubbleCenter.assign(numBubbles, Array<double,3>(0.,0.,0.));
+    for (plint iEntry=0; iEntry<totNumEntries; ++iEntry) {
+        plint id = (plint)entries[entrySize*iEntry];
+        PLB_ASSERT( id>=0 && id<(plint)numBubbles );
+        bubbleVolume[id] += entries[entrySize*iEntry+1];
+        bubbleCenter[id] += Array<double,3> ( entries[entrySize*iEntry+2],
+                                              entries[entrySize*iEntry+3],
+                                              entries[entrySize*iEntry+4] );
+    }
+
     static const double epsilon = std::numeric_limits<double>::epsilon()*1.e4;
     for (pluint i=0; i<numBubbles; ++i) {
-        bubbleCenter[i] = Array<double,3>(bubbleCenterX[i], bubbleCenterY[i], bubbleCenterZ[i]);
         double volume = bubbleVolume[i];
         if (volume>epsilon) {
             bubbleCenter[i] /= volume;
@@ -131,9 +151,38 @@ void BubbleMatch3D::computeBubbleData(pluint numBubbles)
     }
 }
 
+namespace {
+
+// Root of an element in a union-find forest, with path halving.
+plint findBubbleRoot(std::vector<plint>& parent, plint i) {
+    while (parent[i]!=i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Merge the sets of two elements. The root is always the smallest
+// element, so that the result is independent of the merge order.
+void mergeBubbles(std::vector<plint>& parent, plint i, plint j) {
+    plint rootI = findBubbleRoot(parent, i);
+    plint rootJ = findBubbleRoot(parent, j);
+    if (rootI<rootJ) {
+        parent[rootJ] = rootI;
+    }
+    else if (rootJ<rootI) {
+        parent[rootI] = rootJ;
+    }
+}
+
+}  // namespace
+
 plint BubbleMatch3D::globalBubbleIds()
 {
-    plint localNumUniqueBubbles = 0;
+    // 1. Concatenate the tags and the contacts of all blocks. The size of these
+    //    lists is proportional to the number of bubble fragments, not to the
+    //    maximum number of bubbles.
+    plint localNumTags = 0, localNumContacts = 0;
     std::vector<plint> const& localIds = mpiData.getLocalIds();
     for (pluint i=0; i<localIds.size(); ++i) {
         plint id = localIds[i];
@@ -141,94 +190,105 @@ plint BubbleMatch3D::globalBubbleIds()
         BubbleRemapData3D* pData = dynamic_cast<BubbleRemapData3D*>(atomicDataContainer.getData());
         PLB_ASSERT(pData);
         BubbleRemapData3D& data = *pData;
-        localNumUniqueBubbles += data.getUniqueTags().size();
+        localNumTags += data.getUniqueTags().size();
+        localNumContacts += data.getContacts().size();
     }
 
-    std::vector<plint> allNumBubbles(global::mpi().getSize());
-    allNumBubbles[global::mpi().getRank()] = localNumUniqueBubbles;
+    plint numProcs = global::mpi().getSize();
+    plint myRank = global::mpi().getRank();
+    std::vector<plint> allSizes(2*numProcs);
+    allSizes[myRank] = localNumTags;
+    allSizes[numProcs+myRank] = localNumContacts;
 #ifdef PLB_MPI_PARALLEL
-    global::mpi().allReduceVect(allNumBubbles, MPI_SUM);
+    global::mpi().allReduceVect(allSizes, MPI_SUM);
 #endif
-
-    std::vector<plint> cumNumBubbles(global::mpi().getSize());
-    PLB_ASSERT(cumNumBubbles.size()>0);
-    cumNumBubbles[0] = allNumBubbles[0];
-    for (pluint i=1; i<cumNumBubbles.size(); ++i) {
-        cumNumBubbles[i] = allNumBubbles[i]+cumNumBubbles[i-1];
+    plint totNumTags = 0, totNumContacts = 0;
+    plint tagOffset = 0, contactOffset = 0;
+    for (plint iProc=0; iProc<numProcs; ++iProc) {
+        if (iProc==myRank) {
+            tagOffset = totNumTags;
+            contactOffset = totNumContacts;
+        }
+        totNumTags += allSizes[iProc];
+        totNumContacts += allSizes[numProcs+iProc];
     }
-    plint totNumBubbles = cumNumBubbles.back();
-
-    std::vector<plint> bubbleIds(totNumBubbles);
-    pluint offset = global::mpi().getRank()==0 ? 0 : cumNumBubbles[global::mpi().getRank()-1];
 
+    std::vector<plint> allTags(totNumTags);
+    std::vector<plint> allContacts(2*totNumContacts);
     for (pluint i=0; i<localIds.size(); ++i) {
         plint id = localIds[i];
         AtomicContainerBlock3D& atomicDataContainer = bubbleRemapContainer->getComponent(id);
-        BubbleRemapData3D* pData = dynamic_cast<BubbleRemapData3D*>(atomicDataContainer.getData());
-        PLB_ASSERT(pData);
-        BubbleRemapData3D& data = *pData;
-        std::vector<plint> uniqueTags = data.getUniqueTags();
-        for (pluint i=0; i<uniqueTags.size(); ++i, ++offset) {
-            bubbleIds[offset] = uniqueTags[i];
+        BubbleRemapData3D& data = *dynamic_cast<BubbleRemapData3D*>(atomicDataContainer.getData());
+        std::vector<plint> const& uniqueTags = data.getUniqueTags();
+        for (pluint iTag=0; iTag<uniqueTags.size(); ++iTag, ++tagOffset) {
+            allTags[tagOffset] = uniqueTags[iTag];
+        }
+        std::vector<std::pair<plint,plint> > const& contacts = data.getContacts();
+        for (pluint iContact=0; iContact<contacts.size(); ++iContact, ++contactOffset) {
+            allContacts[2*contactOffset]   = contacts[iContact].first;
+            allContacts[2*contactOffset+1] = contacts[iContact].second;
         }
     }
 #ifdef PLB_MPI_PARALLEL
-    global::mpi().allReduceVect(bubbleIds, MPI_SUM);
+    global::mpi().allReduceVect(allTags, MPI_SUM);
+    global::mpi().allReduceVect(allContacts, MPI_SUM);
 #endif
-    std::map<plint,plint> tagRemap;
-    for (pluint i=0; i<bubbleIds.size(); ++i) {
-        tagRemap[bubbleIds[i]] = i;
+
+    // 2. Merge the fragments which are in contact (union-find on the sorted
+    //    list of tags), and number the bubbles in the order of their smallest tag.
+    std::sort(allTags.begin(), allTags.end());
+    std::vector<plint> parent(totNumTags);
+    for (plint iTag=0; iTag<totNumTags; ++iTag) {
+        parent[iTag] = iTag;
+    }
+    for (plint iContact=0; iContact<totNumContacts; ++iContact) {
+        std::vector<plint>::const_iterator tag1 =
+            std::lower_bound(allTags.begin(), allTags.end(), allContacts[2*iContact]);
+        std::vector<plint>::const_iterator tag2 =
+            std::lower_bound(allTags.begin(), allTags.end(), allContacts[2*iContact+1]);
+        PLB_ASSERT( tag1!=allTags.end() && *tag1==allContacts[2*iContact] );
+        PLB_ASSERT( tag2!=allTags.end() && *tag2==allContacts[2*iContact+1] );
+        mergeBubbles(parent, tag1-allTags.begin(), tag2-allTags.begin());
+    }
+    std::vector<plint> bubbleIds(totNumTags);
+    plint numBubbles = 0;
+    for (plint iTag=0; iTag<totNumTags; ++iTag) {
+        plint root = findBubbleRoot(parent, iTag);
+        if (root==iTag) {
+            bubbleIds[iTag] = numBubbles++;
+        }
+        else {
+            // The root is smaller than iTag, and has already been numbered.
+            bubbleIds[iTag] = bubbleIds[root];
+        }
     }
 
+    // 3. Every block only needs the remap of its own tags: ApplyTagRemap3D
+    //    modifies the bulk only, and the envelopes are refreshed afterwards
+    //    by the communication of the tag matrix.
     for (pluint i=0; i<localIds.size(); ++i) {
         plint id = localIds[i];
         AtomicContainerBlock3D& atomicDataContainer = bubbleRemapContainer->getComponent(id);
-        BubbleRemapData3D* pData = dynamic_cast<BubbleRemapData3D*>(atomicDataContainer.getData());
-        PLB_ASSERT(pData);
-        BubbleRemapData3D& data = *pData;
-        data.getTagRemap()=tagRemap;
-    }
-
-    return totNumBubbles;
-}
-
-void BubbleMatch3D::resetBubbleContainer() {
-    MultiBlockManagement3D const& management = bubbleContainer->getMultiBlockManagement();
-    ThreadAttribution const& threadAttribution = management.getThreadAttribution();
-    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
-    std::map<plint,Box3D> const& domains = sparseBlock.getBulks();
-
-    std::map<plint,Box3D>::const_iterator it = domains.begin();
-    plint pos = 0;
-    for (; it != domains.end(); ++it, ++pos) {
-        plint id = it->first;
-        if (threadAttribution.isLocal(id)) {
-            AtomicContainerBlock3D& atomicDataContainer = bubbleContainer->getComponent(id);
-            dynamic_cast<BubbleCounterData3D*>(atomicDataContainer.getData())->reset();
+        BubbleRemapData3D& data = *dynamic_cast<BubbleRemapData3D*>(atomicDataContainer.getData());
+        std::map<plint,plint>& tagRemap = data.getTagRemap();
+        tagRemap.clear();
+        std::vector<plint> const& uniqueTags = data.getUniqueTags();
+        for (pluint iTag=0; iTag<uniqueTags.size(); ++iTag) {
+            plint pos = std::lower_bound(allTags.begin(), allTags.end(), uniqueTags[iTag])-allTags.begin();
+            tagRemap[uniqueTags[iTag]] = bubbleIds[pos];
         }
     }
+
+    return numBubbles;
 }
 
-void BubbleMatch3D::bubbleBucketFill(MultiScalarField3D<int>& flag)
+void BubbleMatch3D::labelLocalBubbles(MultiScalarField3D<int>& flag)
 {
-    setToConstant(*tagMatrix, tagMatrix->getBoundingBox(), (plint)-1);
-    resetBubbleContainer();
-    plint numIter=2;
-    while(numIter>0) {
-        CountBubbleIteration3D functional(matchEmpty);
-        std::vector<MultiBlock3D*> args;
-        args.push_back(tagMatrix);
-        args.push_back(&flag);
-        args.push_back(bubbleContainer);
-        applyProcessingFunctional(functional, bubbleContainer->getBoundingBox(), args);
-        plint numConflicts = functional.getNumConflicts();
-        if (numConflicts>0) {
-            numIter=2;
-        }
-        else {
-            --numIter;
-        }
-    }
+    std::vector<MultiBlock3D*> args;
+    args.push_back(tagMatrix);
+    args.push_back(&flag);
+    args.push_back(bubbleRemapContainer);
+    applyProcessingFunctional(new LabelLocalBubbles3D(matchEmpty), bubbleRemapContainer->getBoundingBox(), args);
 }
 
 
@@ -261,127 +321,29 @@ void BubbleMPIdata::computeLocalIds(MultiBlock3D& block) {
 
 
 
-/* ************** class BubbleCounterData3D ********************************** */
-
-BubbleCounterData3D::BubbleCounterData3D(plint maxNumBubbles_)
-    : maxNumBubbles(maxNumBubbles_)
-{ }
-
-BubbleCounterData3D* BubbleCounterData3D::clone() const {
-    return new BubbleCounterData3D(*this);
-}
-
-bool BubbleCounterData3D::convertCell (
-        plint& tag0,
-        plint tag1,  plint tag2,  plint tag3,
-        plint tag4,  plint tag5,  plint tag6,
-        plint tag7,  plint tag8,  plint tag9,
-        plint tag10, plint tag11, plint tag12, plint tag13,
-        plint tag1_,  plint tag2_,  plint tag3_,
-        plint tag4_,  plint tag5_,  plint tag6_,
-        plint tag7_,  plint tag8_,  plint tag9_,
-        plint tag10_, plint tag11_, plint tag12_, plint tag13_ )
-{
-    bool hasConflict =
-        processNeighbor(tag0, tag1) || processNeighbor(tag0, tag2) || processNeighbor(tag0, tag3) ||
-        processNeighbor(tag0, tag4) || processNeighbor(tag0, tag5) || processNeighbor(tag0, tag6) ||
-        processNeighbor(tag0, tag7) || processNeighbor(tag0, tag8) || processNeighbor(tag0, tag9) ||
-        processNeighbor(tag0, tag10) || processNeighbor(tag0, tag11) || processNeighbor(tag0, tag12) ||
-        processNeighbor(tag0, tag13) ||
-        processNeighbor(tag0, tag1_) || processNeighbor(tag0, tag2_) || processNeighbor(tag0, tag3_) ||
-        processNeighbor(tag0, tag4_) || processNeighbor(tag0, tag5_) || processNeighbor(tag0, tag6_) ||
-        processNeighbor(tag0, tag7_) || processNeighbor(tag0, tag8_) || processNeighbor(tag0, tag9_) ||
-        processNeighbor(tag0, tag10_) || processNeighbor(tag0, tag11_) || processNeighbor(tag0, tag12_) ||
-        processNeighbor(tag0, tag13_);
-    if (tag0==-1) {
-        tag0 = getNextTag();
-    }
-    return hasConflict;
-}
-
-bool BubbleCounterData3D::processNeighbor(plint& tag0, plint tag1) {
-    plint myTag = convertTag(tag0);
-    plint otherTag = convertTag(tag1);
-    tag0 = myTag; // re-assign tag in case it got re-assigned in "convertTag()".
-    bool hasConflict = false;
-    if (otherTag == -1) {
-        if (myTag == -1) {
-            tag0 = getNextTag();
-        }
-    }
-    else {
-        if (myTag<otherTag) {
-            tag0 = otherTag;
-            registerConflict(myTag, otherTag);
-            hasConflict = true;
-        }
-    }
-    return hasConflict;
-}
-
-plint BubbleCounterData3D::getNextTag() {
-    plint nextTag = getUniqueID()*maxNumBubbles + nextCellId;
-    ++nextCellId;
-    return nextTag;
-}
-
-void BubbleCounterData3D::reset() {
-    nextCellId = 0;
-    retagging.clear();
-    //uniqueTags.clear();
-    //tagRemap.clear();
-}
-
-plint BubbleCounterData3D::convertTag(plint tag) const {
-    if (tag==-1) return tag;
-    std::map<plint,plint>::const_iterator it = retagging.find(tag);
-    if (it==retagging.end()) {
-        return tag;
-    }
-    else {
-        return it->second;
-    }
-}
-
-void BubbleCounterData3D::registerConflict(plint oldTag, plint newTag) {
-    retagging.insert(std::pair<plint,plint>(oldTag, newTag));
-    std::map<plint,plint>::iterator it = retagging.begin();
-    // If some of the map's items are still pointing to the old
-    // tag, redirect them to the new one.
-    for (; it!=retagging.end(); ++it) {
-        if (it->second==oldTag) {
-            it->second=newTag;
-        }
-    }
-}
-
 /* *************** Class BubbleRemapData3D ******************************** */
 
 BubbleRemapData3D* BubbleRemapData3D::clone() const {
     return new BubbleRemapData3D(*this);
 }
 
-bool BubbleRemapData3D::isMyTag(plint tag) {
-    return tag/maxNumBubbles == getUniqueID();
+plint BubbleRemapData3D::globalTag(plint localTag) const {
+    PLB_ASSERT( localTag < maxNumBubbles );
+    return getUniqueID()*maxNumBubbles + localTag;
 }
 
 
-/* *************** Class CountBubbleIteration3D ******************************** */
+/* *************** Class LabelLocalBubbles3D ******************************** */
 
-CountBubbleIteration3D::CountBubbleIteration3D(bool matchEmpty_)
-    : numConflictsId(this->getStatistics().subscribeIntSum()),
-      matchEmpty(matchEmpty_)
+LabelLocalBubbles3D::LabelLocalBubbles3D(bool matchEmpty_)
+    : matchEmpty(matchEmpty_)
 { }
 
-CountBubbleIteration3D* CountBubbleIteration3D::clone() const {
-    return new CountBubbleIteration3D(*this);
+LabelLocalBubbles3D* LabelLocalBubbles3D::clone() const {
+    return new LabelLocalBubbles3D(*this);
 }
 
-plint CountBubbleIteration3D::getNumConflicts() const {
-    return this->getStatistics().getIntSum(numConflictsId);
-}
-
-void CountBubbleIteration3D::processGenericBlocks(Box3D domain,std::vector<AtomicBlock3D*> atomicBlocks)
+void LabelLocalBubbles3D::processGenericBlocks(Box3D domain,std::vector<AtomicBlock3D*> atomicBlocks)
 {
     PLB_ASSERT(atomicBlocks.size()==3);
     ScalarField3D<plint>* pTagMatrix = dynamic_cast<ScalarField3D<plint>*> (atomicBlocks[0]);
@@ -395,53 +357,87 @@ void CountBubbleIteration3D::processGenericBlocks(Box3D domain,std::vector<Atomi
     AtomicContainerBlock3D* pDataBlock = dynamic_cast<AtomicContainerBlock3D*> (atomicBlocks[2]);
     PLB_ASSERT(pDataBlock);
     AtomicContainerBlock3D& dataBlock = *pDataBlock;
-    BubbleCounterData3D* pData = dynamic_cast<BubbleCounterData3D*>(dataBlock.getData());
+    BubbleRemapData3D* pData = dynamic_cast<BubbleRemapData3D*>(dataBlock.getData());
     PLB_ASSERT(pData);
-    BubbleCounterData3D& data = *pData;
+    BubbleRemapData3D& data = *pData;
 
     Dot3D flagOffset = computeRelativeDisplacement(tagMatrix, flagMatrix);
-    BlockStatistics& statistics = this->getStatistics();
 
+    // The 13 neighbors which precede a cell in the order of the loop below.
+    static const plint numPrevious = 13;
+    static const plint previous[numPrevious][3] = {
+        {-1,-1,-1}, {-1,-1, 0}, {-1,-1, 1}, {-1, 0,-1}, {-1, 0, 0}, {-1, 0, 1},
+        {-1, 1,-1}, {-1, 1, 0}, {-1, 1, 1}, { 0,-1,-1}, { 0,-1, 0}, { 0,-1, 1},
+        { 0, 0,-1} };
+
+    // The envelope is reset as well, because the parts of it which are outside
+    // the multi-block are not overwritten by the subsequent envelope update.
+    Box3D fullDomain(tagMatrix.getBoundingBox());
+    for (plint iX=fullDomain.x0; iX<=fullDomain.x1; ++iX) {
+        for (plint iY=fullDomain.y0; iY<=fullDomain.y1; ++iY) {
+            for (plint iZ=fullDomain.z0; iZ<=fullDomain.z1; ++iZ) {
+                tagMatrix.get(iX,iY,iZ) = -1;
+            }
+        }
+    }
+
+    // 1. Provisional tags, with the equivalences recorded in a union-find forest.
+    std::vector<plint> parent;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {         
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
                 int currentFlag = flagMatrix.get(iX+flagOffset.x, iY+flagOffset.y, iZ+flagOffset.z);
                 if ( (matchEmpty && currentFlag==twoPhaseFlag::empty) ||
                      (!matchEmpty && currentFlag==twoPhaseFlag::fluid) ||
                      currentFlag==twoPhaseFlag::interface )
                 {
-                    bool isConflicting = data.convertCell (
-                            tagMatrix.get(iX  ,iY  ,iZ  ),
-                            tagMatrix.get(iX-1,iY  ,iZ  ),
-                            tagMatrix.get(iX  ,iY-1,iZ  ),
-                            tagMatrix.get(iX  ,iY  ,iZ-1),
-                            tagMatrix.get(iX-1,iY-1,iZ  ),
-                            tagMatrix.get(iX-1,iY+1,iZ  ),
-                            tagMatrix.get(iX-1,iY  ,iZ-1),
-                            tagMatrix.get(iX-1,iY  ,iZ+1),
-                            tagMatrix.get(iX  ,iY-1,iZ-1),
-                            tagMatrix.get(iX  ,iY-1,iZ+1),
-                            tagMatrix.get(iX-1,iY-1,iZ-1),
-                            tagMatrix.get(iX-1,iY-1,iZ+1),
-                            tagMatrix.get(iX-1,iY+1,iZ-1),
-                            tagMatrix.get(iX-1,iY+1,iZ+1),
-
-                            tagMatrix.get(iX+1,iY  ,iZ  ),
-                            tagMatrix.get(iX  ,iY+1,iZ  ),
-                            tagMatrix.get(iX  ,iY  ,iZ+1),
-                            tagMatrix.get(iX+1,iY+1,iZ  ),
-                            tagMatrix.get(iX+1,iY-1,iZ  ),
-                            tagMatrix.get(iX+1,iY  ,iZ+1),
-                            tagMatrix.get(iX+1,iY  ,iZ-1),
-                            tagMatrix.get(iX  ,iY+1,iZ+1),
-                            tagMatrix.get(iX  ,iY+1,iZ-1),
-                            tagMatrix.get(iX+1,iY+1,iZ+1),
-                            tagMatrix.get(iX+1,iY+1,iZ-1),
-                            tagMatrix.get(iX+1,iY-1,iZ+1),
-                            tagMatrix.get(iX+1,iY-1,iZ-1) );
-                    if (isConflicting) {
-                        statistics.gatherIntSum(numConflictsId, 1);
+                    plint tag = -1;
+                    for (plint iPrev=0; iPrev<numPrevious; ++iPrev) {
+                        plint nX = iX+previous[iPrev][0];
+                        plint nY = iY+previous[iPrev][1];
+                        plint nZ = iZ+previous[iPrev][2];
+                        if (contained(nX,nY,nZ, domain)) {
+                            plint neighborTag = tagMatrix.get(nX,nY,nZ);
+                            if (neighborTag>=0) {
+                                if (tag==-1) {
+                                    tag = neighborTag;
+                                }
+                                else {
+                                    mergeBubbles(parent, tag, neighborTag);
+                                }
+                            }
+                        }
                     }
+                    if (tag==-1) {
+                        tag = (plint)parent.size();
+                        parent.push_back(tag);
+                    }
+                    tagMatrix.get(iX,iY,iZ) = tag;
+                }
+            }
+        }
+    }
+
+    // 2. Consecutive numbering of the roots, and conversion to global tags.
+    std::vector<plint> localTag(parent.size());
+    std::vector<plint>& uniqueTags = data.getUniqueTags();
+    uniqueTags.clear();
+    for (plint iTag=0; iTag<(plint)parent.size(); ++iTag) {
+        plint root = findBubbleRoot(parent, iTag);
+        if (root==iTag) {
+            localTag[iTag] = data.globalTag((plint)uniqueTags.size());
+            uniqueTags.push_back(localTag[iTag]);
+        }
+        else {
+            localTag[iTag] = localTag[root];
+        }
+    }
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                plint& tag = tagMatrix.get(iX,iY,iZ);
+                if (tag>=0) {
+                    tag = localTag[tag];
                 }
             }
         }
@@ -449,13 +445,13 @@ void CountBubbleIteration3D::processGenericBlocks(Box3D domain,std::vector<Atomi
 }
 
 
-/* *************** Class CollectBubbleTags3D ******************************** */
+/* *************** Class CollectBubbleContacts3D ******************************** */
 
-CollectBubbleTags3D* CollectBubbleTags3D::clone() const {
-    return new CollectBubbleTags3D(*this);
+CollectBubbleContacts3D* CollectBubbleContacts3D::clone() const {
+    return new CollectBubbleContacts3D(*this);
 }
 
-void CollectBubbleTags3D::processGenericBlocks(Box3D domain,std::vector<AtomicBlock3D*> atomicBlocks)
+void CollectBubbleContacts3D::processGenericBlocks(Box3D domain,std::vector<AtomicBlock3D*> atomicBlocks)
 {
     PLB_ASSERT(atomicBlocks.size()==2);
     ScalarField3D<plint>* pTagMatrix = dynamic_cast<ScalarField3D<plint>*> (atomicBlocks[0]);
@@ -469,26 +465,34 @@ void CollectBubbleTags3D::processGenericBlocks(Box3D domain,std::vector<AtomicBl
     PLB_ASSERT(pData);
     BubbleRemapData3D& data = *pData;
 
-    std::set<plint> uniqueTags;
+    std::vector<std::pair<plint,plint> >& contacts = data.getContacts();
+    contacts.clear();
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {         
+            // In the interior of the x-y cross-section, only the two
+            // extremal cells along z are on the boundary of the domain.
+            bool onBoundaryXY = iX==domain.x0 || iX==domain.x1 || iY==domain.y0 || iY==domain.y1;
+            plint stepZ = onBoundaryXY ? 1 : std::max((plint)1, domain.z1-domain.z0);
+            for (plint iZ=domain.z0; iZ<=domain.z1; iZ+=stepZ) {
                 plint tag = tagMatrix.get(iX,iY,iZ);
-                if (tag>=0) {
-                    uniqueTags.insert(tag);
+                if (tag<0) continue;
+                for (plint dx=-1; dx<=1; ++dx) {
+                    for (plint dy=-1; dy<=1; ++dy) {
+                        for (plint dz=-1; dz<=1; ++dz) {
+                            if (!contained(iX+dx,iY+dy,iZ+dz, domain)) {
+                                plint neighborTag = tagMatrix.get(iX+dx,iY+dy,iZ+dz);
+                                if (neighborTag>=0 && neighborTag!=tag) {
+                                    contacts.push_back(std::make_pair(tag, neighborTag));
+                                }
+                            }
+                        }
+                    }
                 }
             }
         }
     }
-
-    data.getUniqueTags().clear();
-    std::set<plint>::const_iterator it = uniqueTags.begin();
-    for (; it!=uniqueTags.end(); ++it) {
-        plint tag = *it;
-        if (data.isMyTag(tag)) {
-            data.getUniqueTags().push_back(tag);
-        }
-    }
+    std::sort(contacts.begin(), contacts.end());
+    contacts.erase(std::unique(contacts.begin(), contacts.end()), contacts.end());
 }
 
 
@@ -58,7 +58,8 @@ public:
     std::vector<Array<double,3> > const&  getBubbleCenter() { return bubbleCenter; }
     pluint numBubbles() const { return bubbleVolume.size(); }
 private:
-    // Re-assign a continuously numbered ID to the detected bubbles.
+    // Merge the bubbles which touch each other across block boundaries, and
+    // re-assign a continuously numbered ID to the detected bubbles.
     pluint countAndTagBubbles();
     // Computes the volumes and centers of all new bubbles.
     template<typename T>
@@ -67,17 +68,16 @@ private:
     // after calling AnalyzeBubbles3D.
     void computeBubbleData(pluint numBubbles);
     // Implements all required MPI operations needed to compute the global IDs of the current
-    // bubbbles, after calling CollectBubbleTags3D.
+    // bubbbles, after calling LabelLocalBubbles3D and CollectBubbleContacts3D.
     plint globalBubbleIds();
-    // Prepare the bubble container for the next time iteration.
-    void resetBubbleContainer();
-    // Parallel bucket-fill algorithm to assign a unique ID to every contiguous region.
-    void bubbleBucketFill(MultiScalarField3D<int>& flag);
+    // Assign a unique ID to every contiguous region inside each block, and
+    // make the IDs of the neighboring blocks visible in the envelopes.
+    void labelLocalBubbles(MultiScalarField3D<int>& flag);
 private:
     BubbleMatch3D(BubbleMatch3D const& rhs) : mpiData(rhs.mpiData) { PLB_ASSERT( false ); }
     BubbleMatch3D& operator=(BubbleMatch3D const& rhs) { PLB_ASSERT( false ); return *this; }
 private:
-    MultiContainerBlock3D *bubbleContainer, *bubbleAnalysisContainer, *bubbleRemapContainer;
+    MultiContainerBlock3D *bubbleAnalysisContainer, *bubbleRemapContainer;
     BubbleMPIdata mpiData;
     MultiScalarField3D<plint> *tagMatrix;
     std::vector<double> bubbleVolume;
@@ -88,57 +88,6 @@ private:
 
 
 
-/**
- * Data for the bubble counter, associated to one block.
- * It holds information that changes during time:
- *  nextCellId: next available ID, if a new cell-type is found.
- *  retagging: a map that relates equivalent IDs, when two domains
- *             are found to be contiguous.
- *  maxNumBubbles: an upper bound for the number of bubbles per block,
- *                 so every block can create a globally unique bubble ID.
- **/
-class BubbleCounterData3D : public ContainerBlockData {
-public:
-    BubbleCounterData3D(plint maxNumBubbles_);
-    virtual BubbleCounterData3D* clone() const;
-    // The assumption here is that cell 0 is a cell that needs to
-    // be tagged ("a bubble cell"). Depending on the tag of neighboring
-    // cells, either one of the neighbor's tag or a new tag is assigned.
-    // There is a conflict if cell 0 has been previously converted in
-    // a way that is incompatible with the neighbor's tags.
-    bool convertCell (
-            plint& tag0,
-            plint tag1,  plint tag2,  plint tag3,
-            plint tag4,  plint tag5,  plint tag6,
-            plint tag7,  plint tag8,  plint tag9,
-            plint tag10, plint tag11, plint tag12, plint tag13,
-            plint tag1_,  plint tag2_,  plint tag3_,
-            plint tag4_,  plint tag5_,  plint tag6_,
-            plint tag7_,  plint tag8_,  plint tag9_,
-            plint tag10_, plint tag11_, plint tag12_, plint tag13_ );
-    // The assumption here is that cell 0 is a cell that needs to
-    // be tagged ("a bubble cell"). Depending on the tag of neighboring
-    // cell 1, either cell 1's tag or a new tag is assigned.
-    // There is a conflict if cell 0 has been previously converted in
-    // a way that is incompatible with cell 1's tag.
-    bool processNeighbor(plint& tag0, plint tag1);
-    plint getNextTag();
-    void reset();
-    // Get the "real" value (after remapping) of a given tag.
-    plint convertTag(plint tag) const;
-    // Important: it is assumed that oldTag and newTag are not
-    // themselves mapped. This means that for arbitrary tags tag1 and
-    // tag2 you should not call registerConflict(tag1,tag2), but
-    // registerConflict(convertTag(tag1), convertTag(tag2).
-
-    void registerConflict(plint oldTag, plint newTag);
-private:
-    plint nextCellId;
-    std::map<plint,plint> retagging;
-private:
-    plint maxNumBubbles;
-};
-
 class BubbleRemapData3D : public ContainerBlockData {
 public:
     BubbleRemapData3D(plint maxNumBubbles_=0)
@@ -147,39 +96,65 @@ public:
     virtual BubbleRemapData3D* clone() const;
     std::vector<plint>& getUniqueTags() { return uniqueTags; }
     std::vector<plint> const& getUniqueTags() const { return uniqueTags; }
+    // Pairs of tags (the first one belonging to this block) of bubbles which
+    // touch each other across the boundary of the block.
+    std::vector<std::pair<plint,plint> >& getContacts() { return contacts; }
+    std::vector<std::pair<plint,plint> > const& getContacts() const { return contacts; }
     std::map<plint,plint>& getTagRemap() { return tagRemap; }
-    bool isMyTag(plint tag);
+    // Convert a tag which is unique within the block into a globally unique one.
+    plint globalTag(plint localTag) const;
 private:
     plint maxNumBubbles;
     std::vector<plint> uniqueTags;
+    std::vector<std::pair<plint,plint> > contacts;
     std::map<plint,plint> tagRemap;
 };
 
+// Contributions of one block to the volume and center of the bubbles it
+// intersects, stored as a sparse list: the volume and the (volume-weighted)
+// center of bubble bubbleIds[i] are bubbleVolume[i] and bubbleCenter[i].
 struct BubbleAnalysisData3D : public ContainerBlockData {
     virtual BubbleAnalysisData3D* clone() const {
         return new BubbleAnalysisData3D(*this);
     }
+    std::vector<plint> bubbleIds;
     std::vector<double> bubbleVolume;
     std::vector<Array<double,3> > bubbleCenter;
 };
 
-class CountBubbleIteration3D : public PlainReductiveBoxProcessingFunctional3D
+// Connected-component labelling of the bubble cells inside the domain, with a
+// union-find algorithm. Every bubble cell gets a tag which is unique among all
+// blocks, and the list of tags is stored in the BubbleRemapData3D. Cells outside
+// the domain are not accessed, so that the blocks are labelled independently.
+class LabelLocalBubbles3D : public BoxProcessingFunctional3D
 {
 public:
-    CountBubbleIteration3D(bool matchEmpty_);
+    LabelLocalBubbles3D(bool matchEmpty_);
     virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks);
-    virtual CountBubbleIteration3D* clone() const;
+    virtual LabelLocalBubbles3D* clone() const;
     virtual void getTypeOfModification (std::vector<modif::ModifT>& modified) const {
         modified[0] = modif::staticVariables; // tags.
         modified[1] = modif::nothing;         // flags.
         modified[2] = modif::nothing;         // data.
     }
-    plint getNumConflicts() const;
 private:
-    plint numConflictsId;
     bool matchEmpty;
 };
 
+// Find the pairs of tags which are adjacent across the boundary of the domain,
+// after LabelLocalBubbles3D, and store them in the BubbleRemapData3D. Only the
+// outer layer of cells of the domain is visited.
+class CollectBubbleContacts3D : public BoxProcessingFunctional3D
+{
+public:
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks);
+    virtual CollectBubbleContacts3D* clone() const;
+    virtual void getTypeOfModification (std::vector<modif::ModifT>& modified) const {
+        modified[0] = modif::nothing;  // tags.
+        modified[1] = modif::nothing;  // data.
+    }
+};
+
 template<typename T>
 class AnalyzeBubbles3D : public BoxProcessingFunctional3D
 {
@@ -199,21 +174,8 @@ private:
 };
 
 
-// Converts the information about the overall available bubble tags available
-// to all processors.
-class CollectBubbleTags3D : public BoxProcessingFunctional3D
-{
-public:
-    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks);
-    virtual CollectBubbleTags3D* clone() const;
-    virtual void getTypeOfModification (std::vector<modif::ModifT>& modified) const {
-        modified[0] = modif::nothing;  // tags.
-        modified[1] = modif::nothing;  // data.
-    }
-};
-
 // Assign a new tag to all bubble cells (they must have been uniquely tagged previously).
-// The only field in the BubbleCounterData3D which is used here is tagRemap.
+// The only field in the BubbleRemapData3D which is used here is tagRemap.
 class ApplyTagRemap3D : public BoxProcessingFunctional3D
 {
 public:
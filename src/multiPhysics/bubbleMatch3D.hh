@@ -41,7 +41,7 @@ namespace plb {
 template<typename T>
 void BubbleMatch3D::execute(MultiScalarField3D<int>& flag, MultiScalarField3D<T>& volumeFraction)
 {
-    bubbleBucketFill(flag);
+    labelLocalBubbles(flag);
     pluint numBubbles = countAndTagBubbles();
     bubbleVolume.clear();
     bubbleCenter.clear();
@@ -102,10 +102,8 @@ void AnalyzeBubbles3D<T>::processGenericBlocks(Box3D domain,std::vector<AtomicBl
     Dot3D vfOffset = computeRelativeDisplacement(tagMatrix, volumeFraction);
     Dot3D absOfs = tagMatrix.getLocation();
 
-    std::vector<double> bubbleVolume(numBubbles);
-    std::fill(bubbleVolume.begin(), bubbleVolume.end(), 0.);
-    std::vector<Array<double,3> > bubbleCenter(numBubbles);
-    std::fill(bubbleCenter.begin(), bubbleCenter.end(), Array<double,3>(0.,0.,0.));
+    // Only the bubbles present in this block are accounted for.
+    std::map<plint, std::pair<double,Array<double,3> > > bubbles;
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -116,18 +114,22 @@ void AnalyzeBubbles3D<T>::processGenericBlocks(Box3D domain,std::vector<AtomicBl
                     if ( (matchEmpty && flagMatrix.get(iX+flagOffset.x,iY+flagOffset.y,iZ+flagOffset.z)==twoPhaseFlag::empty) ||
                          (!matchEmpty && flagMatrix.get(iX+flagOffset.x,iY+flagOffset.y,iZ+flagOffset.z)==twoPhaseFlag::fluid) )
                     {
-                        PLB_ASSERT( tag < (plint)bubbleVolume.size() );
-                        bubbleVolume[tag] += 1.0;
-                        bubbleCenter[tag] += Array<double,3>((double)iX+absOfs.x,(double)iY+absOfs.y,(double)iZ+absOfs.z);
+                        PLB_ASSERT( tag < (plint)numBubbles );
+                        std::pair<double,Array<double,3> >& bubble =
+                            bubbles.insert(std::make_pair(tag, std::make_pair(0., Array<double,3>(0.,0.,0.)))).first->second;
+                        bubble.first += 1.0;
+                        bubble.second += Array<double,3>((double)iX+absOfs.x,(double)iY+absOfs.y,(double)iZ+absOfs.z);
                     }
                     else if (flagMatrix.get(iX+flagOffset.x,iY+flagOffset.y,iZ+flagOffset.z)==twoPhaseFlag::interface) {
-                        PLB_ASSERT( tag < (plint)bubbleVolume.size() );
+                        PLB_ASSERT( tag < (plint)numBubbles );
                         double vf = (double)volumeFraction.get(iX+vfOffset.x,iY+vfOffset.y,iZ+vfOffset.z);
                         if (matchEmpty) {
                             vf = 1.0 - vf;
                         }
-                        bubbleVolume[tag] += vf;
-                        bubbleCenter[tag] += vf*Array<double,3>((double)iX+absOfs.x,(double)iY+absOfs.y,(double)iZ+absOfs.z);
+                        std::pair<double,Array<double,3> >& bubble =
+                            bubbles.insert(std::make_pair(tag, std::make_pair(0., Array<double,3>(0.,0.,0.)))).first->second;
+                        bubble.first += vf;
+                        bubble.second += vf*Array<double,3>((double)iX+absOfs.x,(double)iY+absOfs.y,(double)iZ+absOfs.z);
                     }
                     else {
                         PLB_ASSERT( false );
@@ -137,8 +139,15 @@ void AnalyzeBubbles3D<T>::processGenericBlocks(Box3D domain,std::vector<AtomicBl
         }
     }
 
-    data.bubbleVolume = bubbleVolume;
-    data.bubbleCenter = bubbleCenter;
+    data.bubbleIds.clear();
+    data.bubbleVolume.clear();
+    data.bubbleCenter.clear();
+    std::map<plint, std::pair<double,Array<double,3> > >::const_iterator it = bubbles.begin();
+    for (; it != bubbles.end(); ++it) {
+        data.bubbleIds.push_back(it->first);
+        data.bubbleVolume.push_back(it->second.first);
+        data.bubbleCenter.push_back(it->second.second);
+    }
 }
 
 }  // namespace plb
@@ -1743,6 +1743,9 @@ void FreeSurfaceIniInterfaceToAnyNodes3D<T,Descriptor>
     using namespace twoPhaseFlag;
 
     FreeSurfaceProcessorParam3D<T,Descriptor> param(atomicBlocks);
+
+    // Shared instance for all the cells which are emptied by this processor.
+    Dynamics<T,Descriptor>* emptyDynamics = 0;
     
     // 1. For interface->fluid nodes, update in the flag matrix,
     //   and compute and store mass excess from these cells.
@@ -1790,7 +1793,10 @@ void FreeSurfaceIniInterfaceToAnyNodes3D<T,Descriptor>
             }
             if (!isAdjacentToProtected) {
                 param.flag(iX,iY,iZ) = empty;
-                param.attributeDynamics(iX,iY,iZ, new NoDynamics<T,Descriptor>(rhoDefault));
+                if (!emptyDynamics) {
+                    emptyDynamics = param.internDynamics(new NoDynamics<T,Descriptor>(rhoDefault));
+                }
+                param.attributeDynamics(iX,iY,iZ, emptyDynamics);
 
                 T massExcess = param.mass(iX,iY,iZ);
                 param.emptiedMassExcess().insert(std::pair<Node,T>(node,massExcess));
@@ -1814,6 +1820,9 @@ void FreeSurfaceIniInterfaceToAnyNodes3D<T,Descriptor>
             }
         }
     }
+    if (emptyDynamics) {
+        param.releaseInternedDynamics(emptyDynamics);
+    }
 }
 
 /* *************** Class FreeSurfaceIniEmptyToInterfaceNodes3D ******************************************* */
@@ -1923,6 +1932,9 @@ void FreeSurfaceRemoveFalseInterfaceCells3D<T,Descriptor>
 
     FreeSurfaceProcessorParam3D<T,Descriptor> param(atomicBlocks);
 
+    // Shared instance for all the cells which are emptied by this processor.
+    Dynamics<T,Descriptor>* emptyDynamics = 0;
+
     /// In the following, the flag status of cells is read (non-locally) and
     /// modified (locally). To avoid conflict, two loops are made, the first
     /// of which reads only, and the second writes. The vectors "interfaceToFluidNodes"
@@ -1979,7 +1991,10 @@ void FreeSurfaceRemoveFalseInterfaceCells3D<T,Descriptor>
                             T massExcess = param.mass(iX,iY,iZ);
                             param.emptiedMassExcess().insert(std::pair<Node,T>(node,massExcess));
                             
-                            param.attributeDynamics(iX,iY,iZ,new NoDynamics<T,Descriptor>(rhoDefault));
+                            if (!emptyDynamics) {
+                                emptyDynamics = param.internDynamics(new NoDynamics<T,Descriptor>(rhoDefault));
+                            }
+                            param.attributeDynamics(iX,iY,iZ, emptyDynamics);
                             param.mass(iX,iY,iZ) = T();
                             param.volumeFraction(iX,iY,iZ) = T();
                             //param.setForce(iX,iY,iZ, Array<T,3>(T(),T(),T()));
@@ -2001,6 +2016,9 @@ void FreeSurfaceRemoveFalseInterfaceCells3D<T,Descriptor>
         Node const& pos = interfaceToEmptyNodes[i];
         param.flag(pos[0],pos[1],pos[2]) = empty;
     }
+    if (emptyDynamics) {
+        param.releaseInternedDynamics(emptyDynamics);
+    }
 }
 
 
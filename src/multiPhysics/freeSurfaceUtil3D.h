@@ -223,6 +223,12 @@ public:
     void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics) {
         fluid_->attributeDynamics(iX,iY,iZ, dynamics);
     }
+    Dynamics<T,Descriptor>* internDynamics(Dynamics<T,Descriptor>* dynamics) {
+        return fluid_->internDynamics(dynamics);
+    }
+    void releaseInternedDynamics(Dynamics<T,Descriptor>* dynamics) {
+        fluid_->releaseInternedDynamics(dynamics);
+    }
 
     bool isBoundary(plint iX, plint iY, plint iZ) {
         return cell(iX, iY, iZ).getDynamics().isBoundary();
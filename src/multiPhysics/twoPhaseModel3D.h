@@ -744,10 +744,24 @@ public:
         fluid_->attributeDynamics(iX,iY,iZ, dynamics);
     }
 
+    Dynamics<T,Descriptor>* internDynamics(Dynamics<T,Descriptor>* dynamics) {
+        return fluid_->internDynamics(dynamics);
+    }
+    void releaseInternedDynamics(Dynamics<T,Descriptor>* dynamics) {
+        fluid_->releaseInternedDynamics(dynamics);
+    }
     void attributeDynamics2(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics) {
         PLB_ASSERT(!useFreeSurfaceLimit);
         fluid2_->attributeDynamics(iX,iY,iZ, dynamics);
     }
+    Dynamics<T,Descriptor>* internDynamics2(Dynamics<T,Descriptor>* dynamics) {
+        PLB_ASSERT(!useFreeSurfaceLimit);
+        return fluid2_->internDynamics(dynamics);
+    }
+    void releaseInternedDynamics2(Dynamics<T,Descriptor>* dynamics) {
+        PLB_ASSERT(!useFreeSurfaceLimit);
+        fluid2_->releaseInternedDynamics(dynamics);
+    }
 
     bool isBoundary(plint iX, plint iY, plint iZ) {
         return cell(iX, iY, iZ).getDynamics().isBoundary();
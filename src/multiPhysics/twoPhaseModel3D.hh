@@ -1465,6 +1465,10 @@ void TwoPhaseIniInterfaceToAnyNodes3D<T,Descriptor>
     using namespace twoPhaseFlag;
 
     TwoPhaseProcessorParam3D<T,Descriptor> param(atomicBlocks);
+
+    // Shared instances for all the cells which are emptied by this processor.
+    Dynamics<T,Descriptor>* emptyDynamics = 0;
+    Dynamics<T,Descriptor>* emptyDynamics2 = 0;
     
     // 1. For interface->fluid nodes, update in the flag matrix,
     //   and compute and store mass excess from these cells.
@@ -1497,7 +1501,10 @@ void TwoPhaseIniInterfaceToAnyNodes3D<T,Descriptor>
 
                 if (model!=freeSurface) {
                     // interface->fluid for phase 1 means interface->empty for phase 2.
-                    param.attributeDynamics2(iX,iY,iZ,new NoDynamics<T,Descriptor>(rhoDefault));
+                    if (!emptyDynamics2) {
+                        emptyDynamics2 = param.internDynamics2(new NoDynamics<T,Descriptor>(rhoDefault));
+                    }
+                    param.attributeDynamics2(iX,iY,iZ, emptyDynamics2);
                     param.setForce2(iX,iY,iZ, Array<T,3>(T(),T(),T()));
                     param.setDensity2(iX,iY,iZ, rhoDefault);
                     param.setMomentum2(iX,iY,iZ, Array<T,3>(T(),T(),T()));
@@ -1520,7 +1527,10 @@ void TwoPhaseIniInterfaceToAnyNodes3D<T,Descriptor>
         plint iZ = node[2];
         
         param.flag(iX,iY,iZ) = empty;
-        param.attributeDynamics(iX,iY,iZ, new NoDynamics<T,Descriptor>(rhoDefault));
+        if (!emptyDynamics) {
+            emptyDynamics = param.internDynamics(new NoDynamics<T,Descriptor>(rhoDefault));
+        }
+        param.attributeDynamics(iX,iY,iZ, emptyDynamics);
 
         T massExcess = param.mass(iX,iY,iZ);
         param.massExcess().insert(std::pair<Node,T>(node,massExcess));
@@ -1570,6 +1580,12 @@ void TwoPhaseIniInterfaceToAnyNodes3D<T,Descriptor>
             }
         }
     }
+    if (emptyDynamics) {
+        param.releaseInternedDynamics(emptyDynamics);
+    }
+    if (emptyDynamics2) {
+        param.releaseInternedDynamics2(emptyDynamics2);
+    }
 }
 
 /* *************** Class TwoPhaseIniEmptyToInterfaceNodes3D ******************************************* */
@@ -1635,6 +1651,10 @@ void TwoPhaseRemoveFalseInterfaceCells3D<T,Descriptor>
 
     TwoPhaseProcessorParam3D<T,Descriptor> param(atomicBlocks);
 
+    // Shared instances for all the cells which are emptied by this processor.
+    Dynamics<T,Descriptor>* emptyDynamics = 0;
+    Dynamics<T,Descriptor>* emptyDynamics2 = 0;
+
     /// In the following, the flag status of cells is read (non-locally) and
     /// modified (locally). To avoid conflict, two loops are made, the first
     /// of which reads only, and the second writes. The vectors "interfaceToFluidNodes"
@@ -1690,7 +1710,10 @@ void TwoPhaseRemoveFalseInterfaceCells3D<T,Descriptor>
                                 param.mass2(iX,iY,iZ) = T();
                                 param.setDensity2(iX,iY,iZ, rhoDefault);
                                 param.setMomentum2(iX,iY,iZ, Array<T,3>(T(),T(),T()));
-                                param.attributeDynamics2(iX,iY,iZ,new NoDynamics<T,Descriptor>(rhoDefault));
+                                if (!emptyDynamics2) {
+                                    emptyDynamics2 = param.internDynamics2(new NoDynamics<T,Descriptor>(rhoDefault));
+                                }
+                                param.attributeDynamics2(iX,iY,iZ, emptyDynamics2);
                                 param.setForce2(iX,iY,iZ, Array<T,3>(T(),T(),T()));
                             }
                         }
@@ -1702,7 +1725,10 @@ void TwoPhaseRemoveFalseInterfaceCells3D<T,Descriptor>
                             T massExcess = param.mass(iX,iY,iZ);
                             param.massExcess().insert(std::pair<Node,T>(node,massExcess));
                             
-                            param.attributeDynamics(iX,iY,iZ,new NoDynamics<T,Descriptor>(rhoDefault));
+                            if (!emptyDynamics) {
+                                emptyDynamics = param.internDynamics(new NoDynamics<T,Descriptor>(rhoDefault));
+                            }
+                            param.attributeDynamics(iX,iY,iZ, emptyDynamics);
                             param.mass(iX,iY,iZ) = T();
                             param.volumeFraction(iX,iY,iZ) = T();
                             param.setForce(iX,iY,iZ, Array<T,3>(T(),T(),T()));
@@ -1733,6 +1759,12 @@ void TwoPhaseRemoveFalseInterfaceCells3D<T,Descriptor>
         PLB_ASSERT(param.flag(pos[0],pos[1],pos[2]) != protectEmpty);
         param.flag(pos[0],pos[1],pos[2]) = empty;
     }
+    if (emptyDynamics) {
+        param.releaseInternedDynamics(emptyDynamics);
+    }
+    if (emptyDynamics2) {
+        param.releaseInternedDynamics2(emptyDynamics2);
+    }
 }
 
 /* *************** Class TwoPhaseOutletMaximumVolumeFraction3D ******************************************* */
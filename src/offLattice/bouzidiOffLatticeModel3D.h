@@ -27,6 +27,7 @@
 
 #include "core/globalDefs.h"
 #include "offLattice/offLatticeModel3D.h"
+#include "offLattice/offLatticeNodeList3D.h"
 
 namespace plb {
 
@@ -44,10 +45,9 @@ public:
             std::vector<AtomicBlock3D const*> const& args );
     void cellCompletion (
             BlockLattice3D<T,Descriptor>& lattice,
-            Dot3D const& boundaryNode,
-            std::vector<int> const& solidDirections, std::vector<plint> const& boundaryIds,
-            std::vector<bool> const& hasFluidNeighbor, Dot3D const& absoluteOffset,
-            Array<T,3>& localForce, std::vector<AtomicBlock3D const*> const& args );
+            OffLatticeNodeList3D<T> const& boundaryNodes, plint iNode,
+            Dot3D const& absoluteOffset, Array<T,3>& localForce,
+            std::vector<AtomicBlock3D const*> const& args );
     virtual ContainerBlockData* generateOffLatticeInfo() const;
     virtual Array<T,3> getLocalForce(AtomicContainerBlock3D& container) const;
     void selectComputeStat(bool flag) { computeStat = flag; }
@@ -57,25 +57,15 @@ private:
     std::vector<T> invAB;
 private:
     /// Store the location of wall nodes, as well as the pattern of missing vs. known
-    ///   populations.
+    ///   populations. The links of a boundary node point along the solid
+    ///   directions; their flag tells whether the previous node along the
+    ///   link is a fluid node.
     class BouzidiOffLatticeInfo3D : public ContainerBlockData {
     public:
-        std::vector<Dot3D> const&               getBoundaryNodes() const
+        OffLatticeNodeList3D<T> const&          getBoundaryNodes() const
         { return boundaryNodes; }
-        std::vector<Dot3D>&                     getBoundaryNodes()
+        OffLatticeNodeList3D<T>&                getBoundaryNodes()
         { return boundaryNodes; }
-        std::vector<std::vector<int> > const&   getSolidDirections() const
-        { return solidDirections; }
-        std::vector<std::vector<int> >&         getSolidDirections()
-        { return solidDirections; }
-        std::vector<std::vector<plint> > const& getBoundaryIds() const
-        { return boundaryIds; }
-        std::vector<std::vector<plint> >&       getBoundaryIds()
-        { return boundaryIds; }
-        std::vector<std::vector<bool> > const&  getHasFluidNeighbor() const
-        { return hasFluidNeighbor; }
-        std::vector<std::vector<bool> >&        getHasFluidNeighbor()
-        { return hasFluidNeighbor; }
         Array<T,3> const&                       getLocalForce() const
         { return localForce; }
         Array<T,3>&                             getLocalForce()
@@ -84,10 +74,7 @@ private:
             return new BouzidiOffLatticeInfo3D(*this);
         }
     private:
-        std::vector<Dot3D>               boundaryNodes;
-        std::vector<std::vector<int> >   solidDirections;
-        std::vector<std::vector<plint> > boundaryIds;
-        std::vector<std::vector<bool> >  hasFluidNeighbor;
+        OffLatticeNodeList3D<T>          boundaryNodes;
         Array<T,3>                       localForce;
     };
 };
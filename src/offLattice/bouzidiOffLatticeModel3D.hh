@@ -26,6 +26,7 @@
 #define BOUZIDI_OFF_LATTICE_MODEL_3D_HH
 
 #include "offLattice/bouzidiOffLatticeModel3D.h"
+#include "offLattice/offLatticeNodeList3D.hh"
 #include "latticeBoltzmann/geometricOperationTemplates.h"
 #include "latticeBoltzmann/externalFieldAccess.h"
 #include <algorithm>
@@ -69,9 +70,8 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::prepareCell (
     BouzidiOffLatticeInfo3D* info =
         dynamic_cast<BouzidiOffLatticeInfo3D*>(container.getData());
     PLB_ASSERT( info );
-    std::vector<int> solidDirections;
-    std::vector<plint> boundaryIds;
-    std::vector<bool> hasFluidNeighbor;
+    OffLatticeNodeList3D<T>& boundaryNodes = info->getBoundaryNodes();
+    bool nodeAdded = false;
     if (this->isFluid(cellLocation+offset)) {
         for (plint iPop=1; iPop<D::q; ++iPop) {
             Dot3D neighbor(cellLocation.x+D::c[iPop][0], cellLocation.y+D::c[iPop][1], cellLocation.z+D::c[iPop][2]);
@@ -98,23 +98,15 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::prepareCell (
                 global::timer("intersect").stop();
                 PLB_ASSERT( ok );
                 // ... then add this node to the list.
-                solidDirections.push_back(iPop);
-                boundaryIds.push_back(iTriangle);
-                bool prevNodeIsPureFluid = this->isFluid(prevNode+offset);
-                if (prevNodeIsPureFluid) {
-                    hasFluidNeighbor.push_back(true);
-                }
-                else {
-                    hasFluidNeighbor.push_back(false);
+                if (!nodeAdded) {
+                    boundaryNodes.addNode(cellLocation);
+                    nodeAdded = true;
                 }
+                bool prevNodeIsPureFluid = this->isFluid(prevNode+offset);
+                boundaryNodes.addLink( iPop, 1, iTriangle, distance*invAB[iPop],
+                                       wallNormal, prevNodeIsPureFluid );
             }
         }
-        if (!solidDirections.empty()) {
-            info->getBoundaryNodes().push_back(cellLocation);
-            info->getSolidDirections().push_back(solidDirections);
-            info->getBoundaryIds().push_back(boundaryIds);
-            info->getHasFluidNeighbor().push_back(hasFluidNeighbor);
-        }
     }
 }
 
@@ -146,26 +138,15 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::boundaryCompletion (
     BouzidiOffLatticeInfo3D* info =
         dynamic_cast<BouzidiOffLatticeInfo3D*>(container.getData());
     PLB_ASSERT( info );
-    std::vector<Dot3D> const&
-        boundaryNodes = info->getBoundaryNodes();
-    std::vector<std::vector<int> > const&
-        solidDirections = info->getSolidDirections();
-    std::vector<std::vector<plint> > const&
-        boundaryIds = info->getBoundaryIds();
-    std::vector<std::vector<bool> > const&
-        hasFluidNeighbor = info->getHasFluidNeighbor();
-    PLB_ASSERT( boundaryNodes.size() == solidDirections.size() );
-    PLB_ASSERT( boundaryNodes.size() == boundaryIds.size() );
-    PLB_ASSERT( boundaryNodes.size() == hasFluidNeighbor.size() );
+    OffLatticeNodeList3D<T> const& boundaryNodes = info->getBoundaryNodes();
 
     Dot3D absoluteOffset = lattice.getLocation();
 
     Array<T,3>& localForce = info->getLocalForce();
     localForce.resetToZero();
-    for (pluint i=0; i<boundaryNodes.size(); ++i) {
+    for (plint iNode=0; iNode<boundaryNodes.getNumNodes(); ++iNode) {
         cellCompletion (
-            lattice, boundaryNodes[i], solidDirections[i],
-            boundaryIds[i], hasFluidNeighbor[i], absoluteOffset, localForce, args );
+            lattice, boundaryNodes, iNode, absoluteOffset, localForce, args );
     }
 }
 
@@ -173,10 +154,9 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::boundaryCompletion (
 template<typename T, template<typename U> class Descriptor>
 void BouzidiOffLatticeModel3D<T,Descriptor>::cellCompletion (
         BlockLattice3D<T,Descriptor>& lattice,
-        Dot3D const& boundaryNode,
-        std::vector<int> const& solidDirections, std::vector<plint> const& boundaryIds,
-        std::vector<bool> const& hasFluidNeighbor, Dot3D const& absoluteOffset,
-        Array<T,3>& localForce, std::vector<AtomicBlock3D const*> const& args )
+        OffLatticeNodeList3D<T> const& boundaryNodes, plint iNode,
+        Dot3D const& absoluteOffset, Array<T,3>& localForce,
+        std::vector<AtomicBlock3D const*> const& args )
 {
     typedef Descriptor<T> D;
     Array<T,D::d> deltaJ;
@@ -184,15 +164,21 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::cellCompletion (
 
     plint numNeumannNodes=0;
     T neumannDensity = T();
+    Dot3D const& boundaryNode = boundaryNodes.getNode(iNode);
     Cell<T,Descriptor>& cell = lattice.get(boundaryNode.x,boundaryNode.y,boundaryNode.z);
-    for(pluint i=0; i<solidDirections.size(); ++i) {
-        int iPop = solidDirections[i];
-        int oppPop = indexTemplates::opposite<D>(i);
+    plint linkEnd = boundaryNodes.linkEnd(iNode);
+    for(plint iLink=boundaryNodes.linkBegin(iNode); iLink<linkEnd; ++iLink) {
+        int iPop = boundaryNodes.getDirection(iLink);
+        int oppPop = indexTemplates::opposite<D>(iPop);
+        bool hasFluidNeighbor = boundaryNodes.getFlag(iLink);
+        // The normalized wall distance q is precomputed; the surface is only
+        //   queried for the boundary type and the wall velocity.
+        T q = boundaryNodes.getQ(iLink);
         Array<T,3> wallNode, wall_vel;
         T AC;
         OffBoundary::Type bdType;
         Array<T,3> wallNormal;
-        plint id = boundaryIds[i];
+        plint id = boundaryNodes.getId(iLink);
 #ifdef PLB_DEBUG
         bool ok =
 #endif
@@ -200,12 +186,11 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::cellCompletion (
                 boundaryNode+absoluteOffset, Dot3D(D::c[iPop][0],D::c[iPop][1],D::c[iPop][2]),
                 wallNode, AC, wallNormal, wall_vel, bdType, id );
         PLB_ASSERT( ok );
-        T q = AC * invAB[iPop];
         Cell<T,Descriptor>& iCell = lattice.get(boundaryNode.x+D::c[iPop][0],boundaryNode.y+D::c[iPop][1],boundaryNode.z+D::c[iPop][2]);
         Cell<T,Descriptor>& jCell = lattice.get(boundaryNode.x-D::c[iPop][0],boundaryNode.y-D::c[iPop][1],boundaryNode.z-D::c[iPop][2]);
         if (bdType==OffBoundary::dirichlet) {
             T u_ci = D::c[iPop][0]*wall_vel[0]+D::c[iPop][1]*wall_vel[1]+D::c[iPop][2]*wall_vel[2];
-            if (hasFluidNeighbor[i]) {
+            if (hasFluidNeighbor) {
                 if (q<(T)0.5) {
                     cell[oppPop] = 2.*q*iCell[iPop] + (1.-2.*q)*cell[iPop];
                     cell[oppPop] += 2.* u_ci*D::t[iPop]*D::invCs2;
@@ -222,7 +207,7 @@ void BouzidiOffLatticeModel3D<T,Descriptor>::cellCompletion (
         else if (bdType==OffBoundary::densityNeumann) {
             ++numNeumannNodes;
             neumannDensity += wall_vel[0];
-            if (hasFluidNeighbor[i]) {
+            if (hasFluidNeighbor) {
                 cell[oppPop] = jCell[oppPop];
             }
             else {
@@ -28,6 +28,7 @@
 #include "core/globalDefs.h"
 #include "offLattice/offLatticeModel3D.h"
 #include "offLattice/guoOffLatticeModel3D.h"
+#include "offLattice/offLatticeNodeList3D.h"
 
 namespace plb {
 
@@ -50,29 +51,21 @@ public:
 private:
     void cellCompletion (
             BlockLattice3D<T,Descriptor>& lattice,
-            Dot3D const& guoNode,
-            std::vector<int> const& dryNodeFluidDirections,
-            std::vector<plint> const& dryNodeIds, Dot3D const& absoluteOffset,
-            Array<T,3>& localForce, std::vector<AtomicBlock3D const*> const& args );
+            OffLatticeNodeList3D<T> const& dryNodes, plint iDry,
+            Dot3D const& absoluteOffset, Array<T,3>& localForce,
+            std::vector<AtomicBlock3D const*> const& args );
 private:
     bool computeStat;
 private:
     /// Store the location of wall nodes, as well as the pattern of missing vs. known
-    ///   populations.
+    ///   populations. The links of a dry node point along the directions of
+    ///   its fluid neighbors.
     class OffLatticeInfo3D : public ContainerBlockData {
     public:
-        std::vector<Dot3D> const&                getDryNodes() const
+        OffLatticeNodeList3D<T> const&           getDryNodes() const
         { return dryNodes; }
-        std::vector<Dot3D>&                      getDryNodes()
+        OffLatticeNodeList3D<T>&                 getDryNodes()
         { return dryNodes; }
-        std::vector<std::vector<int > > const&   getDryNodeFluidDirections() const
-        { return dryNodeFluidDirections; }
-        std::vector<std::vector<int > >&         getDryNodeFluidDirections()
-        { return dryNodeFluidDirections; }
-        std::vector<std::vector<plint> > const&  getDryNodeIds() const
-        { return dryNodeIds; }
-        std::vector<std::vector<plint> >&        getDryNodeIds()
-        { return dryNodeIds; }
         Array<T,3> const&                        getLocalForce() const
         { return localForce; }
         Array<T,3>&                              getLocalForce()
@@ -81,9 +74,7 @@ private:
             return new OffLatticeInfo3D(*this);
         }
     private:
-        std::vector<Dot3D> dryNodes;
-        std::vector<std::vector<int> >   dryNodeFluidDirections;
-        std::vector<std::vector<plint> > dryNodeIds;
+        OffLatticeNodeList3D<T>          dryNodes;
         Array<T,3>                       localForce;
     };
 };
@@ -26,6 +26,7 @@
 #define FILIPPOVA_HAENEL_3D_HH
 
 #include "offLattice/filippovaHaenel3D.h"
+#include "offLattice/offLatticeNodeList3D.hh"
 #include "offLattice/nextNeighbors3D.h"
 #include "latticeBoltzmann/geometricOperationTemplates.h"
 #include "latticeBoltzmann/externalFieldAccess.h"
@@ -62,8 +63,8 @@ void FilippovaHaenelModel3D<T,Descriptor>::prepareCell (
     Dot3D offset = container.getLocation();
     OffLatticeInfo3D* info = dynamic_cast<OffLatticeInfo3D*>(container.getData());
     PLB_ASSERT( info );
-    std::vector<int> liquidNeighbors;
-    std::vector<plint> ids;
+    OffLatticeNodeList3D<T>& dryNodes = info->getDryNodes();
+    bool nodeAdded = false;
     if (!this->isFluid(cellLocation+offset)) {
         for (int iPop=0; iPop<D::q; ++iPop) {
             Dot3D neighbor(cellLocation.x+D::c[iPop][0], cellLocation.y+D::c[iPop][1], cellLocation.z+D::c[iPop][2]);
@@ -91,15 +92,14 @@ void FilippovaHaenelModel3D<T,Descriptor>::prepareCell (
                 global::timer("intersect").stop();
                 PLB_ASSERT( ok );
                 // ... then add this node to the list.
-                liquidNeighbors.push_back(iPop);
-                ids.push_back(iTriangle);
+                if (!nodeAdded) {
+                    dryNodes.addNode(cellLocation);
+                    nodeAdded = true;
+                }
+                dryNodes.addLink( iPop, 1, iTriangle, distance/std::sqrt(D::cNormSqr[iPop]),
+                                  wallNormal );
             }
         }
-        if (!liquidNeighbors.empty()) {
-            info->getDryNodes().push_back(cellLocation);
-            info->getDryNodeFluidDirections().push_back(liquidNeighbors);
-            info->getDryNodeIds().push_back(ids);
-        }
     }
 }
 
@@ -131,33 +131,27 @@ void FilippovaHaenelModel3D<T,Descriptor>::boundaryCompletion (
     OffLatticeInfo3D* info =
         dynamic_cast<OffLatticeInfo3D*>(container.getData());
     PLB_ASSERT( info );
-    std::vector<Dot3D> const&
-        dryNodes = info->getDryNodes();
-    std::vector<std::vector<int > > const&
-        dryNodeFluidDirections = info->getDryNodeFluidDirections();
-    std::vector<std::vector<plint> > const&
-        dryNodeIds = info->getDryNodeIds();
-    PLB_ASSERT( dryNodes.size() == dryNodeFluidDirections.size() );
+    OffLatticeNodeList3D<T> const& dryNodes = info->getDryNodes();
 
     Dot3D absoluteOffset = lattice.getLocation();
 
     Array<T,3>& localForce = info->getLocalForce();
     localForce.resetToZero();
-    for (pluint iDry=0; iDry<dryNodes.size(); ++iDry) {
+    for (plint iDry=0; iDry<dryNodes.getNumNodes(); ++iDry) {
         cellCompletion (
-            lattice, dryNodes[iDry], dryNodeFluidDirections[iDry],
-            dryNodeIds[iDry], absoluteOffset, localForce, args );
+            lattice, dryNodes, iDry, absoluteOffset, localForce, args );
     }
 }
 
 template<typename T, template<typename U> class Descriptor>
 void FilippovaHaenelModel3D<T,Descriptor>::cellCompletion (
-        BlockLattice3D<T,Descriptor>& lattice, Dot3D const& guoNode,
-        std::vector<int> const& dryNodeFluidDirections,
-        std::vector<plint> const& dryNodeIds, Dot3D const& absoluteOffset,
-        Array<T,3>& localForce, std::vector<AtomicBlock3D const*> const& args )
+        BlockLattice3D<T,Descriptor>& lattice,
+        OffLatticeNodeList3D<T> const& dryNodes, plint iDry,
+        Dot3D const& absoluteOffset, Array<T,3>& localForce,
+        std::vector<AtomicBlock3D const*> const& args )
 {
     typedef Descriptor<T> D;
+    Dot3D const& guoNode = dryNodes.getNode(iDry);
     Cell<T,Descriptor>& s_cell =
         lattice.get( guoNode.x, guoNode.y, guoNode.z );
 #ifdef PLB_DEBUG
@@ -165,12 +159,13 @@ void FilippovaHaenelModel3D<T,Descriptor>::cellCompletion (
 #endif
         NoDynamics<T,Descriptor>().getId();
     PLB_ASSERT( s_cell.getDynamics().getId() == noDynId );
-    for (plint iDirection=0; iDirection<(plint)dryNodeFluidDirections.size(); ++iDirection)
+    plint linkEnd = dryNodes.linkEnd(iDry);
+    for (plint iLink=dryNodes.linkBegin(iDry); iLink<linkEnd; ++iLink)
     {
-        int iOpp = dryNodeFluidDirections[iDirection];
+        int iOpp = dryNodes.getDirection(iLink);
         int iPop = indexTemplates::opposite<Descriptor<T> >(iOpp);
         Dot3D fluidDirection(D::c[iOpp][0],D::c[iOpp][1],D::c[iOpp][2]);
-        plint dryNodeId = dryNodeIds[iDirection];
+        plint dryNodeId = dryNodes.getId(iLink);
 
         Array<T,3> wallNode, wall_vel;
         T wallDistance;
@@ -207,9 +202,10 @@ void FilippovaHaenelModel3D<T,Descriptor>::cellCompletion (
         PLB_ASSERT( ok );
 
         Array<T,3> w_j = wall_vel*f_rho;
-        T d = std::sqrt(D::cNormSqr[iOpp]);
-        PLB_ASSERT( wallDistance <= d );
-        T delta = 1.0-wallDistance / d;
+        // The normalized wall distance is precomputed; the surface is only
+        //   queried for the boundary type and the wall velocity.
+        T delta = 1.0-dryNodes.getQ(iLink);
+        PLB_ASSERT( delta >= 0. );
 
         T kappa = 0.;
         Array<T,3> wf_j; wf_j.resetToZero();
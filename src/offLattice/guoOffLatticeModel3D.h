@@ -27,6 +27,7 @@
 
 #include "core/globalDefs.h"
 #include "offLattice/offLatticeModel3D.h"
+#include "offLattice/offLatticeNodeList3D.h"
 
 namespace plb {
 
@@ -51,12 +52,6 @@ public:
     void selectComputeStat(bool flag) { computeStat = flag; }
     bool computesStat() const { return computeStat; }
 private:
-    void cellCompletion (
-            BlockLattice3D<T,Descriptor>& lattice,
-            Dot3D const& guoNode,
-            std::vector<std::pair<int,int> > const& dryNodeFluidDirections,
-            std::vector<plint> const& dryNodeIds, Dot3D const& absoluteOffset,
-            Array<T,3>& localForce, std::vector<AtomicBlock3D const*> const& args );
     void computeRhoBarJPiNeqAlongDirection (
               BlockLattice3D<T,Descriptor> const& lattice, Dot3D const& guoNode,
               Dot3D const& fluidDirection, int depth, Array<T,3> const& wallNode, T delta,
@@ -80,25 +75,15 @@ private:
     bool computeStat;
 public:
     /// Store the location of wall nodes, as well as the pattern of missing vs. known
-    ///   populations.
+    ///   populations. For each dry node, the links to the fluid neighbors are
+    ///   stored as (next-neighbor direction, depth), together with the id of the
+    ///   wall element, the normalized wall distance and the wall normal.
     class GuoOffLatticeInfo3D : public ContainerBlockData {
     public:
-        std::vector<Dot3D> const&                               getDryNodes() const
+        OffLatticeNodeList3D<T> const&                          getDryNodes() const
         { return dryNodes; }
-        std::vector<Dot3D>&                                     getDryNodes()
+        OffLatticeNodeList3D<T>&                                getDryNodes()
         { return dryNodes; }
-        std::vector<std::vector<std::pair<int,int> > > const&   getDryNodeFluidDirections() const
-        { return dryNodeFluidDirections; }
-        std::vector<std::vector<std::pair<int,int> > >&         getDryNodeFluidDirections()
-        { return dryNodeFluidDirections; }
-        std::vector<std::vector<plint> > const&                 getDryNodeIds() const
-        { return dryNodeIds; }
-        std::vector<std::vector<plint> >&                       getDryNodeIds()
-        { return dryNodeIds; }
-        std::vector<bool> const&                                getIsConnected() const
-        { return isConnected; }
-        std::vector<bool>&                                      getIsConnected()
-        { return isConnected; }
         Array<T,3> const&                                       getLocalForce() const
         { return localForce; }
         Array<T,3>&                                             getLocalForce()
@@ -107,18 +92,18 @@ public:
             return new GuoOffLatticeInfo3D(*this);
         }
     private:
-        std::vector<Dot3D> dryNodes;
-        std::vector<std::vector<std::pair<int,int> > >   dryNodeFluidDirections;
-        std::vector<std::vector<plint> >                 dryNodeIds;
-        std::vector<bool>                                isConnected;
+        OffLatticeNodeList3D<T>                          dryNodes;
         Array<T,3>                                       localForce;
     };
 
     struct LiquidNeighbor {
-        LiquidNeighbor(plint iNeighbor_, plint depth_, plint iTriangle_, Array<T,3> wallNormal);
+        LiquidNeighbor(plint iNeighbor_, plint depth_, plint iTriangle_,
+                       T distance_, Array<T,3> wallNormal_);
         bool operator<(LiquidNeighbor const& rhs) const;
         plint iNeighbor, depth;
         plint iTriangle;
+        T distance;
+        Array<T,3> wallNormal;
         T cosAngle;
     };
 };
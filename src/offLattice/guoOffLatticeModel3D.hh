@@ -26,6 +26,7 @@
 #define GUO_OFF_LATTICE_MODEL_3D_HH
 
 #include "offLattice/guoOffLatticeModel3D.h"
+#include "offLattice/offLatticeNodeList3D.hh"
 #include "offLattice/nextNeighbors3D.h"
 #include "latticeBoltzmann/geometricOperationTemplates.h"
 #include "latticeBoltzmann/externalFieldAccess.h"
@@ -37,10 +38,13 @@ namespace plb {
 
 template<typename T, template<typename U> class Descriptor>
 GuoOffLatticeModel3D<T,Descriptor>::LiquidNeighbor::LiquidNeighbor
-            (plint iNeighbor_, plint depth_, plint iTriangle_, Array<T,3> wallNormal)
+            (plint iNeighbor_, plint depth_, plint iTriangle_,
+             T distance_, Array<T,3> wallNormal_)
         : iNeighbor(iNeighbor_),
           depth(depth_),
-          iTriangle(iTriangle_)
+          iTriangle(iTriangle_),
+          distance(distance_),
+          wallNormal(wallNormal_)
 {
     int const* c = NextNeighbor<T>::c[iNeighbor];
     Array<T,3> neighborVect(c[0],c[1],c[2]);
@@ -124,27 +128,20 @@ void GuoOffLatticeModel3D<T,Descriptor>::prepareCell (
                 global::timer("intersect").stop();
                 PLB_ASSERT( ok );
                 // ... then add this node to the list.
-                liquidNeighbors.push_back(LiquidNeighbor(iNeighbor, depth, iTriangle, wallNormal));
+                liquidNeighbors.push_back(LiquidNeighbor(iNeighbor, depth, iTriangle, distance, wallNormal));
             }
         }
         if (!liquidNeighbors.empty()) {
-            info->getDryNodes().push_back(cellLocation);
+            OffLatticeNodeList3D<T>& dryNodes = info->getDryNodes();
+            dryNodes.addNode(cellLocation);
             std::sort(liquidNeighbors.begin(), liquidNeighbors.end());
-            std::vector<std::pair<int,int> > neighborDepthPairs;
-            std::vector<plint> ids;
-            if (useAllDirections) {
-                for (pluint i=0; i<liquidNeighbors.size(); ++i) {
-                    neighborDepthPairs.push_back(std::make_pair(liquidNeighbors[i].iNeighbor, liquidNeighbors[i].depth));
-                    ids.push_back(liquidNeighbors[i].iTriangle);
-                }
-            }
-            else {
-                plint i = liquidNeighbors.size()-1;
-                neighborDepthPairs.push_back(std::make_pair(liquidNeighbors[i].iNeighbor, liquidNeighbors[i].depth));
-                ids.push_back(liquidNeighbors[i].iTriangle);
+            pluint iFirst = useAllDirections ? 0 : liquidNeighbors.size()-1;
+            for (pluint i=iFirst; i<liquidNeighbors.size(); ++i) {
+                LiquidNeighbor const& neighbor = liquidNeighbors[i];
+                dryNodes.addLink( neighbor.iNeighbor, neighbor.depth, neighbor.iTriangle,
+                                  neighbor.distance*NextNeighbor<T>::invD[neighbor.iNeighbor],
+                                  neighbor.wallNormal );
             }
-            info->getDryNodeFluidDirections().push_back(neighborDepthPairs);
-            info->getDryNodeIds().push_back(ids);
         }
     }
 }
@@ -166,37 +163,6 @@ Array<T,3> GuoOffLatticeModel3D<T,Descriptor>::getLocalForce (
     return info->getLocalForce();
 }
 
-template<typename T, template<typename U> class Descriptor>
-void GuoOffLatticeModel3D<T,Descriptor>::boundaryCompletion (
-        AtomicBlock3D& nonTypeLattice,
-        AtomicContainerBlock3D& container,
-        std::vector<AtomicBlock3D const*> const& args )
-{
-    BlockLattice3D<T,Descriptor>& lattice =
-        dynamic_cast<BlockLattice3D<T,Descriptor>&> (nonTypeLattice);
-    GuoOffLatticeInfo3D* info =
-        dynamic_cast<GuoOffLatticeInfo3D*>(container.getData());
-    PLB_ASSERT( info );
-    std::vector<Dot3D> const&
-        dryNodes = info->getDryNodes();
-    std::vector<std::vector<std::pair<int,int> > > const&
-        dryNodeFluidDirections = info->getDryNodeFluidDirections();
-    std::vector<std::vector<plint> > const&
-        dryNodeIds = info->getDryNodeIds();
-    PLB_ASSERT( dryNodes.size() == dryNodeFluidDirections.size() );
-
-    Dot3D absoluteOffset = lattice.getLocation();
-
-    Array<T,3>& localForce = info->getLocalForce();
-    localForce.resetToZero();
-    for (pluint iDry=0; iDry<dryNodes.size(); ++iDry) {
-        cellCompletion (
-            lattice, dryNodes[iDry], dryNodeFluidDirections[iDry],
-            dryNodeIds[iDry], absoluteOffset, localForce, args );
-    }
-}
-
-
 template<typename T, template<typename U> class Descriptor>
 class GuoAlgorithm3D {
 public:
@@ -204,13 +170,12 @@ public:
     GuoAlgorithm3D (
         OffLatticeModel3D<T,Array<T,3> >& model_,
         BlockLattice3D<T,Descriptor>& lattice_,
-        Dot3D const& guoNode_,
-        std::vector<std::pair<int,int> > const& dryNodeFluidDirections_,
-        std::vector<plint> const& dryNodeIds_, Dot3D const& absoluteOffset_,
+        OffLatticeNodeList3D<T> const& dryNodes_, Dot3D const& absoluteOffset_,
         Array<T,3>& localForce_, std::vector<AtomicBlock3D const*> const& args_,
         bool computeStat_, bool secondOrder_);
     virtual ~GuoAlgorithm3D() { }
-    bool computeNeighborData();
+    /// Select the dry node iDry and extrapolate the variables from its fluid neighbors.
+    bool computeNeighborData(plint iDry);
     void finalize();
 
     virtual void extrapolateVariables (
@@ -220,13 +185,20 @@ public:
     virtual void reduceVariables(T sumWeights) =0;
     virtual void complete() =0;
 
+protected:
+    /// Next-neighbor direction of the link iDirection of the current dry node.
+    int getNeighbor(plint iDirection) const {
+        return dryNodes.getDirection(firstLink+iDirection);
+    }
+    /// Adapt per-direction buffers to the number of links of the current dry node.
+    virtual void resizeBuffers();
 protected:
     OffLatticeModel3D<T,Array<T,3> >& model;
     BlockLattice3D<T,Descriptor>& lattice;
-    Dot3D const& guoNode;
-    Cell<T,Descriptor>& cell;
-    std::vector<std::pair<int,int> > const& dryNodeFluidDirections;
-    std::vector<plint> const& dryNodeIds;
+    OffLatticeNodeList3D<T> const& dryNodes;
+    Dot3D guoNode;
+    Cell<T,Descriptor>* cell;
+    plint firstLink;
     Dot3D absoluteOffset;
     Array<T,3>& localForce;
     std::vector<AtomicBlock3D const*> const& args;
@@ -245,49 +217,62 @@ template<typename T, template<typename U> class Descriptor>
 GuoAlgorithm3D<T,Descriptor>::GuoAlgorithm3D (
             OffLatticeModel3D<T,Array<T,3> >& model_,
             BlockLattice3D<T,Descriptor>& lattice_,
-            Dot3D const& guoNode_,
-            std::vector<std::pair<int,int> > const& dryNodeFluidDirections_,
-            std::vector<plint> const& dryNodeIds_, Dot3D const& absoluteOffset_,
+            OffLatticeNodeList3D<T> const& dryNodes_, Dot3D const& absoluteOffset_,
             Array<T,3>& localForce_, std::vector<AtomicBlock3D const*> const& args_,
             bool computeStat_, bool secondOrder_ )
     : model(model_),
       lattice(lattice_),
-      guoNode(guoNode_),
-      cell(lattice.get(guoNode.x, guoNode.y, guoNode.z)),
-      dryNodeFluidDirections(dryNodeFluidDirections_),
-      dryNodeIds(dryNodeIds_),
+      dryNodes(dryNodes_),
+      cell(0),
+      firstLink(0),
       absoluteOffset(absoluteOffset_),
       localForce(localForce_),
       args(args_),
+      numDirections(0),
       computeStat(computeStat_),
       secondOrder(secondOrder_)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+void GuoAlgorithm3D<T,Descriptor>::resizeBuffers()
 {
-    numDirections = (plint)dryNodeFluidDirections.size();
     weights.resize(numDirections);
     rhoBarVect.resize(numDirections);
     jVect.resize(numDirections);
 }
 
 template<typename T, template<typename U> class Descriptor>
-bool GuoAlgorithm3D<T,Descriptor>::computeNeighborData()
+bool GuoAlgorithm3D<T,Descriptor>::computeNeighborData(plint iDry)
 {
+    guoNode = dryNodes.getNode(iDry);
+    cell = &lattice.get(guoNode.x, guoNode.y, guoNode.z);
+    firstLink = dryNodes.linkBegin(iDry);
+    numDirections = dryNodes.getNumLinks(iDry);
+    this->resizeBuffers();
+
     T sumWeights = T();
-    Array<T,3> wallNormal;
     for (plint iDirection=0; iDirection<numDirections; ++iDirection) {
-        int iNeighbor = dryNodeFluidDirections[iDirection].first;
+        plint iLink = firstLink+iDirection;
+        int iNeighbor = dryNodes.getDirection(iLink);
         int const* c = NextNeighbor<T>::c[iNeighbor];
         Dot3D fluidDirection(c[0],c[1],c[2]);
-        plint dryNodeId = dryNodeIds[iDirection];
-        int depth = dryNodeFluidDirections[iDirection].second;
-
-        Array<T,3> wallNode, wall_vel;
+        plint dryNodeId = dryNodes.getId(iLink);
+        int depth = dryNodes.getDepth(iLink);
+        // The wall distance and normal are geometric quantities which have
+        //   been computed once, at the time the dry nodes were identified.
+        //   The surface is still queried for the boundary type and the wall
+        //   velocity, which may depend on time.
+        Array<T,3> const& wallNormal = dryNodes.getWallNormal(iLink);
+        T delta = (T)1. - dryNodes.getQ(iLink);
+
+        Array<T,3> wallNode, wall_vel, surfaceNormal;
         T wallDistance;
         OffBoundary::Type bdType;
 #ifdef PLB_DEBUG
         bool ok =
 #endif
         this->model.pointOnSurface( guoNode+absoluteOffset, fluidDirection,
-                                    wallNode, wallDistance, wallNormal,
+                                    wallNode, wallDistance, surfaceNormal,
                                     wall_vel, bdType, dryNodeId );
         PLB_ASSERT( ok );
         if (! ( bdType==OffBoundary::dirichlet || bdType==OffBoundary::neumann ||
@@ -299,12 +284,11 @@ bool GuoAlgorithm3D<T,Descriptor>::computeNeighborData()
             for (int iD=0; iD<Descriptor<T>::d; ++iD) {
                 // Use the formula uLB = uP - 1/2 g. If there is no external force,
                 //   the force term automatically evaluates to zero.
-                wall_vel[iD] -= (T)0.5*getExternalForceComponent(cell,iD);
+                wall_vel[iD] -= (T)0.5*getExternalForceComponent(*cell,iD);
             }
         }
         T invDistanceToNeighbor = NextNeighbor<T>::invD[iNeighbor];
-        PLB_ASSERT( wallDistance <= NextNeighbor<T>::d[iNeighbor] );
-        T delta = (T)1. - wallDistance * invDistanceToNeighbor;
+        PLB_ASSERT( delta >= T() );
         Array<T,3> normalFluidDirection((T)fluidDirection.x, (T)fluidDirection.y, (T)fluidDirection.z);
         normalFluidDirection *= invDistanceToNeighbor;
         weights[iDirection] = std::fabs(dot(normalFluidDirection, wallNormal));
@@ -326,13 +310,13 @@ void GuoAlgorithm3D<T,Descriptor>::finalize()
     deltaJ.resetToZero();
     if (computeStat) {
         for (plint iDirection=0; iDirection<numDirections; ++iDirection) {
-            int iNeighbor = dryNodeFluidDirections[iDirection].first;
+            int iNeighbor = getNeighbor(iDirection);
             int iPop = nextNeighborPop<T,Descriptor>(iNeighbor);
             if (iPop>=0) {
                 plint oppPop = indexTemplates::opposite<D>(iPop);
-                deltaJ[0] += D::c[oppPop][0]*cell[oppPop];
-                deltaJ[1] += D::c[oppPop][1]*cell[oppPop];
-                deltaJ[2] += D::c[oppPop][2]*cell[oppPop];
+                deltaJ[0] += D::c[oppPop][0]*(*cell)[oppPop];
+                deltaJ[1] += D::c[oppPop][1]*(*cell)[oppPop];
+                deltaJ[2] += D::c[oppPop][2]*(*cell)[oppPop];
             }
         }
     }
@@ -340,12 +324,12 @@ void GuoAlgorithm3D<T,Descriptor>::finalize()
     this->complete();
 
     if (computeStat) {
-        Cell<T,Descriptor> collidedCell(cell);
+        Cell<T,Descriptor> collidedCell(*cell);
         BlockStatistics statsCopy(lattice.getInternalStatistics());
         collidedCell.collide(statsCopy);
 
         for (plint iDirection=0; iDirection<numDirections; ++iDirection) {
-            int iNeighbor = dryNodeFluidDirections[iDirection].first;
+            int iNeighbor = getNeighbor(iDirection);
             plint iPop = nextNeighborPop<T,Descriptor>(iNeighbor);
             if (iPop>=0) {
                 deltaJ[0] -= D::c[iPop][0]*collidedCell[iPop];
@@ -370,9 +354,7 @@ public:
     GuoPiNeqAlgorithm3D (
         OffLatticeModel3D<T,Array<T,3> >& model_,
         BlockLattice3D<T,Descriptor>& lattice_,
-        Dot3D const& guoNode_,
-        std::vector<std::pair<int,int> > const& dryNodeFluidDirections_,
-        std::vector<plint> const& dryNodeIds_, Dot3D const& absoluteOffset_,
+        OffLatticeNodeList3D<T> const& dryNodes_, Dot3D const& absoluteOffset_,
         Array<T,3>& localForce_, std::vector<AtomicBlock3D const*> const& args_,
         bool computeStat_, bool secondOrder_ );
     virtual void extrapolateVariables (
@@ -381,6 +363,8 @@ public:
               Array<T,3> const& wallNormal, plint triangleId, plint iDirection );
     virtual void reduceVariables(T sumWeights);
     virtual void complete();
+protected:
+    virtual void resizeBuffers();
 private:
     std::vector<Array<T,SymmetricTensor<T,Descriptor>::n> > PiNeqVect;
     Array<T,SymmetricTensor<T,Descriptor>::n> PiNeq;
@@ -390,19 +374,22 @@ template<typename T, template<typename U> class Descriptor>
 GuoPiNeqAlgorithm3D<T,Descriptor>::GuoPiNeqAlgorithm3D (
             OffLatticeModel3D<T,Array<T,3> >& model_,
             BlockLattice3D<T,Descriptor>& lattice_,
-            Dot3D const& guoNode_,
-            std::vector<std::pair<int,int> > const& dryNodeFluidDirections_,
-            std::vector<plint> const& dryNodeIds_, Dot3D const& absoluteOffset_,
+            OffLatticeNodeList3D<T> const& dryNodes_, Dot3D const& absoluteOffset_,
             Array<T,3>& localForce_, std::vector<AtomicBlock3D const*> const& args_,
             bool computeStat_, bool secondOrder_ )
     : GuoAlgorithm3D<T,Descriptor> (
-            model_, lattice_, guoNode_, dryNodeFluidDirections_, dryNodeIds_,
-            absoluteOffset_, localForce_, args_, computeStat_, secondOrder_ )
+            model_, lattice_, dryNodes_, absoluteOffset_, localForce_, args_, computeStat_, secondOrder_ )
 {
-    PiNeqVect.resize(this->numDirections);
     PiNeq.resetToZero();
 }
 
+template<typename T, template<typename U> class Descriptor>
+void GuoPiNeqAlgorithm3D<T,Descriptor>::resizeBuffers()
+{
+    GuoAlgorithm3D<T,Descriptor>::resizeBuffers();
+    PiNeqVect.resize(this->numDirections);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void GuoPiNeqAlgorithm3D<T,Descriptor>::extrapolateVariables (
           Dot3D const& fluidDirection, int depth, Array<T,3> const& wallNode, T delta,
@@ -520,20 +507,21 @@ void GuoPiNeqAlgorithm3D<T,Descriptor>::reduceVariables(T sumWeights) {
 
 template<typename T, template<typename U> class Descriptor>
 void GuoPiNeqAlgorithm3D<T,Descriptor>::complete() {
-    Dynamics<T,Descriptor> const& dynamics = this->cell.getDynamics();
+    Cell<T,Descriptor>& cell = *this->cell;
+    Dynamics<T,Descriptor> const& dynamics = cell.getDynamics();
     T jSqr = normSqr(this->j);
     if (this->model.getPartialReplace()) {
-        Cell<T,Descriptor> saveCell(this->cell);
-        dynamics.regularize(this->cell, this->rhoBar, this->j, jSqr, PiNeq);
+        Cell<T,Descriptor> saveCell(cell);
+        dynamics.regularize(cell, this->rhoBar, this->j, jSqr, PiNeq);
         for (plint iDirection=0; iDirection<this->numDirections; ++iDirection) {
-            int iNeighbor = this->dryNodeFluidDirections[iDirection].first;
+            int iNeighbor = this->getNeighbor(iDirection);
             plint iPop = nextNeighborPop<T,Descriptor>(iNeighbor);
             plint oppPop = indexTemplates::opposite<D>(iPop);
-            this->cell[oppPop] = saveCell[oppPop];
+            cell[oppPop] = saveCell[oppPop];
         }
     }
     else {
-        dynamics.regularize(this->cell, this->rhoBar, this->j, jSqr, PiNeq);
+        dynamics.regularize(cell, this->rhoBar, this->j, jSqr, PiNeq);
     }
 }
 
@@ -546,9 +534,7 @@ public:
     GuoOffPopAlgorithm3D (
         OffLatticeModel3D<T,Array<T,3> >& model_,
         BlockLattice3D<T,Descriptor>& lattice_,
-        Dot3D const& guoNode_,
-        std::vector<std::pair<int,int> > const& dryNodeFluidDirections_,
-        std::vector<plint> const& dryNodeIds_, Dot3D const& absoluteOffset_,
+        OffLatticeNodeList3D<T> const& dryNodes_, Dot3D const& absoluteOffset_,
         Array<T,3>& localForce_, std::vector<AtomicBlock3D const*> const& args_, bool computeStat_, bool secondOrder_ );
     virtual void extrapolateVariables (
               Dot3D const& fluidDirection, int depth, Array<T,3> const& wallNode, T delta,
@@ -556,6 +542,8 @@ public:
               Array<T,3> const& wallNormal, plint triangleId, plint iDirection );
     virtual void reduceVariables(T sumWeights);
     virtual void complete();
+protected:
+    virtual void resizeBuffers();
 private:
     std::vector<Array<T,Descriptor<T>::q> > fNeqVect;
     Array<T,Descriptor<T>::q> fNeq;
@@ -565,19 +553,22 @@ template<typename T, template<typename U> class Descriptor>
 GuoOffPopAlgorithm3D<T,Descriptor>::GuoOffPopAlgorithm3D (
             OffLatticeModel3D<T,Array<T,3> >& model_,
             BlockLattice3D<T,Descriptor>& lattice_,
-            Dot3D const& guoNode_,
-            std::vector<std::pair<int,int> > const& dryNodeFluidDirections_,
-            std::vector<plint> const& dryNodeIds_, Dot3D const& absoluteOffset_,
+            OffLatticeNodeList3D<T> const& dryNodes_, Dot3D const& absoluteOffset_,
             Array<T,3>& localForce_, std::vector<AtomicBlock3D const*> const& args_,
             bool computeStat_, bool secondOrder_ )
     : GuoAlgorithm3D<T,Descriptor> (
-            model_, lattice_, guoNode_, dryNodeFluidDirections_, dryNodeIds_,
-            absoluteOffset_, localForce_, args_, computeStat_, secondOrder_ )
+            model_, lattice_, dryNodes_, absoluteOffset_, localForce_, args_, computeStat_, secondOrder_ )
 {
-    fNeqVect.resize(this->numDirections);
     fNeq.resetToZero();
 }
 
+template<typename T, template<typename U> class Descriptor>
+void GuoOffPopAlgorithm3D<T,Descriptor>::resizeBuffers()
+{
+    GuoAlgorithm3D<T,Descriptor>::resizeBuffers();
+    fNeqVect.resize(this->numDirections);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void GuoOffPopAlgorithm3D<T,Descriptor>::extrapolateVariables (
           Dot3D const& fluidDirection, int depth, Array<T,3> const& wallNode, T delta,
@@ -670,46 +661,60 @@ void GuoOffPopAlgorithm3D<T,Descriptor>::reduceVariables(T sumWeights) {
 
 template<typename T, template<typename U> class Descriptor>
 void GuoOffPopAlgorithm3D<T,Descriptor>::complete() {
+    Cell<T,Descriptor>& cell = *this->cell;
     T jSqr = normSqr(this->j);
     if (this->model.getPartialReplace()) {
         for (plint iDirection=0; iDirection<this->numDirections; ++iDirection) {
-            int iNeighbor = this->dryNodeFluidDirections[iDirection].first;
+            int iNeighbor = this->getNeighbor(iDirection);
             plint iPop = nextNeighborPop<T,Descriptor>(iNeighbor);
-            this->cell[iPop] = this->cell.computeEquilibrium(iPop, this->rhoBar, this->j, jSqr)+fNeq[iPop];
+            cell[iPop] = cell.computeEquilibrium(iPop, this->rhoBar, this->j, jSqr)+fNeq[iPop];
         }
     }
     else {
         for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
-            this->cell[iPop] = this->cell.computeEquilibrium(iPop, this->rhoBar, this->j, jSqr)+fNeq[iPop];
+            cell[iPop] = cell.computeEquilibrium(iPop, this->rhoBar, this->j, jSqr)+fNeq[iPop];
         }
     }
 }
 
 template<typename T, template<typename U> class Descriptor>
-void GuoOffLatticeModel3D<T,Descriptor>::cellCompletion (
-        BlockLattice3D<T,Descriptor>& lattice,
-        Dot3D const& guoNode,
-        std::vector<std::pair<int,int> > const& dryNodeFluidDirections,
-        std::vector<plint> const& dryNodeIds, Dot3D const& absoluteOffset,
-        Array<T,3>& localForce, std::vector<AtomicBlock3D const*> const& args )
+void GuoOffLatticeModel3D<T,Descriptor>::boundaryCompletion (
+        AtomicBlock3D& nonTypeLattice,
+        AtomicContainerBlock3D& container,
+        std::vector<AtomicBlock3D const*> const& args )
 {
+    BlockLattice3D<T,Descriptor>& lattice =
+        dynamic_cast<BlockLattice3D<T,Descriptor>&> (nonTypeLattice);
+    GuoOffLatticeInfo3D* info =
+        dynamic_cast<GuoOffLatticeInfo3D*>(container.getData());
+    PLB_ASSERT( info );
+    OffLatticeNodeList3D<T> const& dryNodes = info->getDryNodes();
+
+    Dot3D absoluteOffset = lattice.getLocation();
+
+    Array<T,3>& localForce = info->getLocalForce();
+    localForce.resetToZero();
+    // The same algorithm object is reused for all dry nodes, to avoid
+    //   per-node memory allocations.
     GuoAlgorithm3D<T,Descriptor>* algorithm=0;
     if (this->regularizedModel) {
         algorithm = new GuoPiNeqAlgorithm3D<T,Descriptor> (
-                *this, lattice, guoNode, dryNodeFluidDirections,
-                dryNodeIds, absoluteOffset, localForce, args, computesStat(), usesSecondOrder() );
+                *this, lattice, dryNodes, absoluteOffset, localForce, args,
+                computesStat(), usesSecondOrder() );
     }
     else {
         algorithm = new GuoOffPopAlgorithm3D<T,Descriptor> (
-                *this, lattice, guoNode, dryNodeFluidDirections,
-                dryNodeIds, absoluteOffset, localForce, args, computesStat(), usesSecondOrder() );
+                *this, lattice, dryNodes, absoluteOffset, localForce, args,
+                computesStat(), usesSecondOrder() );
     }
+    for (plint iDry=0; iDry<dryNodes.getNumNodes(); ++iDry) {
 #ifdef PLB_DEBUG
-    bool ok =
+        bool ok =
 #endif
-        algorithm -> computeNeighborData();
-    PLB_ASSERT( ok );
-    algorithm->finalize();
+            algorithm->computeNeighborData(iDry);
+        PLB_ASSERT( ok );
+        algorithm->finalize();
+    }
     delete algorithm;
 }
 
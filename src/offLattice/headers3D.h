@@ -41,6 +41,7 @@
 #include "offLattice/boundaryShapes3D.h"
 #include "offLattice/triangleBoundary3D.h"
 #include "offLattice/offLatticeModel3D.h"
+#include "offLattice/offLatticeNodeList3D.h"
 #include "offLattice/guoOffLatticeModel3D.h"
 #include "offLattice/bouzidiOffLatticeModel3D.h"
 #include "offLattice/guoAdvDiffOffLatticeModel3D.h"
@@ -41,6 +41,7 @@
 #include "offLattice/boundaryShapes3D.hh"
 #include "offLattice/triangleBoundary3D.hh"
 #include "offLattice/offLatticeModel3D.hh"
+#include "offLattice/offLatticeNodeList3D.hh"
 #include "offLattice/guoOffLatticeModel3D.hh"
 #include "offLattice/bouzidiOffLatticeModel3D.hh"
 #include "offLattice/guoAdvDiffOffLatticeModel3D.hh"
@@ -101,11 +101,26 @@ struct ImmersedWallData3D : public ContainerBlockData
     std::vector< Array<T,3> > g;
     std::vector<int> flags; // Flag for each vertex used to distinguish between vertices for conditional reduction operations.
     std::vector<pluint> globalVertexIds;
+    // Interpolation stencils, shared by the successive immersed-boundary
+    // iterations of a time step: for each vertex, the integer position of
+    // the kernel center, and the 3x4 one-dimensional kernel weights along
+    // x, y and z. They are computed on first use, and must be recomputed
+    // (through computeInamuroStencils) if vertices are moved in place
+    // instead of being re-instantiated.
+    std::vector< Array<plint,3> > stencilPositions;
+    std::vector<T> stencilWeights;
+    bool hasInamuroStencils() const {
+        return stencilPositions.size()==vertices.size();
+    }
     virtual ImmersedWallData3D<T>* clone() const {
         return new ImmersedWallData3D<T>(*this);
     }
 };
 
+/// Evaluate the Inamuro kernel weights of all vertices.
+template<typename T>
+void computeInamuroStencils(ImmersedWallData3D<T>& wallData);
+
 /* ******** Utility functions ************************************ */
 
 template<typename T>
@@ -34,6 +34,33 @@
 
 namespace plb {
 
+/* ******** computeInamuroStencils ************************************ */
+
+template<typename T>
+void computeInamuroStencils(ImmersedWallData3D<T>& wallData)
+{
+    std::vector< Array<T,3> > const& vertices = wallData.vertices;
+    pluint numVertices = vertices.size();
+    wallData.stencilPositions.resize(numVertices);
+    wallData.stencilWeights.resize(3*4*numVertices);
+    InamuroDeltaFunction<T> const& delta = inamuroDeltaFunction<T>();
+    for (pluint i=0; i<numVertices; ++i) {
+        Array<T,3> const& vertex = vertices[i];
+        Array<plint,3> intPos (
+                (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+        wallData.stencilPositions[i] = intPos;
+        // The kernel is a tensor product of one-dimensional kernels: only
+        //   the 3x4 one-dimensional weights are stored, and the 64 kernel
+        //   values are obtained as products of them.
+        T* weights = &wallData.stencilWeights[3*4*i];
+        for (plint iD=0; iD<3; ++iD) {
+            for (plint d=-1; d<=+2; ++d) {
+                weights[4*iD+d+1] = delta.w((T)(intPos[iD]+d)-vertex[iD]);
+            }
+        }
+    }
+}
+
 /* ******** ReduceAxialTorqueImmersed3D ************************************ */
 
 template<typename T>
@@ -254,6 +281,11 @@ void InamuroIteration3D<T,VelFunction>::processGenericBlocks (
     Array<T,3> absOffset = wallData->offset;
 
     std::vector< Array<T,3> > const& vertices = wallData->vertices;
+    if (!wallData->hasInamuroStencils()) {
+        computeInamuroStencils(*wallData);
+    }
+    std::vector< Array<plint,3> > const& stencilPositions = wallData->stencilPositions;
+    std::vector<T> const& stencilWeights = wallData->stencilWeights;
     std::vector<T> const& areas = wallData->areas;
     PLB_ASSERT( vertices.size()==areas.size() );
     std::vector<Array<T,3> > deltaG(vertices.size());
@@ -263,9 +295,10 @@ void InamuroIteration3D<T,VelFunction>::processGenericBlocks (
     // In this iteration, the force is computed for every vertex.
     if (incompressibleModel) {
         for (pluint i=0; i<vertices.size(); ++i) {
-            Array<T,3> const& vertex = vertices[i];
-            Array<plint,3> intPos (
-                    (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+            Array<plint,3> const& intPos = stencilPositions[i];
+            T const* wx = &stencilWeights[3*4*i];
+            T const* wy = wx+4;
+            T const* wz = wx+8;
             Array<T,3> averageJ; averageJ.resetToZero();
             // Use the weighting function to compute the average momentum
             // and the average density on the surface vertex.
@@ -275,22 +308,22 @@ void InamuroIteration3D<T,VelFunction>::processGenericBlocks (
                     for (plint dz=-1; dz<=+2; ++dz) {
                         Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                         Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                        T W = inamuroDeltaFunction<T>().W(r);
+                        T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                         averageJ += W*nextJ;
                     }
                 }
             }
             //averageJ += (T)0.5*g[i];
-            Array<T,3> wallVelocity = velFunction(vertex+absOffset);
+            Array<T,3> wallVelocity = velFunction(vertices[i]+absOffset);
             deltaG[i] = areas[i]*(wallVelocity-averageJ);
             g[i] += deltaG[i];
         }
     } else { // Compressible model.
         for (pluint i=0; i<vertices.size(); ++i) {
-            Array<T,3> const& vertex = vertices[i];
-            Array<plint,3> intPos (
-                    (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+            Array<plint,3> const& intPos = stencilPositions[i];
+            T const* wx = &stencilWeights[3*4*i];
+            T const* wy = wx+4;
+            T const* wz = wx+8;
             Array<T,3> averageJ; averageJ.resetToZero();
             T averageRhoBar = T();
             // Use the weighting function to compute the average momentum
@@ -302,15 +335,14 @@ void InamuroIteration3D<T,VelFunction>::processGenericBlocks (
                         Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                         T nextRhoBar = rhoBar->get(pos[0], pos[1], pos[2]);
                         Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                        T W = inamuroDeltaFunction<T>().W(r);
+                        T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                         averageJ += W*nextJ;
                         averageRhoBar += W*nextRhoBar;
                     }
                 }
             }
             //averageJ += (T)0.5*g[i];
-            Array<T,3> wallVelocity = velFunction(vertex+absOffset);
+            Array<T,3> wallVelocity = velFunction(vertices[i]+absOffset);
             deltaG[i] = areas[i]*((averageRhoBar+(T)1.)*wallVelocity-averageJ);
             //g[i] += deltaG[i];
             g[i] += deltaG[i]/((T)1.0+averageRhoBar);
@@ -319,16 +351,16 @@ void InamuroIteration3D<T,VelFunction>::processGenericBlocks (
     
     // In this iteration, the force is applied from every vertex to the grid nodes.
     for (pluint i=0; i<vertices.size(); ++i) {
-        Array<T,3> const& vertex = vertices[i];
-        Array<plint,3> intPos (
-                (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+        Array<plint,3> const& intPos = stencilPositions[i];
+        T const* wx = &stencilWeights[3*4*i];
+        T const* wy = wx+4;
+        T const* wz = wx+8;
         for (plint dx=-1; dx<=+2; ++dx) {
             for (plint dy=-1; dy<=+2; ++dy) {
                 for (plint dz=-1; dz<=+2; ++dz) {
                     Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                     Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                    Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                    T W = inamuroDeltaFunction<T>().W(r);
+                    T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                     nextJ += tau*W*deltaG[i];
                     j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z) = nextJ;
                 }
@@ -382,6 +414,11 @@ void IndexedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
     PLB_ASSERT(wallData);
 
     std::vector< Array<T,3> > const& vertices = wallData->vertices;
+    if (!wallData->hasInamuroStencils()) {
+        computeInamuroStencils(*wallData);
+    }
+    std::vector< Array<plint,3> > const& stencilPositions = wallData->stencilPositions;
+    std::vector<T> const& stencilWeights = wallData->stencilWeights;
     std::vector<T> const& areas = wallData->areas;
     PLB_ASSERT( vertices.size()==areas.size() );
     std::vector<Array<T,3> > deltaG(vertices.size());
@@ -392,9 +429,10 @@ void IndexedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
 
     if (incompressibleModel) {
         for (pluint i=0; i<vertices.size(); ++i) {
-            Array<T,3> const& vertex = vertices[i];
-            Array<plint,3> intPos (
-                    (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+            Array<plint,3> const& intPos = stencilPositions[i];
+            T const* wx = &stencilWeights[3*4*i];
+            T const* wy = wx+4;
+            T const* wz = wx+8;
             Array<T,3> averageJ; averageJ.resetToZero();
             // x   x . x   x
             for (plint dx=-1; dx<=+2; ++dx) {
@@ -402,8 +440,7 @@ void IndexedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
                     for (plint dz=-1; dz<=+2; ++dz) {
                         Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                         Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                        T W = inamuroDeltaFunction<T>().W(r);
+                        T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                         averageJ += W*nextJ;
                     }
                 }
@@ -415,9 +452,10 @@ void IndexedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
         }
     } else { // Compressible model.
         for (pluint i=0; i<vertices.size(); ++i) {
-            Array<T,3> const& vertex = vertices[i];
-            Array<plint,3> intPos (
-                    (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+            Array<plint,3> const& intPos = stencilPositions[i];
+            T const* wx = &stencilWeights[3*4*i];
+            T const* wy = wx+4;
+            T const* wz = wx+8;
             Array<T,3> averageJ; averageJ.resetToZero();
             T averageRhoBar = T();
             // x   x . x   x
@@ -427,8 +465,7 @@ void IndexedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
                         Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                         T nextRhoBar = rhoBar->get(pos[0], pos[1], pos[2]);
                         Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                        T W = inamuroDeltaFunction<T>().W(r);
+                        T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                         averageJ += W*nextJ;
                         averageRhoBar += W*nextRhoBar;
                     }
@@ -443,16 +480,16 @@ void IndexedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
     }
     
     for (pluint i=0; i<vertices.size(); ++i) {
-        Array<T,3> const& vertex = vertices[i];
-        Array<plint,3> intPos (
-                (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+        Array<plint,3> const& intPos = stencilPositions[i];
+        T const* wx = &stencilWeights[3*4*i];
+        T const* wy = wx+4;
+        T const* wz = wx+8;
         for (plint dx=-1; dx<=+2; ++dx) {
             for (plint dy=-1; dy<=+2; ++dy) {
                 for (plint dz=-1; dz<=+2; ++dz) {
                     Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                     Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                    Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                    T W = inamuroDeltaFunction<T>().W(r);
+                    T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                     nextJ += tau*W*deltaG[i];
                     j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z) = nextJ;
                 }
@@ -505,6 +542,11 @@ void ConstVelInamuroIteration3D<T>::processGenericBlocks (
         dynamic_cast<ImmersedWallData3D<T>*>( container->getData() );
     PLB_ASSERT(wallData);
     std::vector< Array<T,3> > const& vertices = wallData->vertices;
+    if (!wallData->hasInamuroStencils()) {
+        computeInamuroStencils(*wallData);
+    }
+    std::vector< Array<plint,3> > const& stencilPositions = wallData->stencilPositions;
+    std::vector<T> const& stencilWeights = wallData->stencilWeights;
     std::vector<T> const& areas = wallData->areas;
     PLB_ASSERT( vertices.size()==areas.size() );
     std::vector<Array<T,3> > deltaG(vertices.size());
@@ -513,9 +555,10 @@ void ConstVelInamuroIteration3D<T>::processGenericBlocks (
 
     if (incompressibleModel) {
         for (pluint i=0; i<vertices.size(); ++i) {
-            Array<T,3> const& vertex = vertices[i];
-            Array<plint,3> intPos (
-                    (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+            Array<plint,3> const& intPos = stencilPositions[i];
+            T const* wx = &stencilWeights[3*4*i];
+            T const* wy = wx+4;
+            T const* wz = wx+8;
             Array<T,3> averageJ; averageJ.resetToZero();
             // x   x . x   x
             for (plint dx=-1; dx<=+2; ++dx) {
@@ -523,8 +566,7 @@ void ConstVelInamuroIteration3D<T>::processGenericBlocks (
                     for (plint dz=-1; dz<=+2; ++dz) {
                         Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                         Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                        T W = inamuroDeltaFunction<T>().W(r);
+                        T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                         averageJ += W*nextJ;
                     }
                 }
@@ -535,9 +577,10 @@ void ConstVelInamuroIteration3D<T>::processGenericBlocks (
         }
     } else { // Compressible model.
         for (pluint i=0; i<vertices.size(); ++i) {
-            Array<T,3> const& vertex = vertices[i];
-            Array<plint,3> intPos (
-                    (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+            Array<plint,3> const& intPos = stencilPositions[i];
+            T const* wx = &stencilWeights[3*4*i];
+            T const* wy = wx+4;
+            T const* wz = wx+8;
             Array<T,3> averageJ; averageJ.resetToZero();
             T averageRhoBar = T();
             // x   x . x   x
@@ -547,8 +590,7 @@ void ConstVelInamuroIteration3D<T>::processGenericBlocks (
                         Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                         T nextRhoBar = rhoBar->get(pos[0], pos[1], pos[2]);
                         Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                        T W = inamuroDeltaFunction<T>().W(r);
+                        T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                         averageJ += W*nextJ;
                         averageRhoBar += W*nextRhoBar;
                     }
@@ -562,16 +604,16 @@ void ConstVelInamuroIteration3D<T>::processGenericBlocks (
     }
     
     for (pluint i=0; i<vertices.size(); ++i) {
-        Array<T,3> const& vertex = vertices[i];
-        Array<plint,3> intPos (
-                (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+        Array<plint,3> const& intPos = stencilPositions[i];
+        T const* wx = &stencilWeights[3*4*i];
+        T const* wy = wx+4;
+        T const* wz = wx+8;
         for (plint dx=-1; dx<=+2; ++dx) {
             for (plint dy=-1; dy<=+2; ++dy) {
                 for (plint dz=-1; dz<=+2; ++dz) {
                     Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
                     Array<T,3> nextJ = j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z);
-                    Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                    T W = inamuroDeltaFunction<T>().W(r);
+                    T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                     nextJ += tau*W*deltaG[i];
                     j->get(pos[0]+ofsJ.x, pos[1]+ofsJ.y, pos[2]+ofsJ.z) = nextJ;
                 }
@@ -613,6 +655,11 @@ void ComputeImmersedBoundaryForce3D<T>::processGenericBlocks (
         dynamic_cast<ImmersedWallData3D<T>*>( container->getData() );
     PLB_ASSERT(wallData);
     std::vector< Array<T,3> > const& vertices = wallData->vertices;
+    if (!wallData->hasInamuroStencils()) {
+        computeInamuroStencils(*wallData);
+    }
+    std::vector< Array<plint,3> > const& stencilPositions = wallData->stencilPositions;
+    std::vector<T> const& stencilWeights = wallData->stencilWeights;
     std::vector<Array<T,3> >& g = wallData->g;
     PLB_ASSERT( vertices.size()==g.size() );
 
@@ -625,15 +672,15 @@ void ComputeImmersedBoundaryForce3D<T>::processGenericBlocks (
     }
 
     for (pluint i=0; i<vertices.size(); ++i) {
-        Array<T,3> const& vertex = vertices[i];
-        Array<plint,3> intPos (
-                (plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+        Array<plint,3> const& intPos = stencilPositions[i];
+        T const* wx = &stencilWeights[3*4*i];
+        T const* wy = wx+4;
+        T const* wz = wx+8;
         for (plint dx=-1; dx<=+2; ++dx) {
             for (plint dy=-1; dy<=+2; ++dy) {
                 for (plint dz=-1; dz<=+2; ++dz) {
                     Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
-                    Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
-                    T W = inamuroDeltaFunction<T>().W(r);
+                    T W = wx[dx+1]*wy[dy+1]*wz[dz+1];
                     force->get(pos[0], pos[1], pos[2]) += W*g[i];
                 }
             }
@@ -0,0 +1,120 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "offLattice/makeSparse3D.h"
+#include "multiBlock/multiBlockOperations3D.h"
+#include <algorithm>
+
+namespace plb {
+
+void reattachProcessors(std::vector<MultiBlock3D::ProcessorStorage3D> const& processors)
+{
+    for (pluint iProcessor=0; iProcessor<processors.size(); ++iProcessor) {
+        std::vector<MultiBlock3D*> multiBlocks = processors[iProcessor].getMultiBlocks();
+        PLB_ASSERT( !multiBlocks.empty() );
+        DataProcessorGenerator3D* generator = processors[iProcessor].getGenerator().clone();
+        if (generator->extract(multiBlocks[0]->getBoundingBox())) {
+            addInternalProcessor( *generator, multiBlocks,
+                                  processors[iProcessor].getLevel() );
+        }
+        delete generator;
+    }
+}
+
+void detachProcessors( MultiBlock3D& multiBlock,
+                       std::vector<MultiBlock3D::ProcessorStorage3D>& processors )
+{
+    std::vector<MultiBlock3D*> multiBlocks = multiBlockRegistration3D().getMultiBlocks();
+    for (pluint iMulti=0; iMulti<multiBlocks.size(); ++iMulti) {
+        MultiBlock3D& actor = *multiBlocks[iMulti];
+        std::vector<MultiBlock3D::ProcessorStorage3D> const& stored = actor.getStoredProcessors();
+        bool isConcerned = &actor == &multiBlock;
+        for (pluint iProcessor=0; iProcessor<stored.size() && !isConcerned; ++iProcessor) {
+            std::vector<id_t> const& ids = stored[iProcessor].getMultiBlockIds();
+            isConcerned = std::find(ids.begin(), ids.end(), multiBlock.getId()) != ids.end();
+        }
+        if (isConcerned) {
+            processors.insert(processors.end(), stored.begin(), stored.end());
+            actor.clearProcessors();
+        }
+    }
+}
+
+bool canReshapeInPlace( MultiBlockManagement3D const& management,
+                        MultiBlockManagement3D const& newManagement )
+{
+    if (management.getEnvelopeWidth() != newManagement.getEnvelopeWidth()) {
+        return false;
+    }
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+    std::map<plint,Box3D> const& bulks = sparseBlock.getBulks();
+    std::map<plint,Box3D> const& newBulks = newManagement.getSparseBlockStructure().getBulks();
+    std::map<plint,Box3D>::const_iterator it = newBulks.begin();
+    for (; it != newBulks.end(); ++it) {
+        plint blockId = it->first;
+        Box3D newBulk(it->second);
+        std::map<plint,Box3D>::const_iterator oldIt = bulks.find(blockId);
+        if (oldIt != bulks.end() && newBulk == oldIt->second) {
+            if ( management.getThreadAttribution().getMpiProcess(blockId) !=
+                 newManagement.getThreadAttribution().getMpiProcess(blockId) )
+            {
+                return false;
+            }
+        }
+        else {
+            std::vector<plint> intersectingBlocks;
+            std::vector<Box3D> intersections;
+            sparseBlock.intersect(newBulk, intersectingBlocks, intersections);
+            if (!intersectingBlocks.empty()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool haveSameBulks(SparseBlockStructure3D const& block1, SparseBlockStructure3D const& block2)
+{
+    std::map<plint,Box3D> const& bulks1 = block1.getBulks();
+    std::map<plint,Box3D> const& bulks2 = block2.getBulks();
+    if (bulks1.size() != bulks2.size()) {
+        return false;
+    }
+    std::map<plint,Box3D>::const_iterator it1 = bulks1.begin();
+    std::map<plint,Box3D>::const_iterator it2 = bulks2.begin();
+    for (; it1 != bulks1.end(); ++it1, ++it2) {
+        Box3D const& box1 = it1->second;
+        Box3D const& box2 = it2->second;
+        if ( it1->first != it2->first ||
+             box1.x0 != box2.x0 || box1.x1 != box2.x1 ||
+             box1.y0 != box2.y0 || box1.y1 != box2.y1 ||
+             box1.z0 != box2.z0 || box1.z1 != box2.z1 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace plb
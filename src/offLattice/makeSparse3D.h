@@ -51,6 +51,91 @@ template<typename T>
 MultiBlockManagement3D computeSparseManagement (
         MultiScalarField3D<T>& field, plint newEnvelopeWidth );
 
+/// For each block of a reference block-structure, determine if a flag field
+///   is non-zero within a given margin around the block.
+template<typename T>
+class ComputeBlockOccupancyFunctional3D : public BoxProcessingFunctional3D
+{
+public:
+    ComputeBlockOccupancyFunctional3D(std::vector<Box3D> const& referenceBulks_, plint margin_);
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> fields);
+    virtual ComputeBlockOccupancyFunctional3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+private:
+    std::vector<Box3D> referenceBulks;
+    plint margin;
+};
+
+/// Recompute, at runtime, a sparse block-structure which follows the support
+///   of a flag field.
+/** The blocks are taken from a reference block-structure, typically the full
+ *  structure the simulation was set up with. A reference block is kept if the
+ *  flag field is non-zero in at least one cell of its bulk, enlarged by "margin"
+ *  cells. The margin must be large enough for the non-zero region not to leave
+ *  the allocated domain before the next update. The flag field can itself be
+ *  sparse: cells outside its current block-structure count as zero.
+ *
+ *  The blocks keep their id from the reference structure. Blocks which are
+ *  also part of the flag field stay on their MPI process, and the other ones
+ *  are attributed to the process with the fewest cells.
+ */
+template<typename T>
+MultiBlockManagement3D computeAdaptiveSparseManagement (
+        MultiScalarField3D<T>& flags, SparseBlockStructure3D const& reference,
+        plint margin, plint newEnvelopeWidth );
+
+/// Move a multi-block onto a new block-structure, and rebuild its communication
+///   pattern.
+/** Data is kept on the domain covered by both the old and the new structure,
+ *  while the blocks which are new are initialized with default values (e.g.
+ *  background dynamics at rest, for a lattice). Blocks which are dropped are
+ *  deallocated. Periodicity and internal statistics are preserved.
+ *
+ *  If possible (see canReshapeInPlace()), the multi-block is reshaped in place:
+ *  the unchanged atomic-blocks stay where they are, and only the dropped and
+ *  the new ones are deallocated and allocated. Otherwise, the data is copied
+ *  to a new multi-block, which is swapped with the original one.
+ *
+ *  The data processors which refer to the multi-block, and all other data
+ *  processors held by the same multi-blocks, are removed and returned in
+ *  "processors" (see detachProcessors()). They have to be reattached with
+ *  reattachProcessors(), once all multi-blocks they act upon have been moved
+ *  to the new structure. The function returns false, and does nothing, if the
+ *  block-structure is unchanged.
+ */
+template<class MultiBlockT>
+bool adaptSparsity( MultiBlockT& multiBlock, MultiBlockManagement3D const& newManagement,
+                    std::vector<MultiBlock3D::ProcessorStorage3D>& processors );
+
+/// Move a multi-block onto a new block-structure, including its data processors.
+/** This version can only be used if the data processors of the multi-block
+ *  do not couple it with other multi-blocks.
+ */
+template<class MultiBlockT>
+bool adaptSparsity( MultiBlockT& multiBlock, MultiBlockManagement3D const& newManagement );
+
+/// Reattach data processors previously detached by adaptSparsity().
+void reattachProcessors(std::vector<MultiBlock3D::ProcessorStorage3D> const& processors);
+
+/// Remove the data processors held by the multi-block, and by every other
+///   registered multi-block which has a data processor acting on it.
+/** The stored processors of these multi-blocks are appended to "processors". */
+void detachProcessors( MultiBlock3D& multiBlock,
+                       std::vector<MultiBlock3D::ProcessorStorage3D>& processors );
+
+/// Test if a multi-block can be moved to a new block-structure without copying
+///   data between atomic-blocks.
+/** This is the case if the envelope width is unchanged, if the blocks which
+ *  are in both structures (same id and bulk) stay on the same MPI process, and
+ *  if the other blocks of the new structure do not intersect the old one.
+ */
+bool canReshapeInPlace( MultiBlockManagement3D const& management,
+                        MultiBlockManagement3D const& newManagement );
+
+/// Test if two block-structures are made of the same blocks, with the same ids.
+bool haveSameBulks(SparseBlockStructure3D const& block1, SparseBlockStructure3D const& block2);
+
 }  // namespace plb
 
 #endif  // MAKE_SPARSE_3D_H
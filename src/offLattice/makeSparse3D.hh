@@ -31,6 +31,8 @@
 #include "atomicBlock/reductiveDataProcessingFunctional3D.h"
 #include "atomicBlock/atomicContainerBlock3D.h"
 #include "offLattice/domainClustering3D.h"
+#include "multiBlock/multiBlockOperations3D.h"
+#include <algorithm>
 
 
 namespace plb {
@@ -185,6 +187,216 @@ MultiBlockManagement3D computeSparseManagement (
     return newManagement;
 }
 
+
+struct BlockOccupancyData3D : public ContainerBlockData {
+    /// Indices of the occupied blocks in the reference structure.
+    std::vector<plint> occupiedBlocks;
+    virtual BlockOccupancyData3D* clone() const {
+        return new BlockOccupancyData3D(*this);
+    }
+};
+
+/* ******** ComputeBlockOccupancyFunctional3D ************************************ */
+
+template<typename T>
+ComputeBlockOccupancyFunctional3D<T>::ComputeBlockOccupancyFunctional3D (
+        std::vector<Box3D> const& referenceBulks_, plint margin_ )
+    : referenceBulks(referenceBulks_),
+      margin(margin_)
+{ }
+
+template<typename T>
+void ComputeBlockOccupancyFunctional3D<T>::processGenericBlocks (
+        Box3D domain, std::vector<AtomicBlock3D*> blocks )
+{
+    PLB_PRECONDITION( blocks.size()==2 );
+    ScalarField3D<T>* field = dynamic_cast<ScalarField3D<T>*>(blocks[0]);
+    AtomicContainerBlock3D* container = dynamic_cast<AtomicContainerBlock3D*>(blocks[1]);
+    PLB_ASSERT( field );
+    PLB_ASSERT( container );
+    Dot3D location = field->getLocation();
+    Box3D absDomain(domain.shift(location.x, location.y, location.z));
+
+    BlockOccupancyData3D* occupancy = new BlockOccupancyData3D;
+    for (pluint iBlock=0; iBlock<referenceBulks.size(); ++iBlock) {
+        Box3D inters;
+        if (!intersect(absDomain, referenceBulks[iBlock].enlarge(margin), inters)) continue;
+        inters = inters.shift(-location.x, -location.y, -location.z);
+        bool occupied = false;
+        for (plint iX=inters.x0; iX<=inters.x1 && !occupied; ++iX) {
+            for (plint iY=inters.y0; iY<=inters.y1 && !occupied; ++iY) {
+                for (plint iZ=inters.z0; iZ<=inters.z1; ++iZ) {
+                    if (field->get(iX,iY,iZ) != T()) {
+                        occupied = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (occupied) {
+            occupancy->occupiedBlocks.push_back((plint)iBlock);
+        }
+    }
+    container->setData(occupancy);
+}
+
+template<typename T>
+ComputeBlockOccupancyFunctional3D<T>* ComputeBlockOccupancyFunctional3D<T>::clone() const {
+    return new ComputeBlockOccupancyFunctional3D<T>(*this);
+}
+
+template<typename T>
+void ComputeBlockOccupancyFunctional3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::nothing; // Flag field.
+    modified[1] = modif::staticVariables;  // Container Block with occupancy data.
+}
+
+template<typename T>
+BlockDomain::DomainT ComputeBlockOccupancyFunctional3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
+
+/* ******** computeAdaptiveSparseManagement ************************************ */
+
+template<typename T>
+MultiBlockManagement3D computeAdaptiveSparseManagement (
+        MultiScalarField3D<T>& flags, SparseBlockStructure3D const& reference,
+        plint margin, plint newEnvelopeWidth )
+{
+    std::map<plint,Box3D> const& referenceDomains = reference.getBulks();
+    std::vector<plint> referenceIds;
+    std::vector<Box3D> referenceBulks;
+    std::map<plint,Box3D>::const_iterator it = referenceDomains.begin();
+    for (; it != referenceDomains.end(); ++it) {
+        referenceIds.push_back(it->first);
+        referenceBulks.push_back(it->second);
+    }
+
+    MultiContainerBlock3D multiOccupancyBlock(flags);
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&flags);
+    args.push_back(&multiOccupancyBlock);
+    applyProcessingFunctional (
+            new ComputeBlockOccupancyFunctional3D<T>(referenceBulks, margin),
+            flags.getBoundingBox(), args );
+
+    std::vector<int> keepThisBlock(referenceBulks.size(), 0);
+    std::vector<plint> const& localBlocks =
+        multiOccupancyBlock.getMultiBlockManagement().getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        AtomicContainerBlock3D const& occupancyBlock =
+            multiOccupancyBlock.getComponent(localBlocks[iBlock]);
+        BlockOccupancyData3D const* data =
+            dynamic_cast<BlockOccupancyData3D const*> (occupancyBlock.getData());
+        PLB_ASSERT( data );
+        for (pluint i=0; i<data->occupiedBlocks.size(); ++i) {
+            keepThisBlock[data->occupiedBlocks[i]] = 1;
+        }
+    }
+
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(keepThisBlock, MPI_MAX);
+#endif
+
+    // The blocks keep their reference id, and the blocks which already exist
+    //   in the flag field keep their MPI process, so that unchanged blocks
+    //   need not be moved. The other ones go to the least loaded process.
+    MultiBlockManagement3D const& management = flags.getMultiBlockManagement();
+    std::vector<plint> load(global::mpi().getSize(), 0);
+    std::vector<plint> attributedProcess(keepThisBlock.size(), -1);
+    SparseBlockStructure3D newSparseBlock(reference.getBoundingBox());
+    plint numBlocks = 0;
+    for (pluint iBlock=0; iBlock<keepThisBlock.size(); ++iBlock) {
+        if (keepThisBlock[iBlock]) {
+            plint blockId = referenceIds[iBlock];
+            Box3D uniqueBulk, currentBulk;
+            reference.getUniqueBulk(blockId, uniqueBulk);
+            newSparseBlock.addBlock(referenceBulks[iBlock], uniqueBulk, blockId);
+            ++numBlocks;
+            if ( management.getSparseBlockStructure().getBulk(blockId, currentBulk) &&
+                 currentBulk == referenceBulks[iBlock] )
+            {
+                attributedProcess[iBlock] = management.getThreadAttribution().getMpiProcess(blockId);
+                load[attributedProcess[iBlock]] += referenceBulks[iBlock].nCells();
+            }
+        }
+    }
+    // If this assertion fails, that means that the flag field is zero everywhere.
+    PLB_ASSERT( numBlocks>0 );
+
+    ExplicitThreadAttribution* newAttribution = new ExplicitThreadAttribution;
+    for (pluint iBlock=0; iBlock<keepThisBlock.size(); ++iBlock) {
+        if (keepThisBlock[iBlock]) {
+            if (attributedProcess[iBlock]<0) {
+                attributedProcess[iBlock] = std::min_element(load.begin(), load.end()) - load.begin();
+                load[attributedProcess[iBlock]] += referenceBulks[iBlock].nCells();
+            }
+            newAttribution -> addBlock(referenceIds[iBlock], attributedProcess[iBlock]);
+        }
+    }
+
+    return MultiBlockManagement3D (
+            newSparseBlock, newAttribution, newEnvelopeWidth,
+            flags.getMultiBlockManagement().getRefinementLevel() );
+}
+
+
+/* ******** adaptSparsity ************************************ */
+
+template<class MultiBlockT>
+bool adaptSparsity( MultiBlockT& multiBlock, MultiBlockManagement3D const& newManagement,
+                    std::vector<MultiBlock3D::ProcessorStorage3D>& processors )
+{
+    processors.clear();
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    if ( management.getEnvelopeWidth() == newManagement.getEnvelopeWidth() &&
+         haveSameBulks(management.getSparseBlockStructure(), newManagement.getSparseBlockStructure()) )
+    {
+        return false;
+    }
+
+    // The atomic processors refer to the atomic-blocks of the multi-block,
+    //   also when they are held by another multi-block.
+    detachProcessors(multiBlock, processors);
+
+    if (canReshapeInPlace(management, newManagement)) {
+        multiBlock.reshape(newManagement);
+        multiBlock.duplicateOverlaps(modif::dataStructure);
+    }
+    else {
+        bool periodic[3];
+        for (plint iDim=0; iDim<3; ++iDim) {
+            periodic[iDim] = multiBlock.periodicity().get(iDim);
+        }
+        bool statisticsOn = multiBlock.isInternalStatisticsOn();
+        modif::ModifT internalModifT = multiBlock.getInternalTypeOfModification();
+
+        // The clone holds the data on the new structure, but no data processors.
+        //   Swapping it with the original keeps the id of the multi-block unchanged,
+        //   so the references to it in the stored processors remain valid.
+        MultiBlockT* newBlock = multiBlock.clone(newManagement);
+        multiBlock.swap(*newBlock);
+        delete newBlock;
+
+        for (plint iDim=0; iDim<3; ++iDim) {
+            multiBlock.periodicity().toggle(iDim, periodic[iDim]);
+        }
+        multiBlock.toggleInternalStatistics(statisticsOn);
+        multiBlock.setInternalTypeOfModification(internalModifT);
+    }
+    return true;
+}
+
+template<class MultiBlockT>
+bool adaptSparsity(MultiBlockT& multiBlock, MultiBlockManagement3D const& newManagement)
+{
+    std::vector<MultiBlock3D::ProcessorStorage3D> processors;
+    bool hasChanged = adaptSparsity(multiBlock, newManagement, processors);
+    reattachProcessors(processors);
+    return hasChanged;
+}
+
 }  // namespace plb
 
 #endif  // MAKE_SPARSE_3D_HH
@@ -37,6 +37,7 @@
 namespace plb {
 
 template<typename T> class IsoSurfaceDefinition3D;
+template<typename T> class LocalIsoSurface3D;
 
 
 /// Get an iso-surface by means of the marching cube algorithms.
@@ -77,6 +78,32 @@ TriangleSet<T> vofToTriangles(MultiScalarField3D<T>& scalarField, T threshold, B
 template<typename T, template<typename U> class Descriptor>
 TriangleSet<T> vofToTriangles(MultiScalarField3D<T>& scalarField, T threshold);
 
+/// Get an iso-surface by means of the marching cube algorithm, without gathering it.
+/** The arguments are the same as for isoSurfaceMarchingCube, but every MPI
+  * process obtains, in the first argument, only the triangles of its own blocks.
+  * No triangle is communicated, and the result can be written in parallel.
+  **/
+template<typename T>
+void localIsoSurfaceMarchingCube (
+        LocalIsoSurface3D<T>& surface,
+        std::vector<MultiBlock3D*> surfDefinitionArgs,
+        IsoSurfaceDefinition3D<T>* isoSurfaceDefinition,
+        Box3D const& domain, std::vector<plint> surfaceIds = std::vector<plint>() );
+
+/// This wrapper call to the local marching-cube algorithm computes iso-surfaces from a scalar-field.
+template<typename T>
+void localIsoSurfaceMarchingCube (
+        LocalIsoSurface3D<T>& surface,
+        MultiScalarField3D<T>& scalarField, std::vector<T> const& isoLevels, Box3D const& domain );
+
+template<typename T, template<typename U> class Descriptor>
+void localVofToTriangles( LocalIsoSurface3D<T>& surface,
+                          MultiScalarField3D<T>& scalarField, T threshold, Box3D domain );
+
+template<typename T, template<typename U> class Descriptor>
+void localVofToTriangles( LocalIsoSurface3D<T>& surface,
+                          MultiScalarField3D<T>& scalarField, T threshold );
+
 
 template<typename T>
 class IsoSurfaceDefinition3D {
@@ -200,10 +227,17 @@ public:
     void setEdgeOrientedEnvelope(plint edgeOrientedEnvelope_) {
         edgeOrientedEnvelope = edgeOrientedEnvelope_;
     }
+    /// In the default implementation, also store the lattice edge of each triangle vertex.
+    void setEdgeAttribution(bool edgeAttribution_) {
+        edgeAttribution = edgeAttribution_;
+    }
 public:
     class TriangleSetData : public ContainerBlockData {
     public:
         std::vector<Triangle> triangles;
+        /// Lattice edge and surface ID of the three vertices of each triangle,
+        ///   if edge attribution is requested (see polygonize).
+        std::vector<Array<plint,5> > edges;
         virtual TriangleSetData* clone() const {
             return new TriangleSetData(*this);
         }
@@ -431,11 +465,12 @@ private:
              plint iX, plint iY, plint iZ, plint surfaceId,
              std::vector<Triangle>& triangles );
     /// Edge attribution contains three integers to label the cell ID,
-    /// and one integer to label one of the three edges assigned to this cell.
+    /// one integer to label one of the three edges assigned to this cell,
+    /// and the surface ID.
     void polygonize (
              plint iX, plint iY, plint iZ, plint surfaceId,
              std::vector<Triangle>& triangles,
-             std::vector<Array<plint,4> >& edgeAttributions );
+             std::vector<Array<plint,5> >& edgeAttributions );
     static void removeFromVertex (
             Array<T,3> const& p0, Array<T,3> const& p1, Array<T,3>& intersection );
 private:
@@ -443,6 +478,52 @@ private:
     IsoSurfaceDefinition3D<T>* isoSurface;
     bool edgeOrientedData;
     plint edgeOrientedEnvelope;
+    bool edgeAttribution;
+};
+
+/// Part of an iso-surface held by one MPI process, as an indexed triangle mesh.
+/** Each vertex of the marching-cube algorithm lies on a lattice edge which
+  * identifies it exactly. The vertices shared by several triangles are therefore
+  * stored only once, including those on the boundary between two blocks of the
+  * same process. A vertex on the boundary between blocks of two processes is
+  * stored by both of them.
+  **/
+template<typename T>
+class LocalIsoSurface3D {
+public:
+    typedef typename TriangleSet<T>::Triangle Triangle;
+public:
+    /// Replace the content by a set of triangles, the vertices of which lie on the given
+    ///   edges (three per triangle). The fifth component of an edge is the surface ID:
+    ///   vertices of different iso-surfaces are not merged.
+    void assign( std::vector<Triangle> const& triangles,
+                 std::vector<Array<plint,5> > const& edges );
+    plint getNumVertices() const { return (plint)vertices.size(); }
+    plint getNumTriangles() const { return (plint)triangleVertices.size()/3; }
+    std::vector<Array<T,3> > const& getVertices() const { return vertices; }
+    /// Indices of the three vertices of each triangle.
+    std::vector<plint> const& getTriangleVertices() const { return triangleVertices; }
+    Triangle getTriangle(plint iTriangle) const;
+    /// Collective call: each process writes its part into fName_<rank>.vtp (raw-binary
+    ///   VTK PolyData) and the main processor writes the index file fName.pvtp.
+    /** With singlePrecision, the vertex coordinates are written as 32-bit floats. **/
+    void writeParallelVtp( std::string const& fName, bool singlePrecision=false, T deltaX=(T)1,
+                           Array<T,3> const& offset=Array<T,3>((T)0,(T)0,(T)0) ) const;
+    /// Each process with a non-empty part writes it into fName_<rank>.stl (binary STL).
+    void writeParallelBinarySTL( std::string const& fName, T deltaX=(T)1,
+                                 Array<T,3> const& offset=Array<T,3>((T)0,(T)0,(T)0) ) const;
+private:
+    /// Lexicographic order of the edges (and surface IDs) attributed to the triangle vertices.
+    class EdgeLess {
+    public:
+        EdgeLess(std::vector<Array<plint,5> > const& edges_) : edges(edges_) { }
+        bool operator()(pluint i1, pluint i2) const;
+    private:
+        std::vector<Array<plint,5> > const& edges;
+    };
+private:
+    std::vector<Array<T,3> > vertices;
+    std::vector<plint> triangleVertices;
 };
 
 struct MarchingCubeConstants {
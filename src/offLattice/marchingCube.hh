@@ -28,7 +28,12 @@
 #include "core/globalDefs.h"
 #include "offLattice/marchingCube.h"
 #include "latticeBoltzmann/geometricOperationTemplates.h"
+#include "parallelism/mpiManager.h"
+#include "core/util.h"
 #include <limits>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
 
 namespace plb {
 
@@ -260,7 +265,8 @@ MarchingCubeSurfaces3D<T>::MarchingCubeSurfaces3D (
     : surfaceIds(surfaceIds_),
       isoSurface(isoSurface_),
       edgeOrientedData(edgeOrientedData_),
-      edgeOrientedEnvelope(1)
+      edgeOrientedEnvelope(1),
+      edgeAttribution(false)
 { }
 
 template<typename T>
@@ -281,7 +287,8 @@ MarchingCubeSurfaces3D<T>::MarchingCubeSurfaces3D(MarchingCubeSurfaces3D<T> cons
     : surfaceIds(rhs.surfaceIds),
       isoSurface(rhs.isoSurface->clone()),
       edgeOrientedData(rhs.edgeOrientedData),
-      edgeOrientedEnvelope(rhs.edgeOrientedEnvelope)
+      edgeOrientedEnvelope(rhs.edgeOrientedEnvelope),
+      edgeAttribution(rhs.edgeAttribution)
 { }
 
 template<typename T>
@@ -304,6 +311,7 @@ void MarchingCubeSurfaces3D<T>::swap(MarchingCubeSurfaces3D<T>& rhs)
     std::swap(isoSurface, rhs.isoSurface);
     std::swap(edgeOrientedData, rhs.edgeOrientedData);
     std::swap(edgeOrientedEnvelope, rhs.edgeOrientedEnvelope);
+    std::swap(edgeAttribution, rhs.edgeAttribution);
 }
 
 template<typename T>
@@ -335,21 +343,26 @@ template<typename T>
 void MarchingCubeSurfaces3D<T>::defaultImplementation (
         Box3D domain, AtomicContainerBlock3D* triangleContainer )
 {
-    std::vector<Triangle> triangles;
+    TriangleSetData* data = new TriangleSetData;
+    std::vector<Triangle>& triangles = data->triangles;
     Dot3D location = triangleContainer->getLocation();
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
                 for (pluint i=0; i<surfaceIds.size(); ++i) {
-                    polygonize(iX+location.x,iY+location.y,iZ+location.z, surfaceIds[i], triangles);
+                    if (edgeAttribution) {
+                        polygonize(iX+location.x,iY+location.y,iZ+location.z, surfaceIds[i],
+                                   triangles, data->edges);
+                    }
+                    else {
+                        polygonize(iX+location.x,iY+location.y,iZ+location.z, surfaceIds[i], triangles);
+                    }
                 }
             }
         }
     }
 
-    TriangleSetData* data = new TriangleSetData;
-    data->triangles = triangles;
     triangleContainer -> setData(data);
 }
 
@@ -370,7 +383,7 @@ void MarchingCubeSurfaces3D<T>::edgeOriented (
             for (plint iZ=domain.z0-env; iZ<=domain.z1+env; ++iZ) {
                 for (pluint iSurf=0; iSurf<surfaceIds.size(); ++iSurf) {
                     std::vector<Triangle> triangles;
-                    std::vector<Array<plint,4> > edgeAttributions;
+                    std::vector<Array<plint,5> > edgeAttributions;
                     // Get all triangles computed by the marching-cube algorithm for
                     // the current cell.
                     polygonize(iX+location.x,iY+location.y,iZ+location.z, surfaceIds[iSurf],
@@ -553,7 +566,7 @@ template<typename T>
 void MarchingCubeSurfaces3D<T>::polygonize (
              plint iX, plint iY, plint iZ, plint surfaceId,
              std::vector<Triangle>& triangles,
-             std::vector<Array<plint,4> >& edgeAttributions )
+             std::vector<Array<plint,5> >& edgeAttributions )
 {
     typedef MarchingCubeConstants mcc;
     int cubeindex;
@@ -574,21 +587,16 @@ void MarchingCubeSurfaces3D<T>::polygonize (
             triangle[1] = vertlist[edge2];
             triangle[2] = vertlist[edge3];
             triangles.push_back(triangle);
-            edgeAttributions.push_back (
-                    Array<plint,4>(iX+mcc::edgeNeighb[edge1][0],
-                                   iY+mcc::edgeNeighb[edge1][1],
-                                   iZ+mcc::edgeNeighb[edge1][2],
-                                   mcc::edgeOrient[edge1]) );
-            edgeAttributions.push_back (
-                    Array<plint,4>(iX+mcc::edgeNeighb[edge2][0],
-                                   iY+mcc::edgeNeighb[edge2][1],
-                                   iZ+mcc::edgeNeighb[edge2][2],
-                                   mcc::edgeOrient[edge2] ) );
-            edgeAttributions.push_back (
-                    Array<plint,4>(iX+mcc::edgeNeighb[edge3][0],
-                                   iY+mcc::edgeNeighb[edge3][1],
-                                   iZ+mcc::edgeNeighb[edge3][2],
-                                   mcc::edgeOrient[edge3] ) );
+            int triangleEdges[3] = { edge1, edge2, edge3 };
+            for (int iEdge=0; iEdge<3; ++iEdge) {
+                Array<plint,5> attribution;
+                attribution[0] = iX+mcc::edgeNeighb[triangleEdges[iEdge]][0];
+                attribution[1] = iY+mcc::edgeNeighb[triangleEdges[iEdge]][1];
+                attribution[2] = iZ+mcc::edgeNeighb[triangleEdges[iEdge]][2];
+                attribution[3] = mcc::edgeOrient[triangleEdges[iEdge]];
+                attribution[4] = surfaceId;
+                edgeAttributions.push_back(attribution);
+            }
         }
     }
 }
@@ -805,6 +813,271 @@ TriangleSet<T> vofToTriangles(MultiScalarField3D<T>& scalarField, T threshold)
     return vofToTriangles(scalarField, threshold, domain);
 }
 
+template<typename T>
+void localIsoSurfaceMarchingCube (
+        LocalIsoSurface3D<T>& surface,
+        std::vector<MultiBlock3D*> surfDefinitionArgs,
+        IsoSurfaceDefinition3D<T>* isoSurfaceDefinition, Box3D const& domain,
+        std::vector<plint> surfaceIds )
+{
+    typedef typename TriangleSet<T>::Triangle Triangle;
+    PLB_ASSERT( surfDefinitionArgs.size()>0 );
+    if (surfaceIds.empty()) {
+        surfaceIds = isoSurfaceDefinition->getSurfaceIds();
+    }
+    MultiContainerBlock3D triangleContainer(*surfDefinitionArgs[0]);
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&triangleContainer);
+    for (pluint i=0; i<surfDefinitionArgs.size(); ++i) {
+        args.push_back(surfDefinitionArgs[i]);
+    }
+    MarchingCubeSurfaces3D<T>* marchingCube =
+        new MarchingCubeSurfaces3D<T>(surfaceIds, isoSurfaceDefinition);
+    marchingCube->setEdgeAttribution(true);
+    applyProcessingFunctional(marchingCube, domain, args);
+
+    // Collect the triangles of the local blocks, in increasing order of the block IDs.
+    std::vector<plint> localBlocks(triangleContainer.getMultiBlockManagement().getLocalInfo().getBlocks());
+    std::sort(localBlocks.begin(), localBlocks.end());
+    std::vector<Triangle> triangles;
+    std::vector<Array<plint,5> > edges;
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        typename MarchingCubeSurfaces3D<T>::TriangleSetData const* data =
+            dynamic_cast<typename MarchingCubeSurfaces3D<T>::TriangleSetData const*> (
+                    triangleContainer.getComponent(localBlocks[iBlock]).getData() );
+        if (data) {
+            triangles.insert(triangles.end(), data->triangles.begin(), data->triangles.end());
+            edges.insert(edges.end(), data->edges.begin(), data->edges.end());
+        }
+    }
+    surface.assign(triangles, edges);
+}
+
+template<typename T>
+void localIsoSurfaceMarchingCube (
+        LocalIsoSurface3D<T>& surface,
+        MultiScalarField3D<T>& scalarField, std::vector<T> const& isoLevels, Box3D const& domain )
+{
+    std::vector<MultiBlock3D*> scalarFieldArg;
+    scalarFieldArg.push_back(&scalarField);
+    localIsoSurfaceMarchingCube(surface, scalarFieldArg, new ScalarFieldIsoSurface3D<T>(isoLevels), domain);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void localVofToTriangles( LocalIsoSurface3D<T>& surface,
+                          MultiScalarField3D<T>& scalarField, T threshold, Box3D domain )
+{
+    std::vector<T> isoLevels;
+    isoLevels.push_back(threshold);
+    localIsoSurfaceMarchingCube (
+            surface,
+            *lbmSmoothen<T,Descriptor>(*lbmSmoothen<T,Descriptor>(scalarField, domain),domain),
+            isoLevels, scalarField.getBoundingBox().enlarge(-2) );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void localVofToTriangles( LocalIsoSurface3D<T>& surface,
+                          MultiScalarField3D<T>& scalarField, T threshold )
+{
+    Box3D domain = scalarField.getBoundingBox();
+    localVofToTriangles<T,Descriptor>(surface, scalarField, threshold, domain);
+}
+
+/* ****** class LocalIsoSurface3D ***************** */
+
+template<typename T>
+bool LocalIsoSurface3D<T>::EdgeLess::operator()(pluint i1, pluint i2) const {
+    Array<plint,5> const& edge1 = edges[i1];
+    Array<plint,5> const& edge2 = edges[i2];
+    for (plint iComp=0; iComp<5; ++iComp) {
+        if (edge1[iComp]!=edge2[iComp]) {
+            return edge1[iComp]<edge2[iComp];
+        }
+    }
+    return false;
+}
+
+template<typename T>
+void LocalIsoSurface3D<T>::assign (
+        std::vector<Triangle> const& triangles, std::vector<Array<plint,5> > const& edges )
+{
+    PLB_PRECONDITION( edges.size()==3*triangles.size() );
+    vertices.clear();
+    triangleVertices.resize(edges.size());
+    // Sort the triangle vertices by lattice edge: the vertices which are on the
+    //   same edge become neighbors, and are replaced by a single one.
+    std::vector<pluint> order(edges.size());
+    for (pluint iVertex=0; iVertex<order.size(); ++iVertex) {
+        order[iVertex] = iVertex;
+    }
+    EdgeLess edgeLess(edges);
+    std::sort(order.begin(), order.end(), edgeLess);
+    for (pluint iOrder=0; iOrder<order.size(); ++iOrder) {
+        pluint iVertex = order[iOrder];
+        if (iOrder==0 || edgeLess(order[iOrder-1], iVertex)) {
+            vertices.push_back(triangles[iVertex/3][iVertex%3]);
+        }
+        triangleVertices[iVertex] = (plint)vertices.size()-1;
+    }
+}
+
+template<typename T>
+typename LocalIsoSurface3D<T>::Triangle LocalIsoSurface3D<T>::getTriangle(plint iTriangle) const {
+    PLB_PRECONDITION( iTriangle>=0 && iTriangle<getNumTriangles() );
+    return Triangle( vertices[triangleVertices[3*iTriangle]],
+                     vertices[triangleVertices[3*iTriangle+1]],
+                     vertices[triangleVertices[3*iTriangle+2]] );
+}
+
+template<typename T>
+void LocalIsoSurface3D<T>::writeParallelVtp (
+        std::string const& fName, bool singlePrecision, T deltaX, Array<T,3> const& offset ) const
+{
+    plint numVertices = getNumVertices();
+    plint numTriangles = getNumTriangles();
+
+    // 1. The main processor needs to know which pieces are not empty.
+    int numProcs = global::mpi().getSize();
+    int myRank = global::mpi().getRank();
+    std::vector<plint> localNumTriangles(numProcs, 0), allNumTriangles(numProcs, 0);
+    localNumTriangles[myRank] = numTriangles;
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().reduceVect(localNumTriangles, allNumTriangles, MPI_SUM);
+#else
+    allNumTriangles = localNumTriangles;
+#endif
+
+    std::string::size_type slashPos = fName.find_last_of('/');
+    std::string baseName = slashPos==std::string::npos ? fName : fName.substr(slashPos+1);
+    std::string pointType = singlePrecision ? "Float32" : "Float64";
+#ifdef PLB_BIG_ENDIAN
+    std::string byteOrder("BigEndian");
+#else
+    std::string byteOrder("LittleEndian");
+#endif
+
+    if (global::mpi().isMainProcessor()) {
+        std::ofstream indexFile((fName+".pvtp").c_str());
+        indexFile << "<?xml version=\"1.0\"?>\n";
+        indexFile << "<VTKFile type=\"PPolyData\" version=\"0.1\" byte_order=\"" << byteOrder
+                  << "\" header_type=\"UInt64\">\n";
+        indexFile << "<PPolyData GhostLevel=\"0\">\n";
+        indexFile << "<PPoints>\n<PDataArray type=\"" << pointType
+                  << "\" NumberOfComponents=\"3\"/>\n</PPoints>\n";
+        for (int iProc=0; iProc<numProcs; ++iProc) {
+            if (allNumTriangles[iProc]>0) {
+                indexFile << "<Piece Source=\"" << baseName << "_" << iProc << ".vtp\"/>\n";
+            }
+        }
+        indexFile << "</PPolyData>\n";
+        indexFile << "</VTKFile>\n";
+    }
+    if (numTriangles==0) {
+        return;
+    }
+
+    // 2. Write the local piece: an XML header which refers to offsets in the
+    //    raw-binary appended section, followed by the data arrays. Each array
+    //    in the appended section is preceded by its size in bytes.
+    typedef unsigned long long HeaderT;
+    HeaderT pointArraySize = (HeaderT)( 3*numVertices *
+                                        (singlePrecision ? sizeof(float) : sizeof(double)) );
+    HeaderT connectivityArraySize = (HeaderT)(3*numTriangles*sizeof(long long));
+    HeaderT offsetArraySize = (HeaderT)(numTriangles*sizeof(long long));
+
+    std::ofstream pieceFile ( (fName+"_"+util::val2str(myRank)+".vtp").c_str(),
+                              std::ios::out | std::ios::binary );
+    pieceFile << "<?xml version=\"1.0\"?>\n";
+    pieceFile << "<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"" << byteOrder
+              << "\" header_type=\"UInt64\">\n";
+    pieceFile << "<PolyData>\n";
+    pieceFile << "<Piece NumberOfPoints=\"" << numVertices << "\" NumberOfVerts=\"0\" NumberOfLines=\"0\""
+              << " NumberOfStrips=\"0\" NumberOfPolys=\"" << numTriangles << "\">\n";
+    HeaderT arrayOffset = 0;
+    pieceFile << "<Points>\n<DataArray type=\"" << pointType
+              << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << arrayOffset
+              << "\"/>\n</Points>\n";
+    arrayOffset += sizeof(HeaderT) + pointArraySize;
+    pieceFile << "<Polys>\n";
+    pieceFile << "<DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\""
+              << arrayOffset << "\"/>\n";
+    arrayOffset += sizeof(HeaderT) + connectivityArraySize;
+    pieceFile << "<DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\""
+              << arrayOffset << "\"/>\n";
+    pieceFile << "</Polys>\n";
+    pieceFile << "</Piece>\n";
+    pieceFile << "</PolyData>\n";
+    pieceFile << "<AppendedData encoding=\"raw\">\n_";
+
+    pieceFile.write((char const*)&pointArraySize, sizeof(HeaderT));
+    if (singlePrecision) {
+        std::vector<float> pointData(3*numVertices);
+        for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+            for (plint iD=0; iD<3; ++iD) {
+                pointData[3*iVertex+iD] = (float)(deltaX*vertices[iVertex][iD] + offset[iD]);
+            }
+        }
+        pieceFile.write((char const*)&pointData[0], pointArraySize);
+    }
+    else {
+        std::vector<double> pointData(3*numVertices);
+        for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+            for (plint iD=0; iD<3; ++iD) {
+                pointData[3*iVertex+iD] = (double)(deltaX*vertices[iVertex][iD] + offset[iD]);
+            }
+        }
+        pieceFile.write((char const*)&pointData[0], pointArraySize);
+    }
+
+    std::vector<long long> intData(triangleVertices.begin(), triangleVertices.end());
+    pieceFile.write((char const*)&connectivityArraySize, sizeof(HeaderT));
+    pieceFile.write((char const*)&intData[0], connectivityArraySize);
+    for (plint iTriangle=0; iTriangle<numTriangles; ++iTriangle) {
+        intData[iTriangle] = (long long)(3*(iTriangle+1));
+    }
+    pieceFile.write((char const*)&offsetArraySize, sizeof(HeaderT));
+    pieceFile.write((char const*)&intData[0], offsetArraySize);
+    pieceFile << "\n</AppendedData>\n";
+    pieceFile << "</VTKFile>\n";
+}
+
+template<typename T>
+void LocalIsoSurface3D<T>::writeParallelBinarySTL (
+        std::string const& fName, T deltaX, Array<T,3> const& offset ) const
+{
+    unsigned int numTriangles = (unsigned int)getNumTriangles();
+    if (numTriangles==0) {
+        return;
+    }
+    FILE *fp = fopen((fName+"_"+util::val2str(global::mpi().getRank())+".stl").c_str(), "wb");
+    PLB_ASSERT(fp != NULL);
+
+    char header[80];
+    std::fill(header, header+80, '\0');
+    fwrite(header, sizeof(char), 80, fp);
+    fwrite(&numTriangles, sizeof(unsigned int), 1, fp);
+    unsigned short attributeByteCount = 0;
+    for (unsigned int iTriangle=0; iTriangle<numTriangles; ++iTriangle) {
+        Triangle triangle = getTriangle(iTriangle);
+        Array<T,3> normal;
+        crossProduct(triangle[1]-triangle[0], triangle[2]-triangle[0], normal);
+        T normNormal = std::sqrt(VectorTemplateImpl<T,3>::normSqr(normal));
+        if (normNormal > (T)0) {
+            normal /= normNormal;
+        }
+        float data[12];
+        for (plint iD=0; iD<3; ++iD) {
+            data[iD] = (float)normal[iD];
+            for (plint iVertex=0; iVertex<3; ++iVertex) {
+                data[3+3*iVertex+iD] = (float)(deltaX*triangle[iVertex][iD] + offset[iD]);
+            }
+        }
+        fwrite(data, sizeof(float), 12, fp);
+        fwrite(&attributeByteCount, sizeof(unsigned short), 1, fp);
+    }
+    fclose(fp);
+}
+
 template<typename T, class Function>
 bool AnalyticalIsoSurface3D<T,Function>::isInside (
             plint surfaceId, Array<plint,3> const& position ) const
@@ -0,0 +1,83 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Flat storage for the boundary nodes of off-lattice models -- header file.
+ */
+#ifndef OFF_LATTICE_NODE_LIST_3D_H
+#define OFF_LATTICE_NODE_LIST_3D_H
+
+#include "core/globalDefs.h"
+#include "core/geometry3D.h"
+#include "core/array.h"
+#include <vector>
+
+namespace plb {
+
+/// Compressed (CSR-like) list of boundary nodes and their links to the wall.
+/** The links of node iNode are stored contiguously in the index range
+ *  [linkBegin(iNode), linkEnd(iNode)) of flat arrays. Each link holds the
+ *  lattice direction, the number of fluid nodes available along this
+ *  direction, the id of the intersected surface element, the normalized
+ *  distance q to the wall (0 at the node, 1 at the next node along the link),
+ *  the wall normal, and a model-specific flag. Geometric quantities are
+ *  computed once, when the boundary pattern is set up, so that the completion
+ *  step can loop linearly over the nodes without chasing nested containers.
+ **/
+template<typename T>
+class OffLatticeNodeList3D {
+public:
+    OffLatticeNodeList3D();
+    void clear();
+    void reserve(plint numNodes, plint numLinks);
+    /// Start a new boundary node. Subsequent calls to addLink refer to this node.
+    void addNode(Dot3D const& node);
+    void addLink ( int direction, int depth, plint id, T q,
+                   Array<T,3> const& wallNormal, bool flag=false );
+    plint getNumNodes() const { return (plint)nodes.size(); }
+    plint getNumLinks() const { return (plint)directions.size(); }
+    Dot3D const& getNode(plint iNode) const { return nodes[iNode]; }
+    plint linkBegin(plint iNode) const { return linkOffsets[iNode]; }
+    plint linkEnd(plint iNode) const { return linkOffsets[iNode+1]; }
+    plint getNumLinks(plint iNode) const { return linkOffsets[iNode+1]-linkOffsets[iNode]; }
+    int getDirection(plint iLink) const { return directions[iLink]; }
+    int getDepth(plint iLink) const { return depths[iLink]; }
+    plint getId(plint iLink) const { return ids[iLink]; }
+    T getQ(plint iLink) const { return qs[iLink]; }
+    Array<T,3> const& getWallNormal(plint iLink) const { return wallNormals[iLink]; }
+    bool getFlag(plint iLink) const { return flags[iLink]!=0; }
+private:
+    std::vector<Dot3D>      nodes;
+    std::vector<plint>      linkOffsets;
+    std::vector<int>        directions;
+    std::vector<int>        depths;
+    std::vector<plint>      ids;
+    std::vector<T>          qs;
+    std::vector<Array<T,3> > wallNormals;
+    std::vector<char>       flags;
+};
+
+}  // namespace plb
+
+#endif  // OFF_LATTICE_NODE_LIST_3D_H
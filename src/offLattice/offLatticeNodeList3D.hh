@@ -0,0 +1,87 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Flat storage for the boundary nodes of off-lattice models -- generic implementation.
+ */
+#ifndef OFF_LATTICE_NODE_LIST_3D_HH
+#define OFF_LATTICE_NODE_LIST_3D_HH
+
+#include "offLattice/offLatticeNodeList3D.h"
+
+namespace plb {
+
+template<typename T>
+OffLatticeNodeList3D<T>::OffLatticeNodeList3D()
+    : linkOffsets(1, 0)
+{ }
+
+template<typename T>
+void OffLatticeNodeList3D<T>::clear() {
+    nodes.clear();
+    linkOffsets.assign(1, 0);
+    directions.clear();
+    depths.clear();
+    ids.clear();
+    qs.clear();
+    wallNormals.clear();
+    flags.clear();
+}
+
+template<typename T>
+void OffLatticeNodeList3D<T>::reserve(plint numNodes, plint numLinks) {
+    nodes.reserve(numNodes);
+    linkOffsets.reserve(numNodes+1);
+    directions.reserve(numLinks);
+    depths.reserve(numLinks);
+    ids.reserve(numLinks);
+    qs.reserve(numLinks);
+    wallNormals.reserve(numLinks);
+    flags.reserve(numLinks);
+}
+
+template<typename T>
+void OffLatticeNodeList3D<T>::addNode(Dot3D const& node) {
+    nodes.push_back(node);
+    linkOffsets.push_back(linkOffsets.back());
+}
+
+template<typename T>
+void OffLatticeNodeList3D<T>::addLink (
+        int direction, int depth, plint id, T q,
+        Array<T,3> const& wallNormal, bool flag )
+{
+    PLB_PRECONDITION( !nodes.empty() );
+    directions.push_back(direction);
+    depths.push_back(depth);
+    ids.push_back(id);
+    qs.push_back(q);
+    wallNormals.push_back(wallNormal);
+    flags.push_back(flag ? 1 : 0);
+    ++linkOffsets.back();
+}
+
+}  // namespace plb
+
+#endif  // OFF_LATTICE_NODE_LIST_3D_HH
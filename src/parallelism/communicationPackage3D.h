@@ -42,6 +42,9 @@ struct CommunicationInfo3D {
     int toProcessId;
     Box3D toDomain;
     Dot3D absoluteOffset;
+    /// Position of toDomain with respect to the bulk of the recipient
+    ///   (components -1, 0 or +1), used by direction-selective exchanges.
+    Dot3D orientation;
 };
 
 typedef std::vector<CommunicationInfo3D> CommunicationPackage3D;
@@ -33,6 +33,7 @@
 #include "core/plbComplex.h"
 #include "core/plbComplex.hh"
 #include <algorithm>
+#include <vector>
 #include <iostream>
 
 namespace plb {
@@ -1332,6 +1333,63 @@ void MpiManager::gatherv_impl<Complex<__float128> >(Complex<__float128> * sendBu
 }
 #endif
 
+template <typename T>
+void MpiManager::gatherV(T* sendBuf, T* recvBuf, int* recvCounts, int root)
+{
+    if (!ok) return;
+    std::vector<int> displs(getSize(), 0);
+    for (int iProc=1; iProc<getSize(); ++iProc) {
+        displs[iProc] = displs[iProc-1] + recvCounts[iProc-1];
+    }
+    gatherv_impl(sendBuf, recvCounts[getRank()], recvBuf, recvCounts, &displs[0], root);
+}
+
+template void MpiManager::gatherV<char>(char* sendBuf, char* recvBuf, int* recvCounts, int root);
+template void MpiManager::gatherV<int>(int* sendBuf, int* recvBuf, int* recvCounts, int root);
+template void MpiManager::gatherV<long>(long* sendBuf, long* recvBuf, int* recvCounts, int root);
+template void MpiManager::gatherV<float>(float* sendBuf, float* recvBuf, int* recvCounts, int root);
+template void MpiManager::gatherV<double>(double* sendBuf, double* recvBuf, int* recvCounts, int root);
+template void MpiManager::gatherV<long double>(long double* sendBuf, long double* recvBuf, int* recvCounts, int root);
+
+template <typename T>
+void MpiManager::allToAllV( std::vector<T> const& sendBuf, std::vector<int> const& sendCounts,
+                            std::vector<T>& recvBuf, std::vector<int>& recvCounts )
+{
+    if (!ok) return;
+    int numProc = getSize();
+    PLB_PRECONDITION( (int)sendCounts.size() == numProc );
+    recvCounts.resize(numProc);
+    MPI_Alltoall( const_cast<int*>(&sendCounts[0]), 1, MPI_INT,
+                  &recvCounts[0], 1, MPI_INT, getGlobalCommunicator() );
+    // The data is transferred as raw bytes, which avoids the need for an
+    //   MPI type matching T.
+    int typeSize = (int)sizeof(T);
+    std::vector<int> sendBytes(numProc), sendDispls(numProc, 0);
+    std::vector<int> recvBytes(numProc), recvDispls(numProc, 0);
+    for (int iProc=0; iProc<numProc; ++iProc) {
+        sendBytes[iProc] = sendCounts[iProc]*typeSize;
+        recvBytes[iProc] = recvCounts[iProc]*typeSize;
+        if (iProc>0) {
+            sendDispls[iProc] = sendDispls[iProc-1] + sendBytes[iProc-1];
+            recvDispls[iProc] = recvDispls[iProc-1] + recvBytes[iProc-1];
+        }
+    }
+    recvBuf.resize((recvDispls[numProc-1]+recvBytes[numProc-1]) / typeSize);
+    MPI_Alltoallv( sendBuf.empty() ? 0 : const_cast<T*>(&sendBuf[0]),
+                   &sendBytes[0], &sendDispls[0], MPI_BYTE,
+                   recvBuf.empty() ? 0 : &recvBuf[0],
+                   &recvBytes[0], &recvDispls[0], MPI_BYTE, getGlobalCommunicator() );
+}
+
+template void MpiManager::allToAllV<char>(std::vector<char> const& sendBuf, std::vector<int> const& sendCounts,
+                                          std::vector<char>& recvBuf, std::vector<int>& recvCounts);
+template void MpiManager::allToAllV<int>(std::vector<int> const& sendBuf, std::vector<int> const& sendCounts,
+                                         std::vector<int>& recvBuf, std::vector<int>& recvCounts);
+template void MpiManager::allToAllV<long>(std::vector<long> const& sendBuf, std::vector<int> const& sendCounts,
+                                          std::vector<long>& recvBuf, std::vector<int>& recvCounts);
+template void MpiManager::allToAllV<long long>(std::vector<long long> const& sendBuf, std::vector<int> const& sendCounts,
+                                               std::vector<long long>& recvBuf, std::vector<int>& recvCounts);
+
 template <>
 void MpiManager::bCast<char>(char* sendBuf, int sendCount, int root)
 {
@@ -109,9 +109,26 @@ public:
     void scatterV( T *sendBuf, T *recvBuf, int* sendCounts, int root = 0 );
 
     /// Gather data from multiple processors to one processor
+    /** Processor iProc sends recvCounts[iProc] elements, which are stored
+     *  consecutively in recvBuf, in the order of the processor ranks. The
+     *  counts must be known on all processors. Instantiated for char, int,
+     *  long, float, double and long double.
+     */
     template <typename T>
     void gatherV( T* sendBuf, T* recvBuf, int *recvCounts, int root = 0 );
 
+    /// Personalized exchange of data between all processors
+    /** The first sendCounts[0] elements of sendBuf are sent to processor 0,
+     *  the next sendCounts[1] ones to processor 1, etc. The received data is
+     *  stored in recvBuf in the order of the processor ranks, and recvCounts
+     *  holds the number of elements received from each processor. Both
+     *  recvBuf and recvCounts are resized as needed. Meant for plain data;
+     *  instantiated for char, int, long and long long.
+     */
+    template <typename T>
+    void allToAllV( std::vector<T> const& sendBuf, std::vector<int> const& sendCounts,
+                    std::vector<T>& recvBuf, std::vector<int>& recvCounts );
+
 
     /// Broadcast data from one processor to multiple processors
     template <typename T>
@@ -45,7 +45,7 @@ CommunicationStructure3D::CommunicationStructure3D (
         std::vector<Overlap3D> const& overlaps,
         MultiBlockManagement3D const& originManagement,
         MultiBlockManagement3D const& destinationManagement,
-        plint sizeOfCell )
+        plint sizeOfCell, MultiBlock3D const* directionalBlock )
 {
     plint fromEnvelopeWidth = originManagement.getEnvelopeWidth();
     plint toEnvelopeWidth = destinationManagement.getEnvelopeWidth();
@@ -73,6 +73,7 @@ CommunicationStructure3D::CommunicationStructure3D (
                 overlapCoordinates.x0 - originalCoordinates.x0,
                 overlapCoordinates.y0 - originalCoordinates.y0,
                 overlapCoordinates.z0 - originalCoordinates.z0 );
+        info.orientation = overlapBulk.computeOrientation(overlapCoordinates);
 
         plint lx = info.fromDomain.x1-info.fromDomain.x0+1;
         plint ly = info.fromDomain.y1-info.fromDomain.y0+1;
@@ -96,12 +97,18 @@ CommunicationStructure3D::CommunicationStructure3D (
         else if (fromAttribution.isLocal(info.fromBlockId))
         {
             sendPackage.push_back(info);
-            sendPool.subscribeMessage(info.toProcessId, numberOfCells*sizeOfCell);
+            plint cellSize = directionalBlock ?
+                directionalBlock->getLocalComponent(info.fromBlockId).getDataTransfer()
+                                 .directionalCellSize(info.orientation) : sizeOfCell;
+            sendPool.subscribeMessage(info.toProcessId, numberOfCells*cellSize);
         }
         else if (toAttribution.isLocal(info.toBlockId))
         {
             recvPackage.push_back(info);
-            recvPool.subscribeMessage(info.fromProcessId, numberOfCells*sizeOfCell);
+            plint cellSize = directionalBlock ?
+                directionalBlock->getLocalComponent(info.toBlockId).getDataTransfer()
+                                 .directionalCellSize(info.orientation) : sizeOfCell;
+            recvPool.subscribeMessage(info.fromProcessId, numberOfCells*cellSize);
         }
     }
 
@@ -141,6 +148,7 @@ CommunicationPattern3D::CommunicationPattern3D (
                 overlapCoordinates.x0 - originalCoordinates.x0,
                 overlapCoordinates.y0 - originalCoordinates.y0,
                 overlapCoordinates.z0 - originalCoordinates.z0 );
+        info.orientation = overlapBulk.computeOrientation(overlapCoordinates);
 
 #ifdef PLB_DEBUG
         plint lx = info.fromDomain.x1-info.fromDomain.x0+1;
@@ -172,21 +180,59 @@ CommunicationPattern3D::CommunicationPattern3D (
     }
 }
 
+GroupCommunication3D::GroupCommunication3D (
+        std::vector<CommunicationStructure3D const*> const& members,
+        std::vector<plint> const& sizeOfCell )
+{
+    PLB_PRECONDITION( members.size()==sizeOfCell.size() );
+    SendRecvPool sendPool, recvPool;
+    for (pluint iMember=0; iMember<members.size(); ++iMember) {
+        CommunicationStructure3D const& member = *members[iMember];
+        for (pluint iSend=0; iSend<member.sendPackage.size(); ++iSend) {
+            CommunicationInfo3D const& info = member.sendPackage[iSend];
+            sendPool.subscribeMessage(info.toProcessId, info.fromDomain.nCells()*sizeOfCell[iMember]);
+        }
+        for (pluint iRecv=0; iRecv<member.recvPackage.size(); ++iRecv) {
+            CommunicationInfo3D const& info = member.recvPackage[iRecv];
+            recvPool.subscribeMessage(info.fromProcessId, info.toDomain.nCells()*sizeOfCell[iMember]);
+        }
+    }
+    sendComm = SendPoolCommunicator(sendPool);
+    recvComm = RecvPoolCommunicator(recvPool);
+}
+
 ////////////////////// Class ParallelBlockCommunicator3D /////////////////////
 
+plint ParallelBlockCommunicator3D::nextCommunicationStamp = 0;
+
 ParallelBlockCommunicator3D::ParallelBlockCommunicator3D()
     : overlapsModified(true),
-      communication(0)
+      communication(0),
+      communicationStamp(-1),
+      pendingSendComm(0),
+      pendingRecvComm(0),
+      directionalOverlapsModified(true),
+      directionalCommunication(0)
 { }
 
 ParallelBlockCommunicator3D::ParallelBlockCommunicator3D (
         ParallelBlockCommunicator3D const& rhs )
     : overlapsModified(true),
-      communication(0)
+      communication(0),
+      communicationStamp(-1),
+      pendingSendComm(0),
+      pendingRecvComm(0),
+      directionalOverlapsModified(true),
+      directionalCommunication(0)
 { }
 
 ParallelBlockCommunicator3D::~ParallelBlockCommunicator3D() {
     delete communication;
+    delete directionalCommunication;
+    std::map<std::vector<plint>, GroupCommunication3D*>::iterator it = groupCommunications.begin();
+    for (; it != groupCommunications.end(); ++it) {
+        delete it->second;
+    }
 }
 
 ParallelBlockCommunicator3D& ParallelBlockCommunicator3D::operator= (
@@ -199,6 +245,13 @@ ParallelBlockCommunicator3D& ParallelBlockCommunicator3D::operator= (
 void ParallelBlockCommunicator3D::swap(ParallelBlockCommunicator3D& rhs) {
     std::swap(overlapsModified,rhs.overlapsModified);
     std::swap(communication,rhs.communication);
+    std::swap(communicationStamp,rhs.communicationStamp);
+    groupCommunications.swap(rhs.groupCommunications);
+    pendingMembers.swap(rhs.pendingMembers);
+    std::swap(pendingSendComm,rhs.pendingSendComm);
+    std::swap(pendingRecvComm,rhs.pendingRecvComm);
+    std::swap(directionalOverlapsModified,rhs.directionalOverlapsModified);
+    std::swap(directionalCommunication,rhs.directionalCommunication);
 }
 
 ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
@@ -208,28 +261,179 @@ ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
 void ParallelBlockCommunicator3D::duplicateOverlaps( MultiBlock3D& multiBlock,
                                                      modif::ModifT whichData ) const
 {
-    MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
-    PeriodicitySwitch3D const& periodicity             = multiBlock.periodicity();
+    communicate(getEnvelopeCommunication(multiBlock), multiBlock, multiBlock, whichData);
+}
 
+CommunicationStructure3D& ParallelBlockCommunicator3D::getEnvelopeCommunication (
+        MultiBlock3D const& multiBlock ) const
+{
     // Implement a caching mechanism for the communication structure.
     if (overlapsModified) {
         overlapsModified = false;
-        LocalMultiBlockInfo3D const& localInfo = multiBlockManagement.getLocalInfo();
-        std::vector<Overlap3D> overlaps(multiBlockManagement.getLocalInfo().getNormalOverlaps());
-        for (pluint iOverlap=0; iOverlap<localInfo.getPeriodicOverlaps().size(); ++iOverlap) {
-            PeriodicOverlap3D const& pOverlap = localInfo.getPeriodicOverlaps()[iOverlap];
-            if (periodicity.get(pOverlap.normalX,pOverlap.normalY,pOverlap.normalZ)) {
-                overlaps.push_back(pOverlap.overlap);
-            }
-        }
+        MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
         delete communication;
         communication = new CommunicationStructure3D (
-                                overlaps,
+                                getEnvelopeOverlaps(multiBlock),
                                 multiBlockManagement, multiBlockManagement,
                                 multiBlock.sizeOfCell() );
+        communicationStamp = nextCommunicationStamp++;
     }
+    return *communication;
+}
 
-    communicate(*communication, multiBlock, multiBlock, whichData);
+void ParallelBlockCommunicator3D::duplicateOverlapsInGroup (
+        std::vector<MultiBlock3D*> const& multiBlocks, modif::ModifT whichData ) const
+{
+    startDuplicateOverlapsInGroup(multiBlocks, whichData);
+    completeDuplicateOverlapsInGroup(multiBlocks, whichData);
+}
+
+void ParallelBlockCommunicator3D::startDuplicateOverlapsInGroup (
+        std::vector<MultiBlock3D*> const& multiBlocks, modif::ModifT whichData ) const
+{
+    PLB_PRECONDITION( pendingMembers.empty() );
+    std::vector<ParallelBlockCommunicator3D const*> communicators(multiBlocks.size());
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        communicators[iBlock] = dynamic_cast<ParallelBlockCommunicator3D const*> (
+                &multiBlocks[iBlock]->getBlockCommunicator() );
+        if (!communicators[iBlock]) {
+            // Nothing is left pending: the update is executed synchronously.
+            BlockCommunicator3D::duplicateOverlapsInGroup(multiBlocks, whichData);
+            return;
+        }
+    }
+    if (multiBlocks.empty()) {
+        return;
+    }
+
+    pendingMembers.resize(multiBlocks.size());
+    std::vector<plint> stamps(multiBlocks.size());
+    std::vector<plint> sizeOfCell(multiBlocks.size());
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        pendingMembers[iBlock] = &communicators[iBlock]->getEnvelopeCommunication(*multiBlocks[iBlock]);
+        stamps[iBlock] = communicators[iBlock]->communicationStamp;
+        sizeOfCell[iBlock] = multiBlocks[iBlock]->sizeOfCell();
+    }
+
+    if (multiBlocks.size()==1) {
+        // A single multi-block uses the messages of its own envelope structure.
+        pendingSendComm = &pendingMembers[0]->sendComm;
+        pendingRecvComm = &pendingMembers[0]->recvComm;
+    }
+    else {
+        // Stamps are never reused, so entries of outdated structures are simply
+        //   left behind; they are cleaned up from time to time.
+        std::map<std::vector<plint>, GroupCommunication3D*>::iterator it = groupCommunications.find(stamps);
+        if (it==groupCommunications.end()) {
+            static const pluint maxGroups = 16;
+            if (groupCommunications.size()>=maxGroups) {
+                for (it=groupCommunications.begin(); it!=groupCommunications.end(); ++it) {
+                    delete it->second;
+                }
+                groupCommunications.clear();
+            }
+            std::vector<CommunicationStructure3D const*> members (
+                    pendingMembers.begin(), pendingMembers.end() );
+            it = groupCommunications.insert(std::make_pair (
+                        stamps, new GroupCommunication3D(members, sizeOfCell) )).first;
+        }
+        pendingSendComm = &it->second->sendComm;
+        pendingRecvComm = &it->second->recvComm;
+    }
+
+    global::profiler().start("mpiCommunication");
+    bool staticMessage = whichData == modif::staticVariables;
+    pendingRecvComm->startBeingReceptive(staticMessage);
+
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        CommunicationStructure3D const& member = *pendingMembers[iBlock];
+        for (unsigned iSend=0; iSend<member.sendPackage.size(); ++iSend) {
+            CommunicationInfo3D const& info = member.sendPackage[iSend];
+            AtomicBlock3D const& fromBlock = multiBlocks[iBlock]->getLocalComponent(info.fromBlockId);
+            fromBlock.getDataTransfer().send (
+                    info.fromDomain, pendingSendComm->getSendBuffer(info.toProcessId), whichData );
+            pendingSendComm->acceptMessage(info.toProcessId, staticMessage);
+        }
+    }
+
+    // The local copies are done while the messages are in flight.
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        CommunicationStructure3D const& member = *pendingMembers[iBlock];
+        for (unsigned iSendRecv=0; iSendRecv<member.sendRecvPackage.size(); ++iSendRecv) {
+            CommunicationInfo3D const& info = member.sendRecvPackage[iSendRecv];
+            AtomicBlock3D const& fromBlock = multiBlocks[iBlock]->getLocalComponent(info.fromBlockId);
+            AtomicBlock3D& toBlock = multiBlocks[iBlock]->getLocalComponent(info.toBlockId);
+            plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+            plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+            plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+            toBlock.getDataTransfer().attribute (
+                    info.toDomain, deltaX, deltaY, deltaZ, fromBlock,
+                    whichData, info.absoluteOffset );
+        }
+    }
+    global::profiler().stop("mpiCommunication");
+}
+
+void ParallelBlockCommunicator3D::completeDuplicateOverlapsInGroup (
+        std::vector<MultiBlock3D*> const& multiBlocks, modif::ModifT whichData ) const
+{
+    if (pendingMembers.empty()) {
+        return;
+    }
+    PLB_PRECONDITION( pendingMembers.size()==multiBlocks.size() );
+
+    global::profiler().start("mpiCommunication");
+    bool staticMessage = whichData == modif::staticVariables;
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        CommunicationStructure3D const& member = *pendingMembers[iBlock];
+        for (unsigned iRecv=0; iRecv<member.recvPackage.size(); ++iRecv) {
+            CommunicationInfo3D const& info = member.recvPackage[iRecv];
+            AtomicBlock3D& toBlock = multiBlocks[iBlock]->getLocalComponent(info.toBlockId);
+            toBlock.getDataTransfer().receive (
+                    info.toDomain,
+                    pendingRecvComm->receiveMessage(info.fromProcessId, staticMessage),
+                    whichData, info.absoluteOffset );
+        }
+    }
+
+    pendingSendComm->finalize(staticMessage);
+    global::profiler().stop("mpiCommunication");
+    pendingMembers.clear();
+    pendingSendComm = 0;
+    pendingRecvComm = 0;
+}
+
+void ParallelBlockCommunicator3D::duplicateOverlapsDirectionally(MultiBlock3D& multiBlock) const
+{
+    MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
+
+    // The message sizes depend on the orientation of the overlaps, and are
+    //   therefore cached separately from the full envelope update.
+    if (directionalOverlapsModified) {
+        directionalOverlapsModified = false;
+        delete directionalCommunication;
+        directionalCommunication = new CommunicationStructure3D (
+                                getEnvelopeOverlaps(multiBlock),
+                                multiBlockManagement, multiBlockManagement,
+                                multiBlock.sizeOfCell(), &multiBlock );
+    }
+
+    communicateDirectionally(*directionalCommunication, multiBlock);
+}
+
+std::vector<Overlap3D> ParallelBlockCommunicator3D::getEnvelopeOverlaps (
+        MultiBlock3D const& multiBlock ) const
+{
+    LocalMultiBlockInfo3D const& localInfo = multiBlock.getMultiBlockManagement().getLocalInfo();
+    PeriodicitySwitch3D const& periodicity = multiBlock.periodicity();
+    std::vector<Overlap3D> overlaps(localInfo.getNormalOverlaps());
+    for (pluint iOverlap=0; iOverlap<localInfo.getPeriodicOverlaps().size(); ++iOverlap) {
+        PeriodicOverlap3D const& pOverlap = localInfo.getPeriodicOverlaps()[iOverlap];
+        if (periodicity.get(pOverlap.normalX,pOverlap.normalY,pOverlap.normalZ)) {
+            overlaps.push_back(pOverlap.overlap);
+        }
+    }
+    return overlaps;
 }
 
 void ParallelBlockCommunicator3D::communicate (
@@ -261,7 +465,7 @@ void ParallelBlockCommunicator3D::communicate (
     // 2. Non-blocking sends.
     for (unsigned iSend=0; iSend<communication.sendPackage.size(); ++iSend) {
         CommunicationInfo3D const& info = communication.sendPackage[iSend];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
+        AtomicBlock3D const& fromBlock = originMultiBlock.getLocalComponent(info.fromBlockId);
         fromBlock.getDataTransfer().send (
                 info.fromDomain, communication.sendComm.getSendBuffer(info.toProcessId),
                 whichData );
@@ -271,8 +475,8 @@ void ParallelBlockCommunicator3D::communicate (
     // 3. Local copies which require no communication.
     for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
         CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+        AtomicBlock3D const& fromBlock = originMultiBlock.getLocalComponent(info.fromBlockId);
+        AtomicBlock3D& toBlock = destinationMultiBlock.getLocalComponent(info.toBlockId);
         plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
         plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
         plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
@@ -284,7 +488,7 @@ void ParallelBlockCommunicator3D::communicate (
     // 4. Finalize the receives.
     for (unsigned iRecv=0; iRecv<communication.recvPackage.size(); ++iRecv) {
         CommunicationInfo3D const& info = communication.recvPackage[iRecv];
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+        AtomicBlock3D& toBlock = destinationMultiBlock.getLocalComponent(info.toBlockId);
         toBlock.getDataTransfer().receive (
                 info.toDomain,
                 communication.recvComm.receiveMessage(info.fromProcessId, staticMessage),
@@ -296,8 +500,50 @@ void ParallelBlockCommunicator3D::communicate (
     global::profiler().stop("mpiCommunication");
 }
 
+void ParallelBlockCommunicator3D::communicateDirectionally (
+        CommunicationStructure3D& communication, MultiBlock3D& multiBlock ) const
+{
+    global::profiler().start("mpiCommunication");
+    // Message sizes are known in advance.
+    bool staticMessage = true;
+    communication.recvComm.startBeingReceptive(staticMessage);
+
+    for (unsigned iSend=0; iSend<communication.sendPackage.size(); ++iSend) {
+        CommunicationInfo3D const& info = communication.sendPackage[iSend];
+        AtomicBlock3D const& fromBlock = multiBlock.getLocalComponent(info.fromBlockId);
+        fromBlock.getDataTransfer().sendDirectional (
+                info.fromDomain, communication.sendComm.getSendBuffer(info.toProcessId),
+                info.orientation );
+        communication.sendComm.acceptMessage(info.toProcessId, staticMessage);
+    }
+
+    for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
+        CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
+        AtomicBlock3D const& fromBlock = multiBlock.getLocalComponent(info.fromBlockId);
+        AtomicBlock3D& toBlock = multiBlock.getLocalComponent(info.toBlockId);
+        plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+        plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+        plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+        toBlock.getDataTransfer().attributeDirectional (
+                info.toDomain, deltaX, deltaY, deltaZ, fromBlock, info.orientation );
+    }
+
+    for (unsigned iRecv=0; iRecv<communication.recvPackage.size(); ++iRecv) {
+        CommunicationInfo3D const& info = communication.recvPackage[iRecv];
+        AtomicBlock3D& toBlock = multiBlock.getLocalComponent(info.toBlockId);
+        toBlock.getDataTransfer().receiveDirectional (
+                info.toDomain,
+                communication.recvComm.receiveMessage(info.fromProcessId, staticMessage),
+                info.orientation );
+    }
+
+    communication.sendComm.finalize(staticMessage);
+    global::profiler().stop("mpiCommunication");
+}
+
 void ParallelBlockCommunicator3D::signalPeriodicity() const {
     overlapsModified = true;
+    directionalOverlapsModified = true;
 }
 
 
@@ -386,8 +632,8 @@ void BlockingCommunicator3D::communicate (
 {
     for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
         CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+        AtomicBlock3D const& fromBlock = originMultiBlock.getLocalComponent(info.fromBlockId);
+        AtomicBlock3D& toBlock = destinationMultiBlock.getLocalComponent(info.toBlockId);
         plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
         plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
         plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
@@ -402,7 +648,7 @@ void BlockingCommunicator3D::communicate (
     std::vector<MPI_Request> request2(communication.sendPackage.size(), MPI_REQUEST_NULL);
     for (unsigned i=0; i<communication.sendPackage.size(); ++i) {
         CommunicationInfo3D const& info = communication.sendPackage[i];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
+        AtomicBlock3D const& fromBlock = originMultiBlock.getLocalComponent(info.fromBlockId);
         fromBlock.getDataTransfer().send (
                 info.fromDomain, data[i], whichData );
         dataSizes[i] = data[i].size();
@@ -420,7 +666,7 @@ void BlockingCommunicator3D::communicate (
         if (dataSize>0) {
             recvBuffer.resize(dataSize);
             global::mpi().receive(&recvBuffer[0], dataSize, info.fromProcessId);
-            AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+            AtomicBlock3D& toBlock = destinationMultiBlock.getLocalComponent(info.toBlockId);
             toBlock.getDataTransfer().receive (
                     info.toDomain, recvBuffer, whichData, info.absoluteOffset );
         }
@@ -36,6 +36,7 @@
 #include "parallelism/sendRecvPool.h"
 #include "parallelism/communicationPackage3D.h"
 #include <vector>
+#include <map>
 
 namespace plb {
 
@@ -54,11 +55,13 @@ struct CommunicationPattern3D
 
 struct CommunicationStructure3D
 {
+    /// If directionalBlock is given, the messages are sized for a direction-selective
+    ///   envelope update of this block, and sizeOfCell is ignored.
     CommunicationStructure3D (
             std::vector<Overlap3D> const& overlaps,
             MultiBlockManagement3D const& originManagement,
             MultiBlockManagement3D const& destinationManagement,
-            plint sizeOfCell );
+            plint sizeOfCell, MultiBlock3D const* directionalBlock=0 );
     CommunicationPackage3D sendPackage;
     CommunicationPackage3D recvPackage;
     CommunicationPackage3D sendRecvPackage;
@@ -67,6 +70,19 @@ struct CommunicationStructure3D
 };
 
 
+/// Aggregated messages for the envelope update of several multi-blocks.
+/** The messages of all multi-blocks between a given pair of processes are
+ *  concatenated, in the order of the multi-blocks, into a single message.
+ **/
+struct GroupCommunication3D
+{
+    GroupCommunication3D (
+            std::vector<CommunicationStructure3D const*> const& members,
+            std::vector<plint> const& sizeOfCell );
+    SendPoolCommunicator sendComm;
+    RecvPoolCommunicator recvComm;
+};
+
 class ParallelBlockCommunicator3D : public BlockCommunicator3D {
 public:
     ParallelBlockCommunicator3D();
@@ -77,6 +93,13 @@ public:
     void swap(ParallelBlockCommunicator3D& rhs);
     virtual ParallelBlockCommunicator3D* clone() const;
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void duplicateOverlapsDirectionally(MultiBlock3D& multiBlock) const;
+    virtual void duplicateOverlapsInGroup( std::vector<MultiBlock3D*> const& multiBlocks,
+                                           modif::ModifT whichData ) const;
+    virtual void startDuplicateOverlapsInGroup( std::vector<MultiBlock3D*> const& multiBlocks,
+                                                modif::ModifT whichData ) const;
+    virtual void completeDuplicateOverlapsInGroup( std::vector<MultiBlock3D*> const& multiBlocks,
+                                                   modif::ModifT whichData ) const;
     virtual void communicate( std::vector<Overlap3D> const& overlaps,
                               MultiBlock3D const& originMultiBlock,
                               MultiBlock3D& destinationMultiBlock,
@@ -86,12 +109,31 @@ private:
     void communicate( CommunicationStructure3D& communication,
                       MultiBlock3D const& originMultiBlock,
                       MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
+    void communicateDirectionally( CommunicationStructure3D& communication,
+                                   MultiBlock3D& multiBlock ) const;
     void subscribeOverlap (
         Overlap3D const& overlap, MultiBlockManagement3D const& multiBlockManagement,
         SendRecvPool& sendPool, SendRecvPool& recvPool, plint sizeOfCell ) const;
+    std::vector<Overlap3D> getEnvelopeOverlaps(MultiBlock3D const& multiBlock) const;
+    /// Return the cached structure for the envelope update, and rebuild it if needed.
+    CommunicationStructure3D& getEnvelopeCommunication(MultiBlock3D const& multiBlock) const;
 private:
     mutable bool overlapsModified;
     mutable CommunicationStructure3D* communication;
+    /// Unique tag of the current envelope structure; a new one is given out
+    ///   whenever the structure is rebuilt.
+    mutable plint communicationStamp;
+    /// Aggregated messages for groups of multi-blocks, indexed by the
+    ///   tags of the envelope structures of the members.
+    mutable std::map<std::vector<plint>, GroupCommunication3D*> groupCommunications;
+    static plint nextCommunicationStamp;
+    /// State of an envelope update which has been started and not yet
+    ///   completed: the structures of the members, and the message pools.
+    mutable std::vector<CommunicationStructure3D*> pendingMembers;
+    mutable SendPoolCommunicator* pendingSendComm;
+    mutable RecvPoolCommunicator* pendingRecvComm;
+    mutable bool directionalOverlapsModified;
+    mutable CommunicationStructure3D* directionalCommunication;
 };
 
 
@@ -48,6 +48,10 @@ public:
     MultiParticleField3D& operator=(MultiParticleField3D<ParticleFieldT> const& rhs);
     MultiParticleField3D(MultiParticleField3D<ParticleFieldT> const& rhs);
     void swap(MultiParticleField3D<ParticleFieldT>& rhs);
+    /// Move to a new block-structure, keeping the atomic-blocks which are
+    ///   unchanged (see MultiBlock3D::reshapeManagement()). The atomic-blocks
+    ///   which are new are initialized with default values.
+    void reshape(MultiBlockManagement3D const& newManagement);
 public:
     virtual ParticleFieldT& getComponent(plint iBlock);
     virtual ParticleFieldT const& getComponent(plint iBlock) const;
@@ -116,6 +116,19 @@ void MultiParticleField3D<ParticleFieldT>::swap(MultiParticleField3D<ParticleFie
     MultiBlock3D::swap(rhs);
 }
 
+template<class ParticleFieldT>
+void MultiParticleField3D<ParticleFieldT>::reshape(MultiBlockManagement3D const& newManagement)
+{
+    std::vector<plint> droppedBlocks;
+    this->reshapeManagement(newManagement, droppedBlocks);
+    for (pluint iBlock=0; iBlock<droppedBlocks.size(); ++iBlock) {
+        typename BlockMap::iterator it = blocks.find(droppedBlocks[iBlock]);
+        delete it->second;
+        blocks.erase(it);
+    }
+    allocateBlocks();
+}
+
 template<class ParticleFieldT>
 MultiParticleField3D<ParticleFieldT>* MultiParticleField3D<ParticleFieldT>::clone() const {
     return new MultiParticleField3D<ParticleFieldT>(*this);
@@ -139,6 +152,9 @@ void MultiParticleField3D<ParticleFieldT>::allocateBlocks()
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock)
     {
         plint blockId = this->getLocalInfo().getBlocks()[iBlock];
+        if (blocks.find(blockId) != blocks.end()) {
+            continue; // Kept by reshape().
+        }
         SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
         Box3D envelope = bulk.computeEnvelope();
         ParticleFieldT* newBlock =
@@ -147,6 +163,7 @@ void MultiParticleField3D<ParticleFieldT>::allocateBlocks()
         newBlock -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
         blocks[blockId] = newBlock;
     }
+    this->resolveLocalComponents();
 }
 
 template<class ParticleFieldT>
@@ -0,0 +1,141 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Exchange of particles between the blocks of a multi-particle-field -- implementation.
+ */
+
+#include "particles/particleNonLocalTransfer3D.h"
+#include "multiBlock/multiBlock3D.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/sparseBlockStructure3D.h"
+#include "parallelism/mpiManager.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+
+namespace plb {
+
+void computeParticleMigrationPartners( MultiBlock3D const& multiBlock,
+                                       std::vector<int>& partners )
+{
+    partners.clear();
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    plint envelopeWidth = management.getEnvelopeWidth();
+    Box3D boundingBox = multiBlock.getBoundingBox();
+    PeriodicitySwitch3D const& periodicity = multiBlock.periodicity();
+    int myRank = global::mpi().getRank();
+
+    std::vector<plint> const& localBlocks = management.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        Box3D bulk;
+        sparseBlock.getBulk(localBlocks[iBlock], bulk);
+        Box3D envelope(bulk.enlarge(envelopeWidth));
+        // Periodic neighbors are found by shifting the envelope by one
+        //   period, in each periodic direction.
+        for (plint dx=-1; dx<=1; ++dx) {
+            if (dx!=0 && !periodicity.get(0)) continue;
+            for (plint dy=-1; dy<=1; ++dy) {
+                if (dy!=0 && !periodicity.get(1)) continue;
+                for (plint dz=-1; dz<=1; ++dz) {
+                    if (dz!=0 && !periodicity.get(2)) continue;
+                    Box3D shifted( envelope.shift( dx*boundingBox.getNx(),
+                                                   dy*boundingBox.getNy(),
+                                                   dz*boundingBox.getNz() ) );
+                    std::vector<plint> neighbors;
+                    sparseBlock.findNeighbors(shifted, 0, neighbors);
+                    for (pluint iNeighbor=0; iNeighbor<neighbors.size(); ++iNeighbor) {
+                        int proc = attribution.getMpiProcess(neighbors[iNeighbor]);
+                        if (proc != myRank) {
+                            partners.push_back(proc);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    std::sort(partners.begin(), partners.end());
+    partners.erase(std::unique(partners.begin(), partners.end()), partners.end());
+}
+
+void exchangeParticleMigrants( std::vector<int> const& partners,
+                               std::map<int, std::vector<char> > const& outgoing,
+                               std::vector<std::vector<char> >& incoming )
+{
+    incoming.clear();
+#ifdef PLB_MPI_PARALLEL
+    pluint numPartners = partners.size();
+    incoming.resize(numPartners);
+    if (numPartners==0) {
+        return;
+    }
+    MPI_Status status;
+
+    // 1. Exchange the message sizes. The partner relation is symmetric, which
+    //    is why every process knows how many size messages to expect.
+    std::vector<int> sendSizes(numPartners), recvSizes(numPartners);
+    std::vector<MPI_Request> sizeRequests(2*numPartners);
+    for (pluint iPartner=0; iPartner<numPartners; ++iPartner) {
+        global::mpi().iRecv(&recvSizes[iPartner], 1, partners[iPartner], &sizeRequests[iPartner]);
+    }
+    for (pluint iPartner=0; iPartner<numPartners; ++iPartner) {
+        std::map<int, std::vector<char> >::const_iterator it = outgoing.find(partners[iPartner]);
+        sendSizes[iPartner] = it==outgoing.end() ? 0 : (int)it->second.size();
+        global::mpi().iSend(&sendSizes[iPartner], 1, partners[iPartner],
+                            &sizeRequests[numPartners+iPartner]);
+    }
+    for (pluint iRequest=0; iRequest<sizeRequests.size(); ++iRequest) {
+        global::mpi().wait(&sizeRequests[iRequest], &status);
+    }
+
+    // 2. Exchange the particles, skipping the empty messages.
+    std::vector<MPI_Request> dataRequests;
+    dataRequests.reserve(2*numPartners);
+    for (pluint iPartner=0; iPartner<numPartners; ++iPartner) {
+        if (recvSizes[iPartner]>0) {
+            incoming[iPartner].resize(recvSizes[iPartner]);
+            dataRequests.push_back(MPI_Request());
+            global::mpi().iRecv(&incoming[iPartner][0], recvSizes[iPartner],
+                                partners[iPartner], &dataRequests.back());
+        }
+    }
+    for (pluint iPartner=0; iPartner<numPartners; ++iPartner) {
+        if (sendSizes[iPartner]>0) {
+            std::vector<char> const& buffer = outgoing.find(partners[iPartner])->second;
+            dataRequests.push_back(MPI_Request());
+            global::mpi().iSend(const_cast<char*>(&buffer[0]), sendSizes[iPartner],
+                                partners[iPartner], &dataRequests.back());
+        }
+    }
+    for (pluint iRequest=0; iRequest<dataRequests.size(); ++iRequest) {
+        global::mpi().wait(&dataRequests[iRequest], &status);
+    }
+#else
+    PLB_ASSERT( partners.empty() );
+#endif  // PLB_MPI_PARALLEL
+}
+
+} // namespace plb
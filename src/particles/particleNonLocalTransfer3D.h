@@ -28,6 +28,8 @@
 #include "core/globalDefs.h"
 #include "multiBlock/localMultiBlockInfo3D.h"
 #include "particles/multiParticleField3D.h"
+#include <map>
+#include <vector>
 
 
 namespace plb {
@@ -49,6 +51,51 @@ template<typename T, template<typename U> class Descriptor, class ParticleFieldT
 void injectParticlesAtMainProc( std::vector<Particle3D<T,Descriptor>*>& particles,
                                 MultiParticleField3D<ParticleFieldT>& particleField, Box3D domain );
 
+/// Hand the particles which have left the bulk of their block over to the
+///   block which now contains them.
+/** Every particle found in the envelope of a block is considered to have
+ *  left it during the last iteration: it is removed from this block and
+ *  appended to the bulk of the block in which it is now located (possibly
+ *  on another MPI process, and across periodic boundaries). Particles in
+ *  the bulk are not touched, and nothing else is communicated. This assumes
+ *  that the envelopes contain no ghost copies of the neighbors' particles,
+ *  as is the case when the particles are advanced through
+ *  advanceAndMigrateParticles() instead of an envelope update. A particle
+ *  which has moved by more than the envelope width cannot be delivered, and
+ *  raises a PlbLogicException on all processes.
+ **/
+template<typename T, template<typename U> class Descriptor, class ParticleFieldT>
+void migrateParticles(MultiParticleField3D<ParticleFieldT>& particleField);
+
+/// Advance the particles in the bulk of all blocks, and migrate the ones
+///   which have left their block.
+/** This replaces the combination of AdvanceParticlesFunctional3D and an
+ *  envelope update of the particle-field, which re-serializes all particles
+ *  located close to a block boundary at every iteration. Ghost copies left in
+ *  the envelopes by a previous envelope update are discarded. As with the
+ *  envelope update, a particle must not travel further than the envelope
+ *  width in one iteration: this raises a PlbLogicException on all processes.
+ *  When the speed of a particle drops below sqrt(cutOffValue), the particle is
+ *  eliminated; in this case, particles which have moved beyond the envelope are
+ *  eliminated as well, without being detected.
+ **/
+template<typename T, template<typename U> class Descriptor, class ParticleFieldT>
+void advanceAndMigrateParticles( MultiParticleField3D<ParticleFieldT>& particleField,
+                                 T cutOffValue=-1. );
+
+/// List the MPI processes which own a block adjacent (within the envelope
+///   width, and including periodic neighbors) to a block of the current process.
+void computeParticleMigrationPartners( MultiBlock3D const& multiBlock,
+                                       std::vector<int>& partners );
+
+/// Send the serialized migrating particles to the partner processes, and
+///   receive theirs. An empty message is exchanged with partners for which
+///   no particle is available, so that a process never waits for a message
+///   which is not sent.
+void exchangeParticleMigrants( std::vector<int> const& partners,
+                               std::map<int, std::vector<char> > const& outgoing,
+                               std::vector<std::vector<char> >& incoming );
+
 } // namespace plb
 
 #endif  // PARTICLE_NON_LOCAL_TRANSFER_3D_H
@@ -27,6 +27,14 @@
 
 #include "core/globalDefs.h"
 #include "particles/particleNonLocalTransfer3D.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/sparseBlockStructure3D.h"
+#include "particles/particleIdentifiers3D.h"
+#include "core/hierarchicSerializer.h"
+#include "core/runTimeDiagnostics.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <vector>
 
 namespace plb {
@@ -100,6 +108,158 @@ void injectParticlesAtMainProc( std::vector<Particle3D<T,Descriptor>*>& particle
     copy ( multiSerialParticles, domain, particleField, domain );
 }
 
+template<typename T, template<typename U> class Descriptor, class ParticleFieldT>
+void migrateParticles(MultiParticleField3D<ParticleFieldT>& particleField)
+{
+    MultiBlockManagement3D const& management = particleField.getMultiBlockManagement();
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    PeriodicitySwitch3D const& periodicity = particleField.periodicity();
+    Box3D boundingBox = particleField.getBoundingBox();
+    Array<T,3> lowerEnd( (T)boundingBox.x0-(T)0.5, (T)boundingBox.y0-(T)0.5, (T)boundingBox.z0-(T)0.5 );
+    Array<T,3> upperEnd( (T)boundingBox.x1+(T)0.5, (T)boundingBox.y1+(T)0.5, (T)boundingBox.z1+(T)0.5 );
+    Array<T,3> period( (T)boundingBox.getNx(), (T)boundingBox.getNy(), (T)boundingBox.getNz() );
+    int myRank = global::mpi().getRank();
+
+    // 1. Extract the particles from the envelopes. Those which stay on the
+    //    current process are directly added to their new block, the other
+    //    ones are serialized into one message per destination process.
+    std::map<int, std::vector<char> > outgoing;
+    std::vector<plint> const& localBlocks = management.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        plint blockId = localBlocks[iBlock];
+        ParticleField3D<T,Descriptor>& atomicField =
+            dynamic_cast<ParticleField3D<T,Descriptor>&>(particleField.getLocalComponent(blockId));
+        SmartBulk3D bulk(management, blockId);
+        std::vector<Box3D> envelopeParts;
+        except(atomicField.getBoundingBox(), bulk.toLocal(bulk.getBulk()), envelopeParts);
+        for (pluint iPart=0; iPart<envelopeParts.size(); ++iPart) {
+            std::vector<Particle3D<T,Descriptor>*> found;
+            atomicField.findParticles(envelopeParts[iPart], found);
+            for (pluint iParticle=0; iParticle<found.size(); ++iParticle) {
+                Particle3D<T,Descriptor>* migrant = found[iParticle]->clone();
+                Array<T,3>& position = migrant->getPosition();
+                for (plint iD=0; iD<3; ++iD) {
+                    if (periodicity.get(iD)) {
+                        if (position[iD] <= lowerEnd[iD]) {
+                            position[iD] += period[iD];
+                        }
+                        else if (position[iD] > upperEnd[iD]) {
+                            position[iD] -= period[iD];
+                        }
+                    }
+                }
+                // A cell iX contains the positions in the interval ]iX-1/2, iX+1/2].
+                plint destination = sparseBlock.locate (
+                        (plint)std::ceil(position[0]-(T)0.5),
+                        (plint)std::ceil(position[1]-(T)0.5),
+                        (plint)std::ceil(position[2]-(T)0.5) );
+                if (destination<0) {
+                    // The particle has left the domain.
+                    delete migrant;
+                    continue;
+                }
+                int destinationProc = attribution.getMpiProcess(destination);
+                if (destinationProc==myRank) {
+                    SmartBulk3D destinationBulk(management, destination);
+                    dynamic_cast<ParticleField3D<T,Descriptor>&> (
+                            particleField.getLocalComponent(destination) ).addParticle (
+                                    destinationBulk.toLocal(destinationBulk.getBulk()), migrant );
+                }
+                else {
+                    serialize(*migrant, outgoing[destinationProc]);
+                    delete migrant;
+                }
+            }
+            atomicField.removeParticles(envelopeParts[iPart]);
+        }
+    }
+
+    // 2. Exchange the migrating particles with the neighboring processes.
+    std::vector<int> partners;
+    computeParticleMigrationPartners(particleField, partners);
+    // A message to a non-partner process means that a particle has moved
+    //   by more than the envelope width: it would be lost in the exchange.
+    bool lostParticles = false;
+    for (std::map<int, std::vector<char> >::const_iterator it = outgoing.begin();
+         it != outgoing.end(); ++it)
+    {
+        if (!std::binary_search(partners.begin(), partners.end(), it->first)) {
+            lostParticles = true;
+        }
+    }
+    plbLogicError( lostParticles,
+                   "migrateParticles: a particle has moved by more than the envelope width "
+                   "of the particle field." );
+    std::vector<std::vector<char> > incoming;
+    exchangeParticleMigrants(partners, outgoing, incoming);
+
+    // 3. Append the received particles to the bulk of their new block.
+    for (pluint iMessage=0; iMessage<incoming.size(); ++iMessage) {
+        std::vector<char> const& buffer = incoming[iMessage];
+        pluint posInBuffer = 0;
+        while (posInBuffer < buffer.size()) {
+            HierarchicUnserializer unserializer(buffer, posInBuffer);
+            Particle3D<T,Descriptor>* migrant =
+                meta::particleRegistration3D<T,Descriptor>().generate(unserializer);
+            posInBuffer = unserializer.getCurrentPos();
+            Array<T,3> const& position = migrant->getPosition();
+            plint destination = sparseBlock.locate (
+                    (plint)std::ceil(position[0]-(T)0.5),
+                    (plint)std::ceil(position[1]-(T)0.5),
+                    (plint)std::ceil(position[2]-(T)0.5) );
+            PLB_ASSERT( destination>=0 && attribution.getMpiProcess(destination)==myRank );
+            SmartBulk3D destinationBulk(management, destination);
+            dynamic_cast<ParticleField3D<T,Descriptor>&> (
+                    particleField.getLocalComponent(destination) ).addParticle (
+                            destinationBulk.toLocal(destinationBulk.getBulk()), migrant );
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, class ParticleFieldT>
+void advanceAndMigrateParticles( MultiParticleField3D<ParticleFieldT>& particleField,
+                                 T cutOffValue )
+{
+    MultiBlockManagement3D const& management = particleField.getMultiBlockManagement();
+    std::vector<plint> const& localBlocks = management.getLocalInfo().getBlocks();
+    bool lostParticles = false;
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        plint blockId = localBlocks[iBlock];
+        ParticleField3D<T,Descriptor>& atomicField =
+            dynamic_cast<ParticleField3D<T,Descriptor>&>(particleField.getLocalComponent(blockId));
+        SmartBulk3D bulk(management, blockId);
+        Box3D localBulk(bulk.toLocal(bulk.getBulk()));
+        // Discard the ghost copies of the neighbors' particles, which are
+        //   kept up-to-date through migration from now on.
+        std::vector<Box3D> envelopeParts;
+        except(atomicField.getBoundingBox(), localBulk, envelopeParts);
+        for (pluint iPart=0; iPart<envelopeParts.size(); ++iPart) {
+            atomicField.removeParticles(envelopeParts[iPart]);
+        }
+        // The envelope being empty, this advances the particles of the bulk
+        //   only, but keeps those which move into the envelope.
+        // Without cut-off, the only particles deleted by the advance are
+        //   those which have moved beyond the envelope.
+        std::vector<Particle3D<T,Descriptor>*> found;
+        if (cutOffValue<T()) {
+            atomicField.findParticles(localBulk, found);
+        }
+        pluint numParticles = found.size();
+        atomicField.advanceParticles(atomicField.getBoundingBox(), cutOffValue);
+        if (cutOffValue<T()) {
+            found.clear();
+            atomicField.findParticles(atomicField.getBoundingBox(), found);
+            if (found.size()!=numParticles) {
+                lostParticles = true;
+            }
+        }
+    }
+    plbLogicError( lostParticles,
+                   "advanceAndMigrateParticles: a particle has moved by more than the "
+                   "envelope width of the particle field." );
+    migrateParticles<T,Descriptor>(particleField);
+}
 
 } // namespace plb
 
@@ -29,6 +29,7 @@
 #include "particles/multiParticleField3D.h"
 #include "offLattice/triangleBoundary3D.h"
 #include "algorithm/functions.h"
+#include <map>
 #include <vector>
 #include <string>
 
@@ -227,6 +228,66 @@ void writeSelectedParticleVtk (
                              deltaX, offset);
 }
 
+/// Write the particles in parallel, as a set of raw-binary VTK PolyData files.
+/** Every MPI process writes the particles of the bulk of its blocks into its
+ *  own piece, fName_<rank>.vtp, and the main processor writes the index file
+ *  fName.pvtp, which lists the non-empty pieces (fName has no extension and
+ *  may contain a directory). No particle data is communicated, so that the
+ *  cost and memory of the output scale with the local number of particles.
+ *  The position and the tag are always written; the additional scalars and
+ *  vectors are selected through their id in Particle3D::getScalar() and
+ *  Particle3D::getVector(), and written under the associated name.
+ **/
+template<typename T, template<typename U> class Descriptor>
+void writeParallelParticleVtp (
+        MultiParticleField3D<DenseParticleField3D<T,Descriptor> >& particles,
+        std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX, Array<T,3> const& offset );
+
+template<typename T, template<typename U> class Descriptor>
+void writeParallelParticleVtp (
+        MultiParticleField3D<DenseParticleField3D<T,Descriptor> >& particles,
+        std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX = T(1) )
+{
+    Array<T,3> offset;
+    offset.resetToZero();
+    writeParallelParticleVtp(particles, fName, additionalScalars, additionalVectors, deltaX, offset);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void writeParallelParticleVtp (
+        MultiParticleField3D<LightParticleField3D<T,Descriptor> >& particles,
+        std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX, Array<T,3> const& offset );
+
+template<typename T, template<typename U> class Descriptor>
+void writeParallelParticleVtp (
+        MultiParticleField3D<LightParticleField3D<T,Descriptor> >& particles,
+        std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX = T(1) )
+{
+    Array<T,3> offset;
+    offset.resetToZero();
+    writeParallelParticleVtp(particles, fName, additionalScalars, additionalVectors, deltaX, offset);
+}
+
+/// Implementation of writeParallelParticleVtp, for any type of particle-field.
+template<typename T, template<typename U> class Descriptor>
+void particleVtpParallelImplementation (
+        MultiBlock3D& particles, std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX, Array<T,3> const& offset );
+
 }  // namespace plb
 
 #endif  // PARTICLE_VTK_3D_H
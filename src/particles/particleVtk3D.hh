@@ -31,6 +31,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
 
 #define frand() ((double) rand() / (RAND_MAX + 1.0))
 
@@ -536,6 +537,212 @@ void writeSelectedParticleVtk (
                                     deltaX, offset, 0);
 }
 
+template<typename T, template<typename U> class Descriptor>
+void writeParallelParticleVtp (
+        MultiParticleField3D<DenseParticleField3D<T,Descriptor> >& particles,
+        std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX, Array<T,3> const& offset )
+{
+    particleVtpParallelImplementation<T,Descriptor> (
+            particles, fName, additionalScalars, additionalVectors, deltaX, offset );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void writeParallelParticleVtp (
+        MultiParticleField3D<LightParticleField3D<T,Descriptor> >& particles,
+        std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX, Array<T,3> const& offset )
+{
+    particleVtpParallelImplementation<T,Descriptor> (
+            particles, fName, additionalScalars, additionalVectors, deltaX, offset );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void particleVtpParallelImplementation (
+        MultiBlock3D& particles, std::string const& fName,
+        std::map<plint,std::string> const& additionalScalars,
+        std::map<plint,std::string> const& additionalVectors,
+        T deltaX, Array<T,3> const& offset )
+{
+    // 1. Collect the particles of the bulk of the local blocks.
+    MultiBlockManagement3D const& management = particles.getMultiBlockManagement();
+    std::vector<plint> const& localBlocks = management.getLocalInfo().getBlocks();
+    std::vector<Particle3D<T,Descriptor>*> found;
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        plint blockId = localBlocks[iBlock];
+        ParticleField3D<T,Descriptor>& atomicParticles =
+            dynamic_cast<ParticleField3D<T,Descriptor>&>(particles.getComponent(blockId));
+        SmartBulk3D bulk(management, blockId);
+        std::vector<Particle3D<T,Descriptor>*> foundInBlock;
+        atomicParticles.findParticles(bulk.toLocal(bulk.getBulk()), foundInBlock);
+        found.insert(found.end(), foundInBlock.begin(), foundInBlock.end());
+    }
+    pluint numParticles = found.size();
+
+    // 2. The main processor needs to know which pieces are not empty.
+    int numProcs = global::mpi().getSize();
+    int myRank = global::mpi().getRank();
+    std::vector<plint> localNumParticles(numProcs, 0), allNumParticles(numProcs, 0);
+    localNumParticles[myRank] = (plint)numParticles;
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().reduceVect(localNumParticles, allNumParticles, MPI_SUM);
+#else
+    allNumParticles = localNumParticles;
+#endif
+
+    std::string::size_type slashPos = fName.find_last_of('/');
+    std::string baseName = slashPos==std::string::npos ? fName : fName.substr(slashPos+1);
+
+    if (global::mpi().isMainProcessor()) {
+        std::ofstream indexFile((fName+".pvtp").c_str());
+        indexFile << "<?xml version=\"1.0\"?>\n";
+#ifdef PLB_BIG_ENDIAN
+        indexFile << "<VTKFile type=\"PPolyData\" version=\"0.1\" byte_order=\"BigEndian\" header_type=\"UInt64\">\n";
+#else
+        indexFile << "<VTKFile type=\"PPolyData\" version=\"0.1\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n";
+#endif
+        indexFile << "<PPolyData GhostLevel=\"0\">\n";
+        indexFile << "<PPointData>\n";
+        indexFile << "<PDataArray type=\"Int64\" Name=\"Tag\"/>\n";
+        std::map<plint,std::string>::const_iterator vectorIt = additionalVectors.begin();
+        for (; vectorIt != additionalVectors.end(); ++vectorIt) {
+            indexFile << "<PDataArray type=\"Float64\" Name=\"" << vectorIt->second
+                      << "\" NumberOfComponents=\"3\"/>\n";
+        }
+        std::map<plint,std::string>::const_iterator scalarIt = additionalScalars.begin();
+        for (; scalarIt != additionalScalars.end(); ++scalarIt) {
+            indexFile << "<PDataArray type=\"Float64\" Name=\"" << scalarIt->second << "\"/>\n";
+        }
+        indexFile << "</PPointData>\n";
+        indexFile << "<PPoints>\n<PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n</PPoints>\n";
+        for (int iProc=0; iProc<numProcs; ++iProc) {
+            if (allNumParticles[iProc]>0) {
+                indexFile << "<Piece Source=\"" << baseName << "_" << iProc << ".vtp\"/>\n";
+            }
+        }
+        indexFile << "</PPolyData>\n";
+        indexFile << "</VTKFile>\n";
+    }
+    if (numParticles==0) {
+        return;
+    }
+
+    // 3. Write the local piece: an XML header which refers to offsets in the
+    //    raw-binary appended section, followed by the data arrays. Each array
+    //    in the appended section is preceded by its size in bytes.
+    typedef unsigned long long HeaderT;
+    pluint numScalars = additionalScalars.size();
+    pluint numVectors = additionalVectors.size();
+    HeaderT scalarArraySize = (HeaderT)(numParticles*sizeof(double));
+    HeaderT vectorArraySize = (HeaderT)(3*numParticles*sizeof(double));
+    HeaderT intArraySize    = (HeaderT)(numParticles*sizeof(long long));
+
+    std::ofstream pieceFile ( (fName+"_"+util::val2str(myRank)+".vtp").c_str(),
+                              std::ios::out | std::ios::binary );
+    pieceFile << "<?xml version=\"1.0\"?>\n";
+#ifdef PLB_BIG_ENDIAN
+    pieceFile << "<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"BigEndian\" header_type=\"UInt64\">\n";
+#else
+    pieceFile << "<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n";
+#endif
+    pieceFile << "<PolyData>\n";
+    pieceFile << "<Piece NumberOfPoints=\"" << numParticles << "\" NumberOfVerts=\"" << numParticles
+              << "\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
+    HeaderT arrayOffset = 0;
+    pieceFile << "<PointData>\n";
+    pieceFile << "<DataArray type=\"Int64\" Name=\"Tag\" format=\"appended\" offset=\""
+              << arrayOffset << "\"/>\n";
+    arrayOffset += sizeof(HeaderT) + intArraySize;
+    std::map<plint,std::string>::const_iterator vectorIt = additionalVectors.begin();
+    for (; vectorIt != additionalVectors.end(); ++vectorIt) {
+        pieceFile << "<DataArray type=\"Float64\" Name=\"" << vectorIt->second
+                  << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << arrayOffset << "\"/>\n";
+        arrayOffset += sizeof(HeaderT) + vectorArraySize;
+    }
+    std::map<plint,std::string>::const_iterator scalarIt = additionalScalars.begin();
+    for (; scalarIt != additionalScalars.end(); ++scalarIt) {
+        pieceFile << "<DataArray type=\"Float64\" Name=\"" << scalarIt->second
+                  << "\" format=\"appended\" offset=\"" << arrayOffset << "\"/>\n";
+        arrayOffset += sizeof(HeaderT) + scalarArraySize;
+    }
+    pieceFile << "</PointData>\n";
+    pieceFile << "<Points>\n<DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"appended\" offset=\""
+              << arrayOffset << "\"/>\n</Points>\n";
+    arrayOffset += sizeof(HeaderT) + vectorArraySize;
+    pieceFile << "<Verts>\n";
+    pieceFile << "<DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\""
+              << arrayOffset << "\"/>\n";
+    arrayOffset += sizeof(HeaderT) + intArraySize;
+    pieceFile << "<DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\""
+              << arrayOffset << "\"/>\n";
+    pieceFile << "</Verts>\n";
+    pieceFile << "</Piece>\n";
+    pieceFile << "</PolyData>\n";
+    pieceFile << "<AppendedData encoding=\"raw\">\n_";
+
+    std::vector<long long> intData(numParticles);
+    std::vector<double> scalarData(numParticles);
+    std::vector<double> vectorData(3*numParticles);
+
+    for (pluint iParticle=0; iParticle<numParticles; ++iParticle) {
+        intData[iParticle] = (long long)found[iParticle]->getTag();
+    }
+    pieceFile.write((char const*)&intArraySize, sizeof(HeaderT));
+    pieceFile.write((char const*)&intData[0], intArraySize);
+
+    for (vectorIt = additionalVectors.begin(); vectorIt != additionalVectors.end(); ++vectorIt) {
+        for (pluint iParticle=0; iParticle<numParticles; ++iParticle) {
+            Array<T,3> vectorValue;
+            vectorValue.resetToZero();
+            found[iParticle]->getVector(vectorIt->first, vectorValue);
+            for (plint iD=0; iD<3; ++iD) {
+                vectorData[3*iParticle+iD] = (double)vectorValue[iD];
+            }
+        }
+        pieceFile.write((char const*)&vectorArraySize, sizeof(HeaderT));
+        pieceFile.write((char const*)&vectorData[0], vectorArraySize);
+    }
+
+    for (scalarIt = additionalScalars.begin(); scalarIt != additionalScalars.end(); ++scalarIt) {
+        for (pluint iParticle=0; iParticle<numParticles; ++iParticle) {
+            T scalarValue = T();
+            found[iParticle]->getScalar(scalarIt->first, scalarValue);
+            scalarData[iParticle] = (double)scalarValue;
+        }
+        pieceFile.write((char const*)&scalarArraySize, sizeof(HeaderT));
+        pieceFile.write((char const*)&scalarData[0], scalarArraySize);
+    }
+
+    for (pluint iParticle=0; iParticle<numParticles; ++iParticle) {
+        Array<T,3> pos(found[iParticle]->getPosition());
+        pos = deltaX * pos + offset;
+        for (plint iD=0; iD<3; ++iD) {
+            vectorData[3*iParticle+iD] = (double)pos[iD];
+        }
+    }
+    pieceFile.write((char const*)&vectorArraySize, sizeof(HeaderT));
+    pieceFile.write((char const*)&vectorData[0], vectorArraySize);
+
+    // Every particle is represented by a vertex cell.
+    for (pluint iParticle=0; iParticle<numParticles; ++iParticle) {
+        intData[iParticle] = (long long)iParticle;
+    }
+    pieceFile.write((char const*)&intArraySize, sizeof(HeaderT));
+    pieceFile.write((char const*)&intData[0], intArraySize);
+    for (pluint iParticle=0; iParticle<numParticles; ++iParticle) {
+        intData[iParticle] = (long long)(iParticle+1);
+    }
+    pieceFile.write((char const*)&intArraySize, sizeof(HeaderT));
+    pieceFile.write((char const*)&intData[0], intArraySize);
+
+    pieceFile << "\n</AppendedData>\n";
+    pieceFile << "</VTKFile>\n";
+}
+
 }  // namespace plb
 
 #undef frand